@@ -34,6 +34,8 @@
 #ifndef ASCENDDK_ASCENDCAMERA_ASCEND_CAMERA_COMMON_H_
 #define ASCENDDK_ASCENDCAMERA_ASCEND_CAMERA_COMMON_H_
 
+#include <string>
+
 #include "toolchain/slog.h"
 
 namespace ascend {
@@ -82,10 +82,18 @@ class AscendCameraParameter {
   bool Verify();
 
   /**
-   * @brief get camera channel
-   * @return camera channel number
+   * @brief get camera channels
+   * @return camera channel numbers, at least one
    */
-  const int GetCameraChannel() const;
+  const std::vector<int> &GetCameraChannels() const;
+
+  /**
+   * @brief get output file of a camera channel
+   * @param [in] channel: camera channel
+   * @return output file, channel tag is inserted when capturing several
+   *         cameras
+   */
+  const std::string GetChannelOutputFile(int channel) const;
 
   /**
    * @brief check contains parameter help or not
@@ -136,6 +144,48 @@ class AscendCameraParameter {
    */
   const int GetFps() const;
 
+  /**
+   * @brief get segment size of video file
+   * @return segment size(unit: MB), 0: no limit
+   */
+  const int GetSegmentSize() const;
+
+  /**
+   * @brief get segment time of video file
+   * @return segment time(unit: second), 0: no limit
+   */
+  const int GetSegmentTime() const;
+
+  /**
+   * @brief check write video file with O_DIRECT or not
+   * @return true: O_DIRECT; false: page cache
+   */
+  const bool IsDirectIo() const;
+
+  /**
+   * @brief get the file replayed instead of the camera
+   * @return replay file, empty: use the camera
+   */
+  const std::string &GetReplayFile() const;
+
+  /**
+   * @brief check replay as fast as possible or at fps
+   * @return true: as fast as possible; false: at fps
+   */
+  const bool IsReplayFast() const;
+
+  /**
+   * @brief check stop at the end of the replay file or start over
+   * @return true: stop; false: start over
+   */
+  const bool IsReplayOnce() const;
+
+  /**
+   * @brief get the maximum time a frame waits for its h264 batch
+   * @return max latency(unit: millisecond), 0: every frame is encoded alone
+   */
+  const int GetMaxLatency() const;
+
  private:
   // fps default value
   const int kDefaultFps = 10;
@@ -155,6 +205,24 @@ class AscendCameraParameter {
   // default invalid value
   const int kInvalidValue = -1;
 
+  // segment size default value, no limit
+  const int kDefaultSegmentSize = 0;
+
+  // segment time default value, no limit
+  const int kDefaultSegmentTime = 0;
+
+  // segment time maximum value, one day
+  const int kMaxSegmentTime = 86400;
+
+  // max latency default value of a video file, favours throughput
+  const int kDefaultRecordLatency = 1000;
+
+  // max latency default value of a video to stdout, favours latency
+  const int kDefaultStreamLatency = 100;
+
+  // max latency maximum value
+  const int kMaxLatency = 5000;
+
   // default buffer size
   const int kDefaultBufferSize = 1000;
 
@@ -192,8 +260,11 @@ class AscendCameraParameter {
   // check has parameter help(--help) or not
   bool contains_help_ = false;
 
-  // camera channel
-  int camera_channel_ = kDefaultCameraChannel;
+  // camera channels value, e.g. "0,1"
+  std::string camera_channel_str_ = "";
+
+  // camera channels
+  std::vector<int> camera_channels_;
 
   // image width
   int image_width_ = kInvalidValue;
@@ -222,6 +293,27 @@ class AscendCameraParameter {
   // frames per second
   int fps_ = kInvalidValue;
 
+  // segment size of video file(unit: MB)
+  int segment_size_ = kInvalidValue;
+
+  // segment time of video file(unit: second)
+  int segment_time_ = kInvalidValue;
+
+  // write video file with O_DIRECT or not
+  bool direct_io_ = false;
+
+  // yuv420sp file replayed instead of the camera
+  std::string replay_file_ = "";
+
+  // replay as fast as possible or not
+  bool replay_fast_ = false;
+
+  // stop at the end of the replay file or not
+  bool replay_once_ = false;
+
+  // maximum time a frame waits for its h264 batch(unit: millisecond)
+  int max_latency_ = kInvalidValue;
+
   // record valid parameters
   std::map<std::string, std::string> valid_params_;
 
@@ -347,7 +439,7 @@ class AscendCameraParameter {
    * @brief verify camera channel
    * @return true: verify pass; false: verify not pass
    */
-  bool VerifyCameraChannel() const;
+  bool VerifyCameraChannel();
 
   /**
    * @brief verify media type
@@ -361,6 +453,24 @@ class AscendCameraParameter {
    */
   bool VerifyFpsValue();
 
+  /**
+   * @brief verify segment time value
+   * @return true: verify pass; false: verify not pass
+   */
+  bool VerifySegmentTime() const;
+
+  /**
+   * @brief verify max latency value
+   * @return true: verify pass; false: verify not pass
+   */
+  bool VerifyMaxLatency() const;
+
+  /**
+   * @brief verify replay file can be read
+   * @return true: verify pass; false: verify not pass
+   */
+  bool VerifyReplayFile() const;
+
   /**
    * @brief verify output value
    * @return true: verify pass; false: verify not pass
@@ -371,7 +481,7 @@ class AscendCameraParameter {
    * @brief handle the situation where the file already exists
    * @return true: handle success; false: handle failed
    */
-  bool HandleExistFile() const;
+  bool HandleExistFile(const std::string &file) const;
 
   /**
    * @brief verify output to presenter value
@@ -36,6 +36,10 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include "ascenddk/ascend_ezdvpp/frame_buffer_pool.h"
+#include "ascenddk/ascend_utils/latency_trace.h"
+#include "ascenddk/ascend_ezdvpp/virtual_camera.h"
 extern "C" {
 #include "driver/peripheral_api.h"
 }
@@ -46,6 +50,10 @@ namespace ascendcamera {
 const int kCameraReturnInvalid = 0;
 const int kCameraReturnValid = 1;
 
+// number of frame buffers prepared at init: one being captured, one being
+// converted and two spare for the output side
+const int kCameraFrameBufferCount = 4;
+
 enum AscendCameraErrorID {
   kCameraInitOk = 0,
   kCameraRunOk = 0,
@@ -58,6 +66,8 @@ enum AscendCameraErrorID {
   kCameraSetWorkModeError = -7,
   kCameraGetInfoError = -8,
   kCameraMediaStatusError = -9,
+  kCameraMallocError = -10,
+  kCameraEndOfStream = -11,
 };
 
 struct CameraPara {
@@ -78,6 +88,15 @@ struct CameraPara {
 
   // jpg or h264
   int capture_obj_flag;
+
+  // yuv420sp clip replayed instead of the camera, empty: use the camera
+  std::string replay_file;
+
+  // replay as fast as possible instead of at fps
+  bool replay_fast = false;
+
+  // stop at the end of the clip instead of starting over
+  bool replay_once = false;
 };
 
 struct CameraOutputPara {
@@ -87,6 +106,9 @@ struct CameraOutputPara {
   // frame timeStamp
   time_t timestamp;
 
+  // monotonic capture time in nanosecond
+  int64_t capture_time_ns;
+
   // output buffer
   std::shared_ptr<char> data;
 
@@ -119,10 +141,23 @@ class Camera {
    * @brief get one frame data from camera
    * @param [out] output_para *pOutputPara: used for storage frame data.
    * @return kCameraRunOk: success to get frame data;
-   *         kCameraGetInfoError: failed to get frame data.
+   *         kCameraGetInfoError: failed to get frame data;
+   *         kCameraEndOfStream: the replay file is over.
    */
   int CaptureCameraInfo(CameraOutputPara *output_para);
 
+  /**
+   * @brief get one frame data from camera into a buffer of the caller
+   * @param [out] output_para *pOutputPara: used for storage frame data,
+   *              output_para->data refers to data.
+   * @param [in] std::shared_ptr<char> data: buffer of at least one frame
+   * @return kCameraRunOk: success to get frame data;
+   *         kCameraGetInfoError: failed to get frame data;
+   *         kCameraEndOfStream: the replay file is over.
+   */
+  int CaptureCameraInfo(CameraOutputPara *output_para,
+                        const std::shared_ptr<char> &data);
+
   /**
    * @brief get a error message according to error code.
    * @param [in] int code: error code.
@@ -141,7 +176,24 @@ class Camera {
    */
   int GetUserTimeout() const;
 
+  /**
+   * @brief close the camera, or the clip when replaying
+   */
+  void ReleaseCamera();
+
  private:
+  /**
+   * @brief open the clip which replaces the camera
+   * @return kCameraInitOk: success; kCameraOpenError: failed
+   */
+  int InitVirtualCamera();
+
+  /**
+   * @brief open and set up the MIPI camera
+   * @return enum AscendCameraErrorID
+   */
+  int InitMipiCamera();
+
   // frame id.
   int frame_id_;
 
@@ -150,6 +202,12 @@ class Camera {
 
   // the attributes date of camera
   CameraPara camera_instance_para_;
+
+  // recycled buffers of captured frames
+  std::shared_ptr<ascend::utils::FrameBufferPool> frame_pool_;
+
+  // clip replay source, nullptr when the camera is used
+  std::shared_ptr<ascend::utils::VirtualCamera> virtual_camera_;
 };
 }
 }
@@ -35,16 +35,21 @@
 #define ASCENDDK_ASCENDCAMERA_MAIN_PROCESS_H_
 
 #include <pthread.h>
+#include <time.h>
 #include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "securec.h"
 
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "ascenddk/ascend_ezdvpp/frame_buffer_pool.h"
 #include "ascenddk/ascendcamera/camera.h"
 #include "ascenddk/ascendcamera/output_info_process.h"
 #include "ascenddk/ascendcamera/main_process.h"
 #include "ascenddk/ascendcamera/ascend_camera_parameter.h"
-#include "ascenddk/ascendcamera/thread_safe_queue.h"
+#include "ascenddk/ascendcamera/pipeline_stage.h"
 
 namespace ascend {
 namespace ascendcamera {
@@ -65,49 +70,39 @@ enum LoopFlag {
   kNeedLoop,
 };
 
-#define CHECK_MEMCPY_S_RESULT(ret) \
-if(ret != EOK){ \
-  ASC_LOG_ERROR("Failed to copy memory."); \
-  return kMainProcessMultiframeCpyFail; \
-}
+// h264 encodes at most ten frames in one dvpp call
+const int kH264BufferMaxFrame = 10;
 
-//used for thread control flag
-const int kThreadNoStartup = 0;
-const int kThreadStartup = 1;
-const int kThreadStop = 2;
+// h264 batch buffers prepared per camera: one being captured into and one
+// being encoded. The pool grows when the encode queue holds more batches.
+const int kH264BatchBufferCount = 2;
 
-//used for thread status
-const int kThreadInvalidStatus = 0;
-const int kThreadRunStatus = 1;
-const int kThreadErrorStatus = 2;
+// interval of checking the deadline of h264 batches while no frame arrives
+const int kBatchDeadlineCheckMs = 5;
 
-// fps >10 and in video
-const int kStartupThreadThresHold = 10;
+// frames waiting between capture and encode per camera. When encode or output
+// stalls longer, the new frames are dropped instead of slowing down capture,
+// so the latency is at most kEncodeQueueLength / fps.
+const int kEncodeQueueLength = 4;
 
-const int kH264BufferQueueMaxLength = 10;
-
-const int kH264BufferMaxFrame = 10;
+// encoded data waiting between encode and output per camera
+const int kOutputQueueLength = 4;
 
 // maximum size of yuv file
 const int kYuvImageMaxSize = (1920 * 1080 * 3 / 2);
 
-// maximum number of retrying to push queue.
-const int kMaxRetryNum = 20;
-
-// thread need exit
-const int kThreadNeedExit = 1;
-
-const int kThreadNoNeedExit = 0;
-
-// time of waitting push element
-const int kWaitTime = (100 * 1000);
-
 // 1 second = 1000 millsecond
 const int kSecToMillisec = 1000;
 
 // 1 millisecond = 1000000 nanosecond
 const int kMillSecToNanoSec = 1000000;
 
+// 1 microsecond = 1000 nanosecond
+const int kMicroSecToNanoSec = 1000;
+
+// unit of --segment-size, MB
+const unsigned long long kSegmentSizeUnit = 1024 * 1024;
+
 const int kDebugRecordFrameThresHold = 100;
 
 const int kParaCheckError = -1;
@@ -120,9 +115,11 @@ const char kPortIpSeparator = ':';
 
 const int kFirstIndex = 0;
 
+// frames of one h264 dvpp call. Frames are captured straight into a batch
+// buffer, so the frames of a call are adjacent and referenced in place.
 struct H264Buf {
-  // h264 data buffer
-  char *buf;
+  // first frame of the batch, keeps the batch buffer out of the pool
+  std::shared_ptr<char> buf;
 
   // size of one h264 frame
   long single_frame_size;
@@ -130,55 +127,121 @@ struct H264Buf {
   // frame number
   int index;
 
-  // whether data package is last
-  int exit_flag;
+  // capture time of the first frame in nanosecond
+  int64_t capture_time_ns;
 };
 
-struct MultiFrameProc {
-  // thread run flag
-  std::atomic_int open_thread_flag;
+typedef struct MainProcessDebugInfo {
+  // frame number
+  long total_frame;
+  // the maximum length of queue
+  int queue_max_length;
+  // frames dropped because the encode stage is full
+  long drop_frame;
+  // dvpp outputs sent, written by the output thread
+  long output_count;
+  // latency from capture to output in nanosecond, written by the output
+  // thread. A h264 output counts from its first frame.
+  long long sum_latency_ns;
+  long long max_latency_ns;
+} DebugInfo;
+
+// everything belongs to one camera, the h264 encoder of dvpp keeps the state
+// of its stream, so every camera has its own dvpp and output instance
+struct ChannelObject {
+  // camera channel id
+  int channel_id;
+
+  // used for camera
+  Camera *camera;
 
-  // thread safe queue
-  ThreadSafeQueue<H264Buf *> *safe_queue;
+  // dvpp process
+  ascend::utils::DvppProcess *dvpp_process;
 
-  // current frame buffer
+  // output process
+  OutputInfoProcess *output_process;
+
+  // a frame may be dropped when the encode stage is full, only for a live
+  // output to presenter. A file or stdout waits for the encode stage
+  bool is_drop_allowed;
+
+  // frames of h264 being collected by the encode stage
   H264Buf *current_buf;
 
-  // thread id
-  pthread_t thread_id;
+  // h264 batch buffers of batch_frame_num frames, nullptr for jpg
+  std::shared_ptr<ascend::utils::FrameBufferPool> batch_pool;
+
+  // batch buffer being captured into and its next free frame, used by the
+  // capture thread only
+  std::shared_ptr<char> capture_batch;
+  int capture_slot;
+
+  // capture thread of the camera
+  std::thread capture_thread;
+
+  // result of the capture thread
+  int error_code;
+
+  DebugInfo debug_info;
+};
+
+// dvpp output waiting for the output stage, the buffer is released with it
+struct EncodedFrame {
+  // camera the data belongs to
+  ChannelObject *channel;
+
+  // capture time of the (first) frame in nanosecond
+  int64_t capture_time_ns;
+
+  // dvpp output buffer
+  unsigned char *buf;
+
+  // size of dvpp output buffer
+  unsigned int size;
+
+  EncodedFrame()
+      : channel(nullptr), capture_time_ns(0), buf(nullptr), size(0) {
+  }
 
-  // thread status
-  std::atomic_int thread_status;
+  ~EncodedFrame() {
+    delete[] buf;
+  }
+};
+
+// the encode and output stages are shared by all cameras
+struct PipelineProc {
+  // encode stage: capture threads -> dvpp
+  PipelineStage<CameraOutputPara> *encode_stage;
+
+  // output stage: dvpp -> output channels
+  PipelineStage<EncodedFrame> *output_stage;
 
-  // thread ErrorCode
-  std::atomic_int thread_error_code;
+  // maximum number of frames converted in one h264 dvpp call
+  int batch_frame_num;
+
+  // a h264 batch is converted at the latest this long after the capture of
+  // its first frame, even if it is not full
+  int64_t max_latency_ns;
 };
 
 struct ControlObject {
   // used for user's input parameter
   ascend::ascendcamera::AscendCameraParameter *ascend_camera_paramter;
 
-  // used for camera
-  Camera *camera;
-
-  // dvpp process
-  ascend::utils::DvppProcess *dvpp_process;
-
-  // output process
-  OutputInfoProcess *output_process;
+  // one object per camera, in the order of -c
+  std::vector<ChannelObject *> channels;
 
   // whether need loop
   LoopFlag loop_flag;
 
-  struct MultiFrameProc multi_frame_process;
-};
+  struct PipelineProc pipeline;
 
-typedef struct MainProcessDebugInfo {
-  // frame number
-  long total_frame;
-  // the maximum length of queue
-  int queue_max_length;
-} DebugInfo;
+  // set by the first failed capture thread to stop the others
+  std::atomic<bool> stop_flag;
+
+  // start time of capture, shared by all cameras for the timeout
+  struct timespec begin_time;
+};
 
 class MainProcess {
  public:
@@ -208,39 +271,52 @@ class MainProcess {
   // the attributes for mainproecss instance
   struct ControlObject control_object_;
 
-  DebugInfo debug_info_;
-
   /**
-   * @brief ready for creating a thread.
+   * @brief create and start the encode and output stages.
    * @param [in] int width: resolution
    * @param [in] int height: resolution
-   * @return 0:success -1:fail
+   * @return enum MainProcessErrorCode
+   */
+  int CreatePipeline(int width, int height);
+
+  /**
+   * @brief flush and stop the encode and output stages.
    */
-  int CreateThreadInit(int width, int height);
+  void StopPipeline();
 
   /**
    * @brief create a instance for camera.
+   * @param [in] ChannelObject *channel: camera channel
    * @param [in] int width: resolution
    * @param [in] int height: resolution
    * @return MAINPROCESS_OK:success
    */
-  void CameraInstanceInit(int width, int height);
+  void CameraInstanceInit(ChannelObject *channel, int width, int height);
 
   /**
    * @brief create a instance for dvpp.
+   * @param [in] ChannelObject *channel: camera channel
    * @param [in] int width: resolution
    * @param [in] int height: resolution
    * @return MAINPROCESS_OK:success
    */
-  void DvppInstanceInit(int width, int height);
+  void DvppInstanceInit(ChannelObject *channel, int width, int height);
 
   /**
    * @brief create a instance for output process.
+   * @param [in] ChannelObject *channel: camera channel
    * @param [in] int width: resolution
    * @param [in] int height: resolution
    * @return
    */
-  int OutputInstanceInit(int width, int height);
+  int OutputInstanceInit(ChannelObject *channel, int width, int height);
+
+  /**
+   * @brief find the object of a camera channel
+   * @param [in] int channel_id: camera channel id
+   * @return channel object, nullptr: not found
+   */
+  ChannelObject *FindChannel(int channel_id) const;
 
   /**
    * @brief Dvpp process and output the data
@@ -254,13 +330,12 @@ class MainProcess {
                        OutputInfoProcess *output_info_process);
 
   /**
-   * @brief create buffer for multi-frame
-   * @param [in] struct h264Buf **buf: h264 multi-frame buffer.
-   * @param [in] int size: size of h264 multi-frame buffer.
-   * @param [in] int exit_flag: multi-frame buffer whether is last
+   * @brief create the batch buffer pool and the batch of a camera
+   * @param [in] ChannelObject *channel: camera channel
+   * @param [in] int size: size of one frame
    * @return enum MainProcessErrorCode
    */
-  int CreateMultiFrameBuffer(H264Buf **buf, int size, int exit_flag);
+  int CreateMultiFrameBuffer(ChannelObject *channel, int size);
 
   /**
    * @brief release buffer for multi-frame
@@ -270,44 +345,57 @@ class MainProcess {
   static int FreeMultiFrameBuffer(H264Buf *buf);
 
   /**
-   * @brief multi-frame thread
-   * @param [in] void *startup_arg: point to MainProcess instance.
+   * @brief encode stage handler, runs on the encode thread.
+   * @param [in] CameraOutputPara frame: buffer from camera,
+   *             nullptr: end of stream, convert the frames collected
+   * @return enum MainProcessErrorCode or dvpp error code
    */
-  static void *MultiFrameProcThread(void *startup_arg);
+  int EncodeStageProc(const std::shared_ptr<CameraOutputPara> &frame);
 
   /**
-   * @brief create a multi-frame thread
-   * @return -1:fail 0:success
+   * @brief convert the collected frames by dvpp and pass them to output
+   * @param [in] ChannelObject *channel: camera the frames belong to
+   * @return enum MainProcessErrorCode or dvpp error code
    */
-  int CreateMultiFrameThread(void);
+  int EncodeMultiFrame(ChannelObject *channel);
 
   /**
-   * @brief deal with multi-frame.
-   * @param [in] CameraOutputPara *output_para buffer from camera.
+   * @brief convert the h264 batches whose first frame waited max latency,
+   *        runs on the encode thread.
+   * @return enum MainProcessErrorCode or dvpp error code
+   */
+  int FlushExpiredBatches();
+
+  /**
+   * @brief get the next free frame of the batch buffer of a camera, runs on
+   *        the capture thread.
+   * @param [in] ChannelObject *channel: camera channel
+   * @param [out] std::shared_ptr<char> slot: frame memory, shares ownership
+   *              of the batch buffer
    * @return enum MainProcessErrorCode
    */
-  int MultiFrameBufferProc(CameraOutputPara *output_para);
+  int AcquireBatchSlot(ChannelObject *channel, std::shared_ptr<char> &slot);
 
   /**
-   * @brief if timeout,we need to deal with the unprocessed data from camera.
+   * @brief output stage handler, runs on the output thread.
+   * @param [in] EncodedFrame frame: dvpp output, nullptr: end of stream
+   * @return enum OutputErrorCode
    */
-  void MultiFrameBufferTimeoutProc();
+  int OutputStageProc(const std::shared_ptr<EncodedFrame> &frame);
 
   /**
    * @brief deal with a frame data from camera.
+   * @param [in] ChannelObject *channel: camera channel
    * @return
    */
-  int DoOnce();
+  int DoOnce(ChannelObject *channel);
 
   /**
-   * @brief deal witch multi-frame to dvpp and output process
-   * @param [in] struct H264Buf *h264_buf: h264 multi-frame buffer.
-   * @param [in] ,struct ControlObject *control_object:
-   *               control process instance.
-   * @return enum MainProcessErrorCode
+   * @brief capture thread of a camera, runs until timeout, error or stop
+   * @param [in] ChannelObject *channel: camera channel, the result is saved
+   *             in channel->error_code
    */
-  static int DealMultiFrame(H264Buf *h264_buf,
-                            struct ControlObject *control_object);
+  void CaptureProc(ChannelObject *channel);
 
   /**
    * @brief process before exiting
@@ -315,11 +403,6 @@ class MainProcess {
    */
   void ExitProcess(int ret);
 
-  /**
-   * @brief get size of queue element
-   * @return queue size
-   */
-  int GetQueueSize();
 };
 }
 }
@@ -35,15 +35,17 @@
 #define ASCENDDK_ASCENDCAMERA_OUTPUT_INFO_PROCESS_H_
 
 #include <stdio.h>
+#include <memory>
 #include <string>
 
 #include "ascenddk/presenter/agent/presenter_channel.h"
+#include "ascenddk/ascendcamera/segment_writer.h"
+#include "ascenddk/ascendcamera/stdout_writer.h"
 
 namespace ascend {
 namespace ascendcamera {
 
 const unsigned long long kMinFreeDiskSpace = 100 * 1024 * 1024;
-const int kSystemCallReturnError = -1;
 const int kMaxOutputRetryNum = 30;
 
 // output mode : 1. save file to local; 2. send data to stdout;
@@ -63,6 +65,7 @@ enum OutputErrorCode {
   kOutputLocalFreeDiskNotEnough = -4,
   kOutputLocalFreeDiskCheckFail = -5,
   kOutputLocalFileNoExist = -6,
+  kOutputMallocFail = -7,
 };
 
 struct OutputInfoPara {
@@ -71,6 +74,9 @@ struct OutputInfoPara {
   int width;  // resolution width
   int height;  // resolution height
   ascend::presenter::OpenChannelParam presenter_para;  // presenter data
+  unsigned long long segment_size = 0;  // local file segment size, 0: no limit
+  int segment_duration = 0;  // local file segment time(ms), 0: no limit
+  bool direct_io = false;  // write local file with O_DIRECT
 };
 
 /*
@@ -102,6 +108,17 @@ class OutputInfoProcess {
    */
   int SendToChannel(unsigned char *buf, int size);
 
+  /**
+   * @brief data send to channel, the buffer may be used after the call
+   * @param [in] unsigned char *buf: data buffer
+   * @param [in] int size  : size of data buffer
+   * @param [in] holder: keeps buf alive and unchanged until the channel
+   *             releases it, so stdout can splice buf into a pipe
+   * @return  enum OutputErrorCode
+   */
+  int SendToChannel(unsigned char *buf, int size,
+                    const std::shared_ptr<void> &holder);
+
   /**
    * @brief close channel
    * @return  0
@@ -130,6 +147,12 @@ class OutputInfoProcess {
    */
   int OpenLocalFile();
 
+  /**
+   * @brief open stdout
+   * @return  enum OutputErrorCode.
+   */
+  int OpenStdout();
+
   /**
    * @brief open chennel of presenter
    * @return  enum PresenterErrorCode
@@ -137,7 +160,7 @@ class OutputInfoProcess {
   int OpenPresenterChannel();
 
   /**
-   * @brief data save to local file
+   * @brief data save to local file, a h264 buffer is indexed frame by frame
    * @param [in] unsigned char *buf: data buffer
    * @param [in] int size  : size of data buffer
    * @return  enum OutputErrorCode
@@ -161,16 +184,21 @@ class OutputInfoProcess {
   int OutputToStdout(unsigned char *buf, int size);
 
   /**
-   * @brief check whether the free disk is enough
-   * @return  enum OutputErrorCode
+   * @brief check whether the data can be decoded alone
+   * @param [in] unsigned char *buf: data buffer
+   * @param [in] int size  : size of data buffer
+   * @return  true: jpg image, or h264 data with IDR or SPS
    */
-  int FreeDiskIsEnough() const;
+  bool IsKeyFrame(const unsigned char *buf, int size) const;
 
   // the attributes of output instance
   OutputInfoPara output_para_;
 
-  // local file id
-  FILE *file_desc_ = nullptr;
+  // local file writer
+  SegmentWriter *segment_writer_ = nullptr;
+
+  // stdout writer
+  StdoutWriter *stdout_writer_ = nullptr;
 
   // presenter channel
   ascend::presenter::Channel *presenter_channel_ = nullptr;
@@ -0,0 +1,199 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCENDCAMERA_PIPELINE_STAGE_H_
+#define ASCENDDK_ASCENDCAMERA_PIPELINE_STAGE_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "ascenddk/ascend_utils/thread_safe_queue.h"
+
+namespace ascend {
+namespace ascendcamera {
+
+// stage handler return value: the task is done
+const int kPipelineStageOk = 0;
+
+/*
+ * One stage of a processing pipeline: a worker thread that pops tasks from
+ * its own bounded input queue and hands them to the stage handler. Stages are
+ * chained by calling Submit() of the next stage inside the handler.
+ * A nullptr task marks the end of the stream: the handler is called with it
+ * once, so it can flush what it has buffered, and the thread exits.
+ * After the handler fails, the stage keeps draining its queue without
+ * handling tasks, so producers never block on a dead stage.
+ */
+template<typename T>
+class PipelineStage {
+ public:
+  // returns kPipelineStageOk or an error code
+  typedef std::function<int(const std::shared_ptr<T> &task)> Handler;
+
+  // returns kPipelineStageOk or an error code
+  typedef std::function<int()> TickHandler;
+
+  /**
+   * @brief class constructor
+   * @param [in] queue_length: capacity of the input queue
+   * @param [in] handler: called on the stage thread for every task
+   */
+  PipelineStage(int queue_length, Handler handler)
+      : queue_(queue_length),
+        handler_(handler),
+        tick_interval_ms_(0),
+        error_code_(kPipelineStageOk),
+        is_started_(false) {
+  }
+
+  // class destructor
+  ~PipelineStage() {
+    Stop();
+  }
+
+  PipelineStage(const PipelineStage&) = delete;
+  PipelineStage& operator=(const PipelineStage&) = delete;
+
+  /**
+   * @brief call a handler on the stage thread whenever no task arrives for
+   *        interval_ms, e.g. to flush buffered tasks on a deadline.
+   *        Must be called before Start().
+   * @param [in] interval_ms: idle time before the handler is called, > 0
+   * @param [in] handler: called on the stage thread
+   */
+  void SetTickHandler(int interval_ms, TickHandler handler) {
+    tick_interval_ms_ = interval_ms;
+    tick_handler_ = handler;
+  }
+
+  /**
+   * @brief start the stage thread
+   */
+  void Start() {
+    if (!is_started_) {
+      is_started_ = true;
+      thread_ = std::thread(&PipelineStage::Run, this);
+    }
+  }
+
+  /**
+   * @brief send end of stream, wait until every queued task is handled
+   */
+  void Stop() {
+    if (is_started_) {
+      queue_.Push(std::shared_ptr<T>());
+      thread_.join();
+      is_started_ = false;
+    }
+  }
+
+  /**
+   * @brief queue a task without blocking
+   * @param [in] task: task, must not be nullptr
+   * @return true: queued; false: the queue is full
+   */
+  bool TrySubmit(const std::shared_ptr<T> &task) {
+    return queue_.TryPush(task);
+  }
+
+  /**
+   * @brief queue a task, block while the queue is full
+   * @param [in] task: task, must not be nullptr
+   */
+  void Submit(const std::shared_ptr<T> &task) {
+    queue_.Push(task);
+  }
+
+  /**
+   * @brief get the first error returned by the handler
+   * @return kPipelineStageOk or the error code
+   */
+  int GetErrorCode() const {
+    return error_code_;
+  }
+
+  /**
+   * @brief get number of queued tasks
+   * @return queue size
+   */
+  int GetQueueSize() const {
+    return queue_.Size();
+  }
+
+ private:
+  /**
+   * @brief stage thread
+   */
+  void Run() {
+    bool is_end = false;
+    while (!is_end) {
+      // no task within the tick interval: call the tick handler instead
+      std::shared_ptr<T> task;
+      bool is_tick = false;
+      if (tick_handler_ == nullptr) {
+        queue_.WaitAndPop(task);
+      } else {
+        is_tick = !queue_.WaitAndPop(task, tick_interval_ms_);
+      }
+      is_end = !is_tick && (task == nullptr);
+
+      if (error_code_ != kPipelineStageOk) {
+        continue;
+      }
+
+      int ret = is_tick ? tick_handler_() : handler_(task);
+      if (ret != kPipelineStageOk) {
+        error_code_ = ret;
+      }
+    }
+  }
+
+  ascend::utils::ThreadSafeQueue<std::shared_ptr<T>> queue_;
+
+  Handler handler_;
+
+  int tick_interval_ms_;
+
+  TickHandler tick_handler_;
+
+  std::atomic_int error_code_;
+
+  bool is_started_;
+
+  std::thread thread_;
+};
+}
+}
+#endif /* ASCENDDK_ASCENDCAMERA_PIPELINE_STAGE_H_ */
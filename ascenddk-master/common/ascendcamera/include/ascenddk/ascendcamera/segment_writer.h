@@ -0,0 +1,228 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCENDCAMERA_SEGMENT_WRITER_H_
+#define ASCENDDK_ASCENDCAMERA_SEGMENT_WRITER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace ascend {
+namespace ascendcamera {
+
+// write buffer and O_DIRECT alignment
+const int kSegmentWriteAlign = 4096;
+
+// default size of the write buffer, 4M
+const int kSegmentWriteBufferSize = 4 * 1024 * 1024;
+
+// default interval of free disk check(unit: millisecond)
+const int kSegmentDiskCheckInterval = 1000;
+
+// suffix of the index file of a segment
+const char * const kSegmentIndexSuffix = ".idx";
+
+// "ASIX" in little endian, first word of an index file
+const uint32_t kSegmentIndexMagic = 0x58495341;
+
+const uint32_t kSegmentIndexVersion = 1;
+
+// flag of a frame which can be decoded without former frames
+const uint32_t kSegmentKeyFrame = 0x1;
+
+// the first 16 bytes of an index file
+struct SegmentIndexHeader {
+  uint32_t magic;  // kSegmentIndexMagic
+  uint32_t version;  // kSegmentIndexVersion
+  uint32_t record_size;  // sizeof(SegmentIndexRecord)
+  uint32_t reserved;
+};
+
+// one index record for every frame written to the segment
+struct SegmentIndexRecord {
+  uint64_t offset;  // offset of the frame in the segment file
+  uint32_t size;  // size of the frame
+  uint32_t flags;  // kSegmentKeyFrame or 0
+  int64_t timestamp;  // wall clock time of writing(unit: microsecond)
+};
+
+struct SegmentWriterPara {
+  // path of the first segment, the following ones are named
+  // <name>_0001<ext>, <name>_0002<ext> ...
+  std::string path;
+
+  // start a new segment when it is larger than this(unit: byte), 0: no limit
+  unsigned long long max_segment_size = 0;
+
+  // start a new segment after this time(unit: millisecond), 0: no limit
+  int max_segment_duration = 0;
+
+  // size of the write buffer, multiple of kSegmentWriteAlign
+  int write_buffer_size = kSegmentWriteBufferSize;
+
+  // write the segment file with O_DIRECT, bypassing the page cache
+  bool direct_io = false;
+
+  // the minimum free disk space(unit: byte)
+  unsigned long long min_free_disk = 0;
+
+  // interval of free disk check(unit: millisecond)
+  int disk_check_interval = kSegmentDiskCheckInterval;
+};
+
+/*
+ * Local recording writer. Frames are collected in a large aligned buffer and
+ * written with one write() per buffer, the free disk space is checked on a
+ * timer instead of per frame. The recording is split into segments by size or
+ * duration, a new segment always starts at a key frame. Each segment has an
+ * index file(<segment>.idx) with a SegmentIndexRecord per frame, so a
+ * recording can be seeked and trimmed without parsing the stream.
+ * The index only refers to data which is already written to the segment.
+ */
+class SegmentWriter {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] SegmentWriterPara para: writer parameter
+   */
+  SegmentWriter(const SegmentWriterPara &para);
+
+  // class destructor
+  virtual ~SegmentWriter();
+
+  /**
+   * @brief allocate the write buffer and open the first segment
+   * @return enum OutputErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief append a frame to the recording
+   * @param [in] buf: frame data
+   * @param [in] size: size of frame data
+   * @param [in] is_key_frame: the frame can be decoded alone
+   * @return enum OutputErrorCode
+   */
+  int Write(const unsigned char *buf, int size, bool is_key_frame);
+
+  /**
+   * @brief flush the buffer and close the current segment
+   * @return enum OutputErrorCode
+   */
+  int Close();
+
+  /**
+   * @brief get number of segments opened so far
+   * @return segment number
+   */
+  int GetSegmentCount() const;
+
+ private:
+  /**
+   * @brief get path of a segment
+   * @param [in] sequence: segment sequence number, starts from 0
+   * @return segment path
+   */
+  std::string GetSegmentPath(int sequence) const;
+
+  /**
+   * @brief open the next segment and its index file
+   * @return enum OutputErrorCode
+   */
+  int OpenSegment();
+
+  /**
+   * @brief flush all data and index of the current segment and close it
+   * @return enum OutputErrorCode
+   */
+  int CloseSegment();
+
+  /**
+   * @brief check whether the frame should start a new segment
+   * @param [in] size: size of frame data
+   * @param [in] is_key_frame: the frame can be decoded alone
+   * @return true: start a new segment
+   */
+  bool NeedNewSegment(int size, bool is_key_frame) const;
+
+  /**
+   * @brief write the buffer to the segment and the finished index records to
+   *        the index file
+   * @param [in] is_last: the last flush of the segment, the buffer need not
+   *        be full
+   * @return enum OutputErrorCode
+   */
+  int FlushBuffer(bool is_last);
+
+  /**
+   * @brief check free disk space when the check interval is over
+   * @return enum OutputErrorCode
+   */
+  int CheckFreeDisk();
+
+  // the attributes of the writer
+  SegmentWriterPara para_;
+
+  // aligned write buffer
+  char *buffer_ = nullptr;
+
+  // used size of write buffer
+  int buffer_used_ = 0;
+
+  // file descriptor of current segment and its index
+  int data_fd_ = -1;
+  int index_fd_ = -1;
+
+  // sequence number of current segment, -1: no segment opened
+  int segment_sequence_ = -1;
+
+  // size of current segment, including the data in buffer
+  unsigned long long segment_size_ = 0;
+
+  // size of current segment already written to the file
+  unsigned long long written_size_ = 0;
+
+  // open time of current segment(unit: millisecond)
+  long long segment_start_time_ = 0;
+
+  // last time of free disk check(unit: millisecond)
+  long long disk_check_time_ = 0;
+
+  // index records of frames which are not written to the file completely
+  std::vector<SegmentIndexRecord> pending_index_;
+};
+}
+}
+#endif /* ASCENDDK_ASCENDCAMERA_SEGMENT_WRITER_H_ */
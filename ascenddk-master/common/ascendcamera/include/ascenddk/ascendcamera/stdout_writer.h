@@ -0,0 +1,154 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCENDCAMERA_STDOUT_WRITER_H_
+#define ASCENDDK_ASCENDCAMERA_STDOUT_WRITER_H_
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace ascend {
+namespace ascendcamera {
+
+// capacity requested for a pipe on stdout, 1M(the default pipe-max-size)
+const int kStdoutPipeSize = 1024 * 1024;
+
+// time Close() waits for the reader to drain the pipe before it warns that
+// the reader is slow(unit: ms)
+const int kStdoutDrainTimeout = 1000;
+
+struct StdoutWriterPara {
+  // file descriptor to write to
+  int fd = STDOUT_FILENO;
+
+  // capacity requested when fd is a pipe(unit: byte), 0: keep the capacity
+  int pipe_size = kStdoutPipeSize;
+
+  // splice the data into a pipe instead of copying it
+  bool enable_vmsplice = true;
+};
+
+/*
+ * Writer of the stdout stream, without the stdio buffer. When stdout is a
+ * pipe, the pages of a frame are handed to the pipe by vmsplice() instead of
+ * being copied, so the reader gets them straight from the dvpp output. The
+ * pipe refers to the memory until the reader has consumed it, so the caller
+ * passes a holder which keeps the frame alive and unchanged; it is released
+ * as soon as the unread bytes of the pipe(FIONREAD) are behind the frame.
+ * Otherwise, or without a holder, every frame is written with one write().
+ * A reader which tee()s the pipe may keep referring to released memory, it
+ * has to read() or copy the data.
+ */
+class StdoutWriter {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] StdoutWriterPara para: writer parameter
+   */
+  StdoutWriter(const StdoutWriterPara &para);
+
+  // class destructor
+  virtual ~StdoutWriter();
+
+  /**
+   * @brief check whether fd is a pipe and set its capacity
+   * @return enum OutputErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief write a frame
+   * @param [in] buf: frame data
+   * @param [in] size: size of frame data
+   * @param [in] holder: keeps buf alive and unchanged until released by the
+   *             writer, nullptr: buf is copied
+   * @return enum OutputErrorCode
+   */
+  int Write(const unsigned char *buf, int size,
+            const std::shared_ptr<void> &holder);
+
+  /**
+   * @brief wait until the reader has drained the pipe or closed it, and
+   *        release the frames still held. The pipe references the spliced
+   *        frames, so they are never released before
+   * @return enum OutputErrorCode
+   */
+  int Close();
+
+  /**
+   * @brief check whether frames are spliced into a pipe
+   * @return true: vmsplice; false: write
+   */
+  bool IsSpliced() const;
+
+ private:
+  /**
+   * @brief splice all data into the pipe, retry on interrupt and partial
+   *        splice
+   * @param [in] buf: frame data
+   * @param [in] size: size of frame data
+   * @param [out] spliced: bytes sent into the pipe, also on failure
+   * @return enum OutputErrorCode
+   */
+  int SpliceAll(const unsigned char *buf, int size, int &spliced);
+
+  /**
+   * @brief release the frames the reader has consumed
+   */
+  void ReleaseConsumed();
+
+  /**
+   * @brief check whether every reader of the pipe has closed it
+   * @return true: no reader is left
+   */
+  bool IsReaderClosed() const;
+
+  // the attributes of the writer
+  StdoutWriterPara para_;
+
+  // frames are spliced into a pipe
+  bool is_spliced_ = false;
+
+  // bytes sent to fd so far
+  uint64_t total_written_ = 0;
+
+  // frames still referred to by the pipe: end offset in the stream, holder
+  std::deque<std::pair<uint64_t, std::shared_ptr<void>>> held_frames_;
+};
+}
+}
+#endif /* ASCENDDK_ASCENDCAMERA_STDOUT_WRITER_H_ */
@@ -35,6 +35,7 @@
 
 #include <regex>
 #include <iostream>
+#include <set>
 
 #include <getopt.h>
 #include <stdlib.h>
@@ -60,6 +61,16 @@ const int kParamHasValue = 1;
 // slash string length
 const int kSlashStrLength = 1;
 
+// separator of camera channels, e.g. -c 0,1
+const char kChannelSeparator = ',';
+
+// regex for verify camera channels
+const char *kRegexCameraChannels = "[0-9]+(,[0-9]+)*";
+
+// inserted before the extension of output file name when capturing several
+// cameras, e.g. video_c0.h264
+const char *kChannelFileTag = "_c";
+
 // long options for getopt_long function
 const struct option kLongOptions[] = {
     { "width", kParamHasValue, nullptr, 'w' },
@@ -67,6 +78,13 @@ const struct option kLongOptions[] = {
     { "timeout", kParamHasValue, nullptr, 't' },
     { "fps", kParamHasValue, nullptr, 'F' },
     { "overwrite", kParamHasNoValue, nullptr, 'O' },
+    { "segment-size", kParamHasValue, nullptr, 'S' },
+    { "segment-time", kParamHasValue, nullptr, 'T' },
+    { "direct-io", kParamHasNoValue, nullptr, 'D' },
+    { "replay", kParamHasValue, nullptr, 'R' },
+    { "replay-fast", kParamHasNoValue, nullptr, 'P' },
+    { "replay-once", kParamHasNoValue, nullptr, 'Q' },
+    { "max-latency", kParamHasValue, nullptr, 'L' },
     { nullptr, kParamHasNoValue, nullptr, kParamHasNoValue } };
 
 // short options for getopt_long function
@@ -78,11 +96,14 @@ const string kValidShortParams[] = { "-i", "-v", "-s", "-o", "-w", "-h", "-t",
 
 // valid long parameters
 const string kValidLongParams[] = { "--timeout", "--fps", "--width", "--height",
-    "--help", "--overwrite" };
+    "--help", "--overwrite", "--segment-size", "--segment-time",
+    "--direct-io", "--replay", "--replay-fast", "--replay-once",
+    "--max-latency" };
 
 // the parameters who  have value
 const string kHasValueParams[] = { "-s", "-o", "-w", "-h", "-t", "-c",
-    "--timeout", "--fps", "--width", "--height" };
+    "--timeout", "--fps", "--width", "--height", "--segment-size",
+    "--segment-time", "--replay", "--max-latency" };
 
 // used for concatenate logging information
 stringstream log_info_stream("");
@@ -239,10 +260,10 @@ bool AscendCameraParameter::ParseInputParams(int argc, char* const argv[]) {
   while ((opt = getopt_long_only(argc, argv, kShortOptions, kLongOptions,
                                  nullptr)) != kInvalidValue) {
     switch (opt) {
-      case 'c':  // handle parameter -c, camera channel
-        camera_channel_ = ObtainIntParams(string("-c"), string(optarg),
-                                          is_initialize_fail,
-                                          kDefaultCameraChannel);
+      case 'c':  // handle parameter -c, camera channels
+        camera_channel_str_.assign(
+          ObtainStrParams(string("-c"), string(optarg), is_initialize_fail,
+                          ""));
         break;
 
       case 'w':  // handle parameter -w(--width), iamge width
@@ -294,6 +315,48 @@ bool AscendCameraParameter::ParseInputParams(int argc, char* const argv[]) {
                           is_initialize_fail);
         break;
 
+      case 'S':  // handle parameter segment size
+        segment_size_ = ObtainIntParams(string("--segment-size"),
+                                        string(optarg), is_initialize_fail,
+                                        kDefaultSegmentSize);
+        break;
+
+      case 'T':  // handle parameter segment time
+        segment_time_ = ObtainIntParams(string("--segment-time"),
+                                        string(optarg), is_initialize_fail,
+                                        kDefaultSegmentTime);
+        break;
+
+      case 'D':  // handle parameter direct io
+        direct_io_ = true;
+        ObtainValidParams(string("--direct-io"), string(""),
+                          is_initialize_fail);
+        break;
+
+      case 'R':  // handle parameter replay, file replaces the camera
+        replay_file_.assign(
+          ObtainStrParams(string("--replay"), string(optarg),
+                          is_initialize_fail, ""));
+        break;
+
+      case 'P':  // handle parameter replay fast
+        replay_fast_ = true;
+        ObtainValidParams(string("--replay-fast"), string(""),
+                          is_initialize_fail);
+        break;
+
+      case 'Q':  // handle parameter replay once
+        replay_once_ = true;
+        ObtainValidParams(string("--replay-once"), string(""),
+                          is_initialize_fail);
+        break;
+
+      case 'L':  // handle parameter max latency
+        max_latency_ = ObtainIntParams(string("--max-latency"),
+                                       string(optarg), is_initialize_fail,
+                                       kDefaultRecordLatency);
+        break;
+
       default:  // handle parameter can not be recognized or missing value
         if (optind > opt_index_last) {
           is_initialize_fail = true;
@@ -413,11 +476,13 @@ bool AscendCameraParameter::VerifyNumericalParam(
     const string& param_name, const string& param_value,
     bool& is_initialize_fail) const {
   // check current parameter value is integer type
-  if (param_name.compare(string("-c")) == kCompareEqual
-      || param_name.compare(string("-w(--width)")) == kCompareEqual
+  if (param_name.compare(string("-w(--width)")) == kCompareEqual
       || param_name.compare(string("-h(--height)")) == kCompareEqual
       || param_name.compare(string("-t(--timeout)")) == kCompareEqual
-      || param_name.compare(string("--fps")) == kCompareEqual) {
+      || param_name.compare(string("--fps")) == kCompareEqual
+      || param_name.compare(string("--segment-size")) == kCompareEqual
+      || param_name.compare(string("--segment-time")) == kCompareEqual
+      || param_name.compare(string("--max-latency")) == kCompareEqual) {
 
     if (param_value.length() > kNumericValueLength) {
       is_initialize_fail = true;
@@ -603,18 +668,75 @@ void AscendCameraParameter::CheckIgnoreParams() const {
         "[WARNING] The ascendcamera dose not have -o parameter"
         " value or -o parameter value is '-', so ignore:--overwrite.");
   }
+
+  // segment parameters only work when saving a video to a file
+  if ((segment_size_ != kInvalidValue || segment_time_ != kInvalidValue
+      || direct_io_)
+      && (is_image_ || output_file_.empty()
+          || output_file_.compare("-") == kCompareEqual)) {
+    cerr << "[WARNING] The ascendcamera does not save a video to a file,"
+         " so ignore:--segment-size --segment-time --direct-io." << endl;
+    ASC_LOG_WARN(
+        "The ascendcamera does not save a video to a file, so ignore:"
+        "--segment-size --segment-time --direct-io.");
+  }
+
+  // h264 batches are only used when saving a video to a file or stdout
+  if (max_latency_ != kInvalidValue && (is_image_ || output_file_.empty())) {
+    cerr << "[WARNING] The ascendcamera does not output a h264 video,"
+         " so ignore:--max-latency." << endl;
+    ASC_LOG_WARN(
+        "The ascendcamera does not output a h264 video, so ignore:"
+        "--max-latency.");
+  }
+
+  // replay options only work with a replay file
+  if ((replay_fast_ || replay_once_) && replay_file_.empty()) {
+    cerr << "[WARNING] The ascendcamera does not have --replay parameter,"
+         " so ignore:--replay-fast --replay-once." << endl;
+    ASC_LOG_WARN(
+        "The ascendcamera does not have --replay parameter, so ignore:"
+        "--replay-fast --replay-once.");
+  }
 }
 
-bool AscendCameraParameter::VerifyCameraChannel() const {
-  // check camera channel in valid rang
-  if (camera_channel_ >= kDefaultCameraChannel
-      && camera_channel_ <= kMaxCameraChannel) {
+bool AscendCameraParameter::VerifyCameraChannel() {
+  camera_channels_.clear();
+
+  // use default camera channel
+  if (camera_channel_str_.empty()) {
+    camera_channels_.push_back(kDefaultCameraChannel);
+    return true;
+  }
+
+  bool verify_pass = regex_match(camera_channel_str_,
+                                 regex(kRegexCameraChannels))
+      && (camera_channel_str_.length() <= kNumericValueLength);
+
+  // split camera channels, every channel can be input once
+  set<int> channel_set;
+  stringstream channel_stream(camera_channel_str_);
+  string channel_str = "";
+  while (verify_pass && getline(channel_stream, channel_str,
+                                kChannelSeparator)) {
+    int channel = atoi(channel_str.c_str());
+    if (channel < kDefaultCameraChannel || channel > kMaxCameraChannel
+        || !channel_set.insert(channel).second) {
+      verify_pass = false;
+      break;
+    }
+
+    camera_channels_.push_back(channel);
+  }
+
+  if (verify_pass) {
     return true;
   }
 
   log_info_stream.str("");
   log_info_stream << "The ascendcamera parameter -c has invalid value:"
-                  << camera_channel_ << ", value range:0 1.";
+                  << camera_channel_str_ << ", value range:0 1, several "
+                  << "different channels are separated by ','.";
   string cerr_info = log_info_stream.str();
 
   cerr << "[ERROR] " << cerr_info << endl;
@@ -666,6 +788,59 @@ bool AscendCameraParameter::VerifyFpsValue() {
   return true;
 }
 
+bool AscendCameraParameter::VerifySegmentTime() const {
+  // check segment time in valid range
+  if (segment_time_ == kInvalidValue || segment_time_ <= kMaxSegmentTime) {
+    return true;
+  }
+
+  log_info_stream.str("");
+  log_info_stream << "The ascendcamera parameter --segment-time has invalid "
+                  << "value:" << segment_time_ << ", value range:0~"
+                  << kMaxSegmentTime << ".";
+  string cerr_info = log_info_stream.str();
+
+  cerr << "[ERROR] " << cerr_info << endl;
+  ASC_LOG_ERROR("%s", cerr_info.c_str());
+
+  return false;
+}
+
+bool AscendCameraParameter::VerifyMaxLatency() const {
+  // check max latency in valid range
+  if (max_latency_ == kInvalidValue || max_latency_ <= kMaxLatency) {
+    return true;
+  }
+
+  log_info_stream.str("");
+  log_info_stream << "The ascendcamera parameter --max-latency has invalid "
+                  << "value:" << max_latency_ << ", value range:0~"
+                  << kMaxLatency << ".";
+  string cerr_info = log_info_stream.str();
+
+  cerr << "[ERROR] " << cerr_info << endl;
+  ASC_LOG_ERROR("%s", cerr_info.c_str());
+
+  return false;
+}
+
+bool AscendCameraParameter::VerifyReplayFile() const {
+  // check the replay file can be read
+  if (replay_file_.empty()
+      || access(replay_file_.c_str(), R_OK) != kHasNoAccessPermission) {
+    return true;
+  }
+
+  string cerr_info = "The ascendcamera parameter --replay value:";
+  cerr_info += replay_file_;
+  cerr_info += " is not a readable file.";
+
+  cerr << "[ERROR] " << cerr_info << endl;
+  ASC_LOG_ERROR("%s", cerr_info.c_str());
+
+  return false;
+}
+
 bool AscendCameraParameter::Verify() {
   bool verify_pass = true;
 
@@ -699,6 +874,21 @@ bool AscendCameraParameter::Verify() {
     verify_pass = false;
   }
 
+  // verify segment time
+  if (!VerifySegmentTime()) {
+    verify_pass = false;
+  }
+
+  // verify max latency
+  if (!VerifyMaxLatency()) {
+    verify_pass = false;
+  }
+
+  // verify replay file
+  if (!VerifyReplayFile()) {
+    verify_pass = false;
+  }
+
   // check has need ignored parameters
   CheckIgnoreParams();
 
@@ -739,27 +929,38 @@ bool AscendCameraParameter::VerifyOutputType() const {
     return false;
   }
 
+  // the streams of several cameras can not be mixed in stdout
+  if ((camera_channels_.size() > 1)
+      && (output_file_.compare("-") == kCompareEqual)) {
+    cerr << "[ERROR] The ascendcamera parameter -o - only supports one "
+         "camera channel." << endl;
+    ASC_LOG_ERROR(
+        "The ascendcamera parameter -o - only supports one camera channel.");
+
+    return false;
+  }
+
   return true;
 }
 
-bool AscendCameraParameter::HandleExistFile() const {
+bool AscendCameraParameter::HandleExistFile(const string &file) const {
   // check file is exist or not
-  if (access(output_file_.c_str(), F_OK) == kHasNoAccessPermission) {
+  if (access(file.c_str(), F_OK) == kHasNoAccessPermission) {
     return true;
   }
 
   // check the file(outputFile) is occupied by another program
-  if (ParameterUtils::CheckFileOccupied(output_file_)) {
+  if (ParameterUtils::CheckFileOccupied(file)) {
     return false;
   }
 
   // overwrite exist file without user interaction
   if (overwrite_) {
-    return ParameterUtils::OverwriteExistFile(output_file_);
+    return ParameterUtils::OverwriteExistFile(file);
   }
 
   string cerr_info = "The file: ";
-  cerr_info += output_file_;
+  cerr_info += file;
   cerr_info += " is already exist, please save to another file or"
       " use parameter --overwrite to overwrite it.";
   cerr << "[ERROR] " << cerr_info << endl;
@@ -849,7 +1050,14 @@ bool AscendCameraParameter::VerifyOutputFileValue(const bool verify_pass) {
     return false;
   }
 
-  return HandleExistFile();
+  // every camera channel has its own output file
+  for (int channel : camera_channels_) {
+    if (!HandleExistFile(GetChannelOutputFile(channel))) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 bool AscendCameraParameter::VerifyWidthHeightValue() const {
@@ -909,6 +1117,10 @@ void AscendCameraParameter::DisplayHelpInfo() const {
   string helpInfo = "usage: ascendcamera [options]\n\noptions:\n"
       "  --help\t:display this information\n"
       "  -c\t\t:camera channel, value range:0 1, default value:0\n"
+      "    \t\t several channels are separated by ',', e.g. -c 0,1, "
+      "then every channel\n"
+      "    \t\t outputs to its own file(file_c0.h264, file_c1.h264) or "
+      "presenter channel(channelname/0, channelname/1)\n"
       "  -i\t\t:obtain jpg format image\n"
       "  -v\t\t:obtain h264 format video, parameters -i and -v must "
       "be set only one of them\n"
@@ -930,7 +1142,23 @@ void AscendCameraParameter::DisplayHelpInfo() const {
       " an exist file \n"
       "  -t, --timeout\t:run time(unit: second), default value:"
       "0(run until the process exits), not support decimals\n"
-      "  --fps\t\t:video frame rate, value range:1~20, default value:10"
+      "  --fps\t\t:video frame rate, value range:1~20, default value:10\n"
+      "  --segment-size:split the video file when it is larger than this"
+      "(unit: MB), default value:0(no limit)\n"
+      "  --segment-time:split the video file after this time(unit: second), "
+      "value range:0~86400, default value:0(no limit)\n"
+      "    \t\t the following files are named file_0001.h264, "
+      "file_0002.h264..., every file has a frame index file(.idx)\n"
+      "  --direct-io\t:write the video file without page cache\n"
+      "  --replay\t:replay a raw yuv420sp(nv12) file of -w x -h frames "
+      "instead of the camera, at --fps\n"
+      "  --replay-fast\t:replay as fast as possible\n"
+      "  --replay-once\t:stop at the end of the replay file, default: "
+      "start over\n"
+      "  --max-latency\t:maximum time a frame waits to be encoded with the "
+      "following frames(unit: millisecond), value range:0~5000,\n"
+      "    \t\t default value:1000 for a file, 100 for stdout, 0 encodes every "
+      "frame alone"
       "\n\nexamples:"
       "\n\t(1)ascendcamera -i -c 0 -w 1920 -h 1080 -o image.jpg"
       "\n\tGet image from camera channel 0, image width equal to 1920 and"
@@ -1010,8 +1238,74 @@ const int AscendCameraParameter::GetFps() const {
   return fps_;
 }
 
-const int AscendCameraParameter::GetCameraChannel() const {
-  return camera_channel_;
+const vector<int> &AscendCameraParameter::GetCameraChannels() const {
+  return camera_channels_;
+}
+
+const string AscendCameraParameter::GetChannelOutputFile(int channel) const {
+  // one camera, or output to stdout
+  if (camera_channels_.size() <= 1 || output_file_.empty()
+      || output_file_.compare("-") == kCompareEqual) {
+    return output_file_;
+  }
+
+  // insert channel tag before the extension(.jpg or .h264)
+  string channel_tag = kChannelFileTag + to_string(channel);
+  string::size_type index_last_dot = output_file_.find_last_of('.');
+  string::size_type index_last_slash = output_file_.find_last_of('/');
+  if (index_last_dot == string::npos
+      || (index_last_slash != string::npos
+          && index_last_dot < index_last_slash)) {
+    return output_file_ + channel_tag;
+  }
+
+  return output_file_.substr(kIndexFirst, index_last_dot) + channel_tag
+      + output_file_.substr(index_last_dot);
+}
+
+const int AscendCameraParameter::GetSegmentSize() const {
+  if (segment_size_ == kInvalidValue) {
+    return kDefaultSegmentSize;
+  }
+
+  return segment_size_;
+}
+
+const int AscendCameraParameter::GetSegmentTime() const {
+  if (segment_time_ == kInvalidValue) {
+    return kDefaultSegmentTime;
+  }
+
+  return segment_time_;
+}
+
+const bool AscendCameraParameter::IsDirectIo() const {
+  return direct_io_;
+}
+
+const string &AscendCameraParameter::GetReplayFile() const {
+  return replay_file_;
+}
+
+const bool AscendCameraParameter::IsReplayFast() const {
+  return replay_fast_;
+}
+
+const bool AscendCameraParameter::IsReplayOnce() const {
+  return replay_once_;
+}
+
+const int AscendCameraParameter::GetMaxLatency() const {
+  if (max_latency_ != kInvalidValue) {
+    return max_latency_;
+  }
+
+  // streaming wants low latency, recording wants fewer dvpp calls
+  if (output_file_.compare("-") == kCompareEqual) {
+    return kDefaultStreamLatency;
+  }
+
+  return kDefaultRecordLatency;
 }
 
 }
@@ -58,9 +58,66 @@ Camera::Camera(const CameraPara& camera_para) {
 Camera::~Camera() {
 }
 
+int Camera::InitVirtualCamera() {
+  ascend::utils::VirtualCameraPara virtual_para;
+  virtual_para.path = camera_instance_para_.replay_file;
+  virtual_para.resolution.width = camera_instance_para_.resolution.width;
+  virtual_para.resolution.height = camera_instance_para_.resolution.height;
+  virtual_para.fps =
+      camera_instance_para_.replay_fast ? 0 : camera_instance_para_.fps;
+  virtual_para.loop = !camera_instance_para_.replay_once;
+
+  virtual_camera_ = make_shared<ascend::utils::VirtualCamera>(virtual_para);
+  int ret = virtual_camera_->Init();
+  if (ret != ascend::utils::kDvppOperationOk) {
+    ASC_LOG_ERROR("Camera[%d] open replay file %s failed, ret = %d.",
+                  camera_instance_para_.channel_id,
+                  camera_instance_para_.replay_file.c_str(), ret);
+    virtual_camera_ = nullptr;
+    return kCameraOpenError;
+  }
+
+  ASC_LOG_INFO("Camera[%d] replay %s, %d frames.",
+               camera_instance_para_.channel_id,
+               camera_instance_para_.replay_file.c_str(),
+               virtual_camera_->GetFrameCount());
+  return kCameraInitOk;
+}
+
 int Camera::InitCamera() {
   int ret = kCameraInitOk;
 
+  // replay a clip instead of the camera
+  if (!camera_instance_para_.replay_file.empty()) {
+    ret = InitVirtualCamera();
+    if (ret != kCameraInitOk) {
+      return ret;
+    }
+  } else {
+    ret = InitMipiCamera();
+    if (ret != kCameraInitOk) {
+      return ret;
+    }
+  }
+
+  // frame buffers are allocated and prefaulted once, then recycled
+  ascend::utils::FrameBufferPoolPara pool_para;
+  pool_para.buffer_size = image_size_;
+  pool_para.buffer_count = kCameraFrameBufferCount;
+  frame_pool_ = make_shared<ascend::utils::FrameBufferPool>(pool_para);
+  ret = frame_pool_->Init();
+  if (ret != ascend::utils::kDvppOperationOk) {
+    ASC_LOG_ERROR("Camera[%d] init frame buffer pool failed, ret = %d.",
+                  camera_instance_para_.channel_id, ret);
+    return kCameraMallocError;
+  }
+
+  return kCameraInitOk;
+}
+
+int Camera::InitMipiCamera() {
+  int ret = kCameraInitOk;
+
   // init driver of camera
   ret = MediaLibInit();
   if (ret == LIBMEDIA_STATUS_FAILED) {
@@ -128,24 +185,53 @@ int Camera::InitCamera() {
 }
 
 int Camera::CaptureCameraInfo(CameraOutputPara *output_para) {
+  // the buffer goes back to the pool when the last user releases it
+  shared_ptr<char> data = frame_pool_->Acquire();
+  if (data == nullptr) {
+    ASC_LOG_ERROR("Camera[%d] get frame buffer failed.",
+                  camera_instance_para_.channel_id);
+    return kCameraMallocError;
+  }
+
+  return CaptureCameraInfo(output_para, data);
+}
+
+int Camera::CaptureCameraInfo(CameraOutputPara *output_para,
+                              const shared_ptr<char> &data) {
   int ret = kCameraReturnValid;
   int result = kCameraRunOk;
   int size = image_size_;
-  shared_ptr<char> data(new char[size], default_delete<char[]>());
 
-  // read info from camera
-  ret = ReadFrameFromCamera(camera_instance_para_.channel_id,
-                            (void *) (data.get()), &size);
+  // read info from camera, or the next frame of the clip
+  if (virtual_camera_ != nullptr) {
+    ret = virtual_camera_->ReadFrame(data.get(), size);
+    if (ret == ascend::utils::kDvppErrorEndOfStream) {
+      ASC_LOG_INFO("Camera[%d] replay file is over.",
+                   camera_instance_para_.channel_id);
+      return kCameraEndOfStream;
+    }
+
+    ret = (ret == ascend::utils::kDvppOperationOk) ?
+        kCameraReturnValid : kCameraReturnInvalid;
+  } else {
+    ret = ReadFrameFromCamera(camera_instance_para_.channel_id,
+                              (void *) (data.get()), &size);
+  }
 
   if ((ret == kCameraReturnValid) && (size == image_size_)) {
     // success to get a frame from camera
     output_para->frame_id = ++frame_id_;
     output_para->timestamp = time(NULL);
+    output_para->capture_time_ns = ascend::utils::GetMonotonicTimeNs();
     output_para->data = data;
     output_para->size = size;
     output_para->channel_id = camera_instance_para_.channel_id;
     output_para->resolution = camera_instance_para_.resolution;
     result = kCameraRunOk;
+  } else if (virtual_camera_ != nullptr) {  // failed to read the clip
+    ASC_LOG_ERROR("Camera[%d] read replay file failed.",
+                  camera_instance_para_.channel_id);
+    result = kCameraGetInfoError;
   } else {  // failed to read a frame data from camera
     CameraStatus status = QueryCameraStatus(camera_instance_para_.channel_id);
     ASC_LOG_ERROR("Camera[%d] get image failed status is %d.",
@@ -163,6 +249,15 @@ int Camera::GetUserTimeout() const {
   return camera_instance_para_.timeout;
 }
 
+void Camera::ReleaseCamera() {
+  if (virtual_camera_ != nullptr) {
+    virtual_camera_ = nullptr;
+    return;
+  }
+
+  CloseCamera(camera_instance_para_.channel_id);
+}
+
 void Camera::PrintErrorInfo(int code) const {
 
   static ErrorDescription camera_description[] = { { kCameraInitError,
@@ -172,7 +267,9 @@ void Camera::PrintErrorInfo(int code) const {
       { kCameraSetFormatError, "Failed to set format." }, {
           kCameraSetResolutionError, "Failed to set resolution." }, {
           kCameraSetWorkModeError, "Failed to set work mode." }, {
-          kCameraGetInfoError, "Failed to get info from camera." }, };
+          kCameraGetInfoError, "Failed to get info from camera." }, {
+          kCameraMallocError, "Failed to alloc frame buffer." }, {
+          kCameraEndOfStream, "The replay file is over." }, };
 
   // find same errorcode and get error description
   int num = sizeof(camera_description) / sizeof(ErrorDescription);
@@ -36,6 +36,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <iostream>
 
 #include "ascenddk/ascendcamera/camera.h"
 #include "ascenddk/ascendcamera/output_info_process.h"
@@ -48,51 +49,52 @@ namespace ascendcamera {
 MainProcess::MainProcess() {
   // constuct a instance used to control the whole process.
   control_object_.ascend_camera_paramter = nullptr;
-  control_object_.camera = nullptr;
-  control_object_.dvpp_process = nullptr;
-  control_object_.output_process = nullptr;
   control_object_.loop_flag = kNoNeedLoop;
-  control_object_.multi_frame_process.thread_id = 0;
-  control_object_.multi_frame_process.safe_queue = nullptr;
-  control_object_.multi_frame_process.current_buf = nullptr;
-  control_object_.multi_frame_process.open_thread_flag = kThreadStop;
-  control_object_.multi_frame_process.thread_status = kThreadInvalidStatus;
-
-  // initialization debugging info
-  debug_info_.total_frame = 0;
-  debug_info_.queue_max_length = 0;
+  control_object_.pipeline.encode_stage = nullptr;
+  control_object_.pipeline.output_stage = nullptr;
+  control_object_.pipeline.batch_frame_num = 1;
+  control_object_.pipeline.max_latency_ns = 0;
+  control_object_.stop_flag = false;
+  control_object_.begin_time = { 0, 0 };
 }
 
 MainProcess::~MainProcess() {
+  // the stage threads use dvpp and output instance, stop them first
+  StopPipeline();
+
   // release all
   if (control_object_.ascend_camera_paramter != nullptr) {
     delete control_object_.ascend_camera_paramter;
     control_object_.ascend_camera_paramter = nullptr;
   }
 
-  if (control_object_.camera != nullptr) {
-    delete control_object_.camera;
-    control_object_.camera = nullptr;
-  }
+  for (ChannelObject *channel : control_object_.channels) {
+    if (channel->capture_thread.joinable()) {
+      channel->capture_thread.join();
+    }
 
-  if (control_object_.dvpp_process != nullptr) {
-    delete control_object_.dvpp_process;
-    control_object_.dvpp_process = nullptr;
-  }
+    if (channel->camera != nullptr) {
+      delete channel->camera;
+      channel->camera = nullptr;
+    }
 
-  if (control_object_.output_process != nullptr) {
-    delete control_object_.output_process;
-    control_object_.dvpp_process = nullptr;
-  }
+    if (channel->dvpp_process != nullptr) {
+      delete channel->dvpp_process;
+      channel->dvpp_process = nullptr;
+    }
 
-  if (control_object_.multi_frame_process.safe_queue != nullptr) {
-    delete control_object_.multi_frame_process.safe_queue;
-    control_object_.multi_frame_process.safe_queue = nullptr;
-  }
+    if (channel->output_process != nullptr) {
+      delete channel->output_process;
+      channel->output_process = nullptr;
+    }
 
+    delete channel;
+  }
+  control_object_.channels.clear();
 }
 
-int MainProcess::OutputInstanceInit(int width, int height) {
+int MainProcess::OutputInstanceInit(ChannelObject *channel, int width,
+                                    int height) {
   int ret = kMainProcessOk;
 
   OutputInfoPara output_para;
@@ -104,7 +106,8 @@ int MainProcess::OutputInstanceInit(int width, int height) {
         ascend::presenter::ContentType::kVideo;
   }
 
-  string str = control_object_.ascend_camera_paramter->GetOutputFile();
+  string str = control_object_.ascend_camera_paramter->GetChannelOutputFile(
+      channel->channel_id);
   // if user input "-o",it means output to stdout or save file to local
   if (!str.empty()) {
     // ouput to stdout or save file to local.
@@ -112,10 +115,20 @@ int MainProcess::OutputInstanceInit(int width, int height) {
     output_para.path = (str == "-") ? "" : str;
     output_para.width = width;
     output_para.height = height;
-    control_object_.output_process = new OutputInfoProcess(output_para);
+
+    // a video file is split into segments, an image is always one file
+    if (control_object_.ascend_camera_paramter->GetMediaType() == kVideo) {
+      output_para.segment_size = kSegmentSizeUnit
+          * control_object_.ascend_camera_paramter->GetSegmentSize();
+      output_para.segment_duration = kSecToMillisec
+          * control_object_.ascend_camera_paramter->GetSegmentTime();
+      output_para.direct_io =
+          control_object_.ascend_camera_paramter->IsDirectIo();
+    }
+    channel->output_process = new OutputInfoProcess(output_para);
 
     // open output channel
-    ret = control_object_.output_process->OpenOutputChannel();
+    ret = channel->output_process->OpenOutputChannel();
   } else {  // if user input "-s",it means ouput to presenter.
     string str = control_object_.ascend_camera_paramter->GetOutputPresenter();
     if (!str.empty()) {
@@ -134,24 +147,33 @@ int MainProcess::OutputInstanceInit(int width, int height) {
           str.find_first_of(KPortChannelSeparator, kFirstIndex) + 1,
           str.length() - str.find_first_of(KPortChannelSeparator, kFirstIndex));
 
+      // several cameras: every camera has its own presenter channel,
+      // zzz/zz/0 zzz/zz/1
+      if (control_object_.channels.size() > 1) {
+        output_para.presenter_para.channel_name += KPortChannelSeparator
+            + to_string(channel->channel_id);
+      }
+
       output_para.mode = kOutputToPresenter;
+      channel->is_drop_allowed = true;
       output_para.path = "";
       output_para.width = width;
       output_para.height = height;
-      control_object_.output_process = new OutputInfoProcess(output_para);
+      channel->output_process = new OutputInfoProcess(output_para);
 
       // open output channel
-      ret = control_object_.output_process->OpenOutputChannel();
+      ret = channel->output_process->OpenOutputChannel();
     }
   }
 
   if (ret != kMainProcessOk) {
-    control_object_.output_process->PrintErrorInfo(ret);
+    channel->output_process->PrintErrorInfo(ret);
   }
   return ret;
 }
 
-void MainProcess::DvppInstanceInit(int width, int height) {
+void MainProcess::DvppInstanceInit(ChannelObject *channel, int width,
+                                   int height) {
   // 1. In mode of video to presenter server, it need picture mode.
   // 2. The user points to picture.
   string str = control_object_.ascend_camera_paramter->GetOutputPresenter();
@@ -167,8 +189,7 @@ void MainProcess::DvppInstanceInit(int width, int height) {
     dvpp_to_jpg_para.level = kDvppToJpgQualityParameter;
     dvpp_to_jpg_para.resolution.height = height;
     dvpp_to_jpg_para.resolution.width = width;
-    control_object_.dvpp_process = new ascend::utils::DvppProcess(
-        dvpp_to_jpg_para);
+    channel->dvpp_process = new ascend::utils::DvppProcess(dvpp_to_jpg_para);
     if (is_need_convert_to_jpg) {
       // if output object is presenter and the mode is video ,
       // dvpp chose picture mode and need Continuous convert yuv to jpg
@@ -182,77 +203,130 @@ void MainProcess::DvppInstanceInit(int width, int height) {
     dvpp_to_h264_para.yuv_store_type = ascend::utils::kYuv420sp;
     dvpp_to_h264_para.resolution.width = width;
     dvpp_to_h264_para.resolution.height = height;
-    control_object_.dvpp_process = new ascend::utils::DvppProcess(
-        dvpp_to_h264_para);
+    channel->dvpp_process = new ascend::utils::DvppProcess(dvpp_to_h264_para);
     control_object_.loop_flag = kNeedLoop;
   }
 
 }
 
-void MainProcess::CameraInstanceInit(int width, int height) {
+void MainProcess::CameraInstanceInit(ChannelObject *channel, int width,
+                                     int height) {
   CameraPara camera_para;
 
   // camera instance paramter
   camera_para.fps = control_object_.ascend_camera_paramter->GetFps();
   camera_para.capture_obj_flag = control_object_.ascend_camera_paramter
       ->GetMediaType();
-  camera_para.channel_id = control_object_.ascend_camera_paramter
-      ->GetCameraChannel();
+  camera_para.channel_id = channel->channel_id;
   camera_para.image_format = CAMERA_IMAGE_YUV420_SP;
   camera_para.timeout = control_object_.ascend_camera_paramter->GetTimeout();
   camera_para.resolution.width = width;
   camera_para.resolution.height = height;
+  camera_para.replay_file =
+      control_object_.ascend_camera_paramter->GetReplayFile();
+  camera_para.replay_fast =
+      control_object_.ascend_camera_paramter->IsReplayFast();
+  camera_para.replay_once =
+      control_object_.ascend_camera_paramter->IsReplayOnce();
 
   // camera instance
-  control_object_.camera = new Camera(camera_para);
+  channel->camera = new Camera(camera_para);
 }
 
-int MainProcess::CreateThreadInit(int width, int height) {
-  int ret = kMainProcessOk;
+ChannelObject *MainProcess::FindChannel(int channel_id) const {
+  for (ChannelObject *channel : control_object_.channels) {
+    if (channel->channel_id == channel_id) {
+      return channel;
+    }
+  }
 
-  // init thread flag
-  control_object_.multi_frame_process.open_thread_flag = kThreadStop;
-  control_object_.multi_frame_process.thread_status = kThreadInvalidStatus;
-  control_object_.multi_frame_process.thread_error_code = 0;  //no error
+  return nullptr;
+}
+
+int MainProcess::CreatePipeline(int width, int height) {
+  ascend::utils::DvppProcess *dvpp_process =
+      control_object_.channels[kFirstIndex]->dvpp_process;
 
-  //if fps > 10 ,it need multi-thread
-  if (control_object_.ascend_camera_paramter->GetFps()
-      > kStartupThreadThresHold) {
+  // h264 collects the frames captured within max latency for one dvpp
+  // call: a recording makes few calls, a stream stays responsive
+  if (dvpp_process->GetMode() == ascend::utils::kH264) {
+    int max_latency =
+        control_object_.ascend_camera_paramter->GetMaxLatency();
+    int batch_frame_num = control_object_.ascend_camera_paramter->GetFps()
+        * max_latency / kSecToMillisec;
+    batch_frame_num = (batch_frame_num < 1) ? 1 : batch_frame_num;
+    batch_frame_num = (batch_frame_num > kH264BufferMaxFrame) ?
+        kH264BufferMaxFrame : batch_frame_num;
+    control_object_.pipeline.batch_frame_num = batch_frame_num;
+    control_object_.pipeline.max_latency_ns = (int64_t) max_latency
+        * kMillSecToNanoSec;
+
+    // every camera collects its own h264 frames
     int size = width * height * kYuv420spSizeNumerator
         / kYuv420spSizeDenominator;
-    H264Buf *buffer = nullptr;
-
-    // set thread running flag
-    control_object_.multi_frame_process.open_thread_flag = kThreadStartup;
-
-    // create thread-safe queue
-    control_object_.multi_frame_process.safe_queue = new ThreadSafeQueue<
-        H264Buf *>();
-
-    // create a queue element
-    ret = CreateMultiFrameBuffer(&buffer, size, kThreadNoNeedExit);
-    if (ret != kMainProcessOk) {
-      return ret;
+    for (ChannelObject *channel : control_object_.channels) {
+      int ret = CreateMultiFrameBuffer(channel, size);
+      if (ret != kMainProcessOk) {
+        return ret;
+      }
     }
+  }
 
-    control_object_.multi_frame_process.current_buf = buffer;
-
-    // clear thread status
-    control_object_.multi_frame_process.thread_status = kThreadInvalidStatus;
+  // capture -> encode -> output, the capture threads of all cameras share
+  // one encode thread and one output thread
+  int channel_num = control_object_.channels.size();
+  control_object_.pipeline.output_stage = new PipelineStage<EncodedFrame>(
+      kOutputQueueLength * channel_num,
+      [this](const shared_ptr<EncodedFrame> &frame) {
+        return OutputStageProc(frame);
+      });
+  control_object_.pipeline.encode_stage = new PipelineStage<CameraOutputPara>(
+      kEncodeQueueLength * channel_num,
+      [this](const shared_ptr<CameraOutputPara> &frame) {
+        return EncodeStageProc(frame);
+      });
+
+  // a batch not filled in time is converted on its deadline
+  if (control_object_.pipeline.batch_frame_num > 1) {
+    control_object_.pipeline.encode_stage->SetTickHandler(
+        kBatchDeadlineCheckMs, [this]() {
+          return FlushExpiredBatches();
+        });
+  }
+  control_object_.pipeline.output_stage->Start();
+  control_object_.pipeline.encode_stage->Start();
+
+  ASC_LOG_INFO("The pipeline mode of ascendcamera is start, %d camera(s), "
+               "%d frame(s) per dvpp call at most, max latency %lldms.",
+               channel_num, control_object_.pipeline.batch_frame_num,
+               (long long) (control_object_.pipeline.max_latency_ns
+                   / kMillSecToNanoSec));
+  return kMainProcessOk;
+}
 
-    // create a thread to deal with multi-frame
-    ret = this->CreateMultiFrameThread();
-    if (ret != kMainProcessOk) {
-      FreeMultiFrameBuffer(buffer);
-      return ret;
-    }
+void MainProcess::StopPipeline() {
+  // stop in data flow order, so the encode stage flushes into a live output
+  if (control_object_.pipeline.encode_stage != nullptr) {
+    control_object_.pipeline.encode_stage->Stop();
+    delete control_object_.pipeline.encode_stage;
+    control_object_.pipeline.encode_stage = nullptr;
+  }
 
-    // set thread status
-    control_object_.multi_frame_process.thread_status = kThreadRunStatus;
+  if (control_object_.pipeline.output_stage != nullptr) {
+    control_object_.pipeline.output_stage->Stop();
+    delete control_object_.pipeline.output_stage;
+    control_object_.pipeline.output_stage = nullptr;
+  }
 
-    ASC_LOG_INFO("The multi-frame mode of ascendcamera is start.");
+  // release buffer, the batch buffers are freed with their last frame
+  for (ChannelObject *channel : control_object_.channels) {
+    if (channel->current_buf != nullptr) {
+      FreeMultiFrameBuffer(channel->current_buf);
+      channel->current_buf = nullptr;
+    }
+    channel->capture_batch.reset();
+    channel->batch_pool.reset();
   }
-  return ret;
 }
 
 int MainProcess::Init(int argc, char *argv[]) {
@@ -270,254 +344,271 @@ int MainProcess::Init(int argc, char *argv[]) {
   int width = control_object_.ascend_camera_paramter->GetImageWidth();
   int height = control_object_.ascend_camera_paramter->GetImageHeight();
 
-  // camera instance
-  CameraInstanceInit(width, height);
-
-  // dvpp controller instance
-  DvppInstanceInit(width, height);
-
-  // output instance
-  int ret = OutputInstanceInit(width, height);
-  if (ret != kMainProcessOk) {
-    return ret;
+  for (int channel_id : control_object_.ascend_camera_paramter
+      ->GetCameraChannels()) {
+    ChannelObject *channel = new ChannelObject();
+    channel->channel_id = channel_id;
+    channel->camera = nullptr;
+    channel->dvpp_process = nullptr;
+    channel->output_process = nullptr;
+    channel->is_drop_allowed = false;
+    channel->current_buf = nullptr;
+    channel->capture_slot = 0;
+    channel->error_code = kMainProcessOk;
+    channel->debug_info.total_frame = 0;
+    channel->debug_info.queue_max_length = 0;
+    channel->debug_info.drop_frame = 0;
+    channel->debug_info.output_count = 0;
+    channel->debug_info.sum_latency_ns = 0;
+    channel->debug_info.max_latency_ns = 0;
+    control_object_.channels.push_back(channel);
+  }
+
+  for (ChannelObject *channel : control_object_.channels) {
+    // camera instance
+    CameraInstanceInit(channel, width, height);
+
+    // dvpp controller instance
+    DvppInstanceInit(channel, width, height);
+
+    // output instance
+    int ret = OutputInstanceInit(channel, width, height);
+    if (ret != kMainProcessOk) {
+      return ret;
+    }
   }
 
-  if (control_object_.dvpp_process->GetMode() == ascend::utils::kH264) {
-    ret = CreateThreadInit(width, height);
+  // continuous capture runs as a pipeline, a single picture runs inline
+  ChannelObject *first_channel = control_object_.channels[kFirstIndex];
+  if ((first_channel->dvpp_process != nullptr)
+      && (first_channel->output_process != nullptr)
+      && (control_object_.loop_flag == kNeedLoop)) {
+    return CreatePipeline(width, height);
   }
 
-  return ret;
-}
-
-int MainProcess::GetQueueSize() {
-  return control_object_.multi_frame_process.safe_queue->Size();
+  return kMainProcessOk;
 }
 
-int MainProcess::CreateMultiFrameBuffer(H264Buf **buffer, int size,
-                                        int exit_flag) {
-  // create struct h264Buf and a ten-frame buffer
-  if ((buffer == nullptr) || (size > kYuvImageMaxSize)) {
+int MainProcess::CreateMultiFrameBuffer(ChannelObject *channel, int size) {
+  if ((channel == nullptr) || (size > kYuvImageMaxSize)) {
     return kMainProcessInvalidParameter;
   }
 
-  *buffer = new H264Buf;
+  // batch buffers are allocated once and recycled, the camera captures into
+  // them directly
+  ascend::utils::FrameBufferPoolPara pool_para;
+  pool_para.buffer_size = control_object_.pipeline.batch_frame_num * size;
+  pool_para.buffer_count = kH264BatchBufferCount;
+  channel->batch_pool = make_shared<ascend::utils::FrameBufferPool>(pool_para);
+  int ret = channel->batch_pool->Init();
+  if (ret != ascend::utils::kDvppOperationOk) {
+    ASC_LOG_ERROR("camera[%d] init h264 batch buffer failed, ret = %d.",
+                  channel->channel_id, ret);
+    return kMainProcessMultiframeMallocFail;
+  }
 
-  (*buffer)->single_frame_size = size;
-  (*buffer)->index = 0;
-  (*buffer)->buf = new char[kH264BufferMaxFrame * size];
-  (*buffer)->exit_flag = exit_flag;
+  // create struct h264Buf
+  channel->current_buf = new H264Buf;
+  channel->current_buf->single_frame_size = size;
+  channel->current_buf->index = 0;
+  channel->current_buf->capture_time_ns = 0;
 
   return kMainProcessOk;
 }
 
 int MainProcess::FreeMultiFrameBuffer(H264Buf *h264_buf) {
-  // relase buffer
+  // relase buffer, the batch buffer goes back to the pool
   if (h264_buf != nullptr) {
-    if (h264_buf->buf != nullptr) {
-      delete[] h264_buf->buf;
-    }
-
     delete h264_buf;
   }
 
   return kMainProcessOk;
 }
-int MainProcess::DealMultiFrame(H264Buf *h264_buf,
-                                ControlObject *control_object) {
-  if ((h264_buf == nullptr) || (control_object == nullptr)) {
-    return kMainProcessMultiframeInvalidParameter;
-  }
 
-  // DVPP conversion
-  ascend::utils::DvppOutput dvpp_output = { nullptr, 0 };
-  int ret = control_object->dvpp_process->DvppOperationProc(
-      h264_buf->buf, h264_buf->single_frame_size * h264_buf->index,
-      &dvpp_output);
+int MainProcess::AcquireBatchSlot(ChannelObject *channel,
+                                  shared_ptr<char> &slot) {
+  // the batch buffer is full, the encode stage releases it with the last
+  // frame converted
+  if ((channel->capture_batch == nullptr)
+      || (channel->capture_slot >= control_object_.pipeline.batch_frame_num)) {
+    channel->capture_batch = channel->batch_pool->Acquire();
+    channel->capture_slot = 0;
+    if (channel->capture_batch == nullptr) {
+      ASC_LOG_ERROR("camera[%d] get h264 batch buffer failed.",
+                    channel->channel_id);
+      return kMainProcessMultiframeMallocFail;
+    }
+  }
 
-  if (ret != kMainProcessOk) {
-    control_object->dvpp_process->PrintErrorInfo(ret);
-    FreeMultiFrameBuffer(h264_buf);
+  // single_frame_size never changes after init, so it is safe to read here
+  slot = shared_ptr<char>(channel->capture_batch,
+                          channel->capture_batch.get()
+                              + channel->capture_slot
+                                  * channel->current_buf->single_frame_size);
+  return kMainProcessOk;
+}
 
+int MainProcess::EncodeStageProc(const shared_ptr<CameraOutputPara> &frame) {
+  // end of stream: convert the remaining part of every camera
+  if (frame == nullptr) {
+    int ret = kMainProcessOk;
+    for (ChannelObject *channel : control_object_.channels) {
+      if ((channel->current_buf != nullptr)
+          && (channel->current_buf->index != 0)) {
+        int encode_ret = EncodeMultiFrame(channel);
+        ret = (ret == kMainProcessOk) ? encode_ret : ret;
+      }
+    }
     return ret;
   }
 
-  // send to channel
-  ret = control_object->output_process->SendToChannel(dvpp_output.buffer,
-                                                      dvpp_output.size);
-  if (ret != kMainProcessOk) {
-    control_object->output_process->PrintErrorInfo(ret);
+  ChannelObject *channel = FindChannel(frame->channel_id);
+  if (channel == nullptr) {
+    ASC_LOG_ERROR("The frame of unknown camera[%u].", frame->channel_id);
+    return kMainProcessInvalidParameter;
+  }
+
+  // jpg: every frame is one picture
+  H264Buf *h264_buf = channel->current_buf;
+  if (h264_buf == nullptr) {
+    shared_ptr<EncodedFrame> encoded = make_shared<EncodedFrame>();
+    ascend::utils::DvppOutput dvpp_output = { nullptr, 0 };
+    int ret = channel->dvpp_process->DvppOperationProc(
+        frame->data.get(), frame->size, &dvpp_output);
+    if (ret != kMainProcessOk) {
+      channel->dvpp_process->PrintErrorInfo(ret);
+      return ret;
+    }
+
+    encoded->channel = channel;
+    encoded->capture_time_ns = frame->capture_time_ns;
+    encoded->buf = dvpp_output.buffer;
+    encoded->size = dvpp_output.size;
+    control_object_.pipeline.output_stage->Submit(encoded);
+    return kMainProcessOk;
+  }
+
+  // h264: the frame is in the batch buffer already. It extends the batch
+  // when it follows the last frame, else the batch is converted first
+  // (the capture went on to a new batch buffer or the batch was flushed)
+  if ((h264_buf->index != 0)
+      && (frame->data.get() != h264_buf->buf.get()
+          + h264_buf->index * h264_buf->single_frame_size)) {
+    int ret = EncodeMultiFrame(channel);
+    if (ret != kMainProcessOk) {
+      return ret;
+    }
   }
 
-  // release buffer
-  FreeMultiFrameBuffer(h264_buf);
-  if (dvpp_output.buffer != nullptr) {
-    delete[] dvpp_output.buffer;
+  if (h264_buf->index == 0) {
+    h264_buf->buf = frame->data;
+    h264_buf->capture_time_ns = frame->capture_time_ns;
   }
+  h264_buf->index += 1;
 
-  return ret;
+  // flush on size
+  if (h264_buf->index >= control_object_.pipeline.batch_frame_num) {
+    int ret = EncodeMultiFrame(channel);
+    if (ret != kMainProcessOk) {
+      return ret;
+    }
+  }
+
+  // flush on deadline, also for the other cameras
+  return FlushExpiredBatches();
 }
 
-void *ascend::ascendcamera::MainProcess::MultiFrameProcThread(
-    void *startup_arg) {
-  H264Buf *h264_buf = nullptr;
-  ControlObject *control_obj = (struct ControlObject *) startup_arg;
-
-  while (control_obj->multi_frame_process.open_thread_flag == kThreadStartup) {
-    // If not data,thread will block.
-    control_obj->multi_frame_process.safe_queue->WaitAndPop(h264_buf);
-
-    // The exit flag is seted ,we will ready for exit.
-    if (h264_buf->exit_flag == kThreadNeedExit) {
-      control_obj->multi_frame_process.open_thread_flag = kThreadStop;
-      // if index is equal 0,we will immediately exit.
-      // if index is not equal 0,we will deal with the remaining part.
-      if (h264_buf->index == 0) {
-        FreeMultiFrameBuffer(h264_buf);
-        continue;
-      }
+int MainProcess::FlushExpiredBatches() {
+  int64_t now_ns = ascend::utils::GetMonotonicTimeNs();
+  for (ChannelObject *channel : control_object_.channels) {
+    H264Buf *h264_buf = channel->current_buf;
+    if ((h264_buf == nullptr) || (h264_buf->index == 0)
+        || (now_ns - h264_buf->capture_time_ns
+            < control_object_.pipeline.max_latency_ns)) {
+      continue;
     }
 
-    int ret = DealMultiFrame(h264_buf, control_obj);
-    // deal with the multi-frame data.
+    int ret = EncodeMultiFrame(channel);
     if (ret != kMainProcessOk) {
-      control_obj->multi_frame_process.thread_status = kThreadErrorStatus;
-      control_obj->multi_frame_process.thread_error_code = ret;
-      return nullptr;
+      return ret;
     }
   }
 
-  return nullptr;
+  return kMainProcessOk;
 }
 
-int MainProcess::CreateMultiFrameThread(void) {
-  pthread_t tid = 0;  // used to get new thread id.
+int MainProcess::EncodeMultiFrame(ChannelObject *channel) {
+  H264Buf *h264_buf = channel->current_buf;
+
+  // DVPP conversion
+  ascend::utils::DvppOutput dvpp_output = { nullptr, 0 };
+  int ret = channel->dvpp_process->DvppOperationProc(
+      h264_buf->buf.get(), h264_buf->single_frame_size * h264_buf->index,
+      &dvpp_output);
+  h264_buf->index = 0;
+
+  // the frames are converted, the batch buffer may go back to the pool
+  h264_buf->buf.reset();
 
-  // create a thread
-  int ret = pthread_create(&tid, nullptr, MultiFrameProcThread,
-                           &control_object_);
   if (ret != kMainProcessOk) {
-    cerr << "[ERROR] Failed to create thread." << endl;
-    ASC_LOG_ERROR("Failed to create thread.return value = %d", ret);
-    return kSystemCallReturnError;
+    channel->dvpp_process->PrintErrorInfo(ret);
+    return kMainProcessMultiframeDvppProcError;
   }
 
-  control_object_.multi_frame_process.thread_id = tid;
+  // the output stage owns the dvpp output buffer from now on
+  shared_ptr<EncodedFrame> encoded = make_shared<EncodedFrame>();
+  encoded->channel = channel;
+  encoded->capture_time_ns = h264_buf->capture_time_ns;
+  encoded->buf = dvpp_output.buffer;
+  encoded->size = dvpp_output.size;
+  control_object_.pipeline.output_stage->Submit(encoded);
   return kMainProcessOk;
 }
 
-int MainProcess::MultiFrameBufferProc(CameraOutputPara *output_para) {
-  int ret = kMainProcessOk;
-  H264Buf *buf_h264 = nullptr;
-
-  // if  startup thread,we collect ten frames to multi-frame process thread.
-  buf_h264 = control_object_.multi_frame_process.current_buf;
-  ret = memcpy_s(
-      buf_h264->buf + (buf_h264->index) * (buf_h264->single_frame_size),
-      buf_h264->single_frame_size, output_para->data.get(), output_para->size);
-  CHECK_MEMCPY_S_RESULT(ret);
-  buf_h264->index += 1;
-
-  // ten frames
-  if (buf_h264->index < kH264BufferMaxFrame) {
+int MainProcess::OutputStageProc(const shared_ptr<EncodedFrame> &frame) {
+  // end of stream, nothing buffered in this stage
+  if (frame == nullptr) {
     return kMainProcessOk;
-  } else {
-    do {
-      // if queue is not full ,the ten-frame push to queue.
-      if (GetQueueSize() < kH264BufferQueueMaxLength) {
-        int single_frame_size = buf_h264->single_frame_size;
-
-        H264Buf *buff_h264_temp = nullptr;
-        // create a new buffer
-        ret = CreateMultiFrameBuffer(&buff_h264_temp, single_frame_size,
-                                     kThreadNoNeedExit);
-        if (ret != kMainProcessOk) {
-          control_object_.multi_frame_process.current_buf = nullptr;
-          cerr << "[ERROR] Failed to create multi-frame buffer." << endl;
-          ASC_LOG_ERROR("Failed to create multi-frame buffer.");
-          buf_h264->exit_flag = kThreadNeedExit;
-          control_object_.multi_frame_process.safe_queue->Push(buf_h264);
-          pthread_join(control_object_.multi_frame_process.thread_id, nullptr);
-          control_object_.multi_frame_process.thread_status =
-              kThreadInvalidStatus;
-          return kMainProcessMultiframeMallocFail;
-        }
-
-        control_object_.multi_frame_process.current_buf = buff_h264_temp;
-        control_object_.multi_frame_process.safe_queue->Push(buf_h264);
-
-        // record debug info
-        if (debug_info_.queue_max_length < GetQueueSize()) {
-          debug_info_.queue_max_length = GetQueueSize();
-        }
-
-        break;
-      } else {  //wait some time
-        usleep(kWaitTime);
-        continue;
-      }
-    } while (1);
   }
 
-  return kMainProcessOk;
-}
+  // send to the channel of the camera, the frame holds the dvpp output
+  // until the channel is done with it
+  OutputInfoProcess *output_process = frame->channel->output_process;
+  int ret = output_process->SendToChannel(frame->buf, frame->size, frame);
+  if (ret != kMainProcessOk) {
+    output_process->PrintErrorInfo(ret);
+    return ret;
+  }
 
-void MainProcess::MultiFrameBufferTimeoutProc() {
-  H264Buf *buf_h264 = nullptr;
-  int max_retry_num = 0;
-
-  // if time is up,it will put the last frame to thread.
-  if ((control_object_.multi_frame_process.open_thread_flag == kThreadStartup)
-      && (control_object_.multi_frame_process.thread_status
-          != kThreadInvalidStatus)) {
-
-    // if  startup thread,we collect ten frames to
-    // multi-frame process thread.
-    buf_h264 = control_object_.multi_frame_process.current_buf;
-
-    do {
-      if (GetQueueSize() < kH264BufferQueueMaxLength) {
-        //set exit flag
-        buf_h264->exit_flag = kThreadNeedExit;
-        control_object_.multi_frame_process.safe_queue->Push(buf_h264);
-        control_object_.multi_frame_process.current_buf = nullptr;
-        break;
-      } else {  //wait some time and retry
-        usleep(kWaitTime);
-        max_retry_num++;
-        continue;
-      }
-    } while (max_retry_num < kMaxRetryNum);
+  // record latency from capture to output
+  DebugInfo &debug_info = frame->channel->debug_info;
+  long long latency_ns = ascend::utils::GetMonotonicTimeNs()
+      - frame->capture_time_ns;
+  debug_info.output_count++;
+  debug_info.sum_latency_ns += latency_ns;
+  if (debug_info.max_latency_ns < latency_ns) {
+    debug_info.max_latency_ns = latency_ns;
+  }
 
-    // wait children thread exit
-    pthread_join(control_object_.multi_frame_process.thread_id, nullptr);
-    control_object_.multi_frame_process.thread_status = kThreadInvalidStatus;
+  if (debug_info.output_count % kDebugRecordFrameThresHold == 0) {
+    ASC_LOG_INFO("camera[%d] output = %ld,average latency = %lldus,"
+        "maximum latency = %lldus.", frame->channel->channel_id,
+        debug_info.output_count,
+        debug_info.sum_latency_ns / debug_info.output_count
+            / kMicroSecToNanoSec,
+        debug_info.max_latency_ns / kMicroSecToNanoSec);
   }
+
+  return ret;
 }
 
 int MainProcess::DvppAndOuputProc(CameraOutputPara *output_para,
                                   ascend::utils::DvppProcess *dvpp_process,
                                   OutputInfoProcess *output_info_process) {
-  int ret = 0;
-  // use multi-thread to deal with multi-frame
-  if (dvpp_process->GetMode() == ascend::utils::kH264) {
-    if ((control_object_.multi_frame_process.open_thread_flag == kThreadStartup)
-        && (control_object_.multi_frame_process.thread_status
-            == kThreadRunStatus)) {
-      ret = MultiFrameBufferProc(output_para);
-      return ret;
-    }
-
-    if ((control_object_.multi_frame_process.open_thread_flag == kThreadStartup)
-        && (control_object_.multi_frame_process.thread_status
-            == kThreadErrorStatus)) {
-      return control_object_.multi_frame_process.thread_error_code;
-    }
-  }
-
   ascend::utils::DvppOutput dvpp_output = { nullptr, 0 };
   // DVPP convert to jpg or h264
-  ret = dvpp_process->DvppOperationProc(output_para->data.get(),
-                                        output_para->size, &dvpp_output);
+  int ret = dvpp_process->DvppOperationProc(output_para->data.get(),
+                                            output_para->size, &dvpp_output);
   if (ret != kMainProcessOk) {
     dvpp_process->PrintErrorInfo(ret);
     return ret;
@@ -534,128 +625,219 @@ int MainProcess::DvppAndOuputProc(CameraOutputPara *output_para,
   return ret;
 }
 
-int MainProcess::DoOnce() {
-  CameraOutputPara output_para;
+int MainProcess::DoOnce(ChannelObject *channel) {
+  PipelineStage<CameraOutputPara> *encode_stage =
+      control_object_.pipeline.encode_stage;
+  PipelineStage<EncodedFrame> *output_stage =
+      control_object_.pipeline.output_stage;
+
+  // a failed stage stops the capture
+  if (encode_stage != nullptr) {
+    int ret = encode_stage->GetErrorCode();
+    if (ret == kMainProcessOk) {
+      ret = output_stage->GetErrorCode();
+    }
 
-  // get a frame from camera
-  int ret = control_object_.camera->CaptureCameraInfo(&output_para);
-  if (ret != kMainProcessOk) {
-    control_object_.camera->PrintErrorInfo(ret);
-    return ret;
+    if (ret != kMainProcessOk) {
+      return ret;
+    }
+  }
+
+  shared_ptr<CameraOutputPara> output_para = make_shared<CameraOutputPara>();
+
+  // get a frame from camera, h264 frames are captured into the batch buffer
+  int ret = kMainProcessOk;
+  if (channel->batch_pool != nullptr) {
+    shared_ptr<char> slot;
+    ret = AcquireBatchSlot(channel, slot);
+    if (ret != kMainProcessOk) {
+      return ret;
+    }
+    ret = channel->camera->CaptureCameraInfo(output_para.get(), slot);
+  } else {
+    ret = channel->camera->CaptureCameraInfo(output_para.get());
   }
 
-  ret = DvppAndOuputProc(&output_para, control_object_.dvpp_process,
-                         control_object_.output_process);
   if (ret != kMainProcessOk) {
+    if (ret != kCameraEndOfStream) {
+      channel->camera->PrintErrorInfo(ret);
+    }
     return ret;
   }
 
-  return ret;
-}
+  if (encode_stage == nullptr) {
+    return DvppAndOuputProc(output_para.get(), channel->dvpp_process,
+                            channel->output_process);
+  }
 
-int MainProcess::Run() {
+  // hand the frame over to the encode thread and go on capturing. A live
+  // output drops the frame when the encode thread lags behind, the frame of
+  // a dropped one is captured into again. Others wait, so the camera read
+  // is slowed down and no frame is lost
+  if (!channel->is_drop_allowed) {
+    encode_stage->Submit(output_para);
+  } else if (!encode_stage->TrySubmit(output_para)) {
+    channel->debug_info.drop_frame++;
+    if (channel->debug_info.drop_frame % kDebugRecordFrameThresHold == 1) {
+      ASC_LOG_WARN("camera[%d] drops frame as the encode stage is full, "
+          "drop frame = %ld.", channel->channel_id,
+          channel->debug_info.drop_frame);
+    }
+    return kMainProcessOk;
+  }
 
-  if ((control_object_.camera == nullptr)
-      || (control_object_.ascend_camera_paramter == nullptr)
-      || (control_object_.dvpp_process == nullptr)
-      || (control_object_.output_process == nullptr)) {
-    return kParaCheckError;
+  if (channel->batch_pool != nullptr) {
+    channel->capture_slot++;
   }
 
-  // init driver of camera and open camera.
-  int ret = control_object_.camera->InitCamera();
-  if (ret != kCameraInitOk) {
-    control_object_.camera->PrintErrorInfo(ret);
-    MultiFrameBufferTimeoutProc();
-    return ret;
-  } else {  // print to terminal
-    cerr << "[INFO] Success to open camera["
-         << control_object_.camera->GetChannelId() << "],and start working."
-         << endl;
-    ASC_LOG_INFO("Success to open camera[%d],and start working.",
-                 control_object_.camera->GetChannelId());
+  // record debug info
+  if (channel->debug_info.queue_max_length < encode_stage->GetQueueSize()) {
+    channel->debug_info.queue_max_length = encode_stage->GetQueueSize();
   }
 
-  int timeout = control_object_.camera->GetUserTimeout();
+  return kMainProcessOk;
+}
 
-  // get begin time
-  struct timespec begin_time = { 0, 0 };
+void MainProcess::CaptureProc(ChannelObject *channel) {
+  int timeout = channel->camera->GetUserTimeout();
   struct timespec current_time = { 0, 0 };
   long long running_time = 0;
-  clock_gettime(CLOCK_MONOTONIC, &begin_time);
+  int ret = kMainProcessOk;
 
   do {
+    // another camera failed
+    if (control_object_.stop_flag) {
+      break;
+    }
+
     // get current time
     clock_gettime(CLOCK_MONOTONIC, &current_time);
 
     // get running time
-    running_time = (current_time.tv_sec - begin_time.tv_sec) * kSecToMillisec
-        + current_time.tv_nsec / kMillSecToNanoSec
-        - begin_time.tv_nsec / kMillSecToNanoSec;
+    running_time = (current_time.tv_sec - control_object_.begin_time.tv_sec)
+        * kSecToMillisec + current_time.tv_nsec / kMillSecToNanoSec
+        - control_object_.begin_time.tv_nsec / kMillSecToNanoSec;
 
     // get and deal with a frame from camera.
-    ret = DoOnce();
+    ret = DoOnce(channel);
+
+    // the replay file is over
+    if (ret == kCameraEndOfStream) {
+      ret = kMainProcessOk;
+      break;
+    }
+
     if (ret != kMainProcessOk) {
-      cerr << "[ERROR] Failed to complete the task." << endl;
-      ASC_LOG_ERROR("Failed to complete the task.");
+      control_object_.stop_flag = true;
       break;
     }
 
     // we exit the loop if The running time more than the specified time.
     if ((running_time > (long long) timeout * kSecToMillisec)
         && (timeout != 0)) {
-      cerr << "[INFO] Success to complete the task." << endl;
-      ASC_LOG_ERROR("Success to complete the task.");
       break;
     }
 
     // record debugging info.
-    debug_info_.total_frame++;
-    if (debug_info_.total_frame % kDebugRecordFrameThresHold == 0) {
-      ASC_LOG_INFO("total frame = %ld,running time = %lldms,"
-          "Queue Maximum length = %d.", debug_info_.total_frame, running_time,
-          debug_info_.queue_max_length);
+    channel->debug_info.total_frame++;
+    if (channel->debug_info.total_frame % kDebugRecordFrameThresHold == 0) {
+      ASC_LOG_INFO("camera[%d] total frame = %ld,running time = %lldms,"
+          "Queue Maximum length = %d,drop frame = %ld.", channel->channel_id,
+          channel->debug_info.total_frame, running_time,
+          channel->debug_info.queue_max_length,
+          channel->debug_info.drop_frame);
     }
   } while (control_object_.loop_flag == kNeedLoop);
 
-  ExitProcess(ret);
-
-  return ret;
+  channel->error_code = ret;
 }
 
-void MainProcess::ExitProcess(int ret) {
-  // close camera.
-  if (control_object_.camera != nullptr) {
-    CloseCamera(control_object_.camera->GetChannelId());
-    // close camera
-    cerr << "[INFO] Close camera [" << control_object_.camera->GetChannelId()
-         << "]." << endl;
-    ASC_LOG_INFO("close camera[%d].", control_object_.camera->GetChannelId());
+int MainProcess::Run() {
+
+  if ((control_object_.ascend_camera_paramter == nullptr)
+      || control_object_.channels.empty()) {
+    return kParaCheckError;
+  }
+
+  for (ChannelObject *channel : control_object_.channels) {
+    if ((channel->camera == nullptr) || (channel->dvpp_process == nullptr)
+        || (channel->output_process == nullptr)) {
+      return kParaCheckError;
+    }
+  }
+
+  // init driver of camera and open camera.
+  int ret = kMainProcessOk;
+  for (size_t i = 0; i < control_object_.channels.size(); ++i) {
+    Camera *camera = control_object_.channels[i]->camera;
+    ret = camera->InitCamera();
+    if (ret != kCameraInitOk) {
+      camera->PrintErrorInfo(ret);
+
+      // close the cameras already opened
+      for (size_t j = 0; j < i; ++j) {
+        control_object_.channels[j]->camera->ReleaseCamera();
+      }
+      StopPipeline();
+      return ret;
+    }
+
+    // print to terminal
+    cerr << "[INFO] Success to open camera[" << camera->GetChannelId()
+         << "],and start working." << endl;
+    ASC_LOG_INFO("Success to open camera[%d],and start working.",
+                 camera->GetChannelId());
   }
 
-  // deal with the last frame.
-  if (ret != kMainProcessMultiframeMallocFail) {
-    MultiFrameBufferTimeoutProc();
+  // get begin time, all cameras run against the same clock
+  clock_gettime(CLOCK_MONOTONIC, &control_object_.begin_time);
+
+  // every camera captures on its own thread
+  for (ChannelObject *channel : control_object_.channels) {
+    channel->capture_thread = thread(&MainProcess::CaptureProc, this, channel);
   }
 
-  // for the thread abnormal exit,pop all queue element and release buffer
-  while ((control_object_.multi_frame_process.safe_queue != nullptr)
-      && (!control_object_.multi_frame_process.safe_queue->Empty())
-      && (control_object_.multi_frame_process.thread_status
-          == kThreadInvalidStatus)) {
-    H264Buf *h264_buf = nullptr;
-    control_object_.multi_frame_process.safe_queue->TryPop(h264_buf);
-    FreeMultiFrameBuffer(h264_buf);
+  // the result is the first error of the cameras
+  for (ChannelObject *channel : control_object_.channels) {
+    channel->capture_thread.join();
+    if ((ret == kMainProcessOk) && (channel->error_code != kMainProcessOk)) {
+      ret = channel->error_code;
+    }
   }
 
-  // release buffer
-  if (control_object_.multi_frame_process.current_buf != nullptr) {
-    FreeMultiFrameBuffer(control_object_.multi_frame_process.current_buf);
+  if (ret != kMainProcessOk) {
+    cerr << "[ERROR] Failed to complete the task." << endl;
+    ASC_LOG_ERROR("Failed to complete the task.");
+  } else {
+    cerr << "[INFO] Success to complete the task." << endl;
+    ASC_LOG_INFO("Success to complete the task.");
   }
 
+  ExitProcess(ret);
+
+  return ret;
+}
+
+void MainProcess::ExitProcess(int ret) {
+  // close camera.
+  for (ChannelObject *channel : control_object_.channels) {
+    if (channel->camera != nullptr) {
+      channel->camera->ReleaseCamera();
+      // close camera
+      cerr << "[INFO] Close camera [" << channel->camera->GetChannelId()
+           << "]." << endl;
+      ASC_LOG_INFO("close camera[%d].", channel->camera->GetChannelId());
+    }
+  }
+
+  // deal with the frames still in the pipeline.
+  StopPipeline();
+
   // close the output channel.
-  if (control_object_.output_process != nullptr) {
-    control_object_.output_process->CloseChannel();
+  for (ChannelObject *channel : control_object_.channels) {
+    if (channel->output_process != nullptr) {
+      channel->output_process->CloseChannel();
+    }
   }
 }
 }
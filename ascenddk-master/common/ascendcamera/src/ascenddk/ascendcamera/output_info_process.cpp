@@ -33,12 +33,8 @@
 
 #include "ascenddk/ascendcamera/output_info_process.h"
 
-#include <fcntl.h>
-#include <sys/types.h>
-#include <sys/stat.h>
 #include <stddef.h>
 #include <unistd.h>
-#include <sys/statfs.h>
 
 #include <iostream>
 
@@ -46,6 +42,69 @@
 
 using namespace std;
 
+namespace {
+// h264 start code 0x000001, it may have a leading zero(0x00000001)
+const int kH264StartCodeLength = 3;
+const unsigned char kH264NalTypeMask = 0x1f;
+
+// nal unit type of non-IDR slice, IDR slice and SPS
+const unsigned char kH264NalSlice = 1;
+const unsigned char kH264NalIdr = 5;
+const unsigned char kH264NalSps = 7;
+
+// nal unit types from SEI to AUD and from 14 to 18 start a new access unit
+const unsigned char kH264NalSei = 6;
+const unsigned char kH264NalAud = 9;
+const unsigned char kH264NalPrefix = 14;
+const unsigned char kH264NalReserved18 = 18;
+
+// first bit of a slice header, set when first_mb_in_slice is 0
+const unsigned char kH264FirstMbInSlice = 0x80;
+
+/**
+ * @brief find the next start code
+ * @param [in] buf: h264 data
+ * @param [in] size: size of h264 data
+ * @param [in] from: position to search from
+ * @param [out] header: position of the nal unit header behind the start code
+ * @return position of the start code, including its leading zero; size if
+ *         there is no more nal unit
+ */
+int FindStartCode(const unsigned char *buf, int size, int from, int *header) {
+  for (int i = from; i + kH264StartCodeLength < size; i++) {
+    if ((buf[i] != 0) || (buf[i + 1] != 0) || (buf[i + 2] != 1)) {
+      continue;
+    }
+
+    *header = i + kH264StartCodeLength;
+    return ((i > from) && (buf[i - 1] == 0)) ? i - 1 : i;
+  }
+
+  *header = size;
+  return size;
+}
+
+/**
+ * @brief check whether a nal unit starts a new access unit(frame), when the
+ *        current one has a slice already
+ * @param [in] buf: h264 data
+ * @param [in] size: size of h264 data
+ * @param [in] header: position of the nal unit header
+ * @return true: the nal unit belongs to the next frame
+ */
+bool IsFrameStart(const unsigned char *buf, int size, int header) {
+  unsigned char nal_type = buf[header] & kH264NalTypeMask;
+  if (((nal_type >= kH264NalSei) && (nal_type <= kH264NalAud))
+      || ((nal_type >= kH264NalPrefix) && (nal_type <= kH264NalReserved18))) {
+    return true;
+  }
+
+  // the first slice of a picture
+  return (nal_type >= kH264NalSlice) && (nal_type <= kH264NalIdr)
+      && (header + 1 < size) && ((buf[header + 1] & kH264FirstMbInSlice) != 0);
+}
+}
+
 namespace ascend {
 namespace ascendcamera {
 OutputInfoProcess::OutputInfoProcess(const OutputInfoPara &para) {
@@ -54,11 +113,21 @@ OutputInfoProcess::OutputInfoProcess(const OutputInfoPara &para) {
     return;
   }
   output_para_ = para;
-  file_desc_ = nullptr;
+  segment_writer_ = nullptr;
+  stdout_writer_ = nullptr;
   presenter_channel_ = nullptr;
 }
 
 OutputInfoProcess::~OutputInfoProcess() {
+  if (segment_writer_ != nullptr) {
+    delete segment_writer_;
+    segment_writer_ = nullptr;
+  }
+
+  if (stdout_writer_ != nullptr) {
+    delete stdout_writer_;
+    stdout_writer_ = nullptr;
+  }
 }
 
 int OutputInfoProcess::OpenOutputChannel() {
@@ -67,6 +136,8 @@ int OutputInfoProcess::OpenOutputChannel() {
   // open local file
   if (output_para_.mode == kOutputToLocal) {
     ret = OpenLocalFile();
+  } else if (output_para_.mode == kOutputToStdout) {
+    ret = OpenStdout();
   } else if (output_para_.mode == kOutputToPresenter) {
     // open channel of presenter
     ret = OpenPresenterChannel();
@@ -86,12 +157,33 @@ int OutputInfoProcess::SendToChannel(unsigned char *buf, int size) {
   return ret;
 }
 
+int OutputInfoProcess::SendToChannel(unsigned char *buf, int size,
+                                     const shared_ptr<void> &holder) {
+  // only stdout keeps referring to the buffer
+  if (output_para_.mode == kOutputToStdout) {
+    return stdout_writer_->Write(buf, size, holder);
+  }
+
+  return SendToChannel(buf, size);
+}
+
 int OutputInfoProcess::CloseChannel() {
   int ret = kOutputOk;
 
-  // close file handle
+  // flush and close local file
   if (output_para_.mode == kOutputToLocal) {
-    ret = fclose(file_desc_);
+    if (segment_writer_ != nullptr) {
+      ret = segment_writer_->Close();
+      delete segment_writer_;
+      segment_writer_ = nullptr;
+    }
+  } else if (output_para_.mode == kOutputToStdout) {
+    // wait until the reader has the frames spliced into the pipe
+    if (stdout_writer_ != nullptr) {
+      ret = stdout_writer_->Close();
+      delete stdout_writer_;
+      stdout_writer_ = nullptr;
+    }
   } else if (output_para_.mode == kOutputToPresenter) {
 
     // delete presenter channel
@@ -103,82 +195,99 @@ int OutputInfoProcess::CloseChannel() {
 }
 
 int OutputInfoProcess::OpenLocalFile() {
-  int ret = kOutputOk;
+  SegmentWriterPara writer_para;
+  writer_para.path = output_para_.path;
+  writer_para.max_segment_size = output_para_.segment_size;
+  writer_para.max_segment_duration = output_para_.segment_duration;
+  writer_para.direct_io = output_para_.direct_io;
+  writer_para.min_free_disk = kMinFreeDiskSpace;
 
   // open local file.
-  FILE *file_id_tmp = fopen(output_para_.path.data(), "wb+");
-  // failed to open file
-  if (file_id_tmp == nullptr) {
+  segment_writer_ = new SegmentWriter(writer_para);
+  int ret = segment_writer_->Init();
+  if (ret != kOutputOk) {
     ASC_LOG_ERROR("Failed to create file.");
-    ret = kOutputOpenLocalFileFail;
-  } else {  // success to open file.
-    file_desc_ = file_id_tmp;
-    ret = kOutputOk;
+    delete segment_writer_;
+    segment_writer_ = nullptr;
   }
 
   return ret;
 }
 
-int OutputInfoProcess::FreeDiskIsEnough() const {
-  // check file exist
-  if (access(output_para_.path.data(), F_OK) == kSystemCallReturnError) {
-    return kOutputLocalFileNoExist;
+int OutputInfoProcess::OpenStdout() {
+  // a pipe on stdout gets the frames by vmsplice, others by write
+  StdoutWriterPara writer_para;
+  stdout_writer_ = new StdoutWriter(writer_para);
+  int ret = stdout_writer_->Init();
+  if (ret != kOutputOk) {
+    delete stdout_writer_;
+    stdout_writer_ = nullptr;
   }
 
-  struct statfs disk_info = { 0 };
-  // get disk info of file path
-  if (kSystemCallReturnError == statfs(output_para_.path.data(), &disk_info)) {
-    return kOutputLocalFreeDiskCheckFail;
+  return ret;
+}
+
+bool OutputInfoProcess::IsKeyFrame(const unsigned char *buf, int size) const {
+  // every jpg image is a key frame
+  if (output_para_.presenter_para.content_type
+      == ascend::presenter::ContentType::kImage) {
+    return true;
   }
 
-  // get size of free disk
-  unsigned long long free_size = disk_info.f_bavail * disk_info.f_bsize;
-  // check free disk is enough
-  if (free_size <= kMinFreeDiskSpace) {
-    ASC_LOG_ERROR(
-        "Failed to write file,Disk space is less than 100M."
-        "free size of disk is %d", free_size);
-    return kOutputLocalFreeDiskNotEnough;
+  // search nal unit header behind every start code
+  int header = 0;
+  for (int pos = FindStartCode(buf, size, 0, &header); pos < size;
+      pos = FindStartCode(buf, size, header, &header)) {
+    unsigned char nal_type = buf[header] & kH264NalTypeMask;
+    if ((nal_type == kH264NalIdr) || (nal_type == kH264NalSps)) {
+      return true;
+    }
   }
 
-  return kOutputOk;
+  return false;
 }
 
 int OutputInfoProcess::OutputToLocal(unsigned char *buf, int size) {
-  int ret = kOutputOk;
-
-  // check the free disk is enough
-  ret = FreeDiskIsEnough();
-  if (kOutputOk != ret) {
-    return ret;
+  // a jpg image is one frame
+  if (output_para_.presenter_para.content_type
+      == ascend::presenter::ContentType::kImage) {
+    return segment_writer_->Write(buf, size, true);
   }
 
-  // write data to file
-  int file_write_size = fwrite(buf, sizeof(unsigned char), size, file_desc_);
-  if (file_write_size < size) {
-    ASC_LOG_ERROR(
-        "Failed to write file.we need to write %d byte,"
-        "but only write %d byte", file_write_size, size);
-    fclose(file_desc_);
-    return kOutputWriteFileFail;
+  // a h264 output holds a batch of frames, each gets its own index record.
+  // A frame ends where a nal unit of the next access unit starts
+  int frame_start = 0;
+  bool has_slice = false;
+  int header = 0;
+  for (int pos = FindStartCode(buf, size, 0, &header); pos < size;
+      pos = FindStartCode(buf, size, header, &header)) {
+    if (has_slice && IsFrameStart(buf, size, header)) {
+      int ret = segment_writer_->Write(
+          buf + frame_start, pos - frame_start,
+          IsKeyFrame(buf + frame_start, pos - frame_start));
+      if (ret != kOutputOk) {
+        return ret;
+      }
+
+      frame_start = pos;
+      has_slice = false;
+    }
+
+    unsigned char nal_type = buf[header] & kH264NalTypeMask;
+    if ((nal_type >= kH264NalSlice) && (nal_type <= kH264NalIdr)) {
+      has_slice = true;
+    }
   }
 
-  return kOutputOk;
+  // the last frame, or data without start code
+  return segment_writer_->Write(buf + frame_start, size - frame_start,
+                                IsKeyFrame(buf + frame_start,
+                                           size - frame_start));
 }
 
 int OutputInfoProcess::OutputToStdout(unsigned char *buf, int size) {
-  int ret = kOutputOk;
-
-  // write to stdout
-  ret = fwrite(buf, 1, size, stdout);
-  if (ret != size) {
-    ASC_LOG_ERROR(
-        "Failed to write to stdout.we need to write %d byte,"
-        "but only write %d byte", size, ret);
-    return kOutputWriteStdoutFail;
-  }
-
-  return kOutputOk;
+  // write to stdout, buf is copied as nobody holds it
+  return stdout_writer_->Write(buf, size, shared_ptr<void>());
 }
 
 int OutputInfoProcess::OpenPresenterChannel() {
@@ -246,6 +355,8 @@ int OutputInfoProcess::OutputToPresenter(unsigned char *buf, int size) {
 void OutputInfoProcess::PrintErrorInfo(int code) const {
   static ErrorDescription ouput_description[] = {
       { kOutputWriteStdoutFail, "Failed to write stdout." },
+      { kOutputOpenLocalFileFail, "Failed to create file." },
+      { kOutputMallocFail, "Failed to allocate memory." },
       { kOutputWriteFileFail, "Failed to write file." },
       { kOutputLocalFreeDiskCheckFail,
           "Failed to check free size of local disk." },
@@ -0,0 +1,413 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascendcamera/segment_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "securec.h"
+#include "ascenddk/ascendcamera/ascend_camera_common.h"
+#include "ascenddk/ascendcamera/output_info_process.h"
+
+using namespace std;
+
+namespace {
+// access mode of new segment files: rw-r--r--
+const mode_t kSegmentFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+
+// the segment sequence number in file name: <name>_0001<ext>
+const int kSegmentNameLength = 16;
+const char * const kSegmentNameFormat = "_%04d";
+
+// time unit conversion
+const long long kMillisecondPerSecond = 1000;
+const long long kMicrosecondPerSecond = 1000000;
+const long long kNanosecondPerMillisecond = 1000000;
+const long long kNanosecondPerMicrosecond = 1000;
+
+/**
+ * @brief get monotonic time
+ * @return time(unit: millisecond)
+ */
+long long GetMonotonicMs() {
+  struct timespec now = { 0, 0 };
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * kMillisecondPerSecond
+      + now.tv_nsec / kNanosecondPerMillisecond;
+}
+
+/**
+ * @brief get wall clock time
+ * @return time(unit: microsecond)
+ */
+int64_t GetRealtimeUs() {
+  struct timespec now = { 0, 0 };
+  clock_gettime(CLOCK_REALTIME, &now);
+  return now.tv_sec * kMicrosecondPerSecond
+      + now.tv_nsec / kNanosecondPerMicrosecond;
+}
+
+/**
+ * @brief write all data, retry on interrupt and partial write
+ * @param [in] fd: file descriptor
+ * @param [in] buf: data
+ * @param [in] size: size of data
+ * @return true: success; false: failed
+ */
+bool WriteAll(int fd, const char *buf, size_t size) {
+  while (size > 0) {
+    ssize_t ret = write(fd, buf, size);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    buf += ret;
+    size -= ret;
+  }
+
+  return true;
+}
+}
+
+namespace ascend {
+namespace ascendcamera {
+
+SegmentWriter::SegmentWriter(const SegmentWriterPara &para) {
+  para_ = para;
+}
+
+SegmentWriter::~SegmentWriter() {
+  Close();
+
+  if (buffer_ != nullptr) {
+    free(buffer_);
+    buffer_ = nullptr;
+  }
+}
+
+int SegmentWriter::Init() {
+  if (para_.path.empty() || (para_.write_buffer_size <= 0)
+      || (para_.write_buffer_size % kSegmentWriteAlign != 0)) {
+    ASC_LOG_ERROR("Invalid segment writer parameter, path:%s buffer size:%d.",
+                  para_.path.c_str(), para_.write_buffer_size);
+    return kOutputOpenLocalFileFail;
+  }
+
+  // aligned buffer, so that it can be written with O_DIRECT
+  void *buffer = nullptr;
+  if (posix_memalign(&buffer, kSegmentWriteAlign, para_.write_buffer_size)
+      != 0) {
+    ASC_LOG_ERROR("Failed to allocate write buffer, size:%d.",
+                  para_.write_buffer_size);
+    return kOutputMallocFail;
+  }
+  buffer_ = static_cast<char *>(buffer);
+
+  int ret = OpenSegment();
+  if (ret != kOutputOk) {
+    return ret;
+  }
+
+  return CheckFreeDisk();
+}
+
+int SegmentWriter::Write(const unsigned char *buf, int size,
+                         bool is_key_frame) {
+  if ((buf == nullptr) || (size <= 0) || (data_fd_ < 0)) {
+    ASC_LOG_ERROR("Failed to write file, size:%d fd:%d.", size, data_fd_);
+    return kOutputWriteFileFail;
+  }
+
+  // roll to a new segment
+  int ret = kOutputOk;
+  if (NeedNewSegment(size, is_key_frame)) {
+    ret = CloseSegment();
+    if (ret != kOutputOk) {
+      return ret;
+    }
+
+    ret = OpenSegment();
+    if (ret != kOutputOk) {
+      return ret;
+    }
+  }
+
+  ret = CheckFreeDisk();
+  if (ret != kOutputOk) {
+    return ret;
+  }
+
+  SegmentIndexRecord record = { segment_size_, static_cast<uint32_t>(size),
+      is_key_frame ? kSegmentKeyFrame : 0, GetRealtimeUs() };
+  pending_index_.push_back(record);
+  segment_size_ += size;
+
+  // copy to the buffer, write it when it is full
+  const unsigned char *data = buf;
+  int remain_size = size;
+  while (remain_size > 0) {
+    int copy_size = para_.write_buffer_size - buffer_used_;
+    if (copy_size > remain_size) {
+      copy_size = remain_size;
+    }
+
+    ret = memcpy_s(buffer_ + buffer_used_,
+                   para_.write_buffer_size - buffer_used_, data, copy_size);
+    if (ret != EOK) {
+      ASC_LOG_ERROR("Failed to copy frame to write buffer, ret:%d.", ret);
+      return kOutputWriteFileFail;
+    }
+
+    buffer_used_ += copy_size;
+    data += copy_size;
+    remain_size -= copy_size;
+
+    if (buffer_used_ == para_.write_buffer_size) {
+      ret = FlushBuffer(false);
+      if (ret != kOutputOk) {
+        return ret;
+      }
+    }
+  }
+
+  return kOutputOk;
+}
+
+int SegmentWriter::Close() {
+  if (data_fd_ < 0) {
+    return kOutputOk;
+  }
+
+  return CloseSegment();
+}
+
+int SegmentWriter::GetSegmentCount() const {
+  return segment_sequence_ + 1;
+}
+
+string SegmentWriter::GetSegmentPath(int sequence) const {
+  if (sequence == 0) {
+    return para_.path;
+  }
+
+  char number[kSegmentNameLength] = { 0 };
+  int ret = snprintf_s(number, sizeof(number), sizeof(number) - 1,
+                       kSegmentNameFormat, sequence);
+  if (ret < 0) {
+    return para_.path;
+  }
+
+  // insert the sequence number before the extension of file name
+  string::size_type slash = para_.path.find_last_of('/');
+  string::size_type dot = para_.path.find_last_of('.');
+  if ((dot == string::npos) || ((slash != string::npos) && (dot < slash))) {
+    return para_.path + number;
+  }
+
+  return para_.path.substr(0, dot) + number + para_.path.substr(dot);
+}
+
+int SegmentWriter::OpenSegment() {
+  int sequence = segment_sequence_ + 1;
+  string path = GetSegmentPath(sequence);
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  if (para_.direct_io) {
+    data_fd_ = open(path.c_str(), flags | O_DIRECT, kSegmentFileMode);
+
+    // the file system does not support O_DIRECT, use page cache
+    if ((data_fd_ < 0) && (errno == EINVAL)) {
+      ASC_LOG_WARN("%s does not support direct io, use buffered io.",
+                   path.c_str());
+      para_.direct_io = false;
+    }
+  }
+
+  if (!para_.direct_io) {
+    data_fd_ = open(path.c_str(), flags, kSegmentFileMode);
+  }
+
+  if (data_fd_ < 0) {
+    ASC_LOG_ERROR("Failed to create file %s, errno:%d.", path.c_str(), errno);
+    return kOutputOpenLocalFileFail;
+  }
+
+  string index_path = path + kSegmentIndexSuffix;
+  index_fd_ = open(index_path.c_str(), flags, kSegmentFileMode);
+  if (index_fd_ < 0) {
+    ASC_LOG_ERROR("Failed to create file %s, errno:%d.", index_path.c_str(),
+                  errno);
+    close(data_fd_);
+    data_fd_ = -1;
+    return kOutputOpenLocalFileFail;
+  }
+
+  SegmentIndexHeader header = { kSegmentIndexMagic, kSegmentIndexVersion,
+      sizeof(SegmentIndexRecord), 0 };
+  if (!WriteAll(index_fd_, reinterpret_cast<const char *>(&header),
+                sizeof(header))) {
+    ASC_LOG_ERROR("Failed to write file %s, errno:%d.", index_path.c_str(),
+                  errno);
+    close(index_fd_);
+    close(data_fd_);
+    index_fd_ = -1;
+    data_fd_ = -1;
+    return kOutputWriteFileFail;
+  }
+
+  segment_sequence_ = sequence;
+  segment_size_ = 0;
+  written_size_ = 0;
+  segment_start_time_ = GetMonotonicMs();
+
+  ASC_LOG_INFO("Open segment %s.", path.c_str());
+  return kOutputOk;
+}
+
+int SegmentWriter::CloseSegment() {
+  int ret = FlushBuffer(true);
+
+  close(index_fd_);
+  close(data_fd_);
+  index_fd_ = -1;
+  data_fd_ = -1;
+  pending_index_.clear();
+
+  return ret;
+}
+
+bool SegmentWriter::NeedNewSegment(int size, bool is_key_frame) const {
+  // never split a gop, and never leave a segment empty
+  if (!is_key_frame || (segment_size_ == 0)) {
+    return false;
+  }
+
+  if ((para_.max_segment_size != 0)
+      && (segment_size_ + size > para_.max_segment_size)) {
+    return true;
+  }
+
+  return (para_.max_segment_duration != 0)
+      && (GetMonotonicMs() - segment_start_time_
+          >= para_.max_segment_duration);
+}
+
+int SegmentWriter::FlushBuffer(bool is_last) {
+  // O_DIRECT needs aligned size, the tail of a segment is written through
+  // the page cache
+  int direct_size = buffer_used_;
+  if (para_.direct_io && is_last) {
+    direct_size = buffer_used_ / kSegmentWriteAlign * kSegmentWriteAlign;
+  }
+
+  if (!WriteAll(data_fd_, buffer_, direct_size)) {
+    ASC_LOG_ERROR("Failed to write file, size:%d errno:%d.", direct_size,
+                  errno);
+    return kOutputWriteFileFail;
+  }
+
+  if (direct_size < buffer_used_) {
+    int flags = fcntl(data_fd_, F_GETFL);
+    if ((flags == -1) || (fcntl(data_fd_, F_SETFL, flags & ~O_DIRECT) == -1)
+        || !WriteAll(data_fd_, buffer_ + direct_size,
+                     buffer_used_ - direct_size)) {
+      ASC_LOG_ERROR("Failed to write file tail, size:%d errno:%d.",
+                    buffer_used_ - direct_size, errno);
+      return kOutputWriteFileFail;
+    }
+  }
+
+  written_size_ += buffer_used_;
+  buffer_used_ = 0;
+
+  // the index records of frames completely in the file
+  vector<SegmentIndexRecord>::size_type count = 0;
+  while ((count < pending_index_.size())
+      && (pending_index_[count].offset + pending_index_[count].size
+          <= written_size_)) {
+    count++;
+  }
+
+  if (count == 0) {
+    return kOutputOk;
+  }
+
+  if (!WriteAll(index_fd_, reinterpret_cast<const char *>(&pending_index_[0]),
+                count * sizeof(SegmentIndexRecord))) {
+    ASC_LOG_ERROR("Failed to write index file, errno:%d.", errno);
+    return kOutputWriteFileFail;
+  }
+
+  pending_index_.erase(pending_index_.begin(), pending_index_.begin() + count);
+  return kOutputOk;
+}
+
+int SegmentWriter::CheckFreeDisk() {
+  long long now = GetMonotonicMs();
+  if ((disk_check_time_ != 0)
+      && (now - disk_check_time_ < para_.disk_check_interval)) {
+    return kOutputOk;
+  }
+  disk_check_time_ = now;
+
+  struct statfs disk_info;
+  if (fstatfs(data_fd_, &disk_info) != 0) {
+    ASC_LOG_ERROR("Failed to get disk info, errno:%d.", errno);
+    return kOutputLocalFreeDiskCheckFail;
+  }
+
+  // get size of free disk
+  unsigned long long free_size = static_cast<unsigned long long>(
+      disk_info.f_bavail) * disk_info.f_bsize;
+  if (free_size <= para_.min_free_disk) {
+    ASC_LOG_ERROR("Failed to write file, free size of disk is %llu.",
+                  free_size);
+    return kOutputLocalFreeDiskNotEnough;
+  }
+
+  return kOutputOk;
+}
+}
+}
@@ -0,0 +1,256 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascendcamera/stdout_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "ascenddk/ascendcamera/ascend_camera_common.h"
+#include "ascenddk/ascendcamera/output_info_process.h"
+
+using namespace std;
+
+namespace {
+// interval of checking the pipe while draining it(unit: microsecond)
+const int kDrainCheckInterval = 10000;
+
+// 1 millisecond = 1000 microsecond
+const int kMicrosecondPerMillisecond = 1000;
+
+/**
+ * @brief write all data, retry on interrupt and partial write
+ * @param [in] fd: file descriptor
+ * @param [in] buf: data
+ * @param [in] size: size of data
+ * @return true: success; false: failed
+ */
+bool WriteAll(int fd, const unsigned char *buf, size_t size) {
+  while (size > 0) {
+    ssize_t ret = write(fd, buf, size);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    buf += ret;
+    size -= ret;
+  }
+
+  return true;
+}
+}
+
+namespace ascend {
+namespace ascendcamera {
+
+StdoutWriter::StdoutWriter(const StdoutWriterPara &para) {
+  para_ = para;
+}
+
+StdoutWriter::~StdoutWriter() {
+  Close();
+}
+
+int StdoutWriter::Init() {
+  struct stat file_stat;
+  if (fstat(para_.fd, &file_stat) != 0) {
+    ASC_LOG_ERROR("Failed to get status of stdout, errno:%d.", errno);
+    return kOutputWriteStdoutFail;
+  }
+
+  // a terminal or a file is written
+  if (!S_ISFIFO(file_stat.st_mode) || !para_.enable_vmsplice) {
+    ASC_LOG_INFO("Write stdout without splice.");
+    return kOutputOk;
+  }
+
+  // a larger pipe lets the reader fall behind by more frames, it is only a
+  // wish: pipe-max-size may be smaller for an unprivileged user
+  if (para_.pipe_size > 0) {
+    int pipe_size = fcntl(para_.fd, F_GETPIPE_SZ);
+    if ((pipe_size < para_.pipe_size)
+        && (fcntl(para_.fd, F_SETPIPE_SZ, para_.pipe_size) < 0)) {
+      ASC_LOG_WARN("Failed to set pipe size of stdout to %d, errno:%d.",
+                   para_.pipe_size, errno);
+    }
+  }
+
+  is_spliced_ = true;
+  ASC_LOG_INFO("Stdout is a pipe of %d byte, splice frames into it.",
+               fcntl(para_.fd, F_GETPIPE_SZ));
+  return kOutputOk;
+}
+
+int StdoutWriter::Write(const unsigned char *buf, int size,
+                        const shared_ptr<void> &holder) {
+  if ((buf == nullptr) || (size <= 0)) {
+    return kOutputOk;
+  }
+
+  if (!is_spliced_ || (holder == nullptr)) {
+    if (!WriteAll(para_.fd, buf, size)) {
+      ASC_LOG_ERROR("Failed to write to stdout, size:%d errno:%d.", size,
+                    errno);
+      return kOutputWriteStdoutFail;
+    }
+
+    total_written_ += size;
+    ReleaseConsumed();
+    return kOutputOk;
+  }
+
+  // the pipe refers to every page spliced so far, so the frame is held even
+  // if splicing stops halfway
+  int spliced = 0;
+  int ret = SpliceAll(buf, size, spliced);
+  if (spliced > 0) {
+    total_written_ += spliced;
+    held_frames_.push_back(make_pair(total_written_, holder));
+  }
+
+  if (ret != kOutputOk) {
+    return ret;
+  }
+
+  ReleaseConsumed();
+  return kOutputOk;
+}
+
+int StdoutWriter::SpliceAll(const unsigned char *buf, int size,
+                            int &spliced) {
+  struct iovec iov;
+  iov.iov_base = const_cast<unsigned char *>(buf);
+  iov.iov_len = size;
+  spliced = 0;
+
+  // blocks while the pipe is full, like write()
+  while (iov.iov_len > 0) {
+    ssize_t ret = vmsplice(para_.fd, &iov, 1, 0);
+    if (ret >= 0) {
+      iov.iov_base = static_cast<unsigned char *>(iov.iov_base) + ret;
+      iov.iov_len -= ret;
+      spliced += ret;
+      continue;
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+
+    // the kernel can not splice, write the rest and stop splicing
+    if ((errno == EINVAL) || (errno == ENOSYS)) {
+      ASC_LOG_WARN("Failed to splice into stdout, errno:%d, write instead.",
+                   errno);
+      is_spliced_ = false;
+      if (WriteAll(para_.fd, static_cast<unsigned char *>(iov.iov_base),
+                   iov.iov_len)) {
+        spliced = size;
+        return kOutputOk;
+      }
+    }
+
+    ASC_LOG_ERROR("Failed to splice into stdout, size:%d spliced:%d "
+                  "errno:%d.", size, spliced, errno);
+    return kOutputWriteStdoutFail;
+  }
+
+  return kOutputOk;
+}
+
+void StdoutWriter::ReleaseConsumed() {
+  if (held_frames_.empty()) {
+    return;
+  }
+
+  // bytes in front of the unread ones have been read
+  int unread = 0;
+  if (ioctl(para_.fd, FIONREAD, &unread) != 0) {
+    return;
+  }
+
+  uint64_t consumed = total_written_ - unread;
+  while (!held_frames_.empty() && (held_frames_.front().first <= consumed)) {
+    held_frames_.pop_front();
+  }
+}
+
+int StdoutWriter::Close() {
+  // the pipe references the spliced frames until the reader has them, they
+  // are released only when the pipe is drained or the reader is gone
+  int wait_time = 0;
+  bool is_warned = false;
+  while (!held_frames_.empty()) {
+    ReleaseConsumed();
+    if (held_frames_.empty() || IsReaderClosed()) {
+      break;
+    }
+
+    if (!is_warned
+        && (wait_time >= kStdoutDrainTimeout * kMicrosecondPerMillisecond)) {
+      ASC_LOG_WARN("The reader of stdout did not drain the pipe in %dms, "
+                   "%zu frames are still held.", kStdoutDrainTimeout,
+                   held_frames_.size());
+      is_warned = true;
+    }
+
+    usleep(kDrainCheckInterval);
+    wait_time += kDrainCheckInterval;
+  }
+
+  held_frames_.clear();
+  return kOutputOk;
+}
+
+bool StdoutWriter::IsReaderClosed() const {
+  // the write end of a pipe reports POLLERR once every read end is closed
+  struct pollfd poll_fd;
+  poll_fd.fd = para_.fd;
+  poll_fd.events = 0;
+  poll_fd.revents = 0;
+  return (poll(&poll_fd, 1, 0) > 0)
+      && ((poll_fd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0);
+}
+
+bool StdoutWriter::IsSpliced() const {
+  return is_spliced_;
+}
+}
+}
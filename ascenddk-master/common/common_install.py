@@ -53,6 +53,9 @@ CURRENT_PATH = os.path.dirname(
 INSTALLED_SO_FILE = [{"makefile_path": os.path.join(CURRENT_PATH, "presenter/agent"),
                        "engine_setting": "-lpresenteragent \\",
                        "so_file" : os.path.join(CURRENT_PATH, "presenter/agent/out/libpresenteragent.so")},
+                      {"makefile_path": os.path.join(CURRENT_PATH, "utils/ascend_utils"),
+                       "engine_setting": "-lascend_utils \\",
+                       "so_file" : os.path.join(CURRENT_PATH, "utils/ascend_utils/out/libascend_utils.so")},
                       {"makefile_path": os.path.join(CURRENT_PATH, "utils/ascend_ezdvpp"),
                        "engine_setting": "-lascend_ezdvpp \\",
                        "so_file" : os.path.join(CURRENT_PATH, "utils/ascend_ezdvpp/out/libascend_ezdvpp.so")}]
@@ -629,6 +629,62 @@ class Test_VideoAnalysisServer(unittest.TestCase):
         ret = server._process_human_inference_result(None, b'xxx')
         self.assertEqual(ret, False)
 
+    @patch("video_analysis.src.video_analysis_server.VideoAnalysisServer._save_inference_result")
+    @patch("video_analysis.src.video_analysis_server.VideoAnalysisServer._parse_protobuf")
+    @patch("video_analysis.src.video_analysis_server.VideoAnalysisServer.send_message", return_value=True)
+    def test_process_frame_analysis_result(self, mock1, mock2, mock3):
+        server = Test_VideoAnalysisServer.server
+        def parse_protobuf(request, msg_data):
+            return False
+
+        def _parse_protobuf_1(request, msg_data):
+            request.image_set.frame_index.app_id = "nonexist_app"
+            return True
+
+        def _parse_protobuf_2(request, msg_data):
+            request.image_set.ParseFromString(protobuf_image_request(FRAME_ID))
+            car_result = request.car_result.add()
+            car_result.object_id = "car_1"
+            car_result.type = 100
+            return True
+
+        def _parse_protobuf_3(request, msg_data):
+            request.image_set.ParseFromString(protobuf_image_request(FRAME_ID))
+            car_result = request.car_result.add()
+            car_result.ParseFromString(
+                protobuf_car_color_inference("car_1", FRAME_ID))
+            car_result = request.car_result.add()
+            car_result.ParseFromString(
+                protobuf_car_brand_inference("car_1", FRAME_ID))
+            human_result = request.human_result.add()
+            human_result.ParseFromString(
+                protobuf_human_property_inference("person_1", FRAME_ID))
+            return True
+
+        mock2.side_effect = parse_protobuf
+        ret = server._process_frame_analysis_result(None, b'xxx')
+        self.assertEqual(ret, False)
+
+        mock2.side_effect = _parse_protobuf_1
+        ret = server._process_frame_analysis_result(None, b'xxx')
+        self.assertEqual(ret, False)
+
+        mock2.side_effect = _parse_protobuf_2
+        ret = server._process_frame_analysis_result(None, b'xxx')
+        self.assertEqual(ret, False)
+
+        # the results of an object are saved together with its image
+        mock2.side_effect = _parse_protobuf_3
+        mock3.return_value = False
+        ret = server._process_frame_analysis_result(None, b'xxx')
+        self.assertEqual(ret, False)
+        inference_dict = mock3.call_args_list[0][0][1]
+        self.assertEqual(inference_dict["color"], "blue")
+        self.assertEqual(inference_dict["brand"], "BMW")
+
+        # no response is sent for the message
+        self.assertEqual(mock1.call_count, 0)
+
     @patch("os.path.isdir", side_effect=mock_oserr)
     def test_save_image_fail(self, mock):
         server = Test_VideoAnalysisServer.server
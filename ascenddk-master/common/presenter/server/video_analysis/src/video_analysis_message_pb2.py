@@ -52,7 +52,7 @@ DESCRIPTOR = _descriptor.FileDescriptor(
   name='video_analysis_message.proto',
   package='ascend.presenter.video_analysis',
   syntax='proto3',
-  serialized_pb=_b('\n\x1cvideo_analysis_message.proto\x12\x1f\x61scend.presenter.video_analysis\"\'\n\x0bRegisterApp\x12\n\n\x02id\x18\x01 \x01(\t\x12\x0c\n\x04type\x18\x02 \x01(\t\"Z\n\x0e\x43ommonResponse\x12\x37\n\x03ret\x18\x01 \x01(\x0e\x32*.ascend.presenter.video_analysis.ErrorCode\x12\x0f\n\x07message\x18\x02 \x01(\t\"X\n\nFrameIndex\x12\x0e\n\x06\x61pp_id\x18\x01 \x01(\t\x12\x12\n\nchannel_id\x18\x02 \x01(\t\x12\x14\n\x0c\x63hannel_name\x18\x03 \x01(\t\x12\x10\n\x08\x66rame_id\x18\x04 \x01(\t\"7\n\x06Object\x12\n\n\x02id\x18\x01 \x01(\t\x12\x12\n\nconfidence\x18\x02 \x01(\x02\x12\r\n\x05image\x18\x03 \x01(\x0c\"\x9a\x01\n\x08ImageSet\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x13\n\x0b\x66rame_image\x18\x02 \x01(\x0c\x12\x37\n\x06object\x18\x03 \x03(\x0b\x32\'.ascend.presenter.video_analysis.Object\"\xcd\x01\n\x12\x43\x61rInferenceResult\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x11\n\tobject_id\x18\x02 \x01(\t\x12?\n\x04type\x18\x03 \x01(\x0e\x32\x31.ascend.presenter.video_analysis.CarInferenceType\x12\x12\n\nconfidence\x18\x04 \x01(\x02\x12\r\n\x05value\x18\x05 \x01(\t\"%\n\x07MapType\x12\x0b\n\x03key\x18\x01 \x01(\t\x12\r\n\x05value\x18\x02 \x01(\x02\"\xad\x01\n\x14HumanInferenceResult\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x11\n\tobject_id\x18\x02 \x01(\t\x12@\n\x0ehuman_property\x18\x03 \x03(\x0b\x32(.ascend.presenter.video_analysis.MapType*\xdf\x01\n\tErrorCode\x12\x0e\n\nkErrorNone\x10\x00\x12\x1a\n\x16kErrorAppRegisterExist\x10\x01\x12\x1e\n\x1akErrorAppRegisterNoStorage\x10\x02\x12\x19\n\x15kErrorAppRegisterType\x10\x03\x12\x1a\n\x16kErrorAppRegisterLimit\x10\x04\x12\x13\n\x0fkErrorAppDelete\x10\x05\x12\x11\n\rkErrorAppLost\x10\x06\x12\x16\n\x12kErrorStorageLimit\x10\x07\x12\x0f\n\x0bkErrorOther\x10\x08*0\n\x10\x43\x61rInferenceType\x12\r\n\tkCarColor\x10\x00\x12\r\n\tkCarBrand\x10\x01\x62\x06proto3')
+  serialized_pb=_b('\n\x1cvideo_analysis_message.proto\x12\x1f\x61scend.presenter.video_analysis\"\'\n\x0bRegisterApp\x12\n\n\x02id\x18\x01 \x01(\t\x12\x0c\n\x04type\x18\x02 \x01(\t\"Z\n\x0e\x43ommonResponse\x12\x37\n\x03ret\x18\x01 \x01(\x0e\x32*.ascend.presenter.video_analysis.ErrorCode\x12\x0f\n\x07message\x18\x02 \x01(\t\"X\n\nFrameIndex\x12\x0e\n\x06\x61pp_id\x18\x01 \x01(\t\x12\x12\n\nchannel_id\x18\x02 \x01(\t\x12\x14\n\x0c\x63hannel_name\x18\x03 \x01(\t\x12\x10\n\x08\x66rame_id\x18\x04 \x01(\t\"7\n\x06Object\x12\n\n\x02id\x18\x01 \x01(\t\x12\x12\n\nconfidence\x18\x02 \x01(\x02\x12\r\n\x05image\x18\x03 \x01(\x0c\"\x9a\x01\n\x08ImageSet\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x13\n\x0b\x66rame_image\x18\x02 \x01(\x0c\x12\x37\n\x06object\x18\x03 \x03(\x0b\x32\'.ascend.presenter.video_analysis.Object\"\xcd\x01\n\x12\x43\x61rInferenceResult\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x11\n\tobject_id\x18\x02 \x01(\t\x12?\n\x04type\x18\x03 \x01(\x0e\x32\x31.ascend.presenter.video_analysis.CarInferenceType\x12\x12\n\nconfidence\x18\x04 \x01(\x02\x12\r\n\x05value\x18\x05 \x01(\t\"%\n\x07MapType\x12\x0b\n\x03key\x18\x01 \x01(\t\x12\r\n\x05value\x18\x02 \x01(\x02\"\xad\x01\n\x14HumanInferenceResult\x12@\n\x0b\x66rame_index\x18\x01 \x01(\x0b\x32+.ascend.presenter.video_analysis.FrameIndex\x12\x11\n\tobject_id\x18\x02 \x01(\t\x12@\n\x0ehuman_property\x18\x03 \x03(\x0b\x32(.ascend.presenter.video_analysis.MapType\"\xe9\x01\n\x13\x46rameAnalysisResult\x12<\n\timage_set\x18\x01 \x01(\x0b\x32).ascend.presenter.video_analysis.ImageSet\x12G\n\ncar_result\x18\x02 \x03(\x0b\x32\x33.ascend.presenter.video_analysis.CarInferenceResult\x12K\n\x0chuman_result\x18\x03 \x03(\x0b\x32\x35.ascend.presenter.video_analysis.HumanInferenceResult*\xdf\x01\n\tErrorCode\x12\x0e\n\nkErrorNone\x10\x00\x12\x1a\n\x16kErrorAppRegisterExist\x10\x01\x12\x1e\n\x1akErrorAppRegisterNoStorage\x10\x02\x12\x19\n\x15kErrorAppRegisterType\x10\x03\x12\x1a\n\x16kErrorAppRegisterLimit\x10\x04\x12\x13\n\x0fkErrorAppDelete\x10\x05\x12\x11\n\rkErrorAppLost\x10\x06\x12\x16\n\x12kErrorStorageLimit\x10\x07\x12\x0f\n\x0bkErrorOther\x10\x08*0\n\x10\x43\x61rInferenceType\x12\r\n\tkCarColor\x10\x00\x12\r\n\tkCarBrand\x10\x01\x62\x06proto3')
 )
 
 _ERRORCODE = _descriptor.EnumDescriptor(
@@ -100,8 +100,8 @@ _ERRORCODE = _descriptor.EnumDescriptor(
   ],
   containing_type=None,
   options=None,
-  serialized_start=926,
-  serialized_end=1149,
+  serialized_start=1162,
+  serialized_end=1385,
 )
 _sym_db.RegisterEnumDescriptor(_ERRORCODE)
 
@@ -123,8 +123,8 @@ _CARINFERENCETYPE = _descriptor.EnumDescriptor(
   ],
   containing_type=None,
   options=None,
-  serialized_start=1151,
-  serialized_end=1199,
+  serialized_start=1387,
+  serialized_end=1435,
 )
 _sym_db.RegisterEnumDescriptor(_CARINFERENCETYPE)
 
@@ -502,6 +502,51 @@ _HUMANINFERENCERESULT = _descriptor.Descriptor(
   serialized_end=923,
 )
 
+
+_FRAMEANALYSISRESULT = _descriptor.Descriptor(
+  name='FrameAnalysisResult',
+  full_name='ascend.presenter.video_analysis.FrameAnalysisResult',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='image_set', full_name='ascend.presenter.video_analysis.FrameAnalysisResult.image_set', index=0,
+      number=1, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None, file=DESCRIPTOR),
+    _descriptor.FieldDescriptor(
+      name='car_result', full_name='ascend.presenter.video_analysis.FrameAnalysisResult.car_result', index=1,
+      number=2, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None, file=DESCRIPTOR),
+    _descriptor.FieldDescriptor(
+      name='human_result', full_name='ascend.presenter.video_analysis.FrameAnalysisResult.human_result', index=2,
+      number=3, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None, file=DESCRIPTOR),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto3',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=926,
+  serialized_end=1159,
+)
+
 _COMMONRESPONSE.fields_by_name['ret'].enum_type = _ERRORCODE
 _IMAGESET.fields_by_name['frame_index'].message_type = _FRAMEINDEX
 _IMAGESET.fields_by_name['object'].message_type = _OBJECT
@@ -509,6 +554,9 @@ _CARINFERENCERESULT.fields_by_name['frame_index'].message_type = _FRAMEINDEX
 _CARINFERENCERESULT.fields_by_name['type'].enum_type = _CARINFERENCETYPE
 _HUMANINFERENCERESULT.fields_by_name['frame_index'].message_type = _FRAMEINDEX
 _HUMANINFERENCERESULT.fields_by_name['human_property'].message_type = _MAPTYPE
+_FRAMEANALYSISRESULT.fields_by_name['image_set'].message_type = _IMAGESET
+_FRAMEANALYSISRESULT.fields_by_name['car_result'].message_type = _CARINFERENCERESULT
+_FRAMEANALYSISRESULT.fields_by_name['human_result'].message_type = _HUMANINFERENCERESULT
 DESCRIPTOR.message_types_by_name['RegisterApp'] = _REGISTERAPP
 DESCRIPTOR.message_types_by_name['CommonResponse'] = _COMMONRESPONSE
 DESCRIPTOR.message_types_by_name['FrameIndex'] = _FRAMEINDEX
@@ -517,6 +565,7 @@ DESCRIPTOR.message_types_by_name['ImageSet'] = _IMAGESET
 DESCRIPTOR.message_types_by_name['CarInferenceResult'] = _CARINFERENCERESULT
 DESCRIPTOR.message_types_by_name['MapType'] = _MAPTYPE
 DESCRIPTOR.message_types_by_name['HumanInferenceResult'] = _HUMANINFERENCERESULT
+DESCRIPTOR.message_types_by_name['FrameAnalysisResult'] = _FRAMEANALYSISRESULT
 DESCRIPTOR.enum_types_by_name['ErrorCode'] = _ERRORCODE
 DESCRIPTOR.enum_types_by_name['CarInferenceType'] = _CARINFERENCETYPE
 _sym_db.RegisterFileDescriptor(DESCRIPTOR)
@@ -577,5 +626,12 @@ HumanInferenceResult = _reflection.GeneratedProtocolMessageType('HumanInferenceR
   ))
 _sym_db.RegisterMessage(HumanInferenceResult)
 
+FrameAnalysisResult = _reflection.GeneratedProtocolMessageType('FrameAnalysisResult', (_message.Message,), dict(
+  DESCRIPTOR = _FRAMEANALYSISRESULT,
+  __module__ = 'video_analysis_message_pb2'
+  # @@protoc_insertion_point(class_scope:ascend.presenter.video_analysis.FrameAnalysisResult)
+  ))
+_sym_db.RegisterMessage(FrameAnalysisResult)
+
 
 # @@protoc_insertion_point(module_scope)
@@ -104,6 +104,8 @@ class VideoAnalysisServer(PresenterSocketServer):
             ret = self._process_car_inference_result(conn, msg_data)
         elif msg_name == pb2._HUMANINFERENCERESULT.full_name:
             ret = self._process_human_inference_result(conn, msg_data)
+        elif msg_name == pb2._FRAMEANALYSISRESULT.full_name:
+            ret = self._process_frame_analysis_result(conn, msg_data)
         elif msg_name == presenter_message_pb2._HEARTBEATMESSAGE.full_name:
             ret = self._process_heartbeat(conn)
         # process image request, receive an image data from presenter agent
@@ -212,60 +214,113 @@ class VideoAnalysisServer(PresenterSocketServer):
             self._response_error_unknown(conn)
             return False
 
-        app_id = request.frame_index.app_id
-        channel_id = request.frame_index.channel_id
-        channel_name = request.frame_index.channel_name
-        frame_id = request.frame_index.frame_id
-        frame_image = request.frame_image
+        ret, message = self._save_image_set(conn, request, {})
+        if ret == pb2.kErrorOther:
+            self._response_error_unknown(conn)
+            return False
+
+        response.ret = ret
+        response.message = message
+        self.send_message(conn, response, msg_name)
+        return ret == pb2.kErrorNone
+
+    def _process_frame_analysis_result(self, conn, msg_data):
+        '''
+        Description: process frame_analysis_result message, which carries
+            the image set and all the inference results of a frame. The
+            agent sends it without waiting, so no response is sent back and
+            an error closes the connection.
+        Input:
+            conn: a socket connection
+            msg_data: message data.
+        Returns: True or False
+        '''
+        request = pb2.FrameAnalysisResult()
+        if not self._parse_protobuf(request, msg_data):
+            return False
+
+        # merge the results of an object, so its json is written once
+        inference_dicts = {}
+        for car in request.car_result:
+            inference_dict = inference_dicts.setdefault(car.object_id, {})
+            if car.type == pb2.kCarColor:
+                inference_dict["color_confidence"] = car.confidence
+                inference_dict["color"] = car.value
+            elif car.type == pb2.kCarBrand:
+                inference_dict["brand_confidence"] = car.confidence
+                inference_dict["brand"] = car.value
+            else:
+                logging.error("unknown type %d", car.type)
+                return False
+
+        for human in request.human_result:
+            inference_dict = inference_dicts.setdefault(human.object_id, {})
+            inference_dict["property"] = {}
+            for item in human.human_property:
+                inference_dict["property"][item.key] = item.value
+
+        ret, message = self._save_image_set(conn, request.image_set,
+                                            inference_dicts)
+        if ret != pb2.kErrorNone:
+            logging.error("frame analysis result process failed: %s", message)
+            return False
+        return True
+
+    def _save_image_set(self, conn, image_set, inference_dicts):
+        '''
+        Description: save the frame image, the object images and the
+            inference results of the objects in an image set
+        Input:
+            conn: a socket connection
+            image_set: ImageSet message
+            inference_dicts: inference results of the objects by object id
+        Returns: error code and message, kErrorOther for unknown error
+        '''
+        app_id = image_set.frame_index.app_id
+        channel_id = image_set.frame_index.channel_id
+        channel_name = image_set.frame_index.channel_name
+        frame_id = image_set.frame_index.frame_id
+        frame_image = image_set.frame_image
 
         if not self.app_manager.is_app_exist(app_id):
             logging.error("app_id: %s not exist", app_id)
-            response.ret = pb2.kErrorAppLost
-            response.message = "app_id: %s not exist"%(app_id)
-            self.send_message(conn, response, msg_name)
-            return False
+            return pb2.kErrorAppLost, "app_id: %s not exist"%(app_id)
 
         frame_num = self.app_manager.get_frame_num(app_id, channel_id)
         if frame_num % CHECK_INTERCAL == 0:
             if self._remain_space() <= self.reserved_space:
                 logging.error("Insufficient storage space on Server.")
-                response.ret = pb2.kErrorStorageLimit
-                response.message = "Insufficient storage space on Server."
-                self.send_message(conn, response, msg_name)
-                return False
+                return pb2.kErrorStorageLimit, \
+                    "Insufficient storage space on Server."
 
         stack_index = frame_num // MAX_SUB_DIRECTORY_NUM
         stack_directory = "stack_{}/".format(stack_index)
         frame = stack_directory + frame_id
         frame_dir = os.path.join(self.storage_dir, app_id, channel_id, frame)
         if not self._save_image(frame_dir, frame_image):
-            self._response_error_unknown(conn)
             logging.error("save_image: %s error.", frame_dir)
-            return False
+            return pb2.kErrorOther, "save image: %s error"%(frame_dir)
 
         app_dir = os.path.join(self.storage_dir, app_id)
         self._save_channel_name(app_dir, channel_id, channel_name)
 
-        for i in request.object:
+        for i in image_set.object:
             object_id = i.id
             object_confidence = i.confidence
             object_image = i.image
             object_dir = os.path.join(frame_dir, object_id)
             inference_dict = {"confidence" : object_confidence}
+            inference_dict.update(inference_dicts.get(object_id, {}))
 
             if not self._save_image(object_dir, object_image) or \
               not self._save_inference_result(object_dir, inference_dict):
-                self._response_error_unknown(conn)
                 logging.error("save image: %s error.", object_dir)
-                return False
+                return pb2.kErrorOther, "save image: %s error"%(object_dir)
 
         self.app_manager.increase_frame_num(app_id, channel_id)
 
         self.app_manager.set_heartbeat(conn.fileno())
-        response.ret = pb2.kErrorNone
-        response.message = "image set process succeed"
-        self.send_message(conn, response, msg_name)
-        return True
+        return pb2.kErrorNone, "image set process succeed"
 
     def _process_car_inference_result(self, conn, msg_data):
         '''
@@ -0,0 +1,396 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "bench_backend.h"
+
+#include <malloc.h>
+#include <math.h>
+
+#ifdef EZDVPP_BENCH_CPU_ONLY
+#include "ascenddk/ascend_ezdvpp/dvpp_utils.h"
+#else
+#include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#endif
+
+using namespace std;
+
+namespace {
+// number of planes of yuv420sp output: y plane and interleaved uv plane
+const int kYuv420SPMolecule = DVPP_YUV420SP_SIZE_MOLECULE;
+const int kYuv420SPDenominator = DVPP_YUV420SP_SIZE_DENOMINATOR;
+
+// memory size of a yuv422sp/yuv444sp image relative to width * height
+const int kYuv422SPSizeMul = 2;
+const int kYuv444SPSizeMul = 3;
+
+// pixel bit depth passed to vpc
+const int kBenchBitWidth = 8;
+
+// vpc input path: rdma
+const int kBenchRdma = 1;
+
+// jpg encode quality
+const int kBenchJpegLevel = 100;
+
+// increase of bgr to yuv conversion: no resize
+const double kBenchNoIncrease = 1.0;
+}
+
+namespace ascend {
+namespace utils {
+namespace bench {
+
+int GetImageSize(int image_type, const ResolutionRatio &resolution) {
+  int pixels = resolution.width * resolution.height;
+
+  switch (image_type) {
+    case kVpcYuv420SemiPlannar:
+    case kVpcYuv400SemiPlannar:
+      return pixels * kYuv420SPMolecule / kYuv420SPDenominator;
+    case kVpcYuv422SemiPlannar:
+      return pixels * kYuv422SPSizeMul;
+    case kVpcYuv444SemiPlannar:
+      return pixels * kYuv444SPSizeMul;
+    case kVpcYuv422Packed:
+      return pixels * kYuv422PackedWidthMul;
+    case kVpcYuv444Packed:
+      return pixels * kYuv444PackedWidthMul;
+    case kVpcRgb888Packed:
+      return pixels * kRgb888WidthMul;
+    case kVpcXrgb8888Packed:
+      return pixels * kXrgb888WidthMul;
+    default:
+      return 0;
+  }
+}
+
+void FillTestImage(vector<char> &buffer) {
+  // a cheap pseudo random pattern, so that jpg and h264 encoders do not take
+  // a constant image fast path
+  uint32_t seed = 0x2545F491;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    seed = seed * 1103515245 + 12345;
+    buffer[i] = (char) (((i & 0xff) + (seed >> 28)) & 0xff);
+  }
+}
+
+void SplitRoi(const BenchCase &bench_case,
+              vector<DvppCropOrResizePara> &rois) {
+  rois.clear();
+  int roi_count = bench_case.roi_count > 0 ? bench_case.roi_count : 1;
+  int cols = (int) ceil(sqrt((double) roi_count));
+  int rows = (roi_count + cols - 1) / cols;
+  int tile_width = bench_case.resolution.width / cols;
+  int tile_height = bench_case.resolution.height / rows;
+
+  for (int i = 0; i < roi_count; ++i) {
+    DvppCropOrResizePara para;
+    para.image_type = bench_case.image_type;
+    para.rank = bench_case.rank;
+    para.bit_width = kBenchBitWidth;
+    para.cvdr_or_rdma = kBenchRdma;
+    para.src_resolution = bench_case.resolution;
+    para.dest_resolution = bench_case.dest_resolution;
+
+    // vpc requires even min offsets and odd max offsets
+    para.horz_min = ((i % cols) * tile_width) & ~1;
+    para.horz_max = (para.horz_min + tile_width - 1) | 1;
+    para.vert_min = ((i / cols) * tile_height) & ~1;
+    para.vert_max = (para.vert_min + tile_height - 1) | 1;
+    rois.push_back(para);
+  }
+}
+
+/*
+ * Runs the host side of ezdvpp: staging of the source frame into a vpc aligned
+ * buffer and the copy of the vpc output into the caller's buffer. No dvpp
+ * device is opened, so it also runs where the dvpp driver is busy or absent.
+ */
+class CpuBenchBackend : public BenchBackend {
+ public:
+  const char *GetName() const {
+    return "cpu";
+  }
+
+  bool IsSupported(const BenchCase &bench_case) const {
+    return IsSupportedOperation(bench_case.operation);
+  }
+
+  bool IsSupportedOperation(int operation) const {
+    // jpg, h264, yuv and jpgd run on the dvpp device only
+    return operation == kBenchAlloc || operation == kBenchCrop;
+  }
+
+  int Prepare(const BenchCase &bench_case) {
+    bench_case_ = bench_case;
+    input_.resize(GetImageSize(bench_case.image_type, bench_case.resolution));
+    FillTestImage(input_);
+    SplitRoi(bench_case, rois_);
+
+    // stands for the aligned vpc output of one roi
+    output_size_ = ALIGN_UP(bench_case.dest_resolution.width, kVpcWidthAlign)
+        * ALIGN_UP(bench_case.dest_resolution.height, kVpcHeightAlign)
+        * kYuv420SPMolecule / kYuv420SPDenominator;
+    vpc_output_.resize(output_size_);
+    FillTestImage(vpc_output_);
+    return kDvppOperationOk;
+  }
+
+  int RunOnce() {
+    if (bench_case_.operation == kBenchAlloc) {
+      return StageFrame();
+    }
+
+    // DvppCropOrResize stages the whole frame once per roi, then copies the
+    // vpc output into a new buffer
+    for (size_t i = 0; i < rois_.size(); ++i) {
+      int ret = StageFrame();
+      if (ret != kDvppOperationOk) {
+        return ret;
+      }
+
+      unsigned char *output_buffer = new (nothrow) unsigned char[output_size_];
+      CHECK_NEW_RESULT(output_buffer);
+      ret = memcpy_s(output_buffer, output_size_, vpc_output_.data(),
+                     output_size_);
+      delete[] output_buffer;
+      if (ret != EOK) {
+        return kDvppErrorMemcpyFail;
+      }
+    }
+
+    return kDvppOperationOk;
+  }
+
+  int64_t GetInputSize() const {
+    return input_.size();
+  }
+
+ private:
+  /**
+   * @brief stage the source frame the same way as DvppCropOrResize
+   * @return enum DvppErrorCode
+   */
+  int StageFrame() {
+    DvppUtils dvpp_utils;
+    int width_stride = 0;
+    int buffer_size = 0;
+    char *buffer = nullptr;
+    int ret = dvpp_utils.AllocBuffer(input_.data(), input_.size(), false,
+                                     bench_case_.image_type,
+                                     bench_case_.resolution.width,
+                                     bench_case_.resolution.height,
+                                     width_stride, buffer_size, &buffer);
+    if (ret == kDvppOperationOk) {
+      free(buffer);
+    }
+
+    return ret;
+  }
+
+  BenchCase bench_case_;
+  vector<char> input_;
+  vector<char> vpc_output_;
+  vector<DvppCropOrResizePara> rois_;
+  int output_size_ = 0;
+};
+
+#ifndef EZDVPP_BENCH_CPU_ONLY
+/*
+ * Runs the public DvppProcess api end to end on the dvpp device.
+ */
+class DeviceBenchBackend : public BenchBackend {
+ public:
+  const char *GetName() const {
+    return "device";
+  }
+
+  bool IsSupported(const BenchCase &bench_case) const {
+    bool is_nv12 = bench_case.image_type == kVpcYuv420SemiPlannar
+        && bench_case.rank == kVpcNv12;
+
+    switch (bench_case.operation) {
+      case kBenchAlloc:
+      case kBenchCrop:
+        return true;
+      case kBenchJpeg:
+      case kBenchJpegD:
+        return is_nv12;
+      case kBenchH264:
+        return bench_case.image_type == kVpcYuv420SemiPlannar;
+      case kBenchYuv:
+        return bench_case.image_type == kVpcRgb888Packed
+            && bench_case.rank == kVpcBgr;
+      default:
+        return false;
+    }
+  }
+
+  bool IsSupportedOperation(int operation) const {
+    return (operation >= kBenchAlloc) && (operation < kBenchInvalidOperation);
+  }
+
+  int Prepare(const BenchCase &bench_case) {
+    bench_case_ = bench_case;
+    input_.resize(GetImageSize(bench_case.image_type, bench_case.resolution));
+    FillTestImage(input_);
+    processes_.clear();
+
+    // staging is the same host code on both backends
+    if (bench_case.operation == kBenchAlloc) {
+      return cpu_backend_.Prepare(bench_case);
+    }
+
+    switch (bench_case.operation) {
+      case kBenchJpeg:
+      case kBenchJpegD: {
+        DvppToJpgPara jpg_para;
+        jpg_para.format = JPGENC_FORMAT_NV12;
+        jpg_para.level = kBenchJpegLevel;
+        jpg_para.resolution = bench_case.resolution;
+        processes_.push_back(make_shared<DvppProcess>(jpg_para));
+        break;
+      }
+      case kBenchH264: {
+        DvppToH264Para h264_para;
+        h264_para.coding_type = kH264High;
+        h264_para.yuv_store_type =
+            bench_case.rank == kVpcNv21 ? kYvu420sp : kYuv420sp;
+        h264_para.resolution = bench_case.resolution;
+        processes_.push_back(make_shared<DvppProcess>(h264_para));
+        break;
+      }
+      case kBenchYuv: {
+        DvppToYuvPara yuv_para;
+        yuv_para.image_type = kVpcRgb888Packed;
+        yuv_para.rank = kVpcBgr;
+        yuv_para.bit_width = kBenchBitWidth;
+        yuv_para.cvdr_or_rdma = kBenchRdma;
+        yuv_para.resolution = bench_case.resolution;
+        yuv_para.horz_max = bench_case.resolution.width - 1;
+        yuv_para.vert_max = bench_case.resolution.height - 1;
+        yuv_para.horz_inc = kBenchNoIncrease;
+        yuv_para.vert_inc = kBenchNoIncrease;
+        processes_.push_back(make_shared<DvppProcess>(yuv_para));
+        break;
+      }
+      case kBenchCrop: {
+        vector<DvppCropOrResizePara> rois;
+        SplitRoi(bench_case, rois);
+        for (size_t i = 0; i < rois.size(); ++i) {
+          processes_.push_back(make_shared<DvppProcess>(rois[i]));
+        }
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (bench_case.operation != kBenchJpegD) {
+      return kDvppOperationOk;
+    }
+
+    // the jpg decoded by every iteration is encoded once from the test image
+    DvppOutput jpg_output;
+    int ret = processes_[0]->DvppOperationProc(input_.data(), input_.size(),
+                                               &jpg_output);
+    if (ret != kDvppOperationOk) {
+      return ret;
+    }
+
+    input_.assign(jpg_output.buffer, jpg_output.buffer + jpg_output.size);
+    delete[] jpg_output.buffer;
+
+    DvppJpegDInPara jpegd_para;
+    jpegd_para.is_convert_yuv420 = true;
+    processes_[0] = make_shared<DvppProcess>(jpegd_para);
+    return kDvppOperationOk;
+  }
+
+  int RunOnce() {
+    if (bench_case_.operation == kBenchAlloc) {
+      return cpu_backend_.RunOnce();
+    }
+
+    if (bench_case_.operation == kBenchJpegD) {
+      DvppJpegDOutput jpegd_output;
+      int ret = processes_[0]->DvppJpegDProc(input_.data(), input_.size(),
+                                             &jpegd_output);
+      if (ret == kDvppOperationOk) {
+        delete[] jpegd_output.buffer;
+      }
+      return ret;
+    }
+
+    for (size_t i = 0; i < processes_.size(); ++i) {
+      DvppOutput output;
+      output.buffer = nullptr;
+      int ret = processes_[i]->DvppOperationProc(input_.data(), input_.size(),
+                                                 &output);
+      if (ret != kDvppOperationOk) {
+        return ret;
+      }
+      delete[] output.buffer;
+    }
+
+    return kDvppOperationOk;
+  }
+
+  int64_t GetInputSize() const {
+    return input_.size();
+  }
+
+ private:
+  BenchCase bench_case_;
+  vector<char> input_;
+  vector<shared_ptr<DvppProcess>> processes_;
+  CpuBenchBackend cpu_backend_;
+};
+#endif
+
+shared_ptr<BenchBackend> CreateBenchBackend(const string &name) {
+  if (name == "cpu") {
+    return make_shared<CpuBenchBackend>();
+  }
+
+#ifndef EZDVPP_BENCH_CPU_ONLY
+  if (name == "device") {
+    return make_shared<DeviceBenchBackend>();
+  }
+#endif
+
+  return nullptr;
+}
+}
+}
+}
@@ -0,0 +1,152 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_EZDVPP_BENCH_BENCH_BACKEND_H_
+#define ASCENDDK_ASCEND_EZDVPP_BENCH_BENCH_BACKEND_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ascenddk/ascend_ezdvpp/dvpp_data_type.h"
+
+namespace ascend {
+namespace utils {
+namespace bench {
+
+// Operation measured by one bench case
+enum BenchOperation {
+  kBenchAlloc = 0,  // stage a frame into a vpc aligned buffer
+  kBenchJpeg,  // yuv420sp encode to jpg
+  kBenchH264,  // yuv420sp encode to h264
+  kBenchYuv,  // bgr convert to yuv420sp
+  kBenchCrop,  // crop every roi of a frame and resize it
+  kBenchJpegD,  // jpg decode to yuv
+  kBenchInvalidOperation,
+};
+
+struct BenchCase {
+  int operation = kBenchAlloc;  // enum BenchOperation
+  int image_type = kVpcYuv420SemiPlannar;  // enum DvppVpcImageType
+  int rank = kVpcNv12;  // enum DvppVpcImageRankType
+  ResolutionRatio resolution;  // source frame resolution
+  int roi_count = 1;  // number of rois cropped from one frame
+  ResolutionRatio dest_resolution;  // resolution of every cropped roi
+};
+
+/*
+ * One backend instance is created per worker thread. Prepare() builds the
+ * input of a case outside of the timed region, RunOnce() performs exactly one
+ * operation and is what gets timed.
+ */
+class BenchBackend {
+ public:
+  virtual ~BenchBackend() {
+  }
+
+  /**
+   * @brief get backend name
+   * @return backend name used on the command line and in the report
+   */
+  virtual const char *GetName() const = 0;
+
+  /**
+   * @brief check whether the backend is able to run the case
+   * @param [in] bench_case: bench case
+   * @return true: supported; false: not supported
+   */
+  virtual bool IsSupported(const BenchCase &bench_case) const = 0;
+
+  /**
+   * @brief check whether the backend is able to run an operation for any
+   *        image format
+   * @param [in] operation: enum BenchOperation
+   * @return true: supported; false: not supported
+   */
+  virtual bool IsSupportedOperation(int operation) const = 0;
+
+  /**
+   * @brief build input data of the case
+   * @param [in] bench_case: bench case
+   * @return enum DvppErrorCode
+   */
+  virtual int Prepare(const BenchCase &bench_case) = 0;
+
+  /**
+   * @brief run one operation of the prepared case
+   * @return enum DvppErrorCode
+   */
+  virtual int RunOnce() = 0;
+
+  /**
+   * @brief get input size of one operation, used for throughput
+   * @return size in byte
+   */
+  virtual int64_t GetInputSize() const = 0;
+};
+
+/**
+ * @brief create a backend by name
+ * @param [in] name: "cpu" or "device"
+ * @return backend instance, nullptr if the name is unknown or the backend is
+ *         not built(the device backend in a host build)
+ */
+std::shared_ptr<BenchBackend> CreateBenchBackend(const std::string &name);
+
+/**
+ * @brief get memory size of an unaligned image
+ * @param [in] image_type: enum DvppVpcImageType
+ * @param [in] resolution: image resolution
+ * @return size in byte, 0 if image type is invalid
+ */
+int GetImageSize(int image_type, const ResolutionRatio &resolution);
+
+/**
+ * @brief fill an image buffer with a deterministic non constant pattern
+ * @param [out] buffer: image buffer
+ */
+void FillTestImage(std::vector<char> &buffer);
+
+/**
+ * @brief split a frame into roi_count tiles, aligned as vpc requires
+ *        (min offset even, max offset odd)
+ * @param [in] bench_case: bench case
+ * @param [out] rois: horz_min, horz_max, vert_min, vert_max of every tile
+ */
+void SplitRoi(const BenchCase &bench_case,
+              std::vector<DvppCropOrResizePara> &rois);
+}
+}
+}
+#endif /* ASCENDDK_ASCEND_EZDVPP_BENCH_BENCH_BACKEND_H_ */
@@ -0,0 +1,524 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "bench_backend.h"
+
+using namespace std;
+using namespace ascend::utils;
+using namespace ascend::utils::bench;
+
+namespace {
+// parameter has no value
+const int kParamHasNoValue = 0;
+
+// parameter has value
+const int kParamHasValue = 1;
+
+// nanoseconds in one microsecond and in one second
+const double kNanoPerMicro = 1000.0;
+const double kNanoPerSecond = 1000000000.0;
+
+// byte in one megabyte
+const double kBytePerMega = 1048576.0;
+
+// pixel in one megapixel
+const double kPixelPerMega = 1000000.0;
+
+// default resolution of every cropped roi, the usual model input
+const int kDefaultDestWidth = 224;
+const int kDefaultDestHeight = 224;
+
+// long options for getopt_long function
+const struct option kLongOptions[] = {
+    { "backend", kParamHasValue, nullptr, 'b' },
+    { "ops", kParamHasValue, nullptr, 'p' },
+    { "resolutions", kParamHasValue, nullptr, 'r' },
+    { "formats", kParamHasValue, nullptr, 'f' },
+    { "rois", kParamHasValue, nullptr, 'n' },
+    { "threads", kParamHasValue, nullptr, 't' },
+    { "iterations", kParamHasValue, nullptr, 'i' },
+    { "warmup", kParamHasValue, nullptr, 'w' },
+    { "dest", kParamHasValue, nullptr, 'd' },
+    { "output", kParamHasValue, nullptr, 'o' },
+    { "help", kParamHasNoValue, nullptr, 'H' },
+    { nullptr, kParamHasNoValue, nullptr, kParamHasNoValue } };
+
+// short options for getopt_long function
+const char *kShortOptions = "b:p:r:f:n:t:i:w:d:o:H";
+
+struct NamedOperation {
+  const char *name;
+  int operation;
+};
+
+const NamedOperation kOperations[] = {
+    { "alloc", kBenchAlloc },
+    { "jpeg", kBenchJpeg },
+    { "h264", kBenchH264 },
+    { "yuv", kBenchYuv },
+    { "crop", kBenchCrop },
+    { "jpegd", kBenchJpegD } };
+
+struct NamedResolution {
+  const char *name;
+  int width;
+  int height;
+};
+
+const NamedResolution kResolutions[] = {
+    { "cif", 352, 288 },
+    { "d1", 704, 576 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "4k", 3840, 2160 } };
+
+struct NamedFormat {
+  const char *name;
+  int image_type;
+  int rank;
+};
+
+const NamedFormat kFormats[] = {
+    { "nv12", kVpcYuv420SemiPlannar, kVpcNv12 },
+    { "nv21", kVpcYuv420SemiPlannar, kVpcNv21 },
+    { "yuv400sp", kVpcYuv400SemiPlannar, kVpcNv12 },
+    { "yuv422sp", kVpcYuv422SemiPlannar, kVpcNv12 },
+    { "yuv444sp", kVpcYuv444SemiPlannar, kVpcNv12 },
+    { "yuyv", kVpcYuv422Packed, kVpcYuyv },
+    { "yuv444packed", kVpcYuv444Packed, kVpcYuv },
+    { "bgr888", kVpcRgb888Packed, kVpcBgr },
+    { "xrgb8888", kVpcXrgb8888Packed, kVpcArgb } };
+
+struct BenchOptions {
+  string backend = "cpu";
+  vector<int> operations;
+  vector<ResolutionRatio> resolutions;
+  vector<NamedFormat> formats;
+  vector<int> roi_counts;
+  vector<int> thread_counts;
+  int iterations = 200;
+  int warmup = 10;
+  ResolutionRatio dest_resolution;
+  string output_path;
+};
+
+struct BenchResult {
+  BenchCase bench_case;
+  string format_name;
+  int thread_count = 0;
+  int64_t ops = 0;
+  int64_t failures = 0;
+  double elapsed_ns = 0;
+  int64_t bytes = 0;
+  int64_t pixels = 0;
+  vector<int64_t> latencies;
+};
+
+void PrintUsage() {
+  cout << "usage: ezdvpp_bench [options]\n"
+       << "  -b, --backend     cpu|device (default cpu)\n"
+       << "  -p, --ops         alloc,jpeg,h264,yuv,crop,jpegd, the cpu\n"
+       << "                    backend runs alloc and crop only\n"
+       << "  -r, --resolutions cif,d1,720p,1080p,4k or WIDTHxHEIGHT\n"
+       << "  -f, --formats     nv12,nv21,yuv400sp,yuv422sp,yuv444sp,yuyv,\n"
+       << "                    yuv444packed,bgr888,xrgb8888\n"
+       << "  -n, --rois        roi counts of crop, e.g. 1,4,16\n"
+       << "  -t, --threads     worker thread counts, e.g. 1,2,4\n"
+       << "  -i, --iterations  timed operations per thread (default 200)\n"
+       << "  -w, --warmup      untimed operations per thread (default 10)\n"
+       << "  -d, --dest        roi output resolution (default 224x224)\n"
+       << "  -o, --output      write the json report to a file\n";
+}
+
+vector<string> SplitList(const string &list) {
+  vector<string> items;
+  stringstream list_stream(list);
+  string item;
+  while (getline(list_stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool ParseResolution(const string &name, ResolutionRatio &resolution) {
+  for (const NamedResolution &named : kResolutions) {
+    if (name == named.name) {
+      resolution.width = named.width;
+      resolution.height = named.height;
+      return true;
+    }
+  }
+
+  size_t pos = name.find('x');
+  if (pos == string::npos) {
+    return false;
+  }
+
+  resolution.width = atoi(name.substr(0, pos).c_str());
+  resolution.height = atoi(name.substr(pos + 1).c_str());
+  return resolution.width > 0 && resolution.height > 0;
+}
+
+bool ParseIntList(const string &list, vector<int> &values) {
+  values.clear();
+  for (const string &item : SplitList(list)) {
+    int value = atoi(item.c_str());
+    if (value <= 0) {
+      return false;
+    }
+    values.push_back(value);
+  }
+  return !values.empty();
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options) {
+  string ops = "alloc,crop";
+  string resolutions = "cif,d1,720p,1080p,4k";
+  string formats = "nv12";
+  string rois = "1,4,16";
+  string threads = "1,2,4";
+  string dest = "224x224";
+
+  int option = 0;
+  while ((option = getopt_long(argc, argv, kShortOptions, kLongOptions,
+                               nullptr)) != -1) {
+    switch (option) {
+      case 'b':
+        options.backend = optarg;
+        break;
+      case 'p':
+        ops = optarg;
+        break;
+      case 'r':
+        resolutions = optarg;
+        break;
+      case 'f':
+        formats = optarg;
+        break;
+      case 'n':
+        rois = optarg;
+        break;
+      case 't':
+        threads = optarg;
+        break;
+      case 'i':
+        options.iterations = atoi(optarg);
+        break;
+      case 'w':
+        options.warmup = atoi(optarg);
+        break;
+      case 'd':
+        dest = optarg;
+        break;
+      case 'o':
+        options.output_path = optarg;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  for (const string &name : SplitList(ops)) {
+    const NamedOperation *found = nullptr;
+    for (const NamedOperation &named : kOperations) {
+      if (name == named.name) {
+        found = &named;
+      }
+    }
+    if (found == nullptr) {
+      cerr << "unknown operation: " << name << endl;
+      return false;
+    }
+    options.operations.push_back(found->operation);
+  }
+
+  for (const string &name : SplitList(resolutions)) {
+    ResolutionRatio resolution;
+    if (!ParseResolution(name, resolution)) {
+      cerr << "invalid resolution: " << name << endl;
+      return false;
+    }
+    options.resolutions.push_back(resolution);
+  }
+
+  for (const string &name : SplitList(formats)) {
+    const NamedFormat *found = nullptr;
+    for (const NamedFormat &named : kFormats) {
+      if (name == named.name) {
+        found = &named;
+      }
+    }
+    if (found == nullptr) {
+      cerr << "unknown format: " << name << endl;
+      return false;
+    }
+    options.formats.push_back(*found);
+  }
+
+  if (!ParseIntList(rois, options.roi_counts)
+      || !ParseIntList(threads, options.thread_counts)
+      || !ParseResolution(dest, options.dest_resolution)
+      || options.iterations <= 0 || options.warmup < 0) {
+    cerr << "invalid roi count, thread count, dest or iteration" << endl;
+    return false;
+  }
+
+  return !options.operations.empty() && !options.resolutions.empty()
+      && !options.formats.empty();
+}
+
+const char *GetOperationName(int operation) {
+  for (const NamedOperation &named : kOperations) {
+    if (named.operation == operation) {
+      return named.name;
+    }
+  }
+  return "unknown";
+}
+
+/**
+ * @brief run one case on thread_count workers, each worker owns a backend
+ * @return false if the backend can not prepare the case
+ */
+bool RunCase(const BenchOptions &options, const BenchCase &bench_case,
+             int thread_count, BenchResult &result) {
+  vector<shared_ptr<BenchBackend>> backends;
+  for (int i = 0; i < thread_count; ++i) {
+    shared_ptr<BenchBackend> backend = CreateBenchBackend(options.backend);
+    if (backend->Prepare(bench_case) != kDvppOperationOk) {
+      return false;
+    }
+    backends.push_back(backend);
+  }
+
+  vector<vector<int64_t>> latencies(thread_count);
+  vector<int64_t> failures(thread_count, 0);
+  atomic<int> ready_count(0);
+  atomic<bool> start(false);
+
+  vector<thread> workers;
+  for (int i = 0; i < thread_count; ++i) {
+    workers.push_back(thread([&, i]() {
+      BenchBackend *backend = backends[i].get();
+      for (int j = 0; j < options.warmup; ++j) {
+        backend->RunOnce();
+      }
+
+      latencies[i].reserve(options.iterations);
+      ready_count++;
+      while (!start.load()) {
+        this_thread::yield();
+      }
+
+      for (int j = 0; j < options.iterations; ++j) {
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        int ret = backend->RunOnce();
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        if (ret != kDvppOperationOk) {
+          failures[i]++;
+          continue;
+        }
+        latencies[i].push_back(
+            chrono::duration_cast<chrono::nanoseconds>(end - begin).count());
+      }
+    }));
+  }
+
+  while (ready_count.load() < thread_count) {
+    this_thread::yield();
+  }
+
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  start = true;
+  for (thread &worker : workers) {
+    worker.join();
+  }
+  chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+  result.bench_case = bench_case;
+  result.thread_count = thread_count;
+  result.elapsed_ns = (double) chrono::duration_cast<chrono::nanoseconds>(
+      end - begin).count();
+  for (int i = 0; i < thread_count; ++i) {
+    result.failures += failures[i];
+    result.latencies.insert(result.latencies.end(), latencies[i].begin(),
+                            latencies[i].end());
+  }
+  result.ops = result.latencies.size();
+  result.bytes = result.ops * backends[0]->GetInputSize();
+  result.pixels = result.ops * bench_case.resolution.width
+      * bench_case.resolution.height;
+  sort(result.latencies.begin(), result.latencies.end());
+  return true;
+}
+
+double GetPercentile(const vector<int64_t> &sorted, double percent) {
+  if (sorted.empty()) {
+    return 0;
+  }
+
+  size_t index = (size_t) ceil(percent * sorted.size());
+  index = index == 0 ? 0 : index - 1;
+  return sorted[min(index, sorted.size() - 1)] / kNanoPerMicro;
+}
+
+void WriteReport(ostream &out, const BenchOptions &options,
+                 const vector<BenchResult> &results, int skipped) {
+  out << "{\n  \"backend\": \"" << options.backend << "\",\n"
+      << "  \"iterations\": " << options.iterations << ",\n"
+      << "  \"warmup\": " << options.warmup << ",\n"
+      << "  \"skipped\": " << skipped << ",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &result = results[i];
+    double seconds = result.elapsed_ns / kNanoPerSecond;
+    double ops_per_sec = seconds > 0 ? result.ops / seconds : 0;
+
+    out << (i == 0 ? "\n" : ",\n") << "    {\"op\": \""
+        << GetOperationName(result.bench_case.operation) << "\", "
+        << "\"format\": \"" << result.format_name << "\", "
+        << "\"width\": " << result.bench_case.resolution.width << ", "
+        << "\"height\": " << result.bench_case.resolution.height << ", "
+        << "\"rois\": " << result.bench_case.roi_count << ", "
+        << "\"threads\": " << result.thread_count << ", "
+        << "\"ops\": " << result.ops << ", "
+        << "\"failures\": " << result.failures << ", "
+        << "\"ops_per_sec\": " << ops_per_sec << ", "
+        << "\"mb_per_sec\": "
+        << (seconds > 0 ? result.bytes / kBytePerMega / seconds : 0) << ", "
+        << "\"mpixel_per_sec\": "
+        << (seconds > 0 ? result.pixels / kPixelPerMega / seconds : 0) << ", "
+        << "\"latency_us\": {\"p50\": " << GetPercentile(result.latencies, 0.5)
+        << ", \"p90\": " << GetPercentile(result.latencies, 0.9)
+        << ", \"p99\": " << GetPercentile(result.latencies, 0.99)
+        << ", \"max\": " << GetPercentile(result.latencies, 1.0) << "}}";
+  }
+
+  out << "\n  ]\n}\n";
+}
+}
+
+int main(int argc, char *argv[]) {
+  BenchOptions options;
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  shared_ptr<BenchBackend> probe = CreateBenchBackend(options.backend);
+  if (probe == nullptr) {
+    cerr << "unknown backend or backend not built: " << options.backend
+         << endl;
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  // an operation the backend can not run is an error, not a skipped case
+  for (int operation : options.operations) {
+    if (!probe->IsSupportedOperation(operation)) {
+      cerr << "operation " << GetOperationName(operation)
+           << " is not supported by the " << probe->GetName()
+           << " backend, it needs the dvpp device: -b device" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  vector<BenchResult> results;
+  int skipped = 0;
+
+  // sweep: operation x resolution x format x roi count x thread count. roi
+  // count only applies to crop
+  for (int operation : options.operations) {
+    for (const ResolutionRatio &resolution : options.resolutions) {
+      for (const NamedFormat &format : options.formats) {
+        vector<int> roi_counts =
+            operation == kBenchCrop ? options.roi_counts : vector<int>(1, 1);
+        for (int roi_count : roi_counts) {
+          BenchCase bench_case;
+          bench_case.operation = operation;
+          bench_case.image_type = format.image_type;
+          bench_case.rank = format.rank;
+          bench_case.resolution = resolution;
+          bench_case.roi_count = roi_count;
+          bench_case.dest_resolution = options.dest_resolution;
+          if (!probe->IsSupported(bench_case)) {
+            skipped++;
+            continue;
+          }
+
+          for (int thread_count : options.thread_counts) {
+            BenchResult result;
+            result.format_name = format.name;
+            if (!RunCase(options, bench_case, thread_count, result)) {
+              cerr << "prepare failed: " << GetOperationName(operation) << " "
+                   << format.name << " " << resolution.width << "x"
+                   << resolution.height << endl;
+              skipped++;
+              continue;
+            }
+            results.push_back(result);
+          }
+        }
+      }
+    }
+  }
+
+  if (options.output_path.empty()) {
+    WriteReport(cout, options, results, skipped);
+    return EXIT_SUCCESS;
+  }
+
+  ofstream report(options.output_path.c_str());
+  if (!report.is_open()) {
+    cerr << "can not open " << options.output_path << endl;
+    return EXIT_FAILURE;
+  }
+  WriteReport(report, options, results, skipped);
+  return EXIT_SUCCESS;
+}
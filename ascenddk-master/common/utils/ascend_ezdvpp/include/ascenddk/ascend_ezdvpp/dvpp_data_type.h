@@ -176,6 +176,8 @@ enum DvppErrorCode {
   kDvppErrorMemcpyFail = -6,
   kDvppErrorNewFail = -7,
   kDvppErrorCheckMemorySizeFail = -8,
+  kDvppErrorOpenFileFail = -9,
+  kDvppErrorEndOfStream = -10,
 }
 ;
 
@@ -0,0 +1,163 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_EZDVPP_FRAME_BUFFER_POOL_H_
+#define ASCENDDK_ASCEND_EZDVPP_FRAME_BUFFER_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "dvpp_data_type.h"
+
+namespace ascend {
+namespace utils {
+
+// Default address alignment of pooled buffers, same as the vpc input
+const int kFrameBufferAlign = 128;
+
+struct FrameBufferPoolPara {
+  // memory size of one buffer, e.g. width * height * 3 / 2 of a yuv420sp frame
+  int buffer_size = 0;
+
+  // number of buffers allocated by Init()
+  int buffer_count = 0;
+
+  // maximum number of buffers the pool may grow to when all are in use.
+  // 0: no limit
+  int max_buffer_count = 0;
+
+  // address alignment of every buffer, power of 2
+  int align = kFrameBufferAlign;
+
+  // true: touch every page in Init(), so capture never page faults
+  bool prefault = true;
+
+  // allocates one buffer of buffer_size bytes aligned to align, e.g. memory
+  // the framework transfers without copying. empty: memalign
+  std::function<char *(int size)> allocate;
+
+  // frees a buffer of allocate, must be set with allocate. empty: free
+  std::function<void(char *buffer)> release;
+};
+
+/*
+ * Fixed size, aligned frame buffers that are recycled instead of freed.
+ * Acquire() hands out a shared_ptr whose deleter returns the buffer to the
+ * pool when the last reference drops, so the consumer code is unchanged and
+ * the steady state does not allocate. The memory stays valid while any buffer
+ * is still referenced, even after the pool itself is destroyed.
+ * Thread safe.
+ */
+class FrameBufferPool {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] FrameBufferPoolPara para: pool description
+   */
+  FrameBufferPool(const FrameBufferPoolPara &para);
+
+  // class destructor
+  virtual ~FrameBufferPool();
+
+  /**
+   * @brief check parameters, allocate and prefault buffer_count buffers
+   * @return enum DvppErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief get a free buffer, allocate a new one if all are in use and the
+   *        pool is allowed to grow
+   * @return buffer of GetBufferSize() bytes; nullptr if the pool is exhausted
+   *         or memory allocation fails
+   */
+  std::shared_ptr<char> Acquire();
+
+  /**
+   * @brief get a free buffer as another element type (e.g. uint8_t)
+   * @return buffer sharing ownership with the pooled buffer; nullptr if none
+   */
+  template<typename T>
+  std::shared_ptr<T> Acquire() {
+    std::shared_ptr<char> buffer = Acquire();
+    if (buffer == nullptr) {
+      return std::shared_ptr<T>();
+    }
+    return std::shared_ptr<T>(buffer, reinterpret_cast<T *>(buffer.get()));
+  }
+
+  /**
+   * @brief get memory size of one buffer
+   * @return size in byte
+   */
+  int GetBufferSize() const;
+
+  /**
+   * @brief get number of buffers owned by the pool
+   * @return buffer number
+   */
+  int GetBufferCount() const;
+
+  /**
+   * @brief get number of buffers not in use
+   * @return buffer number
+   */
+  int GetFreeCount() const;
+
+ private:
+  // buffers shared by the pool and the deleters of acquired buffers
+  struct PoolStorage {
+    ~PoolStorage();
+
+    std::mutex mutex;
+    std::function<void(char *buffer)> release;
+    std::vector<char *> all_buffers;
+    std::vector<char *> free_buffers;
+  };
+
+  /**
+   * @brief allocate one aligned buffer and add it to the storage, the
+   *        caller holds the storage mutex
+   * @return buffer, nullptr if memory allocation fails
+   */
+  char *AllocateBuffer();
+
+  // used for storage attributes of pool
+  FrameBufferPoolPara para_;
+
+  std::shared_ptr<PoolStorage> storage_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_EZDVPP_FRAME_BUFFER_POOL_H_ */
@@ -0,0 +1,150 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_EZDVPP_JPEG_ENCODE_POOL_H_
+#define ASCENDDK_ASCEND_EZDVPP_JPEG_ENCODE_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ascenddk/ascend_utils/batch_worker_pool.h"
+#include "dvpp/idvppapi.h"
+#include "dvpp_data_type.h"
+#include "frame_buffer_pool.h"
+
+namespace ascend {
+namespace utils {
+
+struct JpegEncodePoolPara {
+  // number of encode threads, each one owns a dvpp session
+  int worker_num = 2;
+
+  // used to indicate the input format.
+  eEncodeFormat format = JPGENC_FORMAT_NV12;
+
+  // used to indicate the output quality.
+  int level = 100;
+
+  // false: Input image is not aligned; true: Input image is aligned
+  bool is_align_image = true;
+};
+
+struct JpegEncodeTask {
+  // yuv data buffer and size
+  const char *input_buf = nullptr;
+  int input_size = 0;
+
+  // image resolution
+  ResolutionRatio resolution;
+
+  // jpeg data, a pooled buffer returned to the pool when released
+  std::shared_ptr<unsigned char> output;
+
+  // size of jpeg data
+  unsigned int output_size = 0;
+
+  // enum DvppErrorCode of this task
+  int result = kDvppOperationOk;
+};
+
+/*
+ * Encodes the images of one frame (the frame and its object crops) to jpeg
+ * concurrently. Every worker keeps its dvpp session and large page input
+ * buffer for its lifetime instead of creating them per image, and jpeg data
+ * is written to size class buffer pools, so the steady state neither maps
+ * memory nor allocates. Thread safe.
+ */
+class JpegEncodePool {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] JpegEncodePoolPara para: pool description
+   */
+  JpegEncodePool(const JpegEncodePoolPara &para);
+
+  // class destructor, stops the workers
+  virtual ~JpegEncodePool();
+
+  /**
+   * @brief check parameters and start the workers
+   * @return enum DvppErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief encode the tasks and wait until all of them are done
+   * @param [in/out] tasks: input of every task, output and result are set
+   * @return kDvppOperationOk if every task succeeds, otherwise the result of
+   *         the first failed task
+   */
+  int Encode(std::vector<JpegEncodeTask> &tasks);
+
+ private:
+  // dvpp session and input buffer owned by one worker
+  struct EncodeSession {
+    IDVPPAPI *dvpp_api = nullptr;
+    unsigned char *mmap_addr = nullptr;
+    unsigned int mmap_size = 0;
+  };
+
+  /**
+   * @brief encode one image with the session of the calling worker
+   * @param [in] session: dvpp session of the worker
+   * @param [in/out] task: image to encode
+   * @return enum DvppErrorCode
+   */
+  int EncodeImage(EncodeSession &session, JpegEncodeTask &task);
+
+  /**
+   * @brief get a buffer of at least size bytes from the size class pools
+   * @param [in] size: jpeg data size
+   * @return buffer, nullptr if memory allocation fails
+   */
+  std::shared_ptr<unsigned char> AcquireOutput(unsigned int size);
+
+  // used for storage attributes of pool
+  JpegEncodePoolPara para_;
+
+  // one session per worker, created by Init()
+  std::vector<EncodeSession> sessions_;
+
+  // worker threads, worker i encodes with sessions_[i]
+  BatchWorkerPool workers_;
+
+  // output buffer pools by size class, created on first use
+  std::mutex output_mutex_;
+  std::vector<std::unique_ptr<FrameBufferPool>> output_pools_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_EZDVPP_JPEG_ENCODE_POOL_H_ */
@@ -0,0 +1,170 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_EZDVPP_TENSOR_PREPROCESS_H_
+#define ASCENDDK_ASCEND_EZDVPP_TENSOR_PREPROCESS_H_
+
+#include <vector>
+#include "dvpp_data_type.h"
+
+namespace ascend {
+namespace utils {
+
+// The channel number of the output tensor
+const int kTensorChannel = 3;
+
+// The max width or height of the output tensor
+const int kTensorMaxEdge = 4096;
+
+// Element type of the output tensor
+enum TensorDataType {
+  kTensorFloat32 = 0,  // 32 bit float
+  kTensorFloat16,  // 16 bit IEEE half float
+};
+
+// Channel order of the output tensor
+enum TensorChannelOrder {
+  kTensorBgr = 0,  // planes are B, G, R
+  kTensorRgb,  // planes are R, G, B
+};
+
+struct TensorPreprocessPara {
+  // YUV storage method.0:YUV420 semi-planner(nv12) 1:YVU420 semi-planner(nv21)
+  int yuv_store_type = kYuv420sp;
+
+  // tensor resolution
+  ResolutionRatio dest_resolution;
+
+  // channel order of the tensor planes
+  int channel_order = kTensorBgr;
+
+  // element type of the tensor
+  int data_type = kTensorFloat32;
+
+  // per-pixel mean and std table, HWC layout (dest width * height * 3) in the
+  // same channel order as the tensor. nullptr: no subtraction or division
+  const float *mean = nullptr;
+  const float *std = nullptr;
+};
+
+struct TensorPreprocessRoi {
+  ResolutionRatio src_resolution;  // src image resolution
+  int horz_max = 0;  // The maximum deviation from the origin in horz direction
+  int horz_min = 0;  // The minimum deviation from the origin in horz direction
+  int vert_max = 0;  // The maximum deviation from the origin in vert direction
+  int vert_min = 0;  // The minimum deviation from the origin in vert direction
+  bool is_input_align = false;  // false:input image is not aligned
+// true:input image is aligned(width 128, height 16)
+};
+
+/*
+ * Fused CPU preprocessing from a yuv420sp region of interest to one slot of a
+ * CHW model input tensor: bilinear resize, yuv to bgr/rgb, per-pixel
+ * (x - mean) / std and the plane split are done in a single pass, and the
+ * result is written straight into the caller's batch buffer.
+ * An instance keeps per-ROI scratch tables, so use one instance per thread.
+ */
+class TensorPreprocess {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] TensorPreprocessPara para: tensor description
+   */
+  TensorPreprocess(const TensorPreprocessPara &para);
+
+  // class destructor
+  virtual ~TensorPreprocess();
+
+  /**
+   * @brief check parameters and build the CHW mean and 1/std tables
+   * @return enum DvppErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief get memory size of one tensor slot
+   * @return size in byte
+   */
+  int GetTensorSize() const;
+
+  /**
+   * @brief crop the roi, resize it to the tensor resolution, convert it to
+   *        bgr/rgb, normalize it and write it as CHW into output_buf
+   * @param [in] input_buf: yuv420sp image data
+   * @param [in] input_size: size of yuv420sp image data
+   * @param [in] roi: image resolution and region of interest
+   * @param [out] output_buf: tensor slot, GetTensorSize() bytes
+   * @param [in] output_size: size of output_buf
+   * @return enum DvppErrorCode
+   */
+  int TensorPreprocessProc(const char *input_buf, int input_size,
+                           const TensorPreprocessRoi &roi, void *output_buf,
+                           int output_size);
+
+ private:
+  /**
+   * @brief build horizontal sample tables of luma and chroma for the roi
+   * @param [in] roi: region of interest
+   */
+  void BuildHorzTable(const TensorPreprocessRoi &roi);
+
+  /**
+   * @brief convert one row of interpolated yuv to normalized tensor planes
+   * @param [in] row: row index in tensor
+   * @param [out] output_buf: tensor slot
+   */
+  void ConvertRow(int row, void *output_buf);
+
+  // used for storage attributes of tensor
+  TensorPreprocessPara para_;
+
+  // CHW mean table and reciprocal of std table
+  std::vector<float> mean_chw_;
+  std::vector<float> scale_chw_;
+
+  // horizontal sample table: left index, right index, weight of right
+  std::vector<int> luma_x0_;
+  std::vector<int> luma_x1_;
+  std::vector<float> luma_wx_;
+  std::vector<int> chroma_x0_;
+  std::vector<int> chroma_x1_;
+  std::vector<float> chroma_wx_;
+
+  // interpolated y, u, v of the current row
+  std::vector<float> y_row_;
+  std::vector<float> u_row_;
+  std::vector<float> v_row_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_EZDVPP_TENSOR_PREPROCESS_H_ */
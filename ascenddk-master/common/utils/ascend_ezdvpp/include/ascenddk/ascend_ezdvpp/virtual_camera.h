@@ -0,0 +1,128 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_EZDVPP_VIRTUAL_CAMERA_H_
+#define ASCENDDK_ASCEND_EZDVPP_VIRTUAL_CAMERA_H_
+
+#include <chrono>
+#include <string>
+#include "dvpp_data_type.h"
+
+namespace ascend {
+namespace utils {
+
+struct VirtualCameraPara {
+  // raw yuv420sp(nv12) clip, frames stored back to back without header
+  std::string path;
+
+  // frame resolution of the clip
+  ResolutionRatio resolution;
+
+  // replay frame rate, 0: as fast as possible
+  int fps = 0;
+
+  // true: start over at the end of the clip; false: end of stream
+  bool loop = true;
+};
+
+/*
+ * File replay source with the same contract as a MIPI camera channel: every
+ * ReadFrame() returns the next yuv420sp frame, paced to the configured fps.
+ * The clip is memory mapped read only, so any number of virtual channels can
+ * replay the same file from the page cache. Use one instance per channel;
+ * an instance is not thread safe.
+ */
+class VirtualCamera {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] VirtualCameraPara para: clip description
+   */
+  VirtualCamera(const VirtualCameraPara &para);
+
+  // class destructor
+  virtual ~VirtualCamera();
+
+  /**
+   * @brief check parameters and map the clip
+   * @return enum DvppErrorCode
+   */
+  int Init();
+
+  /**
+   * @brief wait for the frame time and copy the next frame
+   * @param [out] buf: frame buffer
+   * @param [in] size: size of buf, at least GetFrameSize()
+   * @return kDvppOperationOk: success; kDvppErrorEndOfStream: the clip is
+   *         over and loop is false; other enum DvppErrorCode: failed
+   */
+  int ReadFrame(char *buf, int size);
+
+  /**
+   * @brief get memory size of one frame
+   * @return size in byte
+   */
+  int GetFrameSize() const;
+
+  /**
+   * @brief get number of frames in the clip
+   * @return frame number
+   */
+  int GetFrameCount() const;
+
+ private:
+  /**
+   * @brief sleep until the time of next frame
+   */
+  void WaitFrameTime();
+
+  // used for storage attributes of virtual camera
+  VirtualCameraPara para_;
+
+  // mapped clip
+  char *clip_ = nullptr;
+  size_t clip_size_ = 0;
+
+  // yuv420sp frame size and number of whole frames in the clip
+  int frame_size_ = 0;
+  int frame_count_ = 0;
+
+  // index of next frame
+  int next_frame_ = 0;
+
+  // time of next frame, zero before the first frame
+  std::chrono::steady_clock::time_point next_time_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_EZDVPP_VIRTUAL_CAMERA_H_ */
@@ -0,0 +1,159 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_ezdvpp/frame_buffer_pool.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#include "ascenddk/ascend_ezdvpp/dvpp_utils.h"
+
+using namespace std;
+
+namespace ascend {
+namespace utils {
+
+FrameBufferPool::FrameBufferPool(const FrameBufferPoolPara &para) {
+  para_ = para;
+  storage_ = make_shared<PoolStorage>();
+  storage_->release = para.release;
+}
+
+FrameBufferPool::~FrameBufferPool() {
+  // buffers still referenced keep storage_ alive through their deleters
+}
+
+FrameBufferPool::PoolStorage::~PoolStorage() {
+  for (size_t i = 0; i < all_buffers.size(); ++i) {
+    if (release) {
+      release(all_buffers[i]);
+    } else {
+      free(all_buffers[i]);
+    }
+  }
+}
+
+int FrameBufferPool::Init() {
+  // alignment must be a power of 2
+  bool is_align_valid = (para_.align > 0)
+      && ((para_.align & (para_.align - 1)) == 0);
+  if (para_.buffer_size <= 0 || para_.buffer_count < 0
+      || para_.max_buffer_count < 0 || !is_align_valid
+      || (para_.max_buffer_count != 0
+          && para_.max_buffer_count < para_.buffer_count)
+      || (bool(para_.allocate) != bool(para_.release))) {
+    ASC_LOG_ERROR("Invalid frame buffer pool parameter, size:%d, count:%d, "
+                  "max count:%d, align:%d.", para_.buffer_size,
+                  para_.buffer_count, para_.max_buffer_count, para_.align);
+    return kDvppErrorInvalidParameter;
+  }
+
+  lock_guard<mutex> lock(storage_->mutex);
+  for (int i = 0; i < para_.buffer_count; ++i) {
+    char *buffer = AllocateBuffer();
+    if (buffer == nullptr) {
+      return kDvppErrorMallocFail;
+    }
+    storage_->free_buffers.push_back(buffer);
+  }
+
+  return kDvppOperationOk;
+}
+
+char *FrameBufferPool::AllocateBuffer() {
+  if (para_.max_buffer_count != 0
+      && (int) storage_->all_buffers.size() >= para_.max_buffer_count) {
+    return nullptr;
+  }
+
+  char *buffer = nullptr;
+  if (para_.allocate) {
+    buffer = para_.allocate(para_.buffer_size);
+  } else {
+    buffer = (char *) memalign(para_.align, para_.buffer_size);
+  }
+  if (buffer == nullptr) {
+    ASC_LOG_ERROR("Failed to alloc frame buffer, size:%d.", para_.buffer_size);
+    return nullptr;
+  }
+
+  // write every page once, so the kernel maps them now and not during capture
+  if (para_.prefault) {
+    int ret = memset_s(buffer, para_.buffer_size, 0, para_.buffer_size);
+    if (ret != EOK) {
+      ASC_LOG_ERROR("Failed to prefault frame buffer, ret:%d.", ret);
+    }
+  }
+
+  storage_->all_buffers.push_back(buffer);
+  return buffer;
+}
+
+shared_ptr<char> FrameBufferPool::Acquire() {
+  char *buffer = nullptr;
+  {
+    lock_guard<mutex> lock(storage_->mutex);
+    if (!storage_->free_buffers.empty()) {
+      buffer = storage_->free_buffers.back();
+      storage_->free_buffers.pop_back();
+    } else {  // all buffers are in use, grow the pool
+      buffer = AllocateBuffer();
+    }
+  }
+
+  if (buffer == nullptr) {
+    return shared_ptr<char>();
+  }
+
+  shared_ptr<PoolStorage> storage = storage_;
+  return shared_ptr<char>(buffer, [storage](char *released) {
+    lock_guard<mutex> lock(storage->mutex);
+    storage->free_buffers.push_back(released);
+  });
+}
+
+int FrameBufferPool::GetBufferSize() const {
+  return para_.buffer_size;
+}
+
+int FrameBufferPool::GetBufferCount() const {
+  lock_guard<mutex> lock(storage_->mutex);
+  return storage_->all_buffers.size();
+}
+
+int FrameBufferPool::GetFreeCount() const {
+  lock_guard<mutex> lock(storage_->mutex);
+  return storage_->free_buffers.size();
+}
+}
+}
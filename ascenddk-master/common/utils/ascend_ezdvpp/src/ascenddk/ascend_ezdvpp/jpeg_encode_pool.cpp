@@ -0,0 +1,273 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_ezdvpp/jpeg_encode_pool.h"
+
+#include <sys/mman.h>
+
+#include "ascenddk/ascend_ezdvpp/dvpp_utils.h"
+
+using namespace std;
+
+namespace {
+// maximum number of encode threads
+const int kMaxJpegWorkerNum = 16;
+
+// buffer size of the smallest output size class, 64K, classes double in size
+const unsigned int kMinOutputClassSize = 65536;
+}
+
+namespace ascend {
+namespace utils {
+
+JpegEncodePool::JpegEncodePool(const JpegEncodePoolPara &para) {
+  para_ = para;
+}
+
+JpegEncodePool::~JpegEncodePool() {
+  // no worker uses a session any more
+  workers_.Stop();
+
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    if (sessions_[i].dvpp_api != nullptr) {
+      (void) DestroyDvppApi(sessions_[i].dvpp_api);
+    }
+    if (sessions_[i].mmap_addr != nullptr) {
+      munmap(sessions_[i].mmap_addr, sessions_[i].mmap_size);
+    }
+  }
+}
+
+int JpegEncodePool::Init() {
+  if (para_.worker_num <= 0 || para_.worker_num > kMaxJpegWorkerNum
+      || !sessions_.empty()) {
+    ASC_LOG_ERROR("Invalid jpeg encode pool parameter, worker num:%d.",
+                  para_.worker_num);
+    return kDvppErrorInvalidParameter;
+  }
+
+  // create every session before any worker starts, the vector never moves
+  sessions_.resize(para_.worker_num);
+  for (int i = 0; i < para_.worker_num; ++i) {
+    int ret = CreateDvppApi(sessions_[i].dvpp_api);
+    if ((sessions_[i].dvpp_api == nullptr) || (ret == kDvppReturnError)) {
+      ASC_LOG_ERROR("Failed to create instance of dvpp(yuv to jpeg).");
+      return kDvppErrorCreateDvppFail;
+    }
+  }
+
+  if (workers_.Start(para_.worker_num) != kUtilsOk) {
+    ASC_LOG_ERROR("Failed to start %d jpeg encode workers.",
+                  para_.worker_num);
+    return kDvppErrorInvalidParameter;
+  }
+  return kDvppOperationOk;
+}
+
+int JpegEncodePool::Encode(vector<JpegEncodeTask> &tasks) {
+  // worker i encodes with its own session
+  int ret = workers_.Run(tasks.size(), [this, &tasks](int worker_index,
+                                                      size_t task_index) {
+    tasks[task_index].result = EncodeImage(sessions_[worker_index],
+                                           tasks[task_index]);
+  });
+  if (ret != kUtilsOk) {
+    ASC_LOG_ERROR("Jpeg encode pool is not initialized.");
+    return kDvppErrorInvalidParameter;
+  }
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (tasks[i].result != kDvppOperationOk) {
+      return tasks[i].result;
+    }
+  }
+  return kDvppOperationOk;
+}
+
+int JpegEncodePool::EncodeImage(EncodeSession &session,
+                                JpegEncodeTask &task) {
+  if ((task.input_buf == nullptr) || (task.input_size <= 0)) {
+    ASC_LOG_ERROR("The input parameter is error in jpeg encode pool, "
+                  "input_size:%d.", task.input_size);
+    return kDvppErrorInvalidParameter;
+  }
+
+  // yuv image width/height/encoding quality level(1-100)/format/height
+  // after aligned, same as DvppProcess
+  sJpegeIn input_data;
+  input_data.width = task.resolution.width;
+  input_data.height = task.resolution.height;
+  input_data.level = para_.level;
+  input_data.format = para_.format;
+  input_data.heightAligned = task.resolution.height;
+  if (JPGENC_FORMAT_YUV420 != (input_data.format & JPGENC_FORMAT_BIT)) {
+    ASC_LOG_ERROR("Unsupported format in jpeg encode pool:%d.",
+                  input_data.format);
+    return kDvppErrorInvalidParameter;
+  }
+  if (!para_.is_align_image) {
+    input_data.stride = ALIGN_UP(input_data.width, kJpegEWidthAlgin);
+  } else {
+    input_data.stride = ALIGN_UP(input_data.width, kJpegECompatWidthAlign);
+    input_data.heightAligned = ALIGN_UP(task.resolution.height,
+                                        kJpegEHeightAlign);
+  }
+  input_data.bufSize = ALIGN_UP(
+      input_data.stride * input_data.heightAligned
+      * DVPP_YUV420SP_SIZE_MOLECULE / DVPP_YUV420SP_SIZE_DENOMINATOR,
+      PAGE_SIZE);
+
+  // the large page input buffer only grows, it is mapped again only when
+  // the image is larger than every image before
+  unsigned int mmap_size = ALIGN_UP(input_data.bufSize + kJpegEAddressAlgin,
+                                    MAP_2M);
+  if (mmap_size > session.mmap_size) {
+    if (session.mmap_addr != nullptr) {
+      munmap(session.mmap_addr, session.mmap_size);
+      session.mmap_addr = nullptr;
+      session.mmap_size = 0;
+    }
+    void *addr = mmap(
+        0, mmap_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | API_MAP_VA32BIT, 0, 0);
+    if (addr == MAP_FAILED) {
+      ASC_LOG_ERROR("Failed to malloc memory in jpeg encode pool.");
+      return kDvppErrorMallocFail;
+    }
+    session.mmap_addr = (unsigned char *) addr;
+    session.mmap_size = mmap_size;
+  }
+
+  // first address of buffer align to 128
+  input_data.buf = (unsigned char *) ALIGN_UP((uint64_t) session.mmap_addr,
+                                              kJpegEAddressAlgin);
+  unsigned int buf_size = session.mmap_size
+      - (input_data.buf - session.mmap_addr);
+
+  // input data align to specify requirement
+  int ret = EOK;
+  if (para_.is_align_image) {
+    ret = memcpy_s(input_data.buf, buf_size, task.input_buf, task.input_size);
+  } else {
+    const char *temp_buf = task.input_buf;
+    for (unsigned int j = 0; (j < input_data.height) && (ret == EOK); j++) {
+      ret = memcpy_s(input_data.buf + ((ptrdiff_t) j * input_data.stride),
+                     buf_size - j * input_data.stride, temp_buf,
+                     input_data.width);
+      temp_buf += input_data.width;
+    }
+    for (unsigned int j = input_data.heightAligned;
+        (j < input_data.heightAligned + input_data.height / 2)
+            && (ret == EOK); j++) {
+      ret = memcpy_s(input_data.buf + ((ptrdiff_t) j * input_data.stride),
+                     buf_size - j * input_data.stride, temp_buf,
+                     input_data.width);
+      temp_buf += input_data.width;
+    }
+  }
+  if (ret != EOK) {
+    ASC_LOG_ERROR("Failed to copy memory,Ret=%d.", ret);
+    return kDvppErrorMemcpyFail;
+  }
+
+  // call dvpp with the session of this worker
+  sJpegeOut output_data;
+  dvppapi_ctl_msg dvpp_api_ctl_msg;
+  dvpp_api_ctl_msg.in = (void *) &input_data;
+  dvpp_api_ctl_msg.in_size = sizeof(input_data);
+  dvpp_api_ctl_msg.out = (void *) &output_data;
+  dvpp_api_ctl_msg.out_size = sizeof(sJpegeOut);
+  if (DvppCtl(session.dvpp_api, DVPP_CTL_JPEGE_PROC, &dvpp_api_ctl_msg)
+      == kDvppReturnError) {
+    ASC_LOG_ERROR("Failed to convert in dvpp(yuv to jpeg).");
+    return kDvppErrorDvppCtlFail;
+  }
+
+  DvppUtils dvpp_utils;
+  ret = dvpp_utils.CheckDataSize(output_data.jpgSize);
+  if (ret != kDvppOperationOk) {
+    output_data.cbFree();
+    return ret;
+  }
+
+  task.output = AcquireOutput(output_data.jpgSize);
+  if (task.output == nullptr) {
+    output_data.cbFree();
+    return kDvppErrorMallocFail;
+  }
+  task.output_size = output_data.jpgSize;
+  ret = memcpy_s(task.output.get(), task.output_size, output_data.jpgData,
+                 output_data.jpgSize);
+  output_data.cbFree();
+  if (ret != EOK) {
+    ASC_LOG_ERROR("Failed to copy memory,Ret=%d.", ret);
+    task.output.reset();
+    return kDvppErrorMemcpyFail;
+  }
+  return kDvppOperationOk;
+}
+
+shared_ptr<unsigned char> JpegEncodePool::AcquireOutput(unsigned int size) {
+  // smallest size class that holds size
+  size_t size_class = 0;
+  unsigned int class_size = kMinOutputClassSize;
+  while (class_size < size) {
+    class_size <<= 1;
+    ++size_class;
+  }
+
+  FrameBufferPool *pool = nullptr;
+  {
+    lock_guard<mutex> lock(output_mutex_);
+    if (output_pools_.size() <= size_class) {
+      output_pools_.resize(size_class + 1);
+    }
+    if (output_pools_[size_class] == nullptr) {
+      FrameBufferPoolPara pool_para;
+      pool_para.buffer_size = class_size;
+      pool_para.prefault = false;
+      unique_ptr<FrameBufferPool> new_pool(new (nothrow) FrameBufferPool(
+          pool_para));
+      if ((new_pool == nullptr) || (new_pool->Init() != kDvppOperationOk)) {
+        return shared_ptr<unsigned char>();
+      }
+      output_pools_[size_class] = move(new_pool);
+    }
+    pool = output_pools_[size_class].get();
+  }
+
+  // pools are never removed, Acquire is thread safe
+  return pool->Acquire<unsigned char>();
+}
+}
+}
@@ -0,0 +1,442 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_ezdvpp/tensor_preprocess.h"
+
+#include <cmath>
+#include <cstdint>
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "ascenddk/ascend_ezdvpp/dvpp_utils.h"
+
+using namespace std;
+
+namespace {
+// BT.601 limited range yuv to rgb coefficients, the same as OpenCV NV12
+const float kYScale = 1.164f;
+const float kYOffset = 16.0f;
+const float kUvOffset = 128.0f;
+const float kVToR = 1.596f;
+const float kUToG = -0.391f;
+const float kVToG = -0.813f;
+const float kUToB = 2.018f;
+
+// the range of one color channel
+const float kColorMin = 0.0f;
+const float kColorMax = 255.0f;
+
+// rounding offset, the same as saturate_cast to uchar
+const float kRoundOffset = 0.5f;
+
+// center of a pixel
+const float kPixelCenter = 0.5f;
+
+// chroma plane is half of luma plane in both directions
+const int kChromaSubsample = 2;
+
+// plane index of blue, green and red for bgr order
+const int kBluePlane = 0;
+const int kGreenPlane = 1;
+const int kRedPlane = 2;
+
+/**
+ * @brief convert a float to IEEE half float(round to nearest even)
+ * @param [in] value: float value
+ * @return half float bits
+ */
+uint16_t FloatToHalf(float value) {
+  union {
+    float f;
+    uint32_t u;
+  } bits;
+  bits.f = value;
+
+  uint32_t sign = (bits.u >> 16) & 0x8000;
+  int32_t exponent = static_cast<int32_t>((bits.u >> 23) & 0xff) - 127 + 15;
+  uint32_t mantissa = bits.u & 0x7fffff;
+
+  // NaN or Inf
+  if (((bits.u >> 23) & 0xff) == 0xff) {
+    return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+  }
+
+  // overflow to Inf
+  if (exponent >= 0x1f) {
+    return static_cast<uint16_t>(sign | 0x7c00);
+  }
+
+  // subnormal or zero
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return static_cast<uint16_t>(sign);
+    }
+    mantissa |= 0x800000;
+    uint32_t shift = static_cast<uint32_t>(14 - exponent);
+    uint32_t half_mantissa = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half_mantissa & 1))) {
+      ++half_mantissa;
+    }
+    return static_cast<uint16_t>(sign | half_mantissa);
+  }
+
+  uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10)
+      | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+    // carry into exponent is the correct rounding result
+    ++half;
+  }
+  return static_cast<uint16_t>(half);
+}
+
+/**
+ * @brief clamp the interpolated source coordinate and split it into two
+ *        neighbours and the weight of the second one
+ * @param [in] coordinate: source coordinate
+ * @param [in] min_index: first valid index
+ * @param [in] max_index: last valid index
+ * @param [out] index0: left or top neighbour
+ * @param [out] index1: right or bottom neighbour
+ * @param [out] weight: weight of index1
+ */
+void SplitCoordinate(float coordinate, int min_index, int max_index,
+                     int &index0, int &index1, float &weight) {
+  if (coordinate <= min_index) {
+    index0 = min_index;
+    index1 = min_index;
+    weight = 0.0f;
+    return;
+  }
+  if (coordinate >= max_index) {
+    index0 = max_index;
+    index1 = max_index;
+    weight = 0.0f;
+    return;
+  }
+  index0 = static_cast<int>(coordinate);
+  index1 = index0 + 1;
+  weight = coordinate - index0;
+}
+}
+
+namespace ascend {
+namespace utils {
+
+TensorPreprocess::TensorPreprocess(const TensorPreprocessPara &para) {
+  // construct a instance used to fill tensor slots
+  para_ = para;
+}
+
+TensorPreprocess::~TensorPreprocess() {
+  // destructor
+}
+
+int TensorPreprocess::Init() {
+  int width = para_.dest_resolution.width;
+  int height = para_.dest_resolution.height;
+
+  // extreme value check
+  if (width <= 0 || height <= 0 || width > kTensorMaxEdge
+      || height > kTensorMaxEdge) {
+    ASC_LOG_ERROR("Tensor resolution %d x %d is invalid!", width, height);
+    return kDvppErrorInvalidParameter;
+  }
+
+  if ((para_.yuv_store_type != kYuv420sp && para_.yuv_store_type != kYvu420sp)
+      || (para_.channel_order != kTensorBgr
+          && para_.channel_order != kTensorRgb)
+      || (para_.data_type != kTensorFloat32
+          && para_.data_type != kTensorFloat16)) {
+    ASC_LOG_ERROR("Tensor format is invalid!");
+    return kDvppErrorInvalidParameter;
+  }
+
+  int plane_size = width * height;
+  mean_chw_.assign(plane_size * kTensorChannel, 0.0f);
+  scale_chw_.assign(plane_size * kTensorChannel, 1.0f);
+
+  // transpose HWC tables to CHW, so that one tensor row of one channel is
+  // contiguous in the tables too; divide is replaced by multiply
+  for (int i = 0; i < plane_size; ++i) {
+    for (int c = 0; c < kTensorChannel; ++c) {
+      int hwc_index = i * kTensorChannel + c;
+      int chw_index = c * plane_size + i;
+      if (para_.mean != nullptr) {
+        mean_chw_[chw_index] = para_.mean[hwc_index];
+      }
+      if (para_.std != nullptr) {
+        if (para_.std[hwc_index] == 0.0f) {
+          ASC_LOG_ERROR("Std table has zero value at %d!", hwc_index);
+          return kDvppErrorInvalidParameter;
+        }
+        scale_chw_[chw_index] = 1.0f / para_.std[hwc_index];
+      }
+    }
+  }
+
+  luma_x0_.resize(width);
+  luma_x1_.resize(width);
+  luma_wx_.resize(width);
+  chroma_x0_.resize(width);
+  chroma_x1_.resize(width);
+  chroma_wx_.resize(width);
+  y_row_.resize(width);
+  u_row_.resize(width);
+  v_row_.resize(width);
+  return kDvppOperationOk;
+}
+
+int TensorPreprocess::GetTensorSize() const {
+  int element_size =
+      para_.data_type == kTensorFloat16 ? sizeof(uint16_t) : sizeof(float);
+  return para_.dest_resolution.width * para_.dest_resolution.height
+      * kTensorChannel * element_size;
+}
+
+void TensorPreprocess::BuildHorzTable(const TensorPreprocessRoi &roi) {
+  int width = para_.dest_resolution.width;
+  int roi_width = roi.horz_max - roi.horz_min + 1;
+  float scale = static_cast<float>(roi_width) / width;
+  int chroma_min = roi.horz_min / kChromaSubsample;
+  int chroma_max = roi.horz_max / kChromaSubsample;
+
+  for (int x = 0; x < width; ++x) {
+    // source luma coordinate, pixel centers are aligned
+    float luma = roi.horz_min + (x + kPixelCenter) * scale - kPixelCenter;
+    SplitCoordinate(luma, roi.horz_min, roi.horz_max, luma_x0_[x], luma_x1_[x],
+                    luma_wx_[x]);
+
+    // chroma sample is located at the center of 2x2 luma
+    float chroma = (luma + kPixelCenter) / kChromaSubsample - kPixelCenter;
+    SplitCoordinate(chroma, chroma_min, chroma_max, chroma_x0_[x],
+                    chroma_x1_[x], chroma_wx_[x]);
+  }
+}
+
+void TensorPreprocess::ConvertRow(int row, void *output_buf) {
+  int width = para_.dest_resolution.width;
+  int plane_size = width * para_.dest_resolution.height;
+  int row_offset = row * width;
+
+  // plane index of each color
+  int blue_plane = kBluePlane;
+  int red_plane = kRedPlane;
+  if (para_.channel_order == kTensorRgb) {
+    blue_plane = kRedPlane;
+    red_plane = kBluePlane;
+  }
+  int plane_offset[kTensorChannel] = { blue_plane * plane_size + row_offset,
+      kGreenPlane * plane_size + row_offset, red_plane * plane_size
+          + row_offset };
+
+  const float *y_row = y_row_.data();
+  const float *u_row = u_row_.data();
+  const float *v_row = v_row_.data();
+  float *float_out = static_cast<float *>(output_buf);
+  uint16_t *half_out = static_cast<uint16_t *>(output_buf);
+  bool is_half = (para_.data_type == kTensorFloat16);
+
+  int x = 0;
+#if defined(__aarch64__)
+  // 4 pixels per iteration
+  const float32x4_t y_offset = vdupq_n_f32(kYOffset);
+  const float32x4_t uv_offset = vdupq_n_f32(kUvOffset);
+  const float32x4_t color_min = vdupq_n_f32(kColorMin);
+  const float32x4_t color_max = vdupq_n_f32(kColorMax);
+  for (; x + 4 <= width; x += 4) {
+    float32x4_t y = vmulq_n_f32(vsubq_f32(vld1q_f32(y_row + x), y_offset),
+                                kYScale);
+    float32x4_t u = vsubq_f32(vld1q_f32(u_row + x), uv_offset);
+    float32x4_t v = vsubq_f32(vld1q_f32(v_row + x), uv_offset);
+
+    float32x4_t color[kTensorChannel];
+    color[kBluePlane] = vmlaq_n_f32(y, u, kUToB);
+    color[kGreenPlane] = vmlaq_n_f32(vmlaq_n_f32(y, u, kUToG), v, kVToG);
+    color[kRedPlane] = vmlaq_n_f32(y, v, kVToR);
+
+    for (int c = 0; c < kTensorChannel; ++c) {
+      float32x4_t value = vrndaq_f32(
+          vminq_f32(vmaxq_f32(color[c], color_min), color_max));
+      int index = plane_offset[c] + x;
+      value = vmulq_f32(vsubq_f32(value, vld1q_f32(&mean_chw_[index])),
+                        vld1q_f32(&scale_chw_[index]));
+      if (is_half) {
+        vst1_u16(half_out + index,
+                 vreinterpret_u16_f16(vcvt_f16_f32(value)));
+      } else {
+        vst1q_f32(float_out + index, value);
+      }
+    }
+  }
+#endif
+
+  // tail pixels, or all pixels without neon
+  for (; x < width; ++x) {
+    float y = (y_row[x] - kYOffset) * kYScale;
+    float u = u_row[x] - kUvOffset;
+    float v = v_row[x] - kUvOffset;
+
+    float color[kTensorChannel];
+    color[kBluePlane] = y + kUToB * u;
+    color[kGreenPlane] = y + kUToG * u + kVToG * v;
+    color[kRedPlane] = y + kVToR * v;
+
+    for (int c = 0; c < kTensorChannel; ++c) {
+      float value = color[c] < kColorMin ? kColorMin : color[c];
+      value = value > kColorMax ? kColorMax : value;
+      value = floorf(value + kRoundOffset);
+      int index = plane_offset[c] + x;
+      value = (value - mean_chw_[index]) * scale_chw_[index];
+      if (is_half) {
+        half_out[index] = FloatToHalf(value);
+      } else {
+        float_out[index] = value;
+      }
+    }
+  }
+}
+
+int TensorPreprocess::TensorPreprocessProc(const char *input_buf,
+                                           int input_size,
+                                           const TensorPreprocessRoi &roi,
+                                           void *output_buf,
+                                           int output_size) {
+  // null pointer and extreme value check
+  if (input_buf == nullptr || output_buf == nullptr || input_size <= 0
+      || output_size < GetTensorSize() || y_row_.empty()) {
+    ASC_LOG_ERROR("Tensor preprocess input param and output param is invalid"
+                  " or instance is not initialized!");
+    return kDvppErrorInvalidParameter;
+  }
+
+  int src_width = roi.src_resolution.width;
+  int src_height = roi.src_resolution.height;
+  if (roi.horz_min < 0 || roi.vert_min < 0 || roi.horz_min > roi.horz_max
+      || roi.vert_min > roi.vert_max || roi.horz_max >= src_width
+      || roi.vert_max >= src_height) {
+    ASC_LOG_ERROR("Roi (%d,%d)-(%d,%d) is out of image %d x %d!", roi.horz_min,
+                  roi.vert_min, roi.horz_max, roi.vert_max, src_width,
+                  src_height);
+    return kDvppErrorInvalidParameter;
+  }
+
+  // aligned image keeps the same layout as vpc output
+  int width_stride = src_width;
+  int height_stride = src_height;
+  if (roi.is_input_align) {
+    width_stride = ALIGN_UP(src_width, kVpcWidthAlign);
+    height_stride = ALIGN_UP(src_height, kVpcHeightAlign);
+  }
+  if (static_cast<int64_t>(input_size)
+      < static_cast<int64_t>(width_stride) * height_stride
+          * DVPP_YUV420SP_SIZE_MOLECULE / DVPP_YUV420SP_SIZE_DENOMINATOR) {
+    ASC_LOG_ERROR("Input size %d is less than yuv420sp image %d x %d!",
+                  input_size, width_stride, height_stride);
+    return kDvppErrorInvalidParameter;
+  }
+
+  const unsigned char *luma_plane =
+      reinterpret_cast<const unsigned char *>(input_buf);
+  const unsigned char *chroma_plane = luma_plane
+      + static_cast<ptrdiff_t>(width_stride) * height_stride;
+
+  // u is the first byte of a chroma pair in nv12, v in nv21
+  int u_index = (para_.yuv_store_type == kYuv420sp) ? 0 : 1;
+  int v_index = 1 - u_index;
+
+  BuildHorzTable(roi);
+
+  int width = para_.dest_resolution.width;
+  int height = para_.dest_resolution.height;
+  int roi_height = roi.vert_max - roi.vert_min + 1;
+  float scale = static_cast<float>(roi_height) / height;
+  int chroma_min = roi.vert_min / kChromaSubsample;
+  int chroma_max = roi.vert_max / kChromaSubsample;
+
+  for (int row = 0; row < height; ++row) {
+    // vertical neighbours of luma and chroma
+    float luma = roi.vert_min + (row + kPixelCenter) * scale - kPixelCenter;
+    int luma_y0 = 0;
+    int luma_y1 = 0;
+    float luma_wy = 0.0f;
+    SplitCoordinate(luma, roi.vert_min, roi.vert_max, luma_y0, luma_y1,
+                    luma_wy);
+    float chroma = (luma + kPixelCenter) / kChromaSubsample - kPixelCenter;
+    int chroma_y0 = 0;
+    int chroma_y1 = 0;
+    float chroma_wy = 0.0f;
+    SplitCoordinate(chroma, chroma_min, chroma_max, chroma_y0, chroma_y1,
+                    chroma_wy);
+
+    const unsigned char *y0 = luma_plane
+        + static_cast<ptrdiff_t>(luma_y0) * width_stride;
+    const unsigned char *y1 = luma_plane
+        + static_cast<ptrdiff_t>(luma_y1) * width_stride;
+    const unsigned char *uv0 = chroma_plane
+        + static_cast<ptrdiff_t>(chroma_y0) * width_stride;
+    const unsigned char *uv1 = chroma_plane
+        + static_cast<ptrdiff_t>(chroma_y1) * width_stride;
+
+    // bilinear sample of the row, source pixels are only read here
+    for (int x = 0; x < width; ++x) {
+      int lx0 = luma_x0_[x];
+      int lx1 = luma_x1_[x];
+      float lwx = luma_wx_[x];
+      float top = y0[lx0] + (y0[lx1] - y0[lx0]) * lwx;
+      float bottom = y1[lx0] + (y1[lx1] - y1[lx0]) * lwx;
+      y_row_[x] = top + (bottom - top) * luma_wy;
+
+      int cx0 = chroma_x0_[x] * kChromaSubsample;
+      int cx1 = chroma_x1_[x] * kChromaSubsample;
+      float cwx = chroma_wx_[x];
+      top = uv0[cx0 + u_index] + (uv0[cx1 + u_index] - uv0[cx0 + u_index]) * cwx;
+      bottom = uv1[cx0 + u_index]
+          + (uv1[cx1 + u_index] - uv1[cx0 + u_index]) * cwx;
+      u_row_[x] = top + (bottom - top) * chroma_wy;
+      top = uv0[cx0 + v_index] + (uv0[cx1 + v_index] - uv0[cx0 + v_index]) * cwx;
+      bottom = uv1[cx0 + v_index]
+          + (uv1[cx1 + v_index] - uv1[cx0 + v_index]) * cwx;
+      v_row_[x] = top + (bottom - top) * chroma_wy;
+    }
+
+    ConvertRow(row, output_buf);
+  }
+
+  return kDvppOperationOk;
+}
+}
+}
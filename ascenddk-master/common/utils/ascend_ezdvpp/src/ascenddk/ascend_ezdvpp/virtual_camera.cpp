@@ -0,0 +1,170 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_ezdvpp/virtual_camera.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include "securec.h"
+#include "ascenddk/ascend_ezdvpp/dvpp_utils.h"
+
+using namespace std;
+
+namespace {
+// yuv420sp size = width * height * 3 / 2
+const int kYuv420spSizeNumerator = 3;
+const int kYuv420spSizeDenominator = 2;
+}
+
+namespace ascend {
+namespace utils {
+
+VirtualCamera::VirtualCamera(const VirtualCameraPara &para) {
+  para_ = para;
+}
+
+VirtualCamera::~VirtualCamera() {
+  if (clip_ != nullptr) {
+    munmap(clip_, clip_size_);
+    clip_ = nullptr;
+  }
+}
+
+int VirtualCamera::Init() {
+  if (para_.path.empty() || (para_.resolution.width <= 0)
+      || (para_.resolution.height <= 0) || (para_.fps < 0)) {
+    ASC_LOG_ERROR("Invalid virtual camera parameter, path:%s "
+                  "resolution:%dx%d fps:%d.", para_.path.c_str(),
+                  para_.resolution.width, para_.resolution.height,
+                  para_.fps);
+    return kDvppErrorInvalidParameter;
+  }
+
+  frame_size_ = para_.resolution.width * para_.resolution.height
+      * kYuv420spSizeNumerator / kYuv420spSizeDenominator;
+
+  int fd = open(para_.path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    ASC_LOG_ERROR("Failed to open clip %s, errno:%d.", para_.path.c_str(),
+                  errno);
+    return kDvppErrorOpenFileFail;
+  }
+
+  struct stat file_stat;
+  if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size < frame_size_)) {
+    ASC_LOG_ERROR("Clip %s has no whole frame of %d bytes.",
+                  para_.path.c_str(), frame_size_);
+    close(fd);
+    return kDvppErrorOpenFileFail;
+  }
+
+  // the mapping keeps the file alive, the descriptor is not needed any more
+  clip_size_ = file_stat.st_size;
+  void *clip = mmap(nullptr, clip_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (clip == MAP_FAILED) {
+    ASC_LOG_ERROR("Failed to map clip %s, errno:%d.", para_.path.c_str(),
+                  errno);
+    return kDvppErrorOpenFileFail;
+  }
+  clip_ = static_cast<char *>(clip);
+  madvise(clip_, clip_size_, MADV_SEQUENTIAL);
+
+  // a partial frame at the end of the clip is ignored
+  frame_count_ = clip_size_ / frame_size_;
+
+  return kDvppOperationOk;
+}
+
+int VirtualCamera::ReadFrame(char *buf, int size) {
+  if ((clip_ == nullptr) || (buf == nullptr) || (size < frame_size_)) {
+    return kDvppErrorInvalidParameter;
+  }
+
+  if (next_frame_ == frame_count_) {
+    if (!para_.loop) {
+      return kDvppErrorEndOfStream;
+    }
+    next_frame_ = 0;
+  }
+
+  WaitFrameTime();
+
+  int ret = memcpy_s(buf, size,
+                     clip_ + static_cast<size_t>(next_frame_) * frame_size_,
+                     frame_size_);
+  if (ret != EOK) {
+    ASC_LOG_ERROR("Failed to copy frame %d, ret:%d.", next_frame_, ret);
+    return kDvppErrorMemcpyFail;
+  }
+
+  next_frame_++;
+  return kDvppOperationOk;
+}
+
+int VirtualCamera::GetFrameSize() const {
+  return frame_size_;
+}
+
+int VirtualCamera::GetFrameCount() const {
+  return frame_count_;
+}
+
+void VirtualCamera::WaitFrameTime() {
+  if (para_.fps == 0) {
+    return;
+  }
+
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+  chrono::steady_clock::duration period = chrono::duration_cast<
+      chrono::steady_clock::duration>(chrono::seconds(1)) / para_.fps;
+
+  // a consumer slower than the fps gets the frames at its own pace,
+  // there is no burst to catch up afterwards, like a real camera
+  if ((next_time_ == chrono::steady_clock::time_point())
+      || (next_time_ < now)) {
+    next_time_ = now + period;
+    return;
+  }
+
+  this_thread::sleep_until(next_time_);
+  next_time_ += period;
+}
+}
+}
@@ -0,0 +1,155 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_ENGINE_REGISTRY_H_
+#define ASCENDDK_HIAI_EMULATOR_ENGINE_REGISTRY_H_
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hiaiengine/status.h"
+
+namespace hiai {
+class Engine;
+}
+
+namespace ascend {
+namespace emulator {
+
+// most input ports of an engine, the arguments of Process
+const uint32_t kMaxEnginePortNum = 8;
+
+// creates an engine
+typedef std::function<hiai::Engine *()> EngineCreator;
+
+// calls Process of an engine, one argument per input port
+typedef std::function<
+    HIAI_StatusT(hiai::Engine *, const std::vector<std::shared_ptr<void>> &)>
+    EngineProcessor;
+
+struct EngineFactory {
+  // engine_name in graph.config
+  std::string name;
+
+  // number of input ports
+  uint32_t input_size = 0;
+
+  EngineCreator create;
+  EngineProcessor process;
+};
+
+// serialize function of HIAI_REGISTER_SERIALIZE_FUNC
+typedef std::function<
+    void(void *, std::string &, uint8_t *&, uint32_t &)> SerializeFunc;
+
+// deserialize function of HIAI_REGISTER_SERIALIZE_FUNC
+typedef std::function<
+    std::shared_ptr<void>(const char *, const uint32_t &, const uint8_t *,
+                          const uint32_t &)> DeserializeFunc;
+
+/*
+ * Registers an engine when its library is loaded, used by
+ * HIAI_IMPL_ENGINE_PROCESS.
+ */
+class EngineRegister {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] name: engine name
+   * @param [in] input_size: number of input ports
+   * @param [in] create: creates the engine
+   * @param [in] process: calls Process of the engine
+   */
+  EngineRegister(const std::string &name, uint32_t input_size,
+                 const EngineCreator &create, const EngineProcessor &process);
+};
+
+/*
+ * Registers a message type, used by HIAI_REGISTER_DATA_TYPE and
+ * HIAI_REGISTER_SERIALIZE_FUNC.
+ */
+class MessageRegister {
+ public:
+  /**
+   * @brief register a message sent as it is
+   * @param [in] name: message name
+   */
+  explicit MessageRegister(const std::string &name);
+
+  /**
+   * @brief register a message with its own serialization
+   * @param [in] name: message name
+   * @param [in] serialize: serialize function
+   * @param [in] deserialize: deserialize function
+   */
+  MessageRegister(const std::string &name, const SerializeFunc &serialize,
+                  const DeserializeFunc &deserialize);
+};
+
+/**
+ * @brief get a registered engine
+ * @param [in] name: engine name
+ * @return factory of the engine, nullptr if it is not registered
+ */
+const EngineFactory *GetEngineFactory(const std::string &name);
+
+/**
+ * @brief check whether a message type is registered
+ * @param [in] name: message name
+ * @return true: registered
+ */
+bool IsMessageRegistered(const std::string &name);
+
+/**
+ * @brief pass a message between host and device. A message with serialize
+ *        functions is serialized, its data buffer is copied to memory of
+ *        HIAI_DMalloc and it is deserialized like the real transfer does;
+ *        any other message is passed as it is
+ * @param [in] name: message name
+ * @param [in] message: message sent
+ * @param [out] received: message received
+ * @return HIAI_OK or HIAI_MEMORY_ALLOC_FAILED
+ */
+HIAI_StatusT TransferMessage(const std::string &name,
+                             const std::shared_ptr<void> &message,
+                             std::shared_ptr<void> &received);
+}
+}
+
+#define HIAI_EMULATOR_CONCAT_IMPL(a, b) a##b
+#define HIAI_EMULATOR_CONCAT(a, b) HIAI_EMULATOR_CONCAT_IMPL(a, b)
+
+#endif /* ASCENDDK_HIAI_EMULATOR_ENGINE_REGISTRY_H_ */
@@ -0,0 +1,100 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_GRAPH_CONFIG_H_
+#define ASCENDDK_HIAI_EMULATOR_GRAPH_CONFIG_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "hiaiengine/ai_types.h"
+
+namespace ascend {
+namespace emulator {
+
+// side of an engine in graph.config
+enum EngineSide {
+  kEngineSideHost = 0,
+  kEngineSideDevice = 1,
+};
+
+// an engine of graph.config
+struct EngineConfig {
+  uint32_t id = 0;
+  std::string engine_name;
+  EngineSide side = kEngineSideHost;
+
+  // threads calling Process
+  uint32_t thread_num = 1;
+
+  // most data waiting on one input port
+  uint32_t queue_size = 200;
+
+  // library of the engine, loaded when the engine is not registered yet
+  std::string so_name;
+
+  hiai::AIConfig ai_config;
+  std::vector<hiai::AIModelDescription> model_descs;
+};
+
+// a connect of graph.config
+struct ConnectConfig {
+  uint32_t src_engine_id = 0;
+  uint32_t src_port_id = 0;
+  uint32_t target_engine_id = 0;
+  uint32_t target_port_id = 0;
+};
+
+// a graph of graph.config
+struct GraphConfig {
+  uint32_t graph_id = 0;
+  int32_t priority = 0;
+  std::vector<EngineConfig> engines;
+  std::vector<ConnectConfig> connects;
+};
+
+/**
+ * @brief parse graph.config, the protobuf text format of the DDK. The
+ *        fields the emulator does not use are ignored
+ * @param [in] file: graph.config
+ * @param [out] graphs: graphs of the file
+ * @return HIAI_OK, HIAI_GRAPH_NOT_EXIST when the file can not be read, or
+ *         HIAI_GRAPH_INVALID_VALUE
+ */
+uint32_t ParseGraphConfig(const std::string &file,
+                          std::vector<GraphConfig> &graphs);
+}
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_GRAPH_CONFIG_H_ */
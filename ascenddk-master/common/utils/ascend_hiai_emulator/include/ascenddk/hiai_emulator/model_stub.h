@@ -0,0 +1,188 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_MODEL_STUB_H_
+#define ASCENDDK_HIAI_EMULATOR_MODEL_STUB_H_
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ascenddk/hiai_emulator/engine_registry.h"
+#include "hiaiengine/ai_tensor.h"
+#include "hiaiengine/ai_types.h"
+
+namespace ascend {
+namespace emulator {
+
+/*
+ * A model run by AIModelManager on the host, in place of the offline model
+ * that only runs on the device. It replays fixed outputs (ReplayModelStub)
+ * or runs a CPU implementation of the model registered by
+ * HIAI_EMULATOR_REGISTER_MODEL_STUB.
+ */
+class ModelStub {
+ public:
+  virtual ~ModelStub() {
+  }
+
+  /**
+   * @brief create the output tensors for the inputs
+   * @param [in] inputs: input tensors
+   * @param [out] outputs: output tensors
+   * @return true: success
+   */
+  virtual bool CreateOutputTensor(
+      const std::vector<std::shared_ptr<hiai::IAITensor>> &inputs,
+      std::vector<std::shared_ptr<hiai::IAITensor>> &outputs) = 0;
+
+  /**
+   * @brief run the model
+   * @param [in] inputs: input tensors
+   * @param [in] outputs: output tensors of CreateOutputTensor or of the
+   *             caller, filled by the model
+   * @return true: success
+   */
+  virtual bool Process(
+      const std::vector<std::shared_ptr<hiai::IAITensor>> &inputs,
+      std::vector<std::shared_ptr<hiai::IAITensor>> &outputs) = 0;
+
+  /**
+   * @brief get the input and output shapes
+   * @param [out] input_dims: input shapes
+   * @param [out] output_dims: output shapes
+   * @return true: success
+   */
+  virtual bool GetTensorDim(std::vector<hiai::TensorDimension> &input_dims,
+                            std::vector<hiai::TensorDimension> &output_dims) {
+    input_dims.clear();
+    output_dims.clear();
+    return true;
+  }
+};
+
+// creates a model stub for an ai_model of graph.config, nullptr: failed
+typedef std::function<
+    std::shared_ptr<ModelStub>(const hiai::AIModelDescription &)>
+    ModelStubCreator;
+
+/*
+ * Replays the outputs of the real model. The replay file is a text file:
+ *   # comment
+ *   output <raw file of output 0>
+ *   output <raw file of output 1>
+ *   latency_us <time of one inference>
+ * A raw file path is relative to the directory of the replay file. Every
+ * Process copies the same bytes to the outputs and sleeps latency_us.
+ */
+class ReplayModelStub : public ModelStub {
+ public:
+  /**
+   * @brief load a replay file
+   * @param [in] replay_file: replay file
+   * @return true: success
+   */
+  bool Load(const std::string &replay_file);
+
+  bool CreateOutputTensor(
+      const std::vector<std::shared_ptr<hiai::IAITensor>> &inputs,
+      std::vector<std::shared_ptr<hiai::IAITensor>> &outputs) override;
+
+  bool Process(const std::vector<std::shared_ptr<hiai::IAITensor>> &inputs,
+               std::vector<std::shared_ptr<hiai::IAITensor>> &outputs) override;
+
+  bool GetTensorDim(std::vector<hiai::TensorDimension> &input_dims,
+                    std::vector<hiai::TensorDimension> &output_dims) override;
+
+ private:
+  // bytes of every output
+  std::vector<std::vector<uint8_t>> outputs_;
+
+  // time of one inference in microsecond
+  uint32_t latency_us_ = 0;
+};
+
+/**
+ * @brief register a model stub, replaces the one of the same name
+ * @param [in] name: name or file name of the model path in graph.config,
+ *             "*" for every model without its own stub or replay file
+ * @param [in] creator: creates the stub
+ */
+void RegisterModelStub(const std::string &name,
+                       const ModelStubCreator &creator);
+
+/**
+ * @brief create the stub of a model. The stub registered for the model name
+ *        is used first, then the one for the file name of the model path,
+ *        then the replay file <path>.replay, then the one for "*"
+ * @param [in] model_desc: ai_model of graph.config
+ * @return stub, nullptr if no stub is found
+ */
+std::shared_ptr<ModelStub> CreateModelStub(
+    const hiai::AIModelDescription &model_desc);
+
+/**
+ * @brief create a tensor that owns a new buffer
+ * @param [in] size: buffer size in byte
+ * @param [in] dim: name and shape of the tensor
+ * @return tensor, its buffer is zero filled
+ */
+std::shared_ptr<hiai::AINeuralNetworkBuffer> CreateNeuralNetworkBuffer(
+    uint32_t size, const hiai::TensorDimension &dim);
+
+/*
+ * Registers a model stub when its library is loaded, used by
+ * HIAI_EMULATOR_REGISTER_MODEL_STUB.
+ */
+class ModelStubRegister {
+ public:
+  ModelStubRegister(const std::string &name,
+                    const ModelStubCreator &creator) {
+    RegisterModelStub(name, creator);
+  }
+};
+}
+}
+
+// register a ModelStub subclass with a default constructor for a model
+#define HIAI_EMULATOR_REGISTER_MODEL_STUB(name, stub_class) \
+  static ascend::emulator::ModelStubRegister \
+      HIAI_EMULATOR_CONCAT(g_model_stub_register_, __LINE__)( \
+          name, [](const hiai::AIModelDescription &) \
+              -> std::shared_ptr<ascend::emulator::ModelStub> { \
+            return std::make_shared<stub_class>(); \
+          })
+
+#endif /* ASCENDDK_HIAI_EMULATOR_MODEL_STUB_H_ */
@@ -0,0 +1,82 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MEMORY_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MEMORY_H_
+
+#include <stdint.h>
+
+#include "hiaiengine/status.h"
+
+// default wait of HIAI_DMalloc in millisecond
+#define MALLOC_DEFAULT_TIME_OUT (500)
+
+namespace hiai {
+
+// who frees memory of HIAI_DMalloc after it is sent
+enum HIAI_MEMORY_ATTR {
+  MEMORY_ATTR_NONE = 0,
+  MEMORY_ATTR_AUTO_FREE = 2,  // the framework after the transfer
+  MEMORY_ATTR_MANUAL_FREE = 4,  // the caller with HIAI_DFree
+};
+
+/*
+ * Memory that can be sent between host and device without a copy. On the
+ * host it is ordinary aligned heap memory, and the transfer between host and
+ * device engines copies it like the real transfer does.
+ */
+class HIAIMemory {
+ public:
+  /**
+   * @brief allocate transfer memory
+   * @param [in] size: size in byte
+   * @param [out] ptr: memory
+   * @param [in] timeout: not used on the host
+   * @param [in] attr: enum HIAI_MEMORY_ATTR
+   * @return HIAI_OK or HIAI_MEMORY_ALLOC_FAILED
+   */
+  static HIAI_StatusT HIAI_DMalloc(const uint32_t size, void *&ptr,
+                                   const uint32_t timeout =
+                                       MALLOC_DEFAULT_TIME_OUT,
+                                   uint32_t attr = MEMORY_ATTR_AUTO_FREE);
+
+  /**
+   * @brief free memory of HIAI_DMalloc
+   * @param [in] ptr: memory, nullptr is ignored
+   * @return HIAI_OK
+   */
+  static HIAI_StatusT HIAI_DFree(void *ptr);
+};
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MEMORY_H_ */
@@ -0,0 +1,140 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MODEL_MANAGER_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MODEL_MANAGER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hiaiengine/ai_tensor.h"
+#include "hiaiengine/ai_types.h"
+
+namespace ascend {
+namespace emulator {
+class ModelStub;
+}
+}
+
+namespace hiai {
+
+// parameters of one Process call, "model_name" selects the model
+class AIContext {
+ public:
+  void AddPara(const std::string &key, const std::string &value) {
+    paras_[key] = value;
+  }
+
+  AIStatus GetPara(const std::string &key, std::string &value) const {
+    std::map<std::string, std::string>::const_iterator it = paras_.find(key);
+    if (it == paras_.end()) {
+      return FAILED;
+    }
+
+    value = it->second;
+    return SUCCESS;
+  }
+
+ private:
+  std::map<std::string, std::string> paras_;
+};
+
+/*
+ * Runs the models of an engine. On the host every model is a
+ * ascend::emulator::ModelStub chosen by the name or the path of the model,
+ * see model_stub.h.
+ */
+class AIModelManager {
+ public:
+  /**
+   * @brief load the models
+   * @param [in] config: ai_config of the engine
+   * @param [in] model_descs: models, the first one is the default model
+   * @return SUCCESS or FAILED
+   */
+  AIStatus Init(const AIConfig &config,
+                const std::vector<AIModelDescription> &model_descs);
+
+  /**
+   * @brief run a model
+   * @param [in] context: "model_name" selects the model, default: the first
+   * @param [in] inputs: input tensors
+   * @param [out] outputs: output tensors, created when empty
+   * @param [in] timeout: not used on the host
+   * @return SUCCESS or FAILED
+   */
+  AIStatus Process(AIContext &context,
+                   const std::vector<std::shared_ptr<IAITensor>> &inputs,
+                   std::vector<std::shared_ptr<IAITensor>> &outputs,
+                   uint32_t timeout);
+
+  /**
+   * @brief create the output tensors of the default model
+   * @param [in] inputs: input tensors
+   * @param [out] outputs: output tensors
+   * @return SUCCESS or FAILED
+   */
+  AIStatus CreateOutputTensor(
+      const std::vector<std::shared_ptr<IAITensor>> &inputs,
+      std::vector<std::shared_ptr<IAITensor>> &outputs);
+
+  /**
+   * @brief get the input and output shapes of a model
+   * @param [in] model_name: model name, empty: the default model
+   * @param [out] input_dims: input shapes
+   * @param [out] output_dims: output shapes
+   * @return SUCCESS or FAILED
+   */
+  AIStatus GetModelIOTensorDim(const std::string &model_name,
+                               std::vector<TensorDimension> &input_dims,
+                               std::vector<TensorDimension> &output_dims);
+
+ private:
+  /**
+   * @brief get a loaded model
+   * @param [in] model_name: model name, empty: the default model
+   * @return model, nullptr if not loaded
+   */
+  std::shared_ptr<ascend::emulator::ModelStub> GetModel(
+      const std::string &model_name) const;
+
+  // loaded models by name, in the order of Init
+  std::vector<std::string> model_names_;
+  std::map<std::string, std::shared_ptr<ascend::emulator::ModelStub>> models_;
+};
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_MODEL_MANAGER_H_ */
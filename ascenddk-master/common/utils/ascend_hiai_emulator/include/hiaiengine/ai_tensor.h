@@ -0,0 +1,174 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TENSOR_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TENSOR_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "hiaiengine/ai_types.h"
+
+namespace hiai {
+
+// shape of a model input or output
+struct TensorDimension {
+  uint32_t n = 0;
+  uint32_t c = 0;
+  uint32_t h = 0;
+  uint32_t w = 0;
+  uint32_t data_type = 0;
+  uint32_t size = 0;
+  std::string name;
+};
+
+// input or output of a model
+class IAITensor {
+ public:
+  virtual ~IAITensor() {
+  }
+};
+
+// a buffer of bytes
+class AISimpleTensor : public IAITensor {
+ public:
+  AISimpleTensor() {
+  }
+
+  // class destructor, frees the buffer if the tensor owns it
+  virtual ~AISimpleTensor() {
+    ReleaseBuffer();
+  }
+
+  /**
+   * @brief set the buffer of the tensor
+   * @param [in] data: buffer
+   * @param [in] size: buffer size in byte
+   * @param [in] is_owner: the tensor deletes the buffer, it must come from
+   *             new uint8_t[]
+   */
+  void SetBuffer(void *data, uint32_t size, bool is_owner = false) {
+    ReleaseBuffer();
+    data_ = data;
+    size_ = size;
+    is_owner_ = is_owner;
+  }
+
+  void *GetBuffer() const {
+    return data_;
+  }
+
+  uint32_t GetSize() const {
+    return size_;
+  }
+
+ private:
+  AISimpleTensor(const AISimpleTensor &) = delete;
+  AISimpleTensor &operator=(const AISimpleTensor &) = delete;
+
+  void ReleaseBuffer() {
+    if (is_owner_) {
+      delete[] static_cast<uint8_t *>(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    is_owner_ = false;
+  }
+
+  void *data_ = nullptr;
+  uint32_t size_ = 0;
+  bool is_owner_ = false;
+};
+
+// a buffer with the name and shape of a model input or output
+class AINeuralNetworkBuffer : public AISimpleTensor {
+ public:
+  const std::string &GetName() const {
+    return name_;
+  }
+
+  void SetName(const std::string &name) {
+    name_ = name;
+  }
+
+  int32_t GetNumber() const {
+    return number_;
+  }
+
+  void SetNumber(int32_t number) {
+    number_ = number;
+  }
+
+  int32_t GetChannel() const {
+    return channel_;
+  }
+
+  void SetChannel(int32_t channel) {
+    channel_ = channel;
+  }
+
+  int32_t GetHeight() const {
+    return height_;
+  }
+
+  void SetHeight(int32_t height) {
+    height_ = height;
+  }
+
+  int32_t GetWidth() const {
+    return width_;
+  }
+
+  void SetWidth(int32_t width) {
+    width_ = width;
+  }
+
+  int32_t GetData_type() const {
+    return data_type_;
+  }
+
+  void SetData_type(int32_t data_type) {
+    data_type_ = data_type;
+  }
+
+ private:
+  std::string name_;
+  int32_t number_ = 0;
+  int32_t channel_ = 0;
+  int32_t height_ = 0;
+  int32_t width_ = 0;
+  int32_t data_type_ = 0;
+};
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TENSOR_H_ */
@@ -0,0 +1,141 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TYPES_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TYPES_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "hiaiengine/status.h"
+
+namespace hiai {
+
+// result of the model manager API
+typedef int32_t AIStatus;
+const AIStatus SUCCESS = 0;
+const AIStatus FAILED = 1;
+
+// one name/value item of the ai_config of an engine in graph.config
+class AIConfigItem {
+ public:
+  const std::string &name() const {
+    return name_;
+  }
+
+  void set_name(const std::string &name) {
+    name_ = name;
+  }
+
+  const std::string &value() const {
+    return value_;
+  }
+
+  void set_value(const std::string &value) {
+    value_ = value;
+  }
+
+ private:
+  std::string name_;
+  std::string value_;
+};
+
+// ai_config of an engine in graph.config, passed to Engine::Init
+class AIConfig {
+ public:
+  int items_size() const {
+    return (int) items_.size();
+  }
+
+  const AIConfigItem &items(int index) const {
+    return items_[index];
+  }
+
+  AIConfigItem *mutable_items(int index) {
+    return &items_[index];
+  }
+
+  AIConfigItem *add_items() {
+    items_.push_back(AIConfigItem());
+    return &items_.back();
+  }
+
+ private:
+  std::vector<AIConfigItem> items_;
+};
+
+// model loaded by AIModelManager
+class AIModelDescription {
+ public:
+  const std::string &name() const {
+    return name_;
+  }
+
+  void set_name(const std::string &name) {
+    name_ = name;
+  }
+
+  const std::string &path() const {
+    return path_;
+  }
+
+  void set_path(const std::string &path) {
+    path_ = path;
+  }
+
+  const std::string &key() const {
+    return key_;
+  }
+
+  void set_key(const std::string &key) {
+    key_ = key;
+  }
+
+  int32_t type() const {
+    return type_;
+  }
+
+  void set_type(int32_t type) {
+    type_ = type;
+  }
+
+ private:
+  std::string name_;
+  std::string path_;
+  std::string key_;
+  int32_t type_ = 0;
+};
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_AI_TYPES_H_ */
@@ -0,0 +1,184 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/vector.hpp"
+#include "hiaiengine/status.h"
+
+// the engines use the names of std without std::, like the DDK headers
+// allow them to
+using namespace std;
+
+namespace hiai {
+
+enum IMAGEFORMAT {
+  RGB565,
+  RGB888,
+  XRGB8888,
+  BGR888,
+  YUV420SP,
+  YUV422SP,
+  YUV444SP,
+  YVU420SP,
+  YUV420P,
+  JPEG,
+  PNG,
+  CUSTOM,
+};
+
+// an image, size is the number of T in data
+template<class T>
+struct ImageData {
+  IMAGEFORMAT format = YUV420SP;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t channel = 0;
+  uint32_t depth = 0;
+  uint32_t height_step = 0;
+  uint32_t width_step = 0;
+  uint32_t size = 0;
+  std::shared_ptr<T> data;
+};
+
+template<class Archive, class T>
+void serialize(Archive &ar, ImageData<T> &data) {
+  ar(data.format, data.width, data.height, data.channel, data.depth,
+     data.height_step, data.width_step, data.size);
+  if ((data.size > 0) && (data.data == nullptr)) {
+    data.data.reset(new T[data.size], std::default_delete<T[]>());
+  }
+  if (data.size > 0) {
+    ar(cereal::binary_data(data.data.get(), data.size * sizeof(T)));
+  }
+}
+
+struct Point2D {
+  int32_t x = 0;
+  int32_t y = 0;
+};
+
+template<class Archive>
+void serialize(Archive &ar, Point2D &data) {
+  ar(data.x, data.y);
+}
+
+template<class T>
+struct Rectangle {
+  T anchor_lt;
+  T anchor_rb;
+};
+
+template<class Archive, class T>
+void serialize(Archive &ar, Rectangle<T> &data) {
+  ar(data.anchor_lt, data.anchor_rb);
+}
+
+// a frame of a stream
+struct FrameInfo {
+  bool is_first = false;
+  bool is_last = false;
+  uint32_t channel_id = 0;
+  uint32_t processor_stream_id = 0;
+  uint32_t frame_id = 0;
+  uint32_t source_id = 0;
+  uint64_t timestamp = 0;
+};
+
+template<class Archive>
+void serialize(Archive &ar, FrameInfo &data) {
+  ar(data.is_first, data.is_last, data.channel_id, data.processor_stream_id,
+     data.frame_id, data.source_id, data.timestamp);
+}
+
+// the frames of a batch
+struct BatchInfo {
+  bool is_first = false;
+  bool is_last = false;
+  uint32_t batch_size = 0;
+  uint32_t max_batch_size = 0;
+  uint32_t batch_ID = 0;
+  uint32_t channel_ID = 0;
+  uint32_t processor_stream_ID = 0;
+  std::vector<uint32_t> frame_ID;
+  std::vector<uint32_t> source_ID;
+  std::vector<uint64_t> timestamp;
+};
+
+template<class Archive>
+void serialize(Archive &ar, BatchInfo &data) {
+  ar(data.is_first, data.is_last, data.batch_size, data.max_batch_size,
+     data.batch_ID, data.channel_ID, data.processor_stream_ID, data.frame_ID,
+     data.source_ID, data.timestamp);
+}
+
+template<class T>
+struct BatchImagePara {
+  BatchInfo b_info;
+  std::vector<ImageData<T>> v_img;
+};
+
+template<class Archive, class T>
+void serialize(Archive &ar, BatchImagePara<T> &data) {
+  ar(data.b_info, data.v_img);
+}
+
+struct RawDataBuffer {
+  uint32_t len_of_byte = 0;
+  std::shared_ptr<uint8_t> data;
+};
+
+template<class Archive>
+void serialize(Archive &ar, RawDataBuffer &data) {
+  ar(data.len_of_byte);
+  if ((data.len_of_byte > 0) && (data.data == nullptr)) {
+    data.data.reset(new uint8_t[data.len_of_byte],
+                    std::default_delete<uint8_t[]>());
+  }
+  if (data.len_of_byte > 0) {
+    ar(cereal::binary_data(data.data.get(), data.len_of_byte));
+  }
+}
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_H_ */
@@ -0,0 +1,53 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_REG_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_REG_H_
+
+#include "ascenddk/hiai_emulator/engine_registry.h"
+#include "hiaiengine/data_type.h"
+
+// register a message type sent by SendData. Engines of one process pass the
+// message as it is, so the type is only recorded
+#define HIAI_REGISTER_DATA_TYPE(name, type) \
+  static ascend::emulator::MessageRegister \
+      HIAI_EMULATOR_CONCAT(g_message_register_, __LINE__)(name)
+
+// register a message type with its own serialization, used when the message
+// passes between host and device engines
+#define HIAI_REGISTER_SERIALIZE_FUNC(name, type, serialize, deserialize) \
+  static ascend::emulator::MessageRegister \
+      HIAI_EMULATOR_CONCAT(g_message_register_, __LINE__)(name, serialize, \
+                                                          deserialize)
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_DATA_TYPE_REG_H_ */
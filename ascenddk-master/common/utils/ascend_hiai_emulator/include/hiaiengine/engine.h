@@ -0,0 +1,142 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_ENGINE_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_ENGINE_H_
+
+#include <stdint.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ascenddk/hiai_emulator/engine_registry.h"
+#include "hiaiengine/ai_types.h"
+#include "hiaiengine/data_type.h"
+#include "hiaiengine/log.h"
+#include "hiaiengine/status.h"
+
+namespace ascend {
+namespace emulator {
+class EngineNode;
+}
+}
+
+namespace hiai {
+
+/*
+ * Base class of the engines of a graph. The graph creates one engine per
+ * engine in graph.config, calls Init once and then Process from thread_num
+ * threads, once for every data that arrives on an input port.
+ */
+class Engine {
+ public:
+  Engine() {
+  }
+
+  virtual ~Engine() {
+  }
+
+  /**
+   * @brief initialize the engine
+   * @param [in] config: ai_config of the engine in graph.config
+   * @param [in] model_desc: ai_model of the engine in graph.config
+   * @return HIAI_OK: success, the graph is not created otherwise
+   */
+  virtual HIAI_StatusT Init(const AIConfig &config,
+                            const std::vector<AIModelDescription> &model_desc) {
+    return HIAI_OK;
+  }
+
+  /**
+   * @brief send data from an output port to the engines connected to it, or
+   *        to the DataRecvInterface set on it
+   * @param [in] port_id: output port
+   * @param [in] message_name: registered message type
+   * @param [in] data_ptr: data
+   * @param [in] timeout: wait for a full queue in millisecond, 0: no wait
+   * @return HIAI_OK, HIAI_QUEUE_FULL when the queue of a receiver is full,
+   *         or an error
+   */
+  HIAI_StatusT SendData(uint32_t port_id, const std::string &message_name,
+                        const std::shared_ptr<void> &data_ptr,
+                        uint32_t timeout = 0);
+
+  // id of the graph of the engine
+  uint32_t GetGraphId() const;
+
+  // id of the engine in graph.config
+  uint32_t GetEngineId() const;
+
+ private:
+  Engine(const Engine &) = delete;
+  Engine &operator=(const Engine &) = delete;
+
+  friend class ascend::emulator::EngineNode;
+
+  // node of the engine in its graph, set before Init
+  ascend::emulator::EngineNode *node_ = nullptr;
+};
+}
+
+// arguments of Process, one per input port
+#define HIAI_PROCESS_ARGS \
+  std::shared_ptr<void> arg0, std::shared_ptr<void> arg1, \
+  std::shared_ptr<void> arg2, std::shared_ptr<void> arg3, \
+  std::shared_ptr<void> arg4, std::shared_ptr<void> arg5, \
+  std::shared_ptr<void> arg6, std::shared_ptr<void> arg7
+
+// declare Process in the class of an engine
+#define HIAI_DEFINE_PROCESS(input_size, output_size) \
+ public: \
+  static_assert((input_size) <= ascend::emulator::kMaxEnginePortNum, \
+                "too many input ports"); \
+  HIAI_StatusT Process(HIAI_PROCESS_ARGS);
+
+// register an engine and define its Process, arg0 ... arg<input_size - 1>
+// hold the data of the input ports, only the port the data arrived on is
+// not nullptr
+#define HIAI_IMPL_ENGINE_PROCESS(name, engine_class, input_size) \
+  static ascend::emulator::EngineRegister \
+      HIAI_EMULATOR_CONCAT(g_engine_register_, __LINE__)( \
+          name, input_size, \
+          []() -> hiai::Engine * { return new engine_class(); }, \
+          [](hiai::Engine *engine, \
+             const std::vector<std::shared_ptr<void>> &args) { \
+            return static_cast<engine_class *>(engine)->Process( \
+                args[0], args[1], args[2], args[3], args[4], args[5], \
+                args[6], args[7]); \
+          }); \
+  HIAI_StatusT engine_class::Process(HIAI_PROCESS_ARGS)
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_ENGINE_H_ */
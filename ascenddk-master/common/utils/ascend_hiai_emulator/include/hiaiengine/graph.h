@@ -0,0 +1,156 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_GRAPH_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_GRAPH_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "hiaiengine/status.h"
+
+namespace ascend {
+namespace emulator {
+class GraphRuntime;
+}
+}
+
+namespace hiai {
+
+// a port of an engine in a graph
+struct EnginePortID {
+  uint32_t graph_id = 0;
+  uint32_t engine_id = 0;
+  uint32_t port_id = 0;
+};
+
+// receives the data an engine sends from a port not connected to an engine
+class DataRecvInterface {
+ public:
+  DataRecvInterface() {
+  }
+
+  virtual ~DataRecvInterface() {
+  }
+
+  /**
+   * @brief called in the thread of the sending engine
+   * @param [in] message: data sent
+   * @return HIAI_OK or an error returned to the sending engine
+   */
+  virtual HIAI_StatusT RecvData(const std::shared_ptr<void> &message) = 0;
+};
+
+/*
+ * A graph of graph.config. All the engines, HOST and DEVICE, run in the
+ * process that creates the graph.
+ */
+class Graph {
+ public:
+  /**
+   * @brief create and start the graphs of a graph.config, the libraries of
+   *        the engines are loaded from so_name
+   * @param [in] config_file: graph.config
+   * @return HIAI_OK or an error
+   */
+  static HIAI_StatusT CreateGraph(const std::string &config_file);
+
+  /**
+   * @brief stop a graph and release its engines
+   * @param [in] graph_id: graph id
+   * @return HIAI_OK or HIAI_GRAPH_NOT_EXIST
+   */
+  static HIAI_StatusT DestroyGraph(uint32_t graph_id);
+
+  /**
+   * @brief get a created graph
+   * @param [in] graph_id: graph id
+   * @return graph, nullptr if it does not exist
+   */
+  static std::shared_ptr<Graph> GetInstance(uint32_t graph_id);
+
+  /**
+   * @brief release a buffer received from another side, allocated by
+   *        HIAI_DMalloc
+   * @param [in] ptr: buffer
+   */
+  static void ReleaseDataBuffer(void *ptr);
+
+  /**
+   * @brief receive the data sent from an output port
+   * @param [in] target_port: engine and output port
+   * @param [in] receiver: receiver of the data
+   * @return HIAI_OK or HIAI_GRAPH_PORT_NOT_EXIST
+   */
+  HIAI_StatusT SetDataRecvFunctor(
+      const EnginePortID &target_port,
+      const std::shared_ptr<DataRecvInterface> &receiver);
+
+  /**
+   * @brief send data to an input port of an engine
+   * @param [in] target_port: engine and input port
+   * @param [in] message_name: registered message type
+   * @param [in] data_ptr: data
+   * @param [in] timeout: wait for a full queue in millisecond, 0: no wait
+   * @return HIAI_OK, HIAI_QUEUE_FULL or an error
+   */
+  HIAI_StatusT SendData(const EnginePortID &target_port,
+                        const std::string &message_name,
+                        const std::shared_ptr<void> &data_ptr,
+                        uint32_t timeout = 0);
+
+  // graph id
+  uint32_t GetGraphId() const {
+    return graph_id_;
+  }
+
+ private:
+  friend class ascend::emulator::GraphRuntime;
+
+  explicit Graph(uint32_t graph_id)
+      : graph_id_(graph_id) {
+  }
+
+  uint32_t graph_id_;
+};
+}
+
+/**
+ * @brief initialize the runtime, the device is not used on the host
+ * @param [in] device_id: device id
+ * @return HIAI_OK
+ */
+HIAI_StatusT HIAI_Init(uint32_t device_id);
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_GRAPH_H_ */
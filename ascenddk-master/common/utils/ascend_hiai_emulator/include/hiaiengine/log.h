@@ -0,0 +1,68 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_LOG_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_LOG_H_
+
+#include "hiaiengine/status.h"
+
+namespace ascend {
+namespace emulator {
+
+/**
+ * @brief write an info log to stderr, see HIAI_ENGINE_LOG
+ * @param [in] file: source file
+ * @param [in] line: source line
+ * @param [in] format: printf format
+ */
+void WriteEngineLog(const char *file, int line, const char *format, ...);
+
+/**
+ * @brief write a log with a status to stderr, see HIAI_ENGINE_LOG
+ * @param [in] file: source file
+ * @param [in] line: source line
+ * @param [in] status: HIAI_DEBUG_INFO logs at debug level, HIAI_OK at info
+ *             level and any other status at error level
+ * @param [in] format: printf format
+ */
+void WriteEngineLog(const char *file, int line, HIAI_StatusT status,
+                    const char *format, ...);
+}
+}
+
+// HIAI_ENGINE_LOG(format, ...) or HIAI_ENGINE_LOG(status, format, ...).
+// Only errors are written unless HIAI_EMULATOR_LOG_LEVEL is info or debug
+#define HIAI_ENGINE_LOG(...) \
+  ascend::emulator::WriteEngineLog(__FILE__, __LINE__, __VA_ARGS__)
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_LOG_H_ */
@@ -0,0 +1,155 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_MULTITYPE_QUEUE_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_MULTITYPE_QUEUE_H_
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hiai {
+
+/*
+ * Queues of the data of the input ports of an engine, used to wait until
+ * every port has data. Process of one engine may run in several threads, so
+ * all the operations are locked.
+ */
+class MultiTypeQueue {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] que_num: number of queues
+   * @param [in] max_queue_size: most data in one queue
+   * @param [in] duration_ms: not used on the host
+   */
+  explicit MultiTypeQueue(uint32_t que_num, uint32_t max_queue_size = 1024,
+                          uint32_t duration_ms = 0)
+      : queues_(que_num),
+        max_queue_size_(max_queue_size) {
+  }
+
+  /**
+   * @brief push data to a queue, nullptr is ignored
+   * @param [in] que_id: queue index
+   * @param [in] data: data
+   * @return true: pushed, false: nullptr, wrong index or full queue
+   */
+  bool PushData(uint32_t que_id, const std::shared_ptr<void> &data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data == nullptr || que_id >= queues_.size()
+        || queues_[que_id].size() >= max_queue_size_) {
+      return false;
+    }
+
+    queues_[que_id].push_back(data);
+    return true;
+  }
+
+  /**
+   * @brief get the first data of a queue and keep it in the queue
+   * @param [in] que_id: queue index
+   * @param [out] data: data
+   * @return true: got, false: empty queue or wrong index
+   */
+  bool FrontData(uint32_t que_id, std::shared_ptr<void> &data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (que_id >= queues_.size() || queues_[que_id].empty()) {
+      return false;
+    }
+
+    data = queues_[que_id].front();
+    return true;
+  }
+
+  /**
+   * @brief get the first data of a queue and remove it from the queue
+   * @param [in] que_id: queue index
+   * @param [out] data: data
+   * @return true: got, false: empty queue or wrong index
+   */
+  bool PopData(uint32_t que_id, std::shared_ptr<void> &data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (que_id >= queues_.size() || queues_[que_id].empty()) {
+      return false;
+    }
+
+    data = queues_[que_id].front();
+    queues_[que_id].pop_front();
+    return true;
+  }
+
+  /**
+   * @brief get the first data of queue 0 ... sizeof...(args) - 1 when every
+   *        one of them has data, nothing is removed otherwise
+   * @param [out] args: data of the queues, in queue order
+   * @return true: got, false: a queue is empty
+   */
+  template<typename ... T>
+  bool PopAllData(std::shared_ptr<T> &... args) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sizeof...(args) > queues_.size()) {
+      return false;
+    }
+
+    for (uint32_t i = 0; i < sizeof...(args); ++i) {
+      if (queues_[i].empty()) {
+        return false;
+      }
+    }
+
+    PopEach(0, args...);
+    return true;
+  }
+
+ private:
+  void PopEach(uint32_t que_id) {
+  }
+
+  template<typename T, typename ... Rest>
+  void PopEach(uint32_t que_id, std::shared_ptr<T> &first,
+               std::shared_ptr<Rest> &... rest) {
+    first = std::static_pointer_cast<T>(queues_[que_id].front());
+    queues_[que_id].pop_front();
+    PopEach(que_id + 1, rest...);
+  }
+
+  std::mutex mutex_;
+  std::vector<std::deque<std::shared_ptr<void>>> queues_;
+  uint32_t max_queue_size_;
+};
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_MULTITYPE_QUEUE_H_ */
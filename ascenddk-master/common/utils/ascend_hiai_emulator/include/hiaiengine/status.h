@@ -0,0 +1,60 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_HIAIENGINE_STATUS_H_
+#define ASCENDDK_HIAI_EMULATOR_HIAIENGINE_STATUS_H_
+
+#include <stdint.h>
+
+// status of the HiAI engine API, also the first argument of HIAI_ENGINE_LOG
+typedef uint32_t HIAI_StatusT;
+
+const HIAI_StatusT HIAI_OK = 0;
+const HIAI_StatusT HIAI_ERROR = 1;
+
+// not an error, logs at debug level
+const HIAI_StatusT HIAI_DEBUG_INFO = 2;
+
+const HIAI_StatusT HIAI_INVALID_INPUT_MSG = 3;
+const HIAI_StatusT HIAI_QUEUE_FULL = 4;
+const HIAI_StatusT HIAI_SEND_DATA_TIMEOUT = 5;
+const HIAI_StatusT HIAI_ENGINE_RUN_ARGS_NOT_RIGHT = 6;
+const HIAI_StatusT HIAI_ENGINE_NOT_EXIST = 7;
+const HIAI_StatusT HIAI_ENGINE_INIT_FAILED = 8;
+const HIAI_StatusT HIAI_GRAPH_INVALID_VALUE = 9;
+const HIAI_StatusT HIAI_GRAPH_INIT_FAILED = 10;
+const HIAI_StatusT HIAI_GRAPH_NOT_EXIST = 11;
+const HIAI_StatusT HIAI_GRAPH_PORT_NOT_EXIST = 12;
+const HIAI_StatusT HIAI_MEMORY_ALLOC_FAILED = 13;
+
+#endif /* ASCENDDK_HIAI_EMULATOR_HIAIENGINE_STATUS_H_ */
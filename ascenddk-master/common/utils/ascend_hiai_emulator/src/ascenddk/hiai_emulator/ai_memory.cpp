@@ -0,0 +1,64 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "hiaiengine/ai_memory.h"
+
+#include <stdlib.h>
+
+namespace {
+
+// alignment of the memory, the same as the buffers DVPP reads
+const size_t kMemoryAlignment = 128;
+}
+
+namespace hiai {
+
+HIAI_StatusT HIAIMemory::HIAI_DMalloc(const uint32_t size, void *&ptr,
+                                      const uint32_t timeout, uint32_t attr) {
+  ptr = nullptr;
+  if (size == 0) {
+    return HIAI_MEMORY_ALLOC_FAILED;
+  }
+
+  if (posix_memalign(&ptr, kMemoryAlignment, size) != 0) {
+    ptr = nullptr;
+    return HIAI_MEMORY_ALLOC_FAILED;
+  }
+  return HIAI_OK;
+}
+
+HIAI_StatusT HIAIMemory::HIAI_DFree(void *ptr) {
+  free(ptr);
+  return HIAI_OK;
+}
+}
@@ -0,0 +1,118 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "hiaiengine/ai_model_manager.h"
+
+#include "ascenddk/hiai_emulator/model_stub.h"
+#include "hiaiengine/log.h"
+
+using namespace std;
+
+namespace {
+
+// context parameter selecting the model of Process
+const char *const kModelNamePara = "model_name";
+}
+
+namespace hiai {
+
+AIStatus AIModelManager::Init(
+    const AIConfig &config, const vector<AIModelDescription> &model_descs) {
+  for (const AIModelDescription &model_desc : model_descs) {
+    shared_ptr<ascend::emulator::ModelStub> model =
+        ascend::emulator::CreateModelStub(model_desc);
+    if (model == nullptr) {
+      HIAI_ENGINE_LOG(HIAI_ERROR, "failed to load model %s from %s",
+                      model_desc.name().c_str(), model_desc.path().c_str());
+      return FAILED;
+    }
+
+    if (models_.find(model_desc.name()) == models_.end()) {
+      model_names_.push_back(model_desc.name());
+    }
+    models_[model_desc.name()] = model;
+  }
+  return SUCCESS;
+}
+
+AIStatus AIModelManager::Process(AIContext &context,
+                                 const vector<shared_ptr<IAITensor>> &inputs,
+                                 vector<shared_ptr<IAITensor>> &outputs,
+                                 uint32_t timeout) {
+  string model_name;
+  context.GetPara(kModelNamePara, model_name);
+  shared_ptr<ascend::emulator::ModelStub> model = GetModel(model_name);
+  if (model == nullptr) {
+    HIAI_ENGINE_LOG(HIAI_ERROR, "model %s is not loaded",
+                    model_name.c_str());
+    return FAILED;
+  }
+
+  if (outputs.empty() && !model->CreateOutputTensor(inputs, outputs)) {
+    return FAILED;
+  }
+  return model->Process(inputs, outputs) ? SUCCESS : FAILED;
+}
+
+AIStatus AIModelManager::CreateOutputTensor(
+    const vector<shared_ptr<IAITensor>> &inputs,
+    vector<shared_ptr<IAITensor>> &outputs) {
+  shared_ptr<ascend::emulator::ModelStub> model = GetModel("");
+  if (model == nullptr) {
+    return FAILED;
+  }
+  return model->CreateOutputTensor(inputs, outputs) ? SUCCESS : FAILED;
+}
+
+AIStatus AIModelManager::GetModelIOTensorDim(
+    const string &model_name, vector<TensorDimension> &input_dims,
+    vector<TensorDimension> &output_dims) {
+  shared_ptr<ascend::emulator::ModelStub> model = GetModel(model_name);
+  if (model == nullptr) {
+    return FAILED;
+  }
+  return model->GetTensorDim(input_dims, output_dims) ? SUCCESS : FAILED;
+}
+
+shared_ptr<ascend::emulator::ModelStub> AIModelManager::GetModel(
+    const string &model_name) const {
+  if (model_names_.empty()) {
+    return nullptr;
+  }
+
+  const string &name = model_name.empty() ? model_names_[0] : model_name;
+  map<string, shared_ptr<ascend::emulator::ModelStub>>::const_iterator it =
+      models_.find(name);
+  return (it == models_.end()) ? nullptr : it->second;
+}
+}
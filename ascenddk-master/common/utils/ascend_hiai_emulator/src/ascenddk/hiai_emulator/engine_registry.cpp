@@ -0,0 +1,179 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/hiai_emulator/engine_registry.h"
+
+#include <string.h>
+#include <map>
+#include <mutex>
+
+#include "hiaiengine/ai_memory.h"
+#include "hiaiengine/log.h"
+
+using namespace std;
+
+namespace {
+
+// message type built in the framework, sent by main to the first engines
+const char *const kStringMessage = "string";
+
+struct MessageType {
+  // both empty for a message sent as it is
+  ascend::emulator::SerializeFunc serialize;
+  ascend::emulator::DeserializeFunc deserialize;
+};
+
+// registries are filled from the static objects of the engine libraries,
+// so they are created at first use
+mutex &GetRegistryMutex() {
+  static mutex registry_mutex;
+  return registry_mutex;
+}
+
+map<string, ascend::emulator::EngineFactory> &GetEngines() {
+  static map<string, ascend::emulator::EngineFactory> engines;
+  return engines;
+}
+
+map<string, MessageType> &GetMessages() {
+  static map<string, MessageType> messages;
+  return messages;
+}
+}
+
+namespace ascend {
+namespace emulator {
+
+EngineRegister::EngineRegister(const string &name, uint32_t input_size,
+                               const EngineCreator &create,
+                               const EngineProcessor &process) {
+  lock_guard<mutex> lock(GetRegistryMutex());
+  EngineFactory &factory = GetEngines()[name];
+  factory.name = name;
+  factory.input_size = input_size;
+  factory.create = create;
+  factory.process = process;
+}
+
+MessageRegister::MessageRegister(const string &name) {
+  lock_guard<mutex> lock(GetRegistryMutex());
+
+  // an engine library may register a message that another one registered
+  // with serialize functions, they are kept
+  GetMessages().insert(make_pair(name, MessageType()));
+}
+
+MessageRegister::MessageRegister(const string &name,
+                                 const SerializeFunc &serialize,
+                                 const DeserializeFunc &deserialize) {
+  lock_guard<mutex> lock(GetRegistryMutex());
+  MessageType &type = GetMessages()[name];
+  type.serialize = serialize;
+  type.deserialize = deserialize;
+}
+
+const EngineFactory *GetEngineFactory(const string &name) {
+  lock_guard<mutex> lock(GetRegistryMutex());
+  map<string, EngineFactory>::const_iterator it = GetEngines().find(name);
+  return (it == GetEngines().end()) ? nullptr : &it->second;
+}
+
+bool IsMessageRegistered(const string &name) {
+  if (name == kStringMessage) {
+    return true;
+  }
+
+  lock_guard<mutex> lock(GetRegistryMutex());
+  return GetMessages().find(name) != GetMessages().end();
+}
+
+HIAI_StatusT TransferMessage(const string &name,
+                             const shared_ptr<void> &message,
+                             shared_ptr<void> &received) {
+  if (name == kStringMessage) {
+    // the framework copies the string to the other side
+    shared_ptr<string> text = static_pointer_cast<string>(message);
+    received = (text == nullptr) ? nullptr : make_shared<string>(*text);
+    return HIAI_OK;
+  }
+
+  MessageType type;
+  {
+    lock_guard<mutex> lock(GetRegistryMutex());
+    map<string, MessageType>::const_iterator it = GetMessages().find(name);
+    if (it == GetMessages().end()) {
+      HIAI_ENGINE_LOG(HIAI_INVALID_INPUT_MSG,
+                      "message %s is not registered", name.c_str());
+      return HIAI_INVALID_INPUT_MSG;
+    }
+    type = it->second;
+  }
+
+  if (!type.serialize || !type.deserialize || message == nullptr) {
+    received = message;
+    return HIAI_OK;
+  }
+
+  string ctrl_str;
+  uint8_t *data_ptr = nullptr;
+  uint32_t data_len = 0;
+  type.serialize(message.get(), ctrl_str, data_ptr, data_len);
+
+  // the receiver owns the data buffer and frees it by
+  // Graph::ReleaseDataBuffer, like a buffer received from the other side
+  void *buffer = nullptr;
+  if (data_ptr != nullptr && data_len > 0) {
+    HIAI_StatusT ret = hiai::HIAIMemory::HIAI_DMalloc(data_len, buffer);
+    if (ret != HIAI_OK) {
+      HIAI_ENGINE_LOG(ret, "failed to allocate %u bytes of message %s",
+                      data_len, name.c_str());
+      return ret;
+    }
+    memcpy(buffer, data_ptr, data_len);
+  } else {
+    data_len = 0;
+  }
+
+  uint32_t ctrl_len = ctrl_str.size();
+  received = type.deserialize(ctrl_str.data(), ctrl_len,
+                              static_cast<const uint8_t *>(buffer), data_len);
+  if (received == nullptr) {
+    hiai::HIAIMemory::HIAI_DFree(buffer);
+    HIAI_ENGINE_LOG(HIAI_INVALID_INPUT_MSG,
+                    "failed to deserialize message %s", name.c_str());
+    return HIAI_INVALID_INPUT_MSG;
+  }
+  return HIAI_OK;
+}
+}
+}
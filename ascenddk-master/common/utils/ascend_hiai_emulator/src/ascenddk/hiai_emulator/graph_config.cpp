@@ -0,0 +1,402 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/hiai_emulator/graph_config.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+
+#include "hiaiengine/log.h"
+#include "hiaiengine/status.h"
+
+using namespace std;
+
+namespace {
+
+// kinds of the tokens of the text format
+enum TokenType {
+  kTokenScalar = 0,  // field name, number or enum value
+  kTokenString = 1,  // quoted string, without the quotes
+  kTokenSymbol = 2,  // ':', '{' or '}'
+};
+
+struct Token {
+  TokenType type;
+  string text;
+  uint32_t line;
+};
+
+// a field of the text format, a value or a message of fields
+struct TextField {
+  string name;
+  string value;
+  bool is_message = false;
+  vector<TextField> fields;
+};
+
+// side values in graph.config
+const char *const kSideHost = "HOST";
+const char *const kSideDevice = "DEVICE";
+
+bool IsScalarChar(char c) {
+  return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.'
+      || c == '-' || c == '+' || c == '/';
+}
+
+/**
+ * @brief split the text format into tokens
+ * @param [in] text: content of graph.config
+ * @param [out] tokens: tokens
+ * @return true: success, false: unexpected character or open string
+ */
+bool Tokenize(const string &text, vector<Token> &tokens) {
+  uint32_t line = 1;
+  size_t i = 0;
+  while (i < text.size()) {
+    char c = text[i];
+    if (c == '\n') {
+      ++line;
+      ++i;
+    } else if (isspace(static_cast<unsigned char>(c))) {
+      ++i;
+    } else if (c == '#') {
+      while (i < text.size() && text[i] != '\n') {
+        ++i;
+      }
+    } else if (c == ':' || c == '{' || c == '}') {
+      tokens.push_back(Token { kTokenSymbol, string(1, c), line });
+      ++i;
+    } else if (c == '"' || c == '\'') {
+      string value;
+      for (++i; i < text.size() && text[i] != c; ++i) {
+        if (text[i] == '\n') {
+          break;
+        }
+        if (text[i] == '\\' && i + 1 < text.size()) {
+          ++i;
+          char escaped = text[i];
+          value += (escaped == 'n') ? '\n' : (escaped == 't') ? '\t' : escaped;
+        } else {
+          value += text[i];
+        }
+      }
+      if (i >= text.size() || text[i] != c) {
+        HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                        "graph config line %u: unterminated string", line);
+        return false;
+      }
+      tokens.push_back(Token { kTokenString, value, line });
+      ++i;
+    } else if (IsScalarChar(c)) {
+      size_t begin = i;
+      while (i < text.size() && IsScalarChar(text[i])) {
+        ++i;
+      }
+      tokens.push_back(Token { kTokenScalar, text.substr(begin, i - begin),
+                               line });
+    } else {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "graph config line %u: unexpected character '%c'",
+                      line, c);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief parse the fields of a message
+ * @param [in] tokens: tokens
+ * @param [in/out] pos: position of the first field, after the message
+ * @param [in] is_nested: the message ends with '}', the file ends otherwise
+ * @param [out] message: fields of the message
+ * @return true: success
+ */
+bool ParseFields(const vector<Token> &tokens, size_t &pos, bool is_nested,
+                 TextField &message) {
+  while (pos < tokens.size()) {
+    const Token &name = tokens[pos];
+    if (name.type == kTokenSymbol && name.text == "}") {
+      if (!is_nested) {
+        HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                        "graph config line %u: unexpected '}'", name.line);
+        return false;
+      }
+      ++pos;
+      return true;
+    }
+    if (name.type != kTokenScalar) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "graph config line %u: field name expected",
+                      name.line);
+      return false;
+    }
+
+    TextField field;
+    field.name = name.text;
+    ++pos;
+    if (pos < tokens.size() && tokens[pos].type == kTokenSymbol
+        && tokens[pos].text == ":") {
+      ++pos;
+    }
+    if (pos >= tokens.size()) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "graph config: no value of field %s",
+                      field.name.c_str());
+      return false;
+    }
+
+    const Token &value = tokens[pos];
+    if (value.type == kTokenSymbol && value.text == "{") {
+      ++pos;
+      field.is_message = true;
+      if (!ParseFields(tokens, pos, true, field)) {
+        return false;
+      }
+    } else if (value.type != kTokenSymbol) {
+      field.value = value.text;
+      ++pos;
+    } else {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "graph config line %u: value of field %s expected",
+                      value.line, field.name.c_str());
+      return false;
+    }
+    message.fields.push_back(field);
+  }
+
+  if (is_nested) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE, "graph config: missing '}'");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief convert a field to an unsigned integer
+ * @param [in] field: field
+ * @param [out] value: value
+ * @return true: success
+ */
+bool ToUint32(const TextField &field, uint32_t &value) {
+  char *end = nullptr;
+  errno = 0;
+  unsigned long long number = strtoull(field.value.c_str(), &end, 0);
+  if (field.is_message || field.value.empty() || *end != '\0' || errno != 0
+      || number > UINT32_MAX || field.value[0] == '-') {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                    "graph config: %s is not an unsigned integer: %s",
+                    field.name.c_str(), field.value.c_str());
+    return false;
+  }
+  value = static_cast<uint32_t>(number);
+  return true;
+}
+
+bool ToInt32(const TextField &field, int32_t &value) {
+  char *end = nullptr;
+  errno = 0;
+  long long number = strtoll(field.value.c_str(), &end, 0);
+  if (field.is_message || field.value.empty() || *end != '\0' || errno != 0
+      || number > INT32_MAX || number < INT32_MIN) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                    "graph config: %s is not an integer: %s",
+                    field.name.c_str(), field.value.c_str());
+    return false;
+  }
+  value = static_cast<int32_t>(number);
+  return true;
+}
+
+void ConvertConfigItems(const TextField &ai_config, hiai::AIConfig &config) {
+  for (const TextField &items : ai_config.fields) {
+    if (items.name != "items" || !items.is_message) {
+      continue;
+    }
+
+    hiai::AIConfigItem *item = config.add_items();
+    for (const TextField &field : items.fields) {
+      if (field.name == "name") {
+        item->set_name(field.value);
+      } else if (field.name == "value") {
+        item->set_value(field.value);
+      }
+    }
+  }
+}
+
+void ConvertModel(const TextField &ai_model,
+                  vector<hiai::AIModelDescription> &model_descs) {
+  hiai::AIModelDescription model_desc;
+  for (const TextField &field : ai_model.fields) {
+    if (field.name == "name") {
+      model_desc.set_name(field.value);
+    } else if (field.name == "path") {
+      model_desc.set_path(field.value);
+    } else if (field.name == "key") {
+      model_desc.set_key(field.value);
+    }
+  }
+  model_descs.push_back(model_desc);
+}
+
+bool ConvertEngine(const TextField &engine,
+                   ascend::emulator::EngineConfig &config) {
+  bool ret = true;
+  for (const TextField &field : engine.fields) {
+    if (field.name == "id") {
+      ret = ToUint32(field, config.id);
+    } else if (field.name == "engine_name") {
+      config.engine_name = field.value;
+    } else if (field.name == "side") {
+      if (field.value == kSideHost) {
+        config.side = ascend::emulator::kEngineSideHost;
+      } else if (field.value == kSideDevice) {
+        config.side = ascend::emulator::kEngineSideDevice;
+      } else {
+        HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                        "graph config: invalid side %s", field.value.c_str());
+        ret = false;
+      }
+    } else if (field.name == "thread_num") {
+      ret = ToUint32(field, config.thread_num);
+    } else if (field.name == "queue_size") {
+      ret = ToUint32(field, config.queue_size);
+    } else if (field.name == "so_name") {
+      config.so_name = field.value;
+    } else if (field.name == "ai_config" && field.is_message) {
+      ConvertConfigItems(field, config.ai_config);
+    } else if (field.name == "ai_model" && field.is_message) {
+      ConvertModel(field, config.model_descs);
+    }
+    if (!ret) {
+      return false;
+    }
+  }
+
+  if (config.engine_name.empty() || config.thread_num == 0
+      || config.queue_size == 0) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                    "graph config: engine %u needs engine_name, thread_num "
+                    "and queue_size above 0", config.id);
+    return false;
+  }
+  return true;
+}
+
+bool ConvertConnect(const TextField &connect,
+                    ascend::emulator::ConnectConfig &config) {
+  bool ret = true;
+  for (const TextField &field : connect.fields) {
+    if (field.name == "src_engine_id") {
+      ret = ToUint32(field, config.src_engine_id);
+    } else if (field.name == "src_port_id") {
+      ret = ToUint32(field, config.src_port_id);
+    } else if (field.name == "target_engine_id") {
+      ret = ToUint32(field, config.target_engine_id);
+    } else if (field.name == "target_port_id") {
+      ret = ToUint32(field, config.target_port_id);
+    }
+    if (!ret) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConvertGraph(const TextField &graph,
+                  ascend::emulator::GraphConfig &config) {
+  bool ret = true;
+  for (const TextField &field : graph.fields) {
+    if (field.name == "graph_id") {
+      ret = ToUint32(field, config.graph_id);
+    } else if (field.name == "priority") {
+      ret = ToInt32(field, config.priority);
+    } else if (field.name == "engines" && field.is_message) {
+      config.engines.push_back(ascend::emulator::EngineConfig());
+      ret = ConvertEngine(field, config.engines.back());
+    } else if (field.name == "connects" && field.is_message) {
+      config.connects.push_back(ascend::emulator::ConnectConfig());
+      ret = ConvertConnect(field, config.connects.back());
+    }
+    if (!ret) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+namespace ascend {
+namespace emulator {
+
+uint32_t ParseGraphConfig(const string &file, vector<GraphConfig> &graphs) {
+  ifstream stream(file.c_str());
+  if (!stream.is_open()) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_NOT_EXIST, "failed to open graph config %s",
+                    file.c_str());
+    return HIAI_GRAPH_NOT_EXIST;
+  }
+  stringstream text;
+  text << stream.rdbuf();
+
+  vector<Token> tokens;
+  TextField root;
+  size_t pos = 0;
+  if (!Tokenize(text.str(), tokens)
+      || !ParseFields(tokens, pos, false, root)) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE, "invalid graph config %s",
+                    file.c_str());
+    return HIAI_GRAPH_INVALID_VALUE;
+  }
+
+  graphs.clear();
+  for (const TextField &field : root.fields) {
+    if (field.name != "graphs" || !field.is_message) {
+      continue;
+    }
+
+    graphs.push_back(GraphConfig());
+    if (!ConvertGraph(field, graphs.back())) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE, "invalid graph config %s",
+                      file.c_str());
+      return HIAI_GRAPH_INVALID_VALUE;
+    }
+  }
+  return HIAI_OK;
+}
+}
+}
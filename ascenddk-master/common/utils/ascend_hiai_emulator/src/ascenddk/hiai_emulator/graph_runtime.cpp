@@ -0,0 +1,503 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "graph_runtime.h"
+
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <chrono>
+#include <sstream>
+
+#include "hiaiengine/ai_memory.h"
+#include "hiaiengine/log.h"
+
+using namespace std;
+
+namespace {
+
+// overrides queue_size of every engine
+const char *const kQueueSizeEnv = "HIAI_EMULATOR_QUEUE_SIZE";
+
+// libraries loaded before the engines, separated by ':'
+const char *const kPluginsEnv = "HIAI_EMULATOR_PLUGINS";
+
+const char kPluginSeparator = ':';
+
+// created graphs. Never freed: an engine may loop in Process until the
+// process exits, and its threads can not be joined at exit
+mutex g_graphs_mutex;
+map<uint32_t, shared_ptr<ascend::emulator::GraphRuntime>> *g_graphs =
+    new map<uint32_t, shared_ptr<ascend::emulator::GraphRuntime>>();
+
+/**
+ * @brief load a library and keep it loaded, its static objects register
+ *        the engines, messages and model stubs
+ * @param [in] so_name: library
+ * @return true: success
+ */
+bool LoadLibrary(const string &so_name) {
+  void *handle = dlopen(so_name.c_str(), RTLD_NOW | RTLD_GLOBAL);
+  if (handle == nullptr) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INIT_FAILED, "failed to load %s: %s",
+                    so_name.c_str(), dlerror());
+    return false;
+  }
+  return true;
+}
+}
+
+namespace ascend {
+namespace emulator {
+
+EngineNode::EngineNode(uint32_t graph_id, const EngineConfig &config,
+                       const EngineFactory *factory)
+    : graph_id_(graph_id),
+      config_(config),
+      factory_(factory),
+      port_depth_(kMaxEnginePortNum, 0),
+      queue_size_(config.queue_size) {
+  const char *env = getenv(kQueueSizeEnv);
+  if (env != nullptr && atoi(env) > 0) {
+    queue_size_ = atoi(env);
+  }
+}
+
+EngineNode::~EngineNode() {
+  Stop();
+}
+
+HIAI_StatusT EngineNode::Init() {
+  engine_.reset(factory_->create());
+  if (engine_ == nullptr) {
+    return HIAI_ENGINE_INIT_FAILED;
+  }
+  engine_->node_ = this;
+
+  HIAI_StatusT ret = engine_->Init(config_.ai_config, config_.model_descs);
+  if (ret != HIAI_OK) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_INIT_FAILED,
+                    "engine %s(%u) failed to init, ret=%u",
+                    config_.engine_name.c_str(), config_.id, ret);
+    return HIAI_ENGINE_INIT_FAILED;
+  }
+  return HIAI_OK;
+}
+
+void EngineNode::Start() {
+  for (uint32_t i = 0; i < config_.thread_num; ++i) {
+    threads_.push_back(thread(&EngineNode::Run, this));
+  }
+}
+
+void EngineNode::Stop() {
+  {
+    lock_guard<mutex> lock(queue_mutex_);
+    is_stopped_ = true;
+  }
+  data_cond_.notify_all();
+  space_cond_.notify_all();
+
+  for (thread &worker : threads_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  threads_.clear();
+}
+
+void EngineNode::AddTarget(uint32_t port_id, EngineNode *target,
+                           uint32_t target_port_id) {
+  lock_guard<mutex> lock(route_mutex_);
+  targets_[port_id].push_back(Target { target, target_port_id });
+}
+
+void EngineNode::SetReceiver(
+    uint32_t port_id, const shared_ptr<hiai::DataRecvInterface> &receiver) {
+  lock_guard<mutex> lock(route_mutex_);
+  receivers_[port_id] = receiver;
+}
+
+HIAI_StatusT EngineNode::SendData(uint32_t port_id,
+                                  const string &message_name,
+                                  const shared_ptr<void> &data,
+                                  uint32_t timeout) {
+  vector<Target> targets;
+  shared_ptr<hiai::DataRecvInterface> receiver = nullptr;
+  {
+    lock_guard<mutex> lock(route_mutex_);
+    map<uint32_t, vector<Target>>::const_iterator target_it =
+        targets_.find(port_id);
+    if (target_it != targets_.end()) {
+      targets = target_it->second;
+    }
+    map<uint32_t, shared_ptr<hiai::DataRecvInterface>>::const_iterator
+        receiver_it = receivers_.find(port_id);
+    if (receiver_it != receivers_.end()) {
+      receiver = receiver_it->second;
+    }
+  }
+
+  // every engine connected to the port receives the data
+  HIAI_StatusT ret = HIAI_OK;
+  for (const Target &target : targets) {
+    HIAI_StatusT push_ret = target.node->PushData(
+        target.port_id, message_name, data, config_.side, timeout);
+    if (push_ret != HIAI_OK) {
+      ret = push_ret;
+    }
+  }
+  if (!targets.empty()) {
+    return ret;
+  }
+
+  if (receiver == nullptr) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_PORT_NOT_EXIST,
+                    "port %u of engine %s(%u) is not connected", port_id,
+                    config_.engine_name.c_str(), config_.id);
+    return HIAI_GRAPH_PORT_NOT_EXIST;
+  }
+
+  // the application receives the data on the host
+  shared_ptr<void> received = data;
+  if (config_.side != kEngineSideHost) {
+    ret = TransferMessage(message_name, data, received);
+    if (ret != HIAI_OK) {
+      return ret;
+    }
+  }
+  return receiver->RecvData(received);
+}
+
+HIAI_StatusT EngineNode::PushData(uint32_t port_id,
+                                  const string &message_name,
+                                  const shared_ptr<void> &data,
+                                  EngineSide src_side, uint32_t timeout) {
+  if (port_id >= factory_->input_size) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_PORT_NOT_EXIST,
+                    "engine %s(%u) has no input port %u",
+                    config_.engine_name.c_str(), config_.id, port_id);
+    return HIAI_GRAPH_PORT_NOT_EXIST;
+  }
+
+  shared_ptr<void> received = data;
+  if (src_side != config_.side) {
+    HIAI_StatusT ret = TransferMessage(message_name, data, received);
+    if (ret != HIAI_OK) {
+      return ret;
+    }
+  }
+
+  unique_lock<mutex> lock(queue_mutex_);
+  if (port_depth_[port_id] >= queue_size_ && !is_stopped_) {
+    if (timeout == 0) {
+      return HIAI_QUEUE_FULL;
+    }
+
+    bool has_space = space_cond_.wait_for(
+        lock, chrono::milliseconds(timeout), [this, port_id]() {
+          return is_stopped_ || port_depth_[port_id] < queue_size_;
+        });
+    if (!has_space) {
+      return HIAI_SEND_DATA_TIMEOUT;
+    }
+  }
+  if (is_stopped_) {
+    return HIAI_ENGINE_NOT_EXIST;
+  }
+
+  queue_.push_back(InputData { port_id, received });
+  ++port_depth_[port_id];
+  lock.unlock();
+  data_cond_.notify_one();
+  return HIAI_OK;
+}
+
+void EngineNode::Run() {
+  while (true) {
+    InputData input;
+    {
+      unique_lock<mutex> lock(queue_mutex_);
+      data_cond_.wait(lock, [this]() {
+        return is_stopped_ || !queue_.empty();
+      });
+      if (is_stopped_) {
+        return;
+      }
+
+      input = queue_.front();
+      queue_.pop_front();
+      --port_depth_[input.port_id];
+    }
+    space_cond_.notify_all();
+
+    // only the argument of the port the data arrived on is set
+    vector<shared_ptr<void>> args(kMaxEnginePortNum);
+    args[input.port_id] = input.data;
+    input.data = nullptr;
+    HIAI_StatusT ret = factory_->process(engine_.get(), args);
+    if (ret != HIAI_OK) {
+      HIAI_ENGINE_LOG(ret, "engine %s(%u) failed to process port %u",
+                      config_.engine_name.c_str(), config_.id,
+                      input.port_id);
+    }
+  }
+}
+
+GraphRuntime::GraphRuntime(const GraphConfig &config)
+    : config_(config),
+      graph_(new hiai::Graph(config.graph_id)) {
+}
+
+GraphRuntime::~GraphRuntime() {
+  // stop all the threads before any engine is deleted, an engine may still
+  // send data to another one
+  for (auto &node : nodes_) {
+    node.second->Stop();
+  }
+}
+
+EngineNode *GraphRuntime::GetNode(uint32_t engine_id) const {
+  map<uint32_t, unique_ptr<EngineNode>>::const_iterator it =
+      nodes_.find(engine_id);
+  return (it == nodes_.end()) ? nullptr : it->second.get();
+}
+
+HIAI_StatusT GraphRuntime::Build() {
+  for (const EngineConfig &engine : config_.engines) {
+    if (nodes_.find(engine.id) != nodes_.end()) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "engine id %u is used twice in graph %u", engine.id,
+                      config_.graph_id);
+      return HIAI_GRAPH_INVALID_VALUE;
+    }
+
+    // engines linked into the application are registered already
+    const EngineFactory *factory = GetEngineFactory(engine.engine_name);
+    if (factory == nullptr && !engine.so_name.empty()) {
+      if (!LoadLibrary(engine.so_name)) {
+        return HIAI_GRAPH_INIT_FAILED;
+      }
+      factory = GetEngineFactory(engine.engine_name);
+    }
+    if (factory == nullptr) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_NOT_EXIST,
+                      "engine %s is not registered by %s",
+                      engine.engine_name.c_str(), engine.so_name.c_str());
+      return HIAI_ENGINE_NOT_EXIST;
+    }
+
+    nodes_[engine.id].reset(
+        new EngineNode(config_.graph_id, engine, factory));
+  }
+
+  for (const ConnectConfig &connect : config_.connects) {
+    EngineNode *src = GetNode(connect.src_engine_id);
+    EngineNode *target = GetNode(connect.target_engine_id);
+    if (src == nullptr || target == nullptr
+        || connect.src_port_id >= kMaxEnginePortNum) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                      "invalid connect %u:%u -> %u:%u in graph %u",
+                      connect.src_engine_id, connect.src_port_id,
+                      connect.target_engine_id, connect.target_port_id,
+                      config_.graph_id);
+      return HIAI_GRAPH_INVALID_VALUE;
+    }
+    src->AddTarget(connect.src_port_id, target, connect.target_port_id);
+  }
+
+  for (auto &node : nodes_) {
+    HIAI_StatusT ret = node.second->Init();
+    if (ret != HIAI_OK) {
+      return ret;
+    }
+  }
+  return HIAI_OK;
+}
+
+HIAI_StatusT GraphRuntime::Create(const string &config_file) {
+  LoadPlugins();
+
+  vector<GraphConfig> configs;
+  HIAI_StatusT ret = ParseGraphConfig(config_file, configs);
+  if (ret != HIAI_OK) {
+    return ret;
+  }
+
+  vector<shared_ptr<GraphRuntime>> runtimes;
+  for (const GraphConfig &config : configs) {
+    if (Get(config.graph_id) != nullptr) {
+      HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE, "graph %u exists already",
+                      config.graph_id);
+      return HIAI_GRAPH_INVALID_VALUE;
+    }
+
+    shared_ptr<GraphRuntime> runtime(new GraphRuntime(config));
+    ret = runtime->Build();
+    if (ret != HIAI_OK) {
+      HIAI_ENGINE_LOG(ret, "failed to create graph %u", config.graph_id);
+      return ret;
+    }
+    runtimes.push_back(runtime);
+  }
+
+  // the engines start when every graph of the file is initialized
+  lock_guard<mutex> lock(g_graphs_mutex);
+  for (shared_ptr<GraphRuntime> &runtime : runtimes) {
+    for (auto &node : runtime->nodes_) {
+      node.second->Start();
+    }
+    (*g_graphs)[runtime->config_.graph_id] = runtime;
+  }
+  return HIAI_OK;
+}
+
+HIAI_StatusT GraphRuntime::Destroy(uint32_t graph_id) {
+  shared_ptr<GraphRuntime> runtime = nullptr;
+  {
+    lock_guard<mutex> lock(g_graphs_mutex);
+    map<uint32_t, shared_ptr<GraphRuntime>>::iterator it =
+        g_graphs->find(graph_id);
+    if (it == g_graphs->end()) {
+      return HIAI_GRAPH_NOT_EXIST;
+    }
+    runtime = it->second;
+    g_graphs->erase(it);
+  }
+
+  // the engines stop when the last user of the graph releases it
+  runtime = nullptr;
+  return HIAI_OK;
+}
+
+shared_ptr<GraphRuntime> GraphRuntime::Get(uint32_t graph_id) {
+  lock_guard<mutex> lock(g_graphs_mutex);
+  map<uint32_t, shared_ptr<GraphRuntime>>::const_iterator it =
+      g_graphs->find(graph_id);
+  return (it == g_graphs->end()) ? nullptr : it->second;
+}
+
+void GraphRuntime::LoadPlugins() {
+  static once_flag plugins_once;
+  call_once(plugins_once, []() {
+    const char *env = getenv(kPluginsEnv);
+    if (env == nullptr) {
+      return;
+    }
+
+    stringstream plugins(env);
+    string plugin;
+    while (getline(plugins, plugin, kPluginSeparator)) {
+      if (!plugin.empty()) {
+        LoadLibrary(plugin);
+      }
+    }
+  });
+}
+}
+}
+
+namespace hiai {
+
+HIAI_StatusT Engine::SendData(uint32_t port_id, const string &message_name,
+                              const shared_ptr<void> &data_ptr,
+                              uint32_t timeout) {
+  if (node_ == nullptr) {
+    return HIAI_ENGINE_NOT_EXIST;
+  }
+  return node_->SendData(port_id, message_name, data_ptr, timeout);
+}
+
+uint32_t Engine::GetGraphId() const {
+  return (node_ == nullptr) ? 0 : node_->GetGraphId();
+}
+
+uint32_t Engine::GetEngineId() const {
+  return (node_ == nullptr) ? 0 : node_->GetEngineId();
+}
+
+HIAI_StatusT Graph::CreateGraph(const string &config_file) {
+  return ascend::emulator::GraphRuntime::Create(config_file);
+}
+
+HIAI_StatusT Graph::DestroyGraph(uint32_t graph_id) {
+  return ascend::emulator::GraphRuntime::Destroy(graph_id);
+}
+
+shared_ptr<Graph> Graph::GetInstance(uint32_t graph_id) {
+  shared_ptr<ascend::emulator::GraphRuntime> runtime =
+      ascend::emulator::GraphRuntime::Get(graph_id);
+  return (runtime == nullptr) ? nullptr : runtime->GetGraph();
+}
+
+void Graph::ReleaseDataBuffer(void *ptr) {
+  HIAIMemory::HIAI_DFree(ptr);
+}
+
+HIAI_StatusT Graph::SetDataRecvFunctor(
+    const EnginePortID &target_port,
+    const shared_ptr<DataRecvInterface> &receiver) {
+  shared_ptr<ascend::emulator::GraphRuntime> runtime =
+      ascend::emulator::GraphRuntime::Get(graph_id_);
+  ascend::emulator::EngineNode *node =
+      (runtime == nullptr) ? nullptr : runtime->GetNode(target_port.engine_id);
+  if (node == nullptr
+      || target_port.port_id >= ascend::emulator::kMaxEnginePortNum) {
+    return HIAI_GRAPH_PORT_NOT_EXIST;
+  }
+
+  node->SetReceiver(target_port.port_id, receiver);
+  return HIAI_OK;
+}
+
+HIAI_StatusT Graph::SendData(const EnginePortID &target_port,
+                             const string &message_name,
+                             const shared_ptr<void> &data_ptr,
+                             uint32_t timeout) {
+  shared_ptr<ascend::emulator::GraphRuntime> runtime =
+      ascend::emulator::GraphRuntime::Get(graph_id_);
+  ascend::emulator::EngineNode *node =
+      (runtime == nullptr) ? nullptr : runtime->GetNode(target_port.engine_id);
+  if (node == nullptr) {
+    return HIAI_GRAPH_PORT_NOT_EXIST;
+  }
+
+  // the application runs on the host
+  return node->PushData(target_port.port_id, message_name, data_ptr,
+                        ascend::emulator::kEngineSideHost, timeout);
+}
+}
+
+HIAI_StatusT HIAI_Init(uint32_t device_id) {
+  ascend::emulator::GraphRuntime::LoadPlugins();
+  return HIAI_OK;
+}
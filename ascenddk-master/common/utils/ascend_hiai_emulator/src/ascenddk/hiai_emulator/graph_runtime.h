@@ -0,0 +1,240 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_HIAI_EMULATOR_GRAPH_RUNTIME_H_
+#define ASCENDDK_HIAI_EMULATOR_GRAPH_RUNTIME_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ascenddk/hiai_emulator/engine_registry.h"
+#include "ascenddk/hiai_emulator/graph_config.h"
+#include "hiaiengine/engine.h"
+#include "hiaiengine/graph.h"
+
+namespace ascend {
+namespace emulator {
+
+/*
+ * An engine of a running graph: the engine object, the queue of the data
+ * sent to its input ports and the threads calling Process.
+ */
+class EngineNode {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] graph_id: graph of the engine
+   * @param [in] config: engine in graph.config
+   * @param [in] factory: registered engine
+   */
+  EngineNode(uint32_t graph_id, const EngineConfig &config,
+             const EngineFactory *factory);
+
+  ~EngineNode();
+
+  /**
+   * @brief create the engine and call its Init
+   * @return HIAI_OK or HIAI_ENGINE_INIT_FAILED
+   */
+  HIAI_StatusT Init();
+
+  /**
+   * @brief start thread_num threads calling Process
+   */
+  void Start();
+
+  /**
+   * @brief stop the threads after the running Process calls return
+   */
+  void Stop();
+
+  /**
+   * @brief connect an output port to an input port of an engine
+   * @param [in] port_id: output port
+   * @param [in] target: target engine
+   * @param [in] target_port_id: input port of target
+   */
+  void AddTarget(uint32_t port_id, EngineNode *target,
+                 uint32_t target_port_id);
+
+  /**
+   * @brief receive the data of an output port in the process
+   * @param [in] port_id: output port
+   * @param [in] receiver: receiver
+   */
+  void SetReceiver(uint32_t port_id,
+                   const std::shared_ptr<hiai::DataRecvInterface> &receiver);
+
+  /**
+   * @brief send data from an output port, see hiai::Engine::SendData
+   */
+  HIAI_StatusT SendData(uint32_t port_id, const std::string &message_name,
+                        const std::shared_ptr<void> &data,
+                        uint32_t timeout);
+
+  /**
+   * @brief queue data for an input port, the data is passed through
+   *        TransferMessage when the sender is on the other side
+   * @param [in] port_id: input port
+   * @param [in] message_name: message type
+   * @param [in] data: data
+   * @param [in] src_side: side of the sender
+   * @param [in] timeout: wait for a full queue in millisecond, 0: no wait
+   * @return HIAI_OK, HIAI_QUEUE_FULL, HIAI_SEND_DATA_TIMEOUT or an error
+   */
+  HIAI_StatusT PushData(uint32_t port_id, const std::string &message_name,
+                        const std::shared_ptr<void> &data,
+                        EngineSide src_side, uint32_t timeout);
+
+  uint32_t GetGraphId() const {
+    return graph_id_;
+  }
+
+  uint32_t GetEngineId() const {
+    return config_.id;
+  }
+
+  const EngineConfig &GetConfig() const {
+    return config_;
+  }
+
+ private:
+  // an input port of an engine an output port sends to
+  struct Target {
+    EngineNode *node;
+    uint32_t port_id;
+  };
+
+  // data waiting in the queue
+  struct InputData {
+    uint32_t port_id;
+    std::shared_ptr<void> data;
+  };
+
+  /**
+   * @brief thread function, calls Process for the queued data
+   */
+  void Run();
+
+  uint32_t graph_id_;
+  EngineConfig config_;
+  const EngineFactory *factory_;
+  std::unique_ptr<hiai::Engine> engine_;
+
+  // data of all the input ports in the order of arrival
+  std::mutex queue_mutex_;
+  std::condition_variable data_cond_;
+  std::condition_variable space_cond_;
+  std::deque<InputData> queue_;
+  std::vector<uint32_t> port_depth_;
+  uint32_t queue_size_;
+  bool is_stopped_ = false;
+  std::vector<std::thread> threads_;
+
+  // output ports, connected before Start, receivers set at any time
+  std::mutex route_mutex_;
+  std::map<uint32_t, std::vector<Target>> targets_;
+  std::map<uint32_t, std::shared_ptr<hiai::DataRecvInterface>> receivers_;
+};
+
+/*
+ * A created graph, its engines and the hiai::Graph given to the
+ * application.
+ */
+class GraphRuntime {
+ public:
+  /**
+   * @brief create the graphs of graph.config, load and start their engines
+   * @param [in] config_file: graph.config
+   * @return HIAI_OK or an error
+   */
+  static HIAI_StatusT Create(const std::string &config_file);
+
+  /**
+   * @brief stop and remove a graph
+   * @param [in] graph_id: graph id
+   * @return HIAI_OK or HIAI_GRAPH_NOT_EXIST
+   */
+  static HIAI_StatusT Destroy(uint32_t graph_id);
+
+  /**
+   * @brief get a created graph
+   * @param [in] graph_id: graph id
+   * @return graph, nullptr if it does not exist
+   */
+  static std::shared_ptr<GraphRuntime> Get(uint32_t graph_id);
+
+  /**
+   * @brief load the libraries of HIAI_EMULATOR_PLUGINS once, they register
+   *        model stubs or engines
+   */
+  static void LoadPlugins();
+
+  ~GraphRuntime();
+
+  std::shared_ptr<hiai::Graph> GetGraph() const {
+    return graph_;
+  }
+
+  /**
+   * @brief get an engine of the graph
+   * @param [in] engine_id: engine id
+   * @return engine, nullptr if it does not exist
+   */
+  EngineNode *GetNode(uint32_t engine_id) const;
+
+ private:
+  explicit GraphRuntime(const GraphConfig &config);
+
+  /**
+   * @brief load the engine libraries, create the engines and connect them
+   * @return HIAI_OK or an error
+   */
+  HIAI_StatusT Build();
+
+  GraphConfig config_;
+  std::shared_ptr<hiai::Graph> graph_;
+  std::map<uint32_t, std::unique_ptr<EngineNode>> nodes_;
+};
+}
+}
+
+#endif /* ASCENDDK_HIAI_EMULATOR_GRAPH_RUNTIME_H_ */
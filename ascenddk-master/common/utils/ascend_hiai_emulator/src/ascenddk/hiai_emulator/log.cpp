@@ -0,0 +1,114 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "hiaiengine/log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// log levels, HIAI_EMULATOR_LOG_LEVEL: error, info or debug
+enum LogLevel {
+  kLogLevelError = 0,
+  kLogLevelInfo = 1,
+  kLogLevelDebug = 2,
+};
+
+const char *const kLogLevelEnv = "HIAI_EMULATOR_LOG_LEVEL";
+
+const char *const kLogLevelNames[] = { "ERROR", "INFO", "DEBUG" };
+
+LogLevel GetLogLevel() {
+  static const LogLevel level = []() {
+    const char *env = getenv(kLogLevelEnv);
+    if (env == nullptr) {
+      return kLogLevelError;
+    }
+    if (strcmp(env, "debug") == 0) {
+      return kLogLevelDebug;
+    }
+    if (strcmp(env, "info") == 0) {
+      return kLogLevelInfo;
+    }
+    return kLogLevelError;
+  }();
+  return level;
+}
+
+void WriteLog(const char *file, int line, LogLevel level, HIAI_StatusT status,
+              const char *format, va_list args) {
+  if (level > GetLogLevel()) {
+    return;
+  }
+
+  // one fprintf per line, lines of engine threads are not mixed
+  char message[1024] = { 0 };
+  vsnprintf(message, sizeof(message), format, args);
+  const char *base = strrchr(file, '/');
+  fprintf(stderr, "[%s] [%ld] %s:%d status=%u %s\n", kLogLevelNames[level],
+          (long) syscall(SYS_gettid), (base == nullptr) ? file : base + 1,
+          line, status, message);
+}
+}
+
+namespace ascend {
+namespace emulator {
+
+void WriteEngineLog(const char *file, int line, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  WriteLog(file, line, kLogLevelInfo, HIAI_OK, format, args);
+  va_end(args);
+}
+
+void WriteEngineLog(const char *file, int line, HIAI_StatusT status,
+                    const char *format, ...) {
+  LogLevel level = kLogLevelError;
+  if (status == HIAI_DEBUG_INFO) {
+    level = kLogLevelDebug;
+  } else if (status == HIAI_OK) {
+    level = kLogLevelInfo;
+  }
+
+  va_list args;
+  va_start(args, format);
+  WriteLog(file, line, level, status, format, args);
+  va_end(args);
+}
+}
+}
@@ -0,0 +1,244 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/hiai_emulator/model_stub.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "hiaiengine/log.h"
+
+using namespace std;
+
+namespace {
+
+// suffix of the replay file of a model path
+const char *const kReplaySuffix = ".replay";
+
+// stub of the models without their own stub or replay file
+const char *const kDefaultStubName = "*";
+
+// keys of a replay file
+const char *const kReplayOutputKey = "output";
+const char *const kReplayLatencyKey = "latency_us";
+
+mutex &GetStubMutex() {
+  static mutex stub_mutex;
+  return stub_mutex;
+}
+
+map<string, ascend::emulator::ModelStubCreator> &GetStubCreators() {
+  static map<string, ascend::emulator::ModelStubCreator> creators;
+  return creators;
+}
+
+string GetDirectory(const string &path) {
+  size_t pos = path.rfind('/');
+  return (pos == string::npos) ? "" : path.substr(0, pos + 1);
+}
+
+string GetFileName(const string &path) {
+  size_t pos = path.rfind('/');
+  return (pos == string::npos) ? path : path.substr(pos + 1);
+}
+
+bool ReadFile(const string &file, vector<uint8_t> &content) {
+  ifstream stream(file.c_str(), ios::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+  content.assign(istreambuf_iterator<char>(stream),
+                 istreambuf_iterator<char>());
+  return true;
+}
+
+bool FindStubCreator(const string &name,
+                     ascend::emulator::ModelStubCreator &creator) {
+  lock_guard<mutex> lock(GetStubMutex());
+  map<string, ascend::emulator::ModelStubCreator>::const_iterator it =
+      GetStubCreators().find(name);
+  if (it == GetStubCreators().end()) {
+    return false;
+  }
+  creator = it->second;
+  return true;
+}
+}
+
+namespace ascend {
+namespace emulator {
+
+bool ReplayModelStub::Load(const string &replay_file) {
+  ifstream stream(replay_file.c_str());
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  string line;
+  while (getline(stream, line)) {
+    istringstream fields(line);
+    string key;
+    if (!(fields >> key) || key[0] == '#') {
+      continue;
+    }
+
+    if (key == kReplayOutputKey) {
+      string file;
+      fields >> file;
+      if (!file.empty() && file[0] != '/') {
+        file = GetDirectory(replay_file) + file;
+      }
+      outputs_.push_back(vector<uint8_t>());
+      if (!ReadFile(file, outputs_.back()) || outputs_.back().empty()) {
+        HIAI_ENGINE_LOG(HIAI_ERROR, "failed to read output %s of %s",
+                        file.c_str(), replay_file.c_str());
+        return false;
+      }
+    } else if (key == kReplayLatencyKey) {
+      fields >> latency_us_;
+    } else {
+      HIAI_ENGINE_LOG(HIAI_ERROR, "unknown key %s in %s", key.c_str(),
+                      replay_file.c_str());
+      return false;
+    }
+  }
+
+  if (outputs_.empty()) {
+    HIAI_ENGINE_LOG(HIAI_ERROR, "no output in %s", replay_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool ReplayModelStub::CreateOutputTensor(
+    const vector<shared_ptr<hiai::IAITensor>> &inputs,
+    vector<shared_ptr<hiai::IAITensor>> &outputs) {
+  vector<hiai::TensorDimension> input_dims;
+  vector<hiai::TensorDimension> output_dims;
+  GetTensorDim(input_dims, output_dims);
+
+  outputs.clear();
+  for (const hiai::TensorDimension &dim : output_dims) {
+    outputs.push_back(CreateNeuralNetworkBuffer(dim.size, dim));
+  }
+  return true;
+}
+
+bool ReplayModelStub::Process(const vector<shared_ptr<hiai::IAITensor>> &inputs,
+                              vector<shared_ptr<hiai::IAITensor>> &outputs) {
+  if (outputs.size() < outputs_.size()) {
+    HIAI_ENGINE_LOG(HIAI_ERROR, "%zu outputs given, %zu expected",
+                    outputs.size(), outputs_.size());
+    return false;
+  }
+
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    shared_ptr<hiai::AISimpleTensor> output =
+        dynamic_pointer_cast<hiai::AISimpleTensor>(outputs[i]);
+    if (output == nullptr || output->GetBuffer() == nullptr
+        || output->GetSize() < outputs_[i].size()) {
+      HIAI_ENGINE_LOG(HIAI_ERROR, "output %zu is smaller than %zu bytes", i,
+                      outputs_[i].size());
+      return false;
+    }
+    memcpy(output->GetBuffer(), outputs_[i].data(), outputs_[i].size());
+  }
+
+  if (latency_us_ > 0) {
+    usleep(latency_us_);
+  }
+  return true;
+}
+
+bool ReplayModelStub::GetTensorDim(
+    vector<hiai::TensorDimension> &input_dims,
+    vector<hiai::TensorDimension> &output_dims) {
+  input_dims.clear();
+  output_dims.clear();
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    hiai::TensorDimension dim;
+    dim.name = "output" + to_string(i);
+    dim.size = outputs_[i].size();
+    output_dims.push_back(dim);
+  }
+  return true;
+}
+
+void RegisterModelStub(const string &name, const ModelStubCreator &creator) {
+  lock_guard<mutex> lock(GetStubMutex());
+  GetStubCreators()[name] = creator;
+}
+
+shared_ptr<ModelStub> CreateModelStub(
+    const hiai::AIModelDescription &model_desc) {
+  ModelStubCreator creator;
+  if (FindStubCreator(model_desc.name(), creator)
+      || FindStubCreator(GetFileName(model_desc.path()), creator)) {
+    return creator(model_desc);
+  }
+
+  string replay_file = model_desc.path() + kReplaySuffix;
+  if (access(replay_file.c_str(), R_OK) == 0) {
+    shared_ptr<ReplayModelStub> stub = make_shared<ReplayModelStub>();
+    return stub->Load(replay_file) ? stub : nullptr;
+  }
+
+  if (FindStubCreator(kDefaultStubName, creator)) {
+    return creator(model_desc);
+  }
+
+  HIAI_ENGINE_LOG(HIAI_ERROR, "no model stub or %s for model %s",
+                  replay_file.c_str(), model_desc.name().c_str());
+  return nullptr;
+}
+
+shared_ptr<hiai::AINeuralNetworkBuffer> CreateNeuralNetworkBuffer(
+    uint32_t size, const hiai::TensorDimension &dim) {
+  shared_ptr<hiai::AINeuralNetworkBuffer> buffer =
+      make_shared<hiai::AINeuralNetworkBuffer>();
+  buffer->SetBuffer(new uint8_t[size](), size, true);
+  buffer->SetName(dim.name);
+  buffer->SetNumber(dim.n);
+  buffer->SetChannel(dim.c);
+  buffer->SetHeight(dim.h);
+  buffer->SetWidth(dim.w);
+  buffer->SetData_type(dim.data_type);
+  return buffer;
+}
+}
+}
@@ -0,0 +1,172 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ascenddk/hiai_emulator/graph_config.h"
+#include "hiaiengine/api.h"
+
+using namespace std;
+
+namespace {
+
+// options of the runner
+const char *const kUsage =
+    "usage: %s -c graph.config [-d seconds] [-n messages]\n"
+    "  -c: graph to run, the engine libraries are loaded from so_name\n"
+    "  -d: seconds to run, default: until -n messages are received\n"
+    "  -n: messages received by the last engines to stop, default: 1\n";
+
+// message sent to the input port 0 of the first engines, like main.cpp
+const char *const kStartMessage = "string";
+
+// input and output port used by the runner
+const uint32_t kRunnerPort = 0;
+
+// poll interval of the received messages in millisecond
+const uint32_t kPollIntervalMs = 10;
+
+atomic<uint64_t> g_received(0);
+
+// counts the messages of the last engines
+class CountingRecvInterface : public hiai::DataRecvInterface {
+ public:
+  HIAI_StatusT RecvData(const shared_ptr<void> &message) override {
+    ++g_received;
+    return HIAI_OK;
+  }
+};
+}
+
+int main(int argc, char *argv[]) {
+  string config_file;
+  double duration_s = 0;
+  uint64_t message_num = 1;
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "c:d:n:")) != -1) {
+    if (opt == 'c') {
+      config_file = optarg;
+    } else if (opt == 'd') {
+      duration_s = atof(optarg);
+    } else if (opt == 'n') {
+      message_num = strtoull(optarg, nullptr, 10);
+    } else {
+      fprintf(stderr, kUsage, argv[0]);
+      return 1;
+    }
+  }
+  if (config_file.empty()) {
+    fprintf(stderr, kUsage, argv[0]);
+    return 1;
+  }
+
+  vector<ascend::emulator::GraphConfig> configs;
+  if (ascend::emulator::ParseGraphConfig(config_file, configs) != HIAI_OK
+      || configs.empty()) {
+    fprintf(stderr, "invalid graph config %s\n", config_file.c_str());
+    return 1;
+  }
+
+  HIAI_Init(0);
+  HIAI_StatusT ret = hiai::Graph::CreateGraph(config_file);
+  if (ret != HIAI_OK) {
+    fprintf(stderr, "failed to create graph %s, ret=%u\n",
+            config_file.c_str(), ret);
+    return 1;
+  }
+
+  // the first engines receive no data from engines, the last engines send
+  // none to engines
+  for (const ascend::emulator::GraphConfig &config : configs) {
+    shared_ptr<hiai::Graph> graph = hiai::Graph::GetInstance(config.graph_id);
+    set<uint32_t> sources;
+    set<uint32_t> leaves;
+    for (const ascend::emulator::EngineConfig &engine : config.engines) {
+      sources.insert(engine.id);
+      leaves.insert(engine.id);
+    }
+    for (const ascend::emulator::ConnectConfig &connect : config.connects) {
+      sources.erase(connect.target_engine_id);
+      leaves.erase(connect.src_engine_id);
+    }
+
+    hiai::EnginePortID port;
+    port.graph_id = config.graph_id;
+    port.port_id = kRunnerPort;
+    for (uint32_t engine_id : leaves) {
+      port.engine_id = engine_id;
+      graph->SetDataRecvFunctor(port,
+                                make_shared<CountingRecvInterface>());
+    }
+    for (uint32_t engine_id : sources) {
+      port.engine_id = engine_id;
+      ret = graph->SendData(port, kStartMessage,
+                            static_pointer_cast<void>(make_shared<string>()));
+      if (ret != HIAI_OK) {
+        fprintf(stderr, "failed to send data to engine %u, ret=%u\n",
+                engine_id, ret);
+      }
+    }
+  }
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  double elapsed_s = 0;
+  while (true) {
+    this_thread::sleep_for(chrono::milliseconds(kPollIntervalMs));
+    elapsed_s = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    if ((duration_s > 0) ? (elapsed_s >= duration_s)
+                         : (g_received >= message_num)) {
+      break;
+    }
+  }
+
+  uint64_t received = g_received;
+  printf("messages: %llu, seconds: %.3f, messages/s: %.2f\n",
+         (unsigned long long) received, elapsed_s, received / elapsed_s);
+  fflush(stdout);
+
+  // engines may loop in Process forever, like the decoding engines, so the
+  // graph is not destroyed
+  _exit(0);
+}
@@ -0,0 +1,120 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_BATCH_WORKER_POOL_H_
+#define ASCENDDK_ASCEND_UTILS_BATCH_WORKER_POOL_H_
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils_common.h"
+
+namespace ascend {
+namespace utils {
+
+/*
+ * A fixed number of worker threads which run the tasks of a batch
+ * concurrently, the caller waits until every task of its batch is done.
+ * A task gets the index of the worker that runs it, so per worker state
+ * (e.g. a device session) is used without locking. Thread safe, batches of
+ * several callers share the workers.
+ */
+class BatchWorkerPool {
+ public:
+  /**
+   * @brief run one task
+   * @param [in] worker_index: index of the worker, from 0 to worker_num - 1
+   * @param [in] task_index: index of the task in its batch
+   */
+  typedef std::function<void(int worker_index, size_t task_index)> TaskFunc;
+
+  // class constructor
+  BatchWorkerPool();
+
+  // class destructor, stops the workers
+  virtual ~BatchWorkerPool();
+
+  /**
+   * @brief start the workers
+   * @param [in] worker_num: number of worker threads
+   * @return enum UtilsErrorCode
+   */
+  int Start(int worker_num);
+
+  /**
+   * @brief stop the workers, a running batch is finished first
+   */
+  void Stop();
+
+  /**
+   * @brief run the tasks of a batch and wait until all of them are done
+   * @param [in] task_num: number of tasks
+   * @param [in] task_func: called once for every task index
+   * @return enum UtilsErrorCode
+   */
+  int Run(size_t task_num, const TaskFunc &task_func);
+
+ private:
+  // tasks of one Run call
+  struct TaskBatch {
+    const TaskFunc *task_func = nullptr;
+    size_t remaining = 0;
+  };
+
+  // a task waiting for a worker
+  struct PendingTask {
+    TaskBatch *batch;
+    size_t task_index;
+  };
+
+  /**
+   * @brief worker thread, runs pending tasks until the pool stops
+   * @param [in] worker_index: index of the worker
+   */
+  void WorkerLoop(int worker_index);
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable task_ready_;
+  std::condition_variable batch_done_;
+  std::deque<PendingTask> pending_;
+  bool is_stopped_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_BATCH_WORKER_POOL_H_ */
@@ -0,0 +1,145 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_DETECTION_FILTER_H_
+#define ASCENDDK_ASCEND_UTILS_DETECTION_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ascend {
+namespace utils {
+
+// floats of a detection in the SSD output: image id, label, score,
+// top left x, top left y, lower right x, lower right y
+const uint32_t kDetectionResultSize = 7;
+
+// a kept detection, coordinates are ratios of the image between 0.0 and 1.0
+struct DetectionBox {
+  int32_t label;
+  float score;
+  float lt_x;
+  float lt_y;
+  float rb_x;
+  float rb_y;
+};
+
+struct DetectionFilterPara {
+  // minimal score of a kept detection
+  float score_threshold;
+
+  // a detection is suppressed by a better one of the same label when their
+  // IoU is above it, 1.0: no suppression
+  float nms_threshold;
+
+  // maximal detections kept for each label, 0: no limit
+  uint32_t top_k;
+
+  DetectionFilterPara()
+      : score_threshold(0.0f),
+        nms_threshold(0.45f),
+        top_k(0) {
+  }
+};
+
+/*
+ * Post processing of the SSD detection output.
+ * The scores are thresholded 4 at a time with neon, the candidates are
+ * sorted by score into structure of arrays and a class aware non maximum
+ * suppression keeps at most top_k detections of every label.
+ * Not thread safe, use one filter for each engine thread.
+ */
+class DetectionFilter {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] para: filter parameters
+   */
+  explicit DetectionFilter(
+      const DetectionFilterPara &para = DetectionFilterPara());
+
+  // class destructor
+  virtual ~DetectionFilter();
+
+  /**
+   * @brief filter the detections of one image
+   * @param [in] results: SSD output, kDetectionResultSize floats each
+   * @param [in] result_num: number of detections in results
+   * @param [in] labels: labels to keep, empty: keep all labels
+   * @param [out] boxes: kept detections by descending score
+   */
+  void Filter(const float *results, size_t result_num,
+              const std::vector<int32_t> &labels,
+              std::vector<DetectionBox> &boxes);
+
+ private:
+  /**
+   * @brief gather the detections above the score threshold and of a kept
+   *        label into the candidate arrays, by descending score
+   * @param [in] results: SSD output
+   * @param [in] result_num: number of detections in results
+   * @param [in] labels: labels to keep, empty: keep all labels
+   */
+  void SelectCandidates(const float *results, size_t result_num,
+                        const std::vector<int32_t> &labels);
+
+  /**
+   * @brief suppress the candidates after a kept one that have its label and
+   *        overlap it more than the nms threshold
+   * @param [in] index: index of the kept candidate
+   */
+  void SuppressOverlaps(size_t index);
+
+  DetectionFilterPara para_;
+
+  // score of every detection, contiguous for the threshold
+  std::vector<float> scores_;
+
+  // detections above the threshold
+  std::vector<uint32_t> candidates_;
+
+  // candidates by descending score in structure of arrays
+  std::vector<float> lt_x_;
+  std::vector<float> lt_y_;
+  std::vector<float> rb_x_;
+  std::vector<float> rb_y_;
+  std::vector<float> area_;
+  std::vector<int32_t> label_;
+
+  // all bits set when the candidate is suppressed
+  std::vector<uint32_t> suppressed_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_DETECTION_FILTER_H_ */
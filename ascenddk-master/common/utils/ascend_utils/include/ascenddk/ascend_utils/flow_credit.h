@@ -0,0 +1,123 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_FLOW_CREDIT_H_
+#define ASCENDDK_ASCEND_UTILS_FLOW_CREDIT_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ascend {
+namespace utils {
+
+/*
+ * Credit based flow control between two engines of one process.
+ * The receiver sets its capacity, a sender takes a credit before it sends
+ * and the receiver returns it when it takes the data out of its queue, so a
+ * sender blocks exactly until the receiver has room instead of polling a
+ * full queue. A receiver that never sets a capacity (e.g. in another
+ * process) is not limited, its senders only use WaitRelease as a bounded
+ * wait when the queue is full.
+ * Credits are shared by name through GetFlowCredit. Thread safe.
+ */
+class FlowCredit {
+ public:
+  /**
+   * @brief get the credits of a receiver, created on first use
+   * @param [in] name: receiver name, e.g. the engine name
+   * @return credits shared by every caller of this process
+   */
+  static std::shared_ptr<FlowCredit> GetFlowCredit(const std::string &name);
+
+  // class constructor, no capacity: not limited
+  FlowCredit();
+
+  // class destructor
+  virtual ~FlowCredit();
+
+  /**
+   * @brief set the number of data the receiver can queue, called by the
+   *        receiver, it should not exceed the queue size of the receiver
+   * @param [in] capacity: credits, 0: not limited
+   */
+  void SetCapacity(int capacity);
+
+  /**
+   * @brief take a credit, wait until the receiver returns one if all are
+   *        taken
+   * @param [in] timeout_ms: maximum wait in millisecond
+   * @param [out] is_blocked: set to true if the sender had to wait, may be
+   *        nullptr
+   * @return true: a credit is taken; false: timeout or not limited, nothing
+   *         needs to be returned
+   */
+  bool Acquire(int timeout_ms, bool *is_blocked = nullptr);
+
+  /**
+   * @brief return a credit, called by the receiver for every data it takes
+   *        out of its queue, or by a sender whose data was not sent
+   */
+  void Release();
+
+  /**
+   * @brief wait until the receiver takes data out of its queue
+   * @param [in] timeout_ms: maximum wait in millisecond
+   * @return true: data taken; false: timeout
+   */
+  bool WaitRelease(int timeout_ms);
+
+  /**
+   * @brief get number of credits taken
+   * @return credit number
+   */
+  int GetInFlight();
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+
+  // credits of the receiver, 0: not limited
+  int capacity_;
+
+  // credits taken by senders
+  int in_flight_;
+
+  // number of Release calls, wakes WaitRelease
+  uint64_t release_count_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_FLOW_CREDIT_H_ */
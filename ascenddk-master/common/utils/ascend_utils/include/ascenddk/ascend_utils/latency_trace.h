@@ -0,0 +1,322 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_LATENCY_TRACE_H_
+#define ASCENDDK_ASCEND_UTILS_LATENCY_TRACE_H_
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "utils_common.h"
+
+namespace ascend {
+namespace utils {
+
+// number of latency histogram buckets, bucket i holds [2^(i-1), 2^i) us
+const int kLatencyBucketNum = 32;
+
+// name of the histogram from the first stamp to the last stamp
+const char * const kEndToEndStage = "end_to_end";
+
+// graph.config items of the engine that owns the tracer
+const char * const kLatencyHistogramFileKey = "latency_histogram_file";
+const char * const kLatencyTraceFileKey = "latency_trace_file";
+const char * const kLatencyExportIntervalKey = "latency_export_interval";
+
+// graph.config items of the engine that starts the engine profile
+const char * const kEngineProfileFileKey = "engine_profile_file";
+const char * const kEngineProfileJsonFileKey = "engine_profile_json_file";
+const char * const kEngineProfileIntervalKey = "engine_profile_interval_ms";
+
+// one stage (engine) a frame has passed
+struct TraceStamp {
+  // stage name
+  std::string stage;
+
+  // process of the stage, stamps of one process share a monotonic clock
+  int32_t pid = 0;
+
+  // monotonic time the frame enters and leaves the stage in nanosecond
+  int64_t enter_ns = 0;
+  int64_t exit_ns = 0;
+};
+
+/**
+ * @brief serialize for TraceStamp
+ *        engine uses it to transfer data between host and device
+ */
+template<class Archive>
+void serialize(Archive &ar, TraceStamp &data) {
+  ar(data.stage, data.pid, data.enter_ns, data.exit_ns);
+}
+
+/**
+ * @brief get monotonic time of this process
+ * @return time in nanosecond
+ */
+int64_t GetMonotonicTimeNs();
+
+/**
+ * @brief append a stage to the trace of a frame, the enter time is now
+ * @param [out] trace: trace carried by the frame
+ * @param [in] stage: stage name
+ */
+void EnterTraceStage(std::vector<TraceStamp> &trace, const std::string &stage);
+
+/**
+ * @brief set the exit time of the last stage to now, call it before the
+ *        frame is sent to the next stage. It also updates the load of the
+ *        stage returned by GetStageLoadNs
+ * @param [out] trace: trace carried by the frame
+ */
+void ExitTraceStage(std::vector<TraceStamp> &trace);
+
+/**
+ * @brief get the load of a stage in this process: the moving average of the
+ *        queue wait plus processing time of the frames that left it.
+ *        A stage no frame left for a second has no load
+ * @param [in] stage: stage name
+ * @return load in nanosecond, 0: unknown stage or idle
+ */
+int64_t GetStageLoadNs(const std::string &stage);
+
+/**
+ * @brief set a gauge of this process, e.g. the sampling interval of a
+ *        channel. Gauges are written to the histogram file of LatencyTracer
+ * @param [in] name: gauge name
+ * @param [in] value: current value
+ */
+void SetGauge(const std::string &name, int64_t value);
+
+struct LatencyTracerPara {
+  // per-stage latency histogram in text, empty: not exported
+  std::string histogram_file;
+
+  // chrome trace json (chrome://tracing, perfetto), empty: not exported
+  std::string chrome_trace_file;
+
+  // frames between two exports, 0: export only on destruction
+  int export_interval = 1000;
+
+  // latest frames kept for the chrome trace
+  int max_trace_frames = 10000;
+};
+
+/*
+ * Collects the traces of finished frames, usually in the last engine of a
+ * graph, and exports per-stage latency histograms and a chrome trace.
+ * For every stage the histogram holds the time spent in the stage, and the
+ * wait before it ("<previous> -> <stage>") when both stages ran in the same
+ * process. Stages in different processes (host and device) have unrelated
+ * clocks, so only their own durations are comparable, and the chrome trace
+ * shows every process as its own track.
+ * The methods are thread safe.
+ */
+class LatencyTracer {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] LatencyTracerPara para: export settings
+   */
+  LatencyTracer(const LatencyTracerPara &para);
+
+  // class destructor, exports the data collected
+  virtual ~LatencyTracer();
+
+  /**
+   * @brief add the trace of a finished frame
+   * @param [in] trace: stamps in the order of the stages
+   * @param [in] channel: channel of the frame
+   * @param [in] frame_id: frame id
+   */
+  void RecordFrame(const std::vector<TraceStamp> &trace,
+                   const std::string &channel, uint32_t frame_id);
+
+  /**
+   * @brief write the histogram and the chrome trace files
+   * @return enum UtilsErrorCode
+   */
+  int Export();
+
+ private:
+  struct LatencyHistogram {
+    long count = 0;
+    int64_t sum_ns = 0;
+    int64_t min_ns = 0;
+    int64_t max_ns = 0;
+    long buckets[kLatencyBucketNum] = { 0 };
+  };
+
+  struct FrameTrace {
+    int channel_index;
+    uint32_t frame_id;
+    std::vector<TraceStamp> trace;
+  };
+
+  /**
+   * @brief add a latency to a histogram
+   * @param [in] name: histogram name
+   * @param [in] latency_ns: latency in nanosecond
+   */
+  void AddLatency(const std::string &name, int64_t latency_ns);
+
+  /**
+   * @brief write the histogram file, the caller holds mutex_
+   * @return enum UtilsErrorCode
+   */
+  int ExportHistogram() const;
+
+  /**
+   * @brief write the chrome trace file, the caller holds mutex_
+   * @return enum UtilsErrorCode
+   */
+  int ExportChromeTrace() const;
+
+  // used for storage attributes of tracer
+  LatencyTracerPara para_;
+
+  std::mutex mutex_;
+
+  // histograms in the order they appeared first
+  std::vector<std::string> histogram_names_;
+  std::map<std::string, LatencyHistogram> histograms_;
+
+  // latest traces for the chrome trace
+  std::deque<FrameTrace> frame_traces_;
+
+  // channels in the order they appeared first, the index is the chrome
+  // trace thread id
+  std::vector<std::string> channels_;
+
+  // frames recorded
+  long frame_count_ = 0;
+};
+
+struct EngineProfilePara {
+  // per-engine table in text, empty: not exported
+  std::string text_file;
+
+  // the same data in json, empty: not exported
+  std::string json_file;
+
+  // length of a profile interval, the statistics restart after each export
+  int export_interval_ms = 5000;
+};
+
+/**
+ * @brief start profiling the engines of this process and export the
+ *        profile every interval from a background thread. Only the first
+ *        call in a process takes effect, the last interval is exported when
+ *        the process exits
+ * @param [in] EngineProfilePara para: export settings
+ * @return enum UtilsErrorCode
+ */
+int StartEngineProfile(const EngineProfilePara &para);
+
+/**
+ * @brief whether StartEngineProfile has been called in this process
+ * @return true: the engines are profiled
+ */
+bool IsEngineProfileStarted();
+
+/**
+ * @brief add a Process call of an engine to the profile, nothing is
+ *        recorded before StartEngineProfile
+ * @param [in] engine: engine name
+ * @param [in] service_ns: time spent in Process in nanosecond
+ * @param [in] queue_depth: data queued to the engine when Process started,
+ *             negative: unknown
+ */
+void RecordEngineProcess(const std::string &engine, int64_t service_ns,
+                         int queue_depth);
+
+/**
+ * @brief add a SendData to an engine to the profile, nothing is recorded
+ *        before StartEngineProfile
+ * @param [in] receiver: name of the receiving engine
+ * @param [in] blocked_ns: time the sender waited for the receiver in
+ *             nanosecond
+ * @param [in] is_queue_full: the receiver returned HIAI_QUEUE_FULL at least
+ *             once
+ * @param [in] is_dropped: the data was not sent
+ */
+void RecordEngineSend(const std::string &receiver, int64_t blocked_ns,
+                      bool is_queue_full, bool is_dropped);
+
+/**
+ * @brief write the profile of the current interval and start a new one
+ * @return enum UtilsErrorCode
+ */
+int ExportEngineProfile();
+
+/*
+ * Measures one Process call of an engine from construction to destruction,
+ * use it through ENGINE_PROFILE_PROCESS at the top of Process.
+ */
+class EngineProcessScope {
+ public:
+  /**
+   * @brief class constructor, the call starts now
+   * @param [in] engine: engine name
+   * @param [in] queue_depth: data queued to the engine, negative: unknown
+   */
+  EngineProcessScope(const std::string &engine, int queue_depth)
+      : engine_(engine),
+        queue_depth_(queue_depth),
+        start_ns_(IsEngineProfileStarted() ? GetMonotonicTimeNs() : 0) {
+  }
+
+  // class destructor, records the call
+  ~EngineProcessScope() {
+    if (start_ns_ != 0) {
+      RecordEngineProcess(engine_, GetMonotonicTimeNs() - start_ns_,
+                          queue_depth_);
+    }
+  }
+
+ private:
+  std::string engine_;
+  int queue_depth_;
+  int64_t start_ns_;
+};
+
+// profiles the rest of the current scope as a Process call of engine
+#define ENGINE_PROFILE_PROCESS(engine, queue_depth) \
+  ascend::utils::EngineProcessScope engine_process_scope((engine), \
+                                                         (queue_depth))
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_LATENCY_TRACE_H_ */
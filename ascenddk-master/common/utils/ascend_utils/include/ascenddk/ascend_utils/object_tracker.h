@@ -0,0 +1,189 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_OBJECT_TRACKER_H_
+#define ASCENDDK_ASCEND_UTILS_OBJECT_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ascend {
+namespace utils {
+
+// bounding box of a detection in pixel
+struct TrackBox {
+  float lt_x;
+  float lt_y;
+  float rb_x;
+  float rb_y;
+};
+
+// detection of a frame, only detections and tracks of one label are matched
+struct TrackDetection {
+  TrackBox box;
+  int32_t label;
+};
+
+// the track of a detection
+struct TrackResult {
+  // id of the track, unique in the tracker and never reused
+  uint32_t track_id;
+
+  // frames matched to the track including this one, 1: new track
+  uint32_t hits;
+};
+
+struct ObjectTrackerPara {
+  // minimal IoU between the predicted box of a track and its detection
+  float iou_threshold;
+
+  // frames a track is kept without a matched detection
+  uint32_t max_missed;
+
+  ObjectTrackerPara()
+      : iou_threshold(0.3f),
+        max_missed(3) {
+  }
+};
+
+/*
+ * SORT style multi object tracker of one video channel.
+ * Every track predicts its box with a constant velocity Kalman filter,
+ * detections are matched to the predicted boxes by IoU from the best pair
+ * down, matched tracks are corrected by their detection and unmatched
+ * detections start new tracks. The IoU matrix is computed on structure of
+ * arrays, 4 detections at a time with neon.
+ * Not thread safe, use one tracker for each channel.
+ */
+class ObjectTracker {
+ public:
+  /**
+   * @brief class constructor
+   * @param [in] para: tracker parameters
+   */
+  explicit ObjectTracker(const ObjectTrackerPara &para = ObjectTrackerPara());
+
+  // class destructor
+  virtual ~ObjectTracker();
+
+  /**
+   * @brief track the detections of the next frame
+   * @param [in] detections: detections of the frame
+   * @param [out] results: the track of every detection, in the same order
+   */
+  void Update(const std::vector<TrackDetection> &detections,
+              std::vector<TrackResult> &results);
+
+  /**
+   * @brief get number of live tracks
+   * @return track number
+   */
+  size_t GetTrackNum() const;
+
+ private:
+  // constant velocity Kalman filter of one box coordinate
+  struct KalmanAxis {
+    float pos;
+    float vel;
+
+    // covariance of (pos, vel)
+    float p00;
+    float p01;
+    float p11;
+  };
+
+  enum TrackAxis {
+    kCenterX = 0,
+    kCenterY,
+    kWidth,
+    kHeight,
+    kAxisNum,
+  };
+
+  struct Track {
+    uint32_t id;
+    int32_t label;
+    uint32_t hits;
+    uint32_t missed;
+    KalmanAxis axis[kAxisNum];
+  };
+
+  /**
+   * @brief start a track from an unmatched detection
+   * @param [in] detection: the detection
+   * @return the new track
+   */
+  Track CreateTrack(const TrackDetection &detection);
+
+  /**
+   * @brief predict the box of a track in the next frame
+   * @param [inout] track: the track
+   */
+  void Predict(Track &track);
+
+  /**
+   * @brief correct a track by its matched detection
+   * @param [inout] track: the track
+   * @param [in] box: box of the detection
+   */
+  void Correct(Track &track, const TrackBox &box);
+
+  /**
+   * @brief compute IoU of every predicted track box and detection box into
+   *        iou_matrix_, 0 if their labels differ
+   * @param [in] detections: detections of the frame
+   */
+  void ComputeIouMatrix(const std::vector<TrackDetection> &detections);
+
+  ObjectTrackerPara para_;
+
+  // id of the next new track
+  uint32_t next_id_;
+
+  std::vector<Track> tracks_;
+
+  // detection boxes in structure of arrays
+  std::vector<float> det_lt_x_;
+  std::vector<float> det_lt_y_;
+  std::vector<float> det_rb_x_;
+  std::vector<float> det_rb_y_;
+  std::vector<float> det_area_;
+  std::vector<int32_t> det_label_;
+
+  // IoU of track i and detection j at i * detection number + j
+  std::vector<float> iou_matrix_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_OBJECT_TRACKER_H_ */
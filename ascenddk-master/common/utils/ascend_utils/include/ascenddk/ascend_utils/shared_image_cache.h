@@ -0,0 +1,123 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_SHARED_IMAGE_CACHE_H_
+#define ASCENDDK_ASCEND_UTILS_SHARED_IMAGE_CACHE_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ascend {
+namespace utils {
+
+// an image produced once and read by several consumers, never modified
+struct SharedImage {
+  std::shared_ptr<uint8_t> data;
+  uint32_t size;
+};
+
+/*
+ * Images shared by the engines of one process, e.g. a crop resized to the
+ * same size for two models. The first consumer of a key produces the image,
+ * the others wait for it instead of producing their own copy, and the image
+ * is dropped after the last consumer took it. Images whose consumers never
+ * come expire after a short time.
+ * Caches are shared by name through GetSharedImageCache. Thread safe.
+ */
+class SharedImageCache {
+ public:
+  // produces the image of a key, returns false on failure
+  typedef std::function<bool(SharedImage &image)> ProduceFunc;
+
+  /**
+   * @brief get a cache, created on first use
+   * @param [in] name: cache name
+   * @return cache shared by every caller of this process
+   */
+  static std::shared_ptr<SharedImageCache> GetSharedImageCache(
+      const std::string &name);
+
+  // class constructor
+  SharedImageCache();
+
+  // class destructor
+  virtual ~SharedImageCache();
+
+  /**
+   * @brief get the image of a key, produce it if no other consumer did
+   * @param [in] key: identifies the image, e.g. frame, object and size
+   * @param [in] consumer_num: number of Get calls of the key, 1: not shared
+   * @param [in] produce: produces the image, called without the lock
+   * @param [out] image: the image
+   * @return true: success; false: produce failed
+   */
+  bool Get(const std::string &key, int consumer_num,
+           const ProduceFunc &produce, SharedImage &image);
+
+  /**
+   * @brief get number of cached images
+   * @return image number
+   */
+  size_t GetImageNum();
+
+ private:
+  struct Entry {
+    // false: the first consumer is still producing the image
+    bool is_ready;
+    bool is_ok;
+
+    // consumers that have not taken the image
+    int remaining;
+    SharedImage image;
+    std::chrono::steady_clock::time_point create_time;
+  };
+
+  /**
+   * @brief drop ready images older than the expire time, the caller holds
+   *        mutex_
+   */
+  void EraseExpired();
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::map<std::string, std::shared_ptr<Entry>> entries_;
+};
+}
+}
+#endif /* ASCENDDK_ASCEND_UTILS_SHARED_IMAGE_CACHE_H_ */
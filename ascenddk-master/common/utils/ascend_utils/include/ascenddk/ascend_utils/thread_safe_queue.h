@@ -0,0 +1,446 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef ASCENDDK_ASCEND_UTILS_THREAD_SAFE_QUEUE_H_
+#define ASCENDDK_ASCEND_UTILS_THREAD_SAFE_QUEUE_H_
+
+#include <stdlib.h>
+#include <climits>
+#include <ctime>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ascend {
+namespace utils {
+
+/*
+ * Bounded lock-free ring queue (multi producer, multi consumer; also the
+ * fastest choice for one producer and one consumer).
+ * Every slot carries a sequence number, so producers and consumers only
+ * contend on their own index. An rvalue is moved in, an lvalue is copied
+ * in, elements are moved out. A push that fails leaves the caller's element
+ * untouched.
+ * The blocking calls sleep on a futex and are woken by the opposite side as
+ * soon as an element or a free slot is available, without polling.
+ */
+template<typename T>
+class ThreadSafeQueue {
+ public:
+
+  /**
+   * @brief ThreadSafeQueue constructor
+   * @param [in] capacity: the queue capacity
+   */
+  explicit ThreadSafeQueue(int capacity = kDefaultQueueCapacity) {
+    // check the input value: capacity is valid
+    if (capacity >= kMinQueueCapacity && capacity <= kMaxQueueCapacity) {
+      queue_capacity_ = capacity;
+    } else { // the input value: capacity is invalid, set the default value
+      queue_capacity_ = kDefaultQueueCapacity;
+    }
+
+    // every slot starts on its own cache line
+    void *memory = nullptr;
+    if (posix_memalign(&memory, kCacheLineSize,
+                       sizeof(Slot) * queue_capacity_) != 0) {
+      throw std::bad_alloc();
+    }
+
+    slots_ = static_cast<Slot*>(memory);
+    for (size_t i = 0; i < queue_capacity_; ++i) {
+      new (&slots_[i]) Slot();
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief ThreadSafeQueue destructor
+   */
+  ~ThreadSafeQueue() {
+    for (size_t i = 0; i < queue_capacity_; ++i) {
+      slots_[i].~Slot();
+    }
+    free(slots_);
+  }
+
+  ThreadSafeQueue(const ThreadSafeQueue&) = delete;
+  ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
+
+  /**
+   * @brief push data to queue without blocking
+   * @param [in] input_value: the value will push to the queue, moved from
+   *        only when it is pushed
+   * @return true: success to push data; false: the queue is full
+   */
+  bool TryPush(T&& input_value) {
+    return TryPushValue(std::move(input_value));
+  }
+
+  /**
+   * @brief push a copy of data to queue without blocking
+   * @param [in] input_value: the value will push to the queue
+   * @return true: success to push data; false: the queue is full
+   */
+  bool TryPush(const T& input_value) {
+    return TryPushValue(input_value);
+  }
+
+  /**
+   * @brief push data to queue, block while the queue is full
+   * @param [in] input_value: the value will push to the queue
+   */
+  void Push(T&& input_value) {
+    PushValue(std::move(input_value), -1);
+  }
+
+  /**
+   * @brief push a copy of data to queue, block while the queue is full
+   * @param [in] input_value: the value will push to the queue
+   */
+  void Push(const T& input_value) {
+    PushValue(input_value, -1);
+  }
+
+  /**
+   * @brief push data to queue, block at most timeout_ms while it is full
+   * @param [in] input_value: the value will push to the queue, moved from
+   *        only when it is pushed
+   * @param [in] timeout_ms: the maximum wait time in millisecond
+   * @return true: success to push data; false: the queue is still full
+   */
+  bool Push(T&& input_value, int timeout_ms) {
+    return PushValue(std::move(input_value), timeout_ms);
+  }
+
+  /**
+   * @brief push a copy of data to queue, block at most timeout_ms while it
+   *        is full
+   * @param [in] input_value: the value will push to the queue
+   * @param [in] timeout_ms: the maximum wait time in millisecond
+   * @return true: success to push data; false: the queue is still full
+   */
+  bool Push(const T& input_value, int timeout_ms) {
+    return PushValue(input_value, timeout_ms);
+  }
+
+  /**
+   * @brief pop data from queue without blocking
+   * @param [out] value: the value popped from the queue
+   * @return true: success to pop data; false: the queue is empty
+   */
+  bool TryPop(T& value) {
+    if (!Dequeue(value)) {
+      return false;
+    }
+
+    Notify(pop_event_, push_waiters_);
+    return true;
+  }
+
+  /**
+   * @brief pop data from queue, block while the queue is empty
+   * @param [out] value: the value popped from the queue
+   */
+  void WaitAndPop(T& value) {
+    Wait(pop_waiters_, push_event_, -1, [&] {return Dequeue(value);});
+    Notify(pop_event_, push_waiters_);
+  }
+
+  /**
+   * @brief pop data from queue, block at most timeout_ms while it is empty
+   * @param [out] value: the value popped from the queue
+   * @param [in] timeout_ms: the maximum wait time in millisecond
+   * @return true: success to pop data; false: the queue is still empty
+   */
+  bool WaitAndPop(T& value, int timeout_ms) {
+    if (!Wait(pop_waiters_, push_event_, timeout_ms,
+              [&] {return Dequeue(value);})) {
+      return false;
+    }
+
+    Notify(pop_event_, push_waiters_);
+    return true;
+  }
+
+  /**
+   * @brief check the queue is empty
+   * @return true: the queue is empty; false: the queue is not empty
+   */
+  bool Empty() const {
+    return Size() == 0;
+  }
+
+  /**
+   * @brief get the queue size, exact when no push or pop is in progress
+   * @return the queue size
+   */
+  int Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? (int) (tail - head) : 0;
+  }
+
+  /**
+   * @brief get the queue capacity
+   * @return the queue capacity
+   */
+  int Capacity() const {
+    return (int) queue_capacity_;
+  }
+
+ private:
+  // size of a cache line, used to keep hot fields apart
+  static const int kCacheLineSize = 64;
+
+  struct alignas(kCacheLineSize) Slot {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  /**
+   * @brief push without blocking and wake a sleeping consumer
+   * @param [in] value: an rvalue is moved from, an lvalue is copied, only
+   *        when it is pushed
+   * @return true: success; false: the queue is full
+   */
+  template<typename Value>
+  bool TryPushValue(Value&& value) {
+    if (!Enqueue(std::forward<Value>(value))) {
+      return false;
+    }
+
+    Notify(push_event_, pop_waiters_);
+    return true;
+  }
+
+  /**
+   * @brief push, block at most timeout_ms while the queue is full, and wake
+   *        a sleeping consumer
+   * @param [in] value: an rvalue is moved from, an lvalue is copied, only
+   *        when it is pushed
+   * @param [in] timeout_ms: the maximum wait time, < 0 means forever
+   * @return true: success; false: the queue is still full
+   */
+  template<typename Value>
+  bool PushValue(Value&& value, int timeout_ms) {
+    // every retry gets the value again, it is taken only by the last one
+    if (!Wait(push_waiters_, pop_event_, timeout_ms,
+              [&] {return Enqueue(std::forward<Value>(value));})) {
+      return false;
+    }
+
+    Notify(push_event_, pop_waiters_);
+    return true;
+  }
+
+  /**
+   * @brief store a value into the tail slot
+   * @param [in] value: an rvalue is moved from, an lvalue is copied, only
+   *        when a slot is free
+   * @return true: success; false: the queue is full, value is untouched
+   */
+  template<typename Value>
+  bool Enqueue(Value&& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = slots_[pos % queue_capacity_];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence == pos) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          slot.data = std::forward<Value>(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos) { // the slot is still used: full
+        return false;
+      } else { // another producer took the slot, reload the tail
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief move the value out of the head slot
+   * @return true: success; false: the queue is empty
+   */
+  bool Dequeue(T& value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = slots_[pos % queue_capacity_];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence == pos + 1) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          value = std::move(slot.data);
+          slot.data = T();
+          slot.sequence.store(pos + queue_capacity_,
+                              std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < pos + 1) { // the slot is not filled yet: empty
+        return false;
+      } else { // another consumer took the slot, reload the head
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief retry an operation until it succeeds, sleeping on the event futex
+   *        in between
+   * @param [in] waiters: waiter counter of the event
+   * @param [in] event: futex word bumped by the opposite side
+   * @param [in] timeout_ms: the maximum wait time, < 0 means forever
+   * @param [in] operation: Enqueue or Dequeue
+   * @return true: the operation succeeded; false: timeout
+   */
+  template<typename Operation>
+  bool Wait(std::atomic<int> &waiters, std::atomic<int> &event, int timeout_ms,
+            Operation operation) {
+    if (operation()) {
+      return true;
+    }
+
+    struct timespec deadline = { 0, 0 };
+    if (timeout_ms >= 0) {
+      clock_gettime(CLOCK_MONOTONIC, &deadline);
+      deadline.tv_sec += timeout_ms / kMillisecPerSec;
+      deadline.tv_nsec += (long) (timeout_ms % kMillisecPerSec)
+          * kNanosecPerMillisec;
+      if (deadline.tv_nsec >= kNanosecPerSec) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= kNanosecPerSec;
+      }
+    }
+
+    while (true) {
+      // register before the last check, so a notify after it can not be lost
+      waiters.fetch_add(1);
+      int expected = event.load();
+      bool success = operation();
+      if (!success) {
+        struct timespec relative = { 0, 0 };
+        if (timeout_ms >= 0 && !GetRemainTime(deadline, relative)) {
+          waiters.fetch_sub(1);
+          return false;
+        }
+
+        syscall(SYS_futex, reinterpret_cast<int*>(&event), FUTEX_WAIT_PRIVATE,
+                expected, timeout_ms >= 0 ? &relative : nullptr, nullptr, 0);
+      }
+      waiters.fetch_sub(1);
+
+      if (success) {
+        return true;
+      }
+    }
+  }
+
+  /**
+   * @brief bump the event and wake the sleepers of the opposite side
+   * @param [in] event: futex word of the event
+   * @param [in] waiters: waiter counter of the event
+   */
+  static void Notify(std::atomic<int> &event, std::atomic<int> &waiters) {
+    event.fetch_add(1);
+    if (waiters.load() > 0) {
+      syscall(SYS_futex, reinterpret_cast<int*>(&event), FUTEX_WAKE_PRIVATE,
+              INT_MAX, nullptr, nullptr, 0);
+    }
+  }
+
+  /**
+   * @brief get remaining time until the deadline
+   * @param [in] deadline: absolute CLOCK_MONOTONIC time
+   * @param [out] relative: remaining time
+   * @return true: time remains; false: the deadline has passed
+   */
+  static bool GetRemainTime(const struct timespec &deadline,
+                            struct timespec &relative) {
+    struct timespec now = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    relative.tv_sec = deadline.tv_sec - now.tv_sec;
+    relative.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+    if (relative.tv_nsec < 0) {
+      relative.tv_sec--;
+      relative.tv_nsec += kNanosecPerSec;
+    }
+    return relative.tv_sec >= 0;
+  }
+
+  // the minimum queue capacity, with one slot a filled slot has the
+  // sequence of a free one
+  static const int kMinQueueCapacity = 2;
+
+  static const int kMaxQueueCapacity = 10000; // the maximum queue capacity
+
+  static const int kDefaultQueueCapacity = 10; // default queue capacity
+
+  static const int kMillisecPerSec = 1000; // 1 second = 1000 millisecond
+
+  static const long kNanosecPerMillisec = 1000000; // 1 ms = 1000000 ns
+
+  static const long kNanosecPerSec = 1000000000; // 1 s = 1000000000 ns
+
+  Slot *slots_; // the ring buffer, aligned to the cache line
+
+  size_t queue_capacity_; // queue capacity
+
+  char padding0_[kCacheLineSize];
+
+  std::atomic<size_t> tail_ { 0 }; // next slot to push, owned by producers
+
+  std::atomic<int> push_event_ { 0 }; // bumped by every push
+
+  std::atomic<int> pop_waiters_ { 0 }; // consumers sleeping on push_event_
+
+  char padding1_[kCacheLineSize];
+
+  std::atomic<size_t> head_ { 0 }; // next slot to pop, owned by consumers
+
+  std::atomic<int> pop_event_ { 0 }; // bumped by every pop
+
+  std::atomic<int> push_waiters_ { 0 }; // producers sleeping on pop_event_
+
+  char padding2_[kCacheLineSize];
+};
+}
+}
+
+#endif /* ASCENDDK_ASCEND_UTILS_THREAD_SAFE_QUEUE_H_ */
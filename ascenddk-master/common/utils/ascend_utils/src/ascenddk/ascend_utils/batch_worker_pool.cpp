@@ -0,0 +1,134 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/batch_worker_pool.h"
+
+using namespace std;
+
+namespace {
+// maximum number of worker threads
+const int kMaxWorkerNum = 16;
+}
+
+namespace ascend {
+namespace utils {
+
+BatchWorkerPool::BatchWorkerPool() {
+  is_stopped_ = false;
+}
+
+BatchWorkerPool::~BatchWorkerPool() {
+  Stop();
+}
+
+int BatchWorkerPool::Start(int worker_num) {
+  if ((worker_num <= 0) || (worker_num > kMaxWorkerNum)
+      || !workers_.empty()) {
+    return kUtilsErrorInvalidParameter;
+  }
+
+  is_stopped_ = false;
+  for (int i = 0; i < worker_num; ++i) {
+    workers_.push_back(thread(&BatchWorkerPool::WorkerLoop, this, i));
+  }
+  return kUtilsOk;
+}
+
+void BatchWorkerPool::Stop() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  task_ready_.notify_all();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].join();
+  }
+  workers_.clear();
+}
+
+int BatchWorkerPool::Run(size_t task_num, const TaskFunc &task_func) {
+  if (workers_.empty()) {
+    return kUtilsErrorInvalidParameter;
+  }
+  if (task_num == 0) {
+    return kUtilsOk;
+  }
+
+  TaskBatch batch;
+  batch.task_func = &task_func;
+  batch.remaining = task_num;
+  {
+    lock_guard<mutex> lock(mutex_);
+    for (size_t i = 0; i < task_num; ++i) {
+      PendingTask pending = { &batch, i };
+      pending_.push_back(pending);
+    }
+  }
+  task_ready_.notify_all();
+
+  unique_lock<mutex> lock(mutex_);
+  batch_done_.wait(lock, [&batch]() {return batch.remaining == 0;});
+  return kUtilsOk;
+}
+
+void BatchWorkerPool::WorkerLoop(int worker_index) {
+  while (true) {
+    PendingTask pending;
+    {
+      unique_lock<mutex> lock(mutex_);
+      task_ready_.wait(lock, [this]() {
+        return is_stopped_ || !pending_.empty();
+      });
+
+      // the tasks queued before Stop are run, their callers are waiting
+      if (pending_.empty()) {
+        return;
+      }
+      pending = pending_.front();
+      pending_.pop_front();
+    }
+
+    (*pending.batch->task_func)(worker_index, pending.task_index);
+
+    bool is_batch_done = false;
+    {
+      lock_guard<mutex> lock(mutex_);
+      is_batch_done = (--pending.batch->remaining == 0);
+    }
+    if (is_batch_done) {
+      batch_done_.notify_all();
+    }
+  }
+}
+}
+}
@@ -0,0 +1,267 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/detection_filter.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace {
+// index of the values in a detection of the SSD output
+enum DetectionIndex {
+  kLabel = 1,
+  kScore,
+  kTopLeftX,
+  kTopLeftY,
+  kLowerRightX,
+  kLowerRightY,
+};
+
+// valid bbox coordinate
+const float kLowerCoord = 0.0f;
+const float kUpperCoord = 1.0f;
+
+// all bits set, a suppressed candidate
+const uint32_t kSuppressed = 0xFFFFFFFF;
+
+float CorrectCoordinate(float value) {
+  float tmp = value < kLowerCoord ? kLowerCoord : value;
+  return tmp > kUpperCoord ? kUpperCoord : tmp;
+}
+
+// labels of the SSD output are integers stored as float
+int32_t ToLabel(float value) {
+  return static_cast<int32_t>(value + 0.5f);
+}
+}
+
+namespace ascend {
+namespace utils {
+
+DetectionFilter::DetectionFilter(const DetectionFilterPara &para) {
+  para_ = para;
+}
+
+DetectionFilter::~DetectionFilter() {
+}
+
+void DetectionFilter::SelectCandidates(const float *results,
+                                       size_t result_num,
+                                       const vector<int32_t> &labels) {
+  scores_.resize(result_num);
+  for (size_t i = 0; i < result_num; ++i) {
+    scores_[i] = results[i * kDetectionResultSize + kScore];
+  }
+
+  candidates_.clear();
+  const float *scores = scores_.data();
+  float threshold = para_.score_threshold;
+  size_t i = 0;
+#if defined(__aarch64__)
+  // most detections are below the threshold, skip 4 of them at a time
+  const float32x4_t threshold_vec = vdupq_n_f32(threshold);
+  for (; i + 4 <= result_num; i += 4) {
+    uint32x4_t above = vcgeq_f32(vld1q_f32(scores + i), threshold_vec);
+    if (vmaxvq_u32(above) == 0) {
+      continue;
+    }
+    for (size_t k = i; k < i + 4; ++k) {
+      if (scores[k] >= threshold) {
+        candidates_.push_back(k);
+      }
+    }
+  }
+#endif
+
+  // tail detections, or all detections without neon
+  for (; i < result_num; ++i) {
+    if (scores[i] >= threshold) {
+      candidates_.push_back(i);
+    }
+  }
+
+  if (!labels.empty()) {
+    size_t kept_num = 0;
+    for (size_t k = 0; k < candidates_.size(); ++k) {
+      int32_t label =
+          ToLabel(results[candidates_[k] * kDetectionResultSize + kLabel]);
+      if (find(labels.begin(), labels.end(), label) != labels.end()) {
+        candidates_[kept_num++] = candidates_[k];
+      }
+    }
+    candidates_.resize(kept_num);
+  }
+
+  stable_sort(candidates_.begin(), candidates_.end(),
+              [scores](uint32_t left, uint32_t right) {
+                return scores[left] > scores[right];
+              });
+
+  size_t candidate_num = candidates_.size();
+  lt_x_.resize(candidate_num);
+  lt_y_.resize(candidate_num);
+  rb_x_.resize(candidate_num);
+  rb_y_.resize(candidate_num);
+  area_.resize(candidate_num);
+  label_.resize(candidate_num);
+  for (size_t k = 0; k < candidate_num; ++k) {
+    const float *result = results + candidates_[k] * kDetectionResultSize;
+    lt_x_[k] = CorrectCoordinate(result[kTopLeftX]);
+    lt_y_[k] = CorrectCoordinate(result[kTopLeftY]);
+    rb_x_[k] = CorrectCoordinate(result[kLowerRightX]);
+    rb_y_[k] = CorrectCoordinate(result[kLowerRightY]);
+    area_[k] = max(rb_x_[k] - lt_x_[k], 0.0f) * max(rb_y_[k] - lt_y_[k], 0.0f);
+    label_[k] = ToLabel(result[kLabel]);
+  }
+}
+
+void DetectionFilter::SuppressOverlaps(size_t index) {
+  size_t candidate_num = candidates_.size();
+  const float *lt_x = lt_x_.data();
+  const float *lt_y = lt_y_.data();
+  const float *rb_x = rb_x_.data();
+  const float *rb_y = rb_y_.data();
+  const float *area = area_.data();
+  const int32_t *label = label_.data();
+  uint32_t *suppressed = suppressed_.data();
+
+  float box_lt_x = lt_x[index];
+  float box_lt_y = lt_y[index];
+  float box_rb_x = rb_x[index];
+  float box_rb_y = rb_y[index];
+  float box_area = area[index];
+  int32_t box_label = label[index];
+  float threshold = para_.nms_threshold;
+
+  // IoU > threshold is tested as inter > threshold * union without division
+  size_t j = index + 1;
+#if defined(__aarch64__)
+  // 4 candidates per iteration
+  const float32x4_t zero = vdupq_n_f32(0);
+  const float32x4_t threshold_vec = vdupq_n_f32(threshold);
+  const float32x4_t box_lt_x_vec = vdupq_n_f32(box_lt_x);
+  const float32x4_t box_lt_y_vec = vdupq_n_f32(box_lt_y);
+  const float32x4_t box_rb_x_vec = vdupq_n_f32(box_rb_x);
+  const float32x4_t box_rb_y_vec = vdupq_n_f32(box_rb_y);
+  const float32x4_t box_area_vec = vdupq_n_f32(box_area);
+  const int32x4_t box_label_vec = vdupq_n_s32(box_label);
+  for (; j + 4 <= candidate_num; j += 4) {
+    float32x4_t inter_width = vmaxq_f32(
+        vsubq_f32(vminq_f32(vld1q_f32(rb_x + j), box_rb_x_vec),
+                  vmaxq_f32(vld1q_f32(lt_x + j), box_lt_x_vec)),
+        zero);
+    float32x4_t inter_height = vmaxq_f32(
+        vsubq_f32(vminq_f32(vld1q_f32(rb_y + j), box_rb_y_vec),
+                  vmaxq_f32(vld1q_f32(lt_y + j), box_lt_y_vec)),
+        zero);
+    float32x4_t inter_area = vmulq_f32(inter_width, inter_height);
+    float32x4_t union_area = vsubq_f32(
+        vaddq_f32(box_area_vec, vld1q_f32(area + j)), inter_area);
+    uint32x4_t overlap =
+        vcgtq_f32(inter_area, vmulq_f32(threshold_vec, union_area));
+
+    // only a candidate of the same label is suppressed
+    uint32x4_t same_label = vceqq_s32(vld1q_s32(label + j), box_label_vec);
+    vst1q_u32(suppressed + j,
+              vorrq_u32(vld1q_u32(suppressed + j),
+                        vandq_u32(overlap, same_label)));
+  }
+#endif
+
+  // tail candidates, or all candidates without neon
+  for (; j < candidate_num; ++j) {
+    if (label[j] != box_label) {
+      continue;
+    }
+    float inter_width = min(rb_x[j], box_rb_x) - max(lt_x[j], box_lt_x);
+    float inter_height = min(rb_y[j], box_rb_y) - max(lt_y[j], box_lt_y);
+    inter_width = inter_width > 0 ? inter_width : 0;
+    inter_height = inter_height > 0 ? inter_height : 0;
+    float inter_area = inter_width * inter_height;
+    float union_area = box_area + area[j] - inter_area;
+    if (inter_area > threshold * union_area) {
+      suppressed[j] = kSuppressed;
+    }
+  }
+}
+
+void DetectionFilter::Filter(const float *results, size_t result_num,
+                             const vector<int32_t> &labels,
+                             vector<DetectionBox> &boxes) {
+  boxes.clear();
+  if (results == nullptr || result_num == 0) {
+    return;
+  }
+
+  SelectCandidates(results, result_num, labels);
+
+  size_t candidate_num = candidates_.size();
+  suppressed_.assign(candidate_num, 0);
+  unordered_map<int32_t, uint32_t> kept_num;
+  bool is_nms = para_.nms_threshold < kUpperCoord;
+  for (size_t k = 0; k < candidate_num; ++k) {
+    if (suppressed_[k] != 0) {
+      continue;
+    }
+
+    // the label already has its best top_k detections
+    if (para_.top_k > 0) {
+      uint32_t &label_kept = kept_num[label_[k]];
+      if (label_kept >= para_.top_k) {
+        continue;
+      }
+      ++label_kept;
+    }
+
+    DetectionBox box;
+    box.label = label_[k];
+    box.score = scores_[candidates_[k]];
+    box.lt_x = lt_x_[k];
+    box.lt_y = lt_y_[k];
+    box.rb_x = rb_x_[k];
+    box.rb_y = rb_y_[k];
+    boxes.push_back(box);
+
+    if (is_nms) {
+      SuppressOverlaps(k);
+    }
+  }
+}
+}
+}
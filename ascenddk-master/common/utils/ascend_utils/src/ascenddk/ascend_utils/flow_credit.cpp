@@ -0,0 +1,127 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/flow_credit.h"
+
+#include <chrono>
+#include <map>
+
+using namespace std;
+
+namespace {
+// credits of this process by receiver name
+mutex g_flow_credits_mutex;
+map<string, shared_ptr<ascend::utils::FlowCredit>> g_flow_credits;
+}
+
+namespace ascend {
+namespace utils {
+
+shared_ptr<FlowCredit> FlowCredit::GetFlowCredit(const string &name) {
+  lock_guard<mutex> lock(g_flow_credits_mutex);
+  shared_ptr<FlowCredit> &credit = g_flow_credits[name];
+  if (credit == nullptr) {
+    credit = make_shared<FlowCredit>();
+  }
+
+  return credit;
+}
+
+FlowCredit::FlowCredit() {
+  capacity_ = 0;
+  in_flight_ = 0;
+  release_count_ = 0;
+}
+
+FlowCredit::~FlowCredit() {
+}
+
+void FlowCredit::SetCapacity(int capacity) {
+  lock_guard<mutex> lock(mutex_);
+  capacity_ = (capacity > 0) ? capacity : 0;
+
+  // senders waiting for a smaller capacity may go on now
+  released_.notify_all();
+}
+
+bool FlowCredit::Acquire(int timeout_ms, bool *is_blocked) {
+  unique_lock<mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return false;
+  }
+
+  if (in_flight_ >= capacity_) {
+    if (is_blocked != nullptr) {
+      *is_blocked = true;
+    }
+
+    // a receiver that stops taking data must not block its senders forever
+    if (!released_.wait_for(lock, chrono::milliseconds(timeout_ms),
+                            [this] {
+                              return (capacity_ == 0)
+                                  || (in_flight_ < capacity_);
+                            }) || (capacity_ == 0)) {
+      return false;
+    }
+  }
+
+  in_flight_++;
+  return true;
+}
+
+void FlowCredit::Release() {
+  lock_guard<mutex> lock(mutex_);
+
+  // data sent without a credit (not limited or timeout) returns nothing
+  if (in_flight_ > 0) {
+    in_flight_--;
+  }
+  release_count_++;
+  released_.notify_all();
+}
+
+bool FlowCredit::WaitRelease(int timeout_ms) {
+  unique_lock<mutex> lock(mutex_);
+  uint64_t release_count = release_count_;
+  return released_.wait_for(lock, chrono::milliseconds(timeout_ms),
+                            [this, release_count] {
+                              return release_count_ != release_count;
+                            });
+}
+
+int FlowCredit::GetInFlight() {
+  lock_guard<mutex> lock(mutex_);
+  return in_flight_;
+}
+}
+}
@@ -0,0 +1,685 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/latency_trace.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+#include "toolchain/slog.h"
+
+using namespace std;
+
+#define ASC_LOG_ERROR(fmt, ...) \
+dlog_error(ASCENDDK, "[%s:%d] " fmt "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+
+namespace {
+// 1 second = 1000000000 nanosecond
+const int64_t kSecToNanoSec = 1000000000;
+
+// 1 microsecond = 1000 nanosecond
+const int64_t kMicroSecToNanoSec = 1000;
+
+// percentiles in the histogram file
+const double kPercentiles[] = { 0.5, 0.9, 0.99 };
+const int kPercentileNum = sizeof(kPercentiles) / sizeof(kPercentiles[0]);
+
+// separator of the wait histogram name, e.g. "camera -> face_detection"
+const char *kWaitNameSeparator = " -> ";
+
+// weight of the latest frame in the stage load average: 1/8
+const int kStageLoadShift = 3;
+
+// the load of a stage no frame left for 1s expires
+const int64_t kStageLoadExpireNs = 1000000000;
+
+// moving average of a stage in this process
+struct StageLoad {
+  int64_t load_ns = 0;
+  int64_t update_ns = 0;
+};
+
+// stage loads and gauges of this process, shared by the engines in it
+mutex g_stage_load_mutex;
+map<string, StageLoad> g_stage_loads;
+map<string, int64_t> g_gauges;
+
+// statistics of one engine in the current profile interval
+struct EngineProfile {
+  // Process calls
+  long process_count = 0;
+  int64_t service_sum_ns = 0;
+  int64_t service_max_ns = 0;
+  long service_buckets[ascend::utils::kLatencyBucketNum] = { 0 };
+
+  // queue depth seen by the Process calls
+  long depth_count = 0;
+  long depth_sum = 0;
+  int depth_max = 0;
+
+  // SendData calls to the engine
+  long send_count = 0;
+  long queue_full_count = 0;
+  long drop_count = 0;
+  int64_t blocked_sum_ns = 0;
+};
+
+// engine profile of this process
+mutex g_engine_profile_mutex;
+map<string, EngineProfile> g_engine_profiles;
+int64_t g_engine_profile_start_ns = 0;
+ascend::utils::EngineProfilePara g_engine_profile_para;
+atomic<bool> g_is_engine_profile_started(false);
+
+/**
+ * @brief get the histogram bucket of a latency
+ * @param [in] latency_ns: latency in nanosecond
+ * @return bucket index, bucket i holds [2^(i-1), 2^i) us
+ */
+int GetBucketIndex(int64_t latency_ns) {
+  int64_t latency_us = latency_ns / kMicroSecToNanoSec;
+  int index = 0;
+  while ((latency_us > 0) && (index < ascend::utils::kLatencyBucketNum - 1)) {
+    latency_us >>= 1;
+    index++;
+  }
+
+  return index;
+}
+
+/**
+ * @brief get the upper bound of a histogram bucket
+ * @param [in] index: bucket index
+ * @return upper bound in microsecond
+ */
+int64_t GetBucketUpperUs(int index) {
+  return (int64_t) 1 << index;
+}
+
+/**
+ * @brief get a percentile from histogram buckets, it is the upper bound of
+ *        the bucket the percentile falls in
+ * @param [in] buckets: kLatencyBucketNum buckets
+ * @param [in] count: sum of the buckets
+ * @param [in] percentile: 0.0 - 1.0
+ * @param [in] max_ns: largest latency in the buckets
+ * @return percentile in microsecond
+ */
+double GetPercentileUs(const long *buckets, long count, double percentile,
+                       int64_t max_ns) {
+  long target = (long) (percentile * count);
+  long accumulated = 0;
+  int index = 0;
+  for (; index < ascend::utils::kLatencyBucketNum - 1; ++index) {
+    accumulated += buckets[index];
+    if (accumulated > target) {
+      break;
+    }
+  }
+
+  return min((double) GetBucketUpperUs(index),
+             (double) max_ns / kMicroSecToNanoSec);
+}
+
+/**
+ * @brief escape a string for json
+ * @param [in] str: string
+ * @return escaped string
+ */
+string EscapeJson(const string &str) {
+  string escaped;
+  for (char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+
+  return escaped;
+}
+
+/*
+ * Exports the engine profile every interval from its own thread, and the
+ * last interval when the process exits.
+ */
+class EngineProfileExporter {
+ public:
+  ~EngineProfileExporter() {
+    if (!thread_.joinable()) {
+      return;
+    }
+
+    {
+      lock_guard<mutex> lock(mutex_);
+      is_stopped_ = true;
+    }
+    stopped_.notify_all();
+    thread_.join();
+    ascend::utils::ExportEngineProfile();
+  }
+
+  /**
+   * @brief start the export thread
+   * @param [in] interval_ms: time between two exports
+   */
+  void Start(int interval_ms) {
+    thread_ = thread(&EngineProfileExporter::Run, this, interval_ms);
+  }
+
+ private:
+  void Run(int interval_ms) {
+    unique_lock<mutex> lock(mutex_);
+    while (!stopped_.wait_for(lock, chrono::milliseconds(interval_ms),
+                              [this] {return is_stopped_;})) {
+      lock.unlock();
+      ascend::utils::ExportEngineProfile();
+      lock.lock();
+    }
+  }
+
+  thread thread_;
+  mutex mutex_;
+  condition_variable stopped_;
+  bool is_stopped_ = false;
+};
+
+// declared after the profile so it is destroyed first
+EngineProfileExporter g_engine_profile_exporter;
+
+// one engine in the exported profile
+struct EngineProfileRow {
+  string engine;
+  const EngineProfile *profile;
+
+  // share of the interval spent in Process, above 100 when Process runs
+  // in several threads
+  double busy_percent;
+};
+
+/**
+ * @brief write the engine profile as a text table
+ * @param [in] file: file path
+ * @param [in] rows: engines, the busiest first
+ * @param [in] interval_ns: length of the interval
+ * @return enum UtilsErrorCode
+ */
+int WriteEngineProfileText(const string &file,
+                           const vector<EngineProfileRow> &rows,
+                           int64_t interval_ns) {
+  FILE *fp = fopen(file.c_str(), "w");
+  if (fp == nullptr) {
+    ASC_LOG_ERROR("Failed to open engine profile file %s.", file.c_str());
+    return ascend::utils::kUtilsErrorOpenFileFail;
+  }
+
+  double interval_s = (double) interval_ns / kSecToNanoSec;
+  fprintf(fp, "# pid: %d, interval_s: %.1f\n", getpid(), interval_s);
+  if (!rows.empty() && (rows.front().profile->process_count > 0)) {
+    fprintf(fp, "# bottleneck: %s, busy %.1f%%\n",
+            rows.front().engine.c_str(), rows.front().busy_percent);
+  }
+  fprintf(fp, "# engine | calls | calls_per_s | busy_percent | mean_us "
+          "| p50_us | p90_us | p99_us | max_us | depth_avg | depth_max "
+          "| sends | queue_full | drops | blocked_ms\n");
+  for (const EngineProfileRow &row : rows) {
+    const EngineProfile &profile = *row.profile;
+    fprintf(fp, "%s | %ld | %.1f | %.1f | %.1f", row.engine.c_str(),
+            profile.process_count, profile.process_count / interval_s,
+            row.busy_percent,
+            (profile.process_count == 0) ? 0.0 :
+            (double) profile.service_sum_ns / profile.process_count
+                / kMicroSecToNanoSec);
+    for (int i = 0; i < kPercentileNum; ++i) {
+      fprintf(fp, " | %.1f",
+              GetPercentileUs(profile.service_buckets, profile.process_count,
+                              kPercentiles[i], profile.service_max_ns));
+    }
+    fprintf(fp, " | %.1f | %.1f | %d | %ld | %ld | %ld | %.1f\n",
+            (double) profile.service_max_ns / kMicroSecToNanoSec,
+            (profile.depth_count == 0) ? 0.0 :
+            (double) profile.depth_sum / profile.depth_count,
+            profile.depth_max, profile.send_count, profile.queue_full_count,
+            profile.drop_count,
+            (double) profile.blocked_sum_ns / kMicroSecToNanoSec / 1000);
+  }
+
+  fclose(fp);
+  return ascend::utils::kUtilsOk;
+}
+
+/**
+ * @brief write the engine profile as json
+ * @param [in] file: file path
+ * @param [in] rows: engines, the busiest first
+ * @param [in] interval_ns: length of the interval
+ * @return enum UtilsErrorCode
+ */
+int WriteEngineProfileJson(const string &file,
+                           const vector<EngineProfileRow> &rows,
+                           int64_t interval_ns) {
+  FILE *fp = fopen(file.c_str(), "w");
+  if (fp == nullptr) {
+    ASC_LOG_ERROR("Failed to open engine profile file %s.", file.c_str());
+    return ascend::utils::kUtilsErrorOpenFileFail;
+  }
+
+  double interval_s = (double) interval_ns / kSecToNanoSec;
+  string bottleneck;
+  if (!rows.empty() && (rows.front().profile->process_count > 0)) {
+    bottleneck = EscapeJson(rows.front().engine);
+  }
+  fprintf(fp, "{\"pid\":%d,\"interval_s\":%.3f,\"bottleneck\":\"%s\","
+          "\"engines\":[", getpid(), interval_s, bottleneck.c_str());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const EngineProfile &profile = *rows[i].profile;
+    fprintf(fp, "%s\n{\"engine\":\"%s\",\"calls\":%ld,"
+            "\"calls_per_s\":%.3f,\"busy_percent\":%.3f,"
+            "\"mean_us\":%.3f", (i == 0) ? "" : ",",
+            EscapeJson(rows[i].engine).c_str(), profile.process_count,
+            profile.process_count / interval_s, rows[i].busy_percent,
+            (profile.process_count == 0) ? 0.0 :
+            (double) profile.service_sum_ns / profile.process_count
+                / kMicroSecToNanoSec);
+    for (int j = 0; j < kPercentileNum; ++j) {
+      fprintf(fp, ",\"p%g_us\":%.3f", kPercentiles[j] * 100,
+              GetPercentileUs(profile.service_buckets, profile.process_count,
+                              kPercentiles[j], profile.service_max_ns));
+    }
+    fprintf(fp, ",\"max_us\":%.3f,\"depth_avg\":%.3f,\"depth_max\":%d,"
+            "\"sends\":%ld,\"queue_full\":%ld,\"drops\":%ld,"
+            "\"blocked_ms\":%.3f}",
+            (double) profile.service_max_ns / kMicroSecToNanoSec,
+            (profile.depth_count == 0) ? 0.0 :
+            (double) profile.depth_sum / profile.depth_count,
+            profile.depth_max, profile.send_count, profile.queue_full_count,
+            profile.drop_count,
+            (double) profile.blocked_sum_ns / kMicroSecToNanoSec / 1000);
+  }
+  fprintf(fp, "\n]}\n");
+
+  fclose(fp);
+  return ascend::utils::kUtilsOk;
+}
+}
+
+namespace ascend {
+namespace utils {
+
+int64_t GetMonotonicTimeNs() {
+  struct timespec now = { 0, 0 };
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t) now.tv_sec * kSecToNanoSec + now.tv_nsec;
+}
+
+void EnterTraceStage(vector<TraceStamp> &trace, const string &stage) {
+  TraceStamp stamp;
+  stamp.stage = stage;
+  stamp.pid = getpid();
+  stamp.enter_ns = GetMonotonicTimeNs();
+  stamp.exit_ns = stamp.enter_ns;
+  trace.push_back(stamp);
+}
+
+void ExitTraceStage(vector<TraceStamp> &trace) {
+  if (trace.empty()) {
+    return;
+  }
+
+  TraceStamp &stamp = trace.back();
+  stamp.exit_ns = GetMonotonicTimeNs();
+
+  // the load counts from the exit of the previous stage when it ran in this
+  // process, so the time queued before the stage is included
+  int64_t start_ns = stamp.enter_ns;
+  if ((trace.size() > 1) && (trace[trace.size() - 2].pid == stamp.pid)) {
+    start_ns = min(start_ns, trace[trace.size() - 2].exit_ns);
+  }
+
+  int64_t latency_ns = max(stamp.exit_ns - start_ns, (int64_t) 0);
+  lock_guard<mutex> lock(g_stage_load_mutex);
+  StageLoad &load = g_stage_loads[stamp.stage];
+  if (stamp.exit_ns - load.update_ns > kStageLoadExpireNs) {
+    load.load_ns = latency_ns;
+  } else {
+    load.load_ns += (latency_ns - load.load_ns) >> kStageLoadShift;
+  }
+  load.update_ns = stamp.exit_ns;
+}
+
+int64_t GetStageLoadNs(const string &stage) {
+  int64_t now_ns = GetMonotonicTimeNs();
+  lock_guard<mutex> lock(g_stage_load_mutex);
+  map<string, StageLoad>::const_iterator it = g_stage_loads.find(stage);
+  if ((it == g_stage_loads.end())
+      || (now_ns - it->second.update_ns > kStageLoadExpireNs)) {
+    return 0;
+  }
+
+  return it->second.load_ns;
+}
+
+void SetGauge(const string &name, int64_t value) {
+  lock_guard<mutex> lock(g_stage_load_mutex);
+  g_gauges[name] = value;
+}
+
+int StartEngineProfile(const EngineProfilePara &para) {
+  if (para.export_interval_ms <= 0) {
+    ASC_LOG_ERROR("The engine profile interval %d is invalid.",
+                  para.export_interval_ms);
+    return kUtilsErrorInvalidParameter;
+  }
+
+  lock_guard<mutex> lock(g_engine_profile_mutex);
+  if (g_is_engine_profile_started) {
+    return kUtilsOk;
+  }
+
+  g_engine_profile_para = para;
+  g_engine_profile_start_ns = GetMonotonicTimeNs();
+  g_engine_profile_exporter.Start(para.export_interval_ms);
+  g_is_engine_profile_started = true;
+  return kUtilsOk;
+}
+
+bool IsEngineProfileStarted() {
+  return g_is_engine_profile_started;
+}
+
+void RecordEngineProcess(const string &engine, int64_t service_ns,
+                         int queue_depth) {
+  if (!g_is_engine_profile_started) {
+    return;
+  }
+
+  service_ns = max(service_ns, (int64_t) 0);
+  lock_guard<mutex> lock(g_engine_profile_mutex);
+  EngineProfile &profile = g_engine_profiles[engine];
+  profile.process_count++;
+  profile.service_sum_ns += service_ns;
+  profile.service_max_ns = max(profile.service_max_ns, service_ns);
+  profile.service_buckets[GetBucketIndex(service_ns)]++;
+  if (queue_depth >= 0) {
+    profile.depth_count++;
+    profile.depth_sum += queue_depth;
+    profile.depth_max = max(profile.depth_max, queue_depth);
+  }
+}
+
+void RecordEngineSend(const string &receiver, int64_t blocked_ns,
+                      bool is_queue_full, bool is_dropped) {
+  if (!g_is_engine_profile_started) {
+    return;
+  }
+
+  lock_guard<mutex> lock(g_engine_profile_mutex);
+  EngineProfile &profile = g_engine_profiles[receiver];
+  profile.send_count++;
+  profile.blocked_sum_ns += max(blocked_ns, (int64_t) 0);
+  if (is_queue_full) {
+    profile.queue_full_count++;
+  }
+  if (is_dropped) {
+    profile.drop_count++;
+  }
+}
+
+int ExportEngineProfile() {
+  // only one export writes the files at a time
+  static mutex export_mutex;
+  lock_guard<mutex> export_lock(export_mutex);
+
+  map<string, EngineProfile> profiles;
+  EngineProfilePara para;
+  int64_t interval_ns = 0;
+  {
+    lock_guard<mutex> lock(g_engine_profile_mutex);
+    if (!g_is_engine_profile_started) {
+      return kUtilsOk;
+    }
+
+    int64_t now_ns = GetMonotonicTimeNs();
+    interval_ns = max(now_ns - g_engine_profile_start_ns, (int64_t) 1);
+    g_engine_profile_start_ns = now_ns;
+    profiles.swap(g_engine_profiles);
+    para = g_engine_profile_para;
+  }
+
+  // the busiest engine is the bottleneck of this process
+  vector<EngineProfileRow> rows;
+  for (const pair<const string, EngineProfile> &profile : profiles) {
+    rows.push_back(EngineProfileRow { profile.first, &profile.second,
+        100.0 * profile.second.service_sum_ns / interval_ns });
+  }
+  sort(rows.begin(), rows.end(),
+       [](const EngineProfileRow &a, const EngineProfileRow &b) {
+         return a.busy_percent > b.busy_percent;
+       });
+
+  int ret = kUtilsOk;
+  if (!para.text_file.empty()) {
+    ret = WriteEngineProfileText(para.text_file, rows, interval_ns);
+  }
+  if (!para.json_file.empty()) {
+    int json_ret = WriteEngineProfileJson(para.json_file, rows, interval_ns);
+    ret = (ret == kUtilsOk) ? json_ret : ret;
+  }
+
+  return ret;
+}
+
+LatencyTracer::LatencyTracer(const LatencyTracerPara &para) {
+  para_ = para;
+}
+
+LatencyTracer::~LatencyTracer() {
+  Export();
+}
+
+void LatencyTracer::RecordFrame(const vector<TraceStamp> &trace,
+                                const string &channel, uint32_t frame_id) {
+  if (trace.empty()) {
+    return;
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  for (size_t i = 0; i < trace.size(); ++i) {
+    AddLatency(trace[i].stage, trace[i].exit_ns - trace[i].enter_ns);
+
+    // the wait is only known when both stages use the same clock
+    if ((i > 0) && (trace[i].pid == trace[i - 1].pid)) {
+      AddLatency(trace[i - 1].stage + kWaitNameSeparator + trace[i].stage,
+                 trace[i].enter_ns - trace[i - 1].exit_ns);
+    }
+  }
+
+  if (trace.front().pid == trace.back().pid) {
+    AddLatency(kEndToEndStage, trace.back().exit_ns - trace.front().enter_ns);
+  }
+
+  if (para_.max_trace_frames > 0) {
+    int channel_index = find(channels_.begin(), channels_.end(), channel)
+        - channels_.begin();
+    if (channel_index == (int) channels_.size()) {
+      channels_.push_back(channel);
+    }
+
+    frame_traces_.push_back(FrameTrace { channel_index, frame_id, trace });
+    while (frame_traces_.size() > (size_t) para_.max_trace_frames) {
+      frame_traces_.pop_front();
+    }
+  }
+
+  frame_count_++;
+  if ((para_.export_interval > 0)
+      && (frame_count_ % para_.export_interval == 0)) {
+    ExportHistogram();
+    ExportChromeTrace();
+  }
+}
+
+int LatencyTracer::Export() {
+  lock_guard<mutex> lock(mutex_);
+  int ret = ExportHistogram();
+  if (ret != kUtilsOk) {
+    return ret;
+  }
+
+  return ExportChromeTrace();
+}
+
+void LatencyTracer::AddLatency(const string &name, int64_t latency_ns) {
+  // a negative latency only comes from a broken stamp
+  if (latency_ns < 0) {
+    latency_ns = 0;
+  }
+
+  map<string, LatencyHistogram>::iterator it = histograms_.find(name);
+  if (it == histograms_.end()) {
+    histogram_names_.push_back(name);
+    it = histograms_.insert(make_pair(name, LatencyHistogram())).first;
+    it->second.min_ns = latency_ns;
+  }
+
+  LatencyHistogram &histogram = it->second;
+  histogram.count++;
+  histogram.sum_ns += latency_ns;
+  histogram.min_ns = min(histogram.min_ns, latency_ns);
+  histogram.max_ns = max(histogram.max_ns, latency_ns);
+  histogram.buckets[GetBucketIndex(latency_ns)]++;
+}
+
+int LatencyTracer::ExportHistogram() const {
+  if (para_.histogram_file.empty()) {
+    return kUtilsOk;
+  }
+
+  FILE *fp = fopen(para_.histogram_file.c_str(), "w");
+  if (fp == nullptr) {
+    ASC_LOG_ERROR("Failed to open latency histogram file %s.",
+                  para_.histogram_file.c_str());
+    return kUtilsErrorOpenFileFail;
+  }
+
+  // summary, one stage per line, a percentile is the upper bound of its
+  // bucket
+  fprintf(fp, "# frames: %ld\n", frame_count_);
+  fprintf(fp, "# stage | count | mean_us | min_us | p50_us | p90_us | p99_us "
+          "| max_us\n");
+  for (const string &name : histogram_names_) {
+    const LatencyHistogram &histogram = histograms_.at(name);
+    fprintf(fp, "%s | %ld | %.1f | %.1f", name.c_str(), histogram.count,
+            (double) histogram.sum_ns / histogram.count / kMicroSecToNanoSec,
+            (double) histogram.min_ns / kMicroSecToNanoSec);
+
+    for (int i = 0; i < kPercentileNum; ++i) {
+      fprintf(fp, " | %.1f",
+              GetPercentileUs(histogram.buckets, histogram.count,
+                              kPercentiles[i], histogram.max_ns));
+    }
+
+    fprintf(fp, " | %.1f\n",
+            (double) histogram.max_ns / kMicroSecToNanoSec);
+  }
+
+  // gauges of this process
+  {
+    lock_guard<mutex> lock(g_stage_load_mutex);
+    if (!g_gauges.empty()) {
+      fprintf(fp, "\n[gauges]\n");
+    }
+    for (const pair<const string, int64_t> &gauge : g_gauges) {
+      fprintf(fp, "%s: %lld\n", gauge.first.c_str(),
+              (long long) gauge.second);
+    }
+  }
+
+  // buckets of every stage: upper bound in us and count
+  for (const string &name : histogram_names_) {
+    const LatencyHistogram &histogram = histograms_.at(name);
+    fprintf(fp, "\n[%s]\n", name.c_str());
+    for (int i = 0; i < kLatencyBucketNum; ++i) {
+      if (histogram.buckets[i] != 0) {
+        fprintf(fp, "< %lld us: %ld\n", (long long) GetBucketUpperUs(i),
+                histogram.buckets[i]);
+      }
+    }
+  }
+
+  fclose(fp);
+  return kUtilsOk;
+}
+
+int LatencyTracer::ExportChromeTrace() const {
+  if (para_.chrome_trace_file.empty()) {
+    return kUtilsOk;
+  }
+
+  FILE *fp = fopen(para_.chrome_trace_file.c_str(), "w");
+  if (fp == nullptr) {
+    ASC_LOG_ERROR("Failed to open chrome trace file %s.",
+                  para_.chrome_trace_file.c_str());
+    return kUtilsErrorOpenFileFail;
+  }
+
+  // complete events: one track(pid) per process, one row(tid) per channel
+  fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  bool is_first = true;
+  for (const FrameTrace &frame : frame_traces_) {
+    string channel = EscapeJson(channels_[frame.channel_index]);
+    for (const TraceStamp &stamp : frame.trace) {
+      fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\","
+              "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+              "\"args\":{\"channel\":\"%s\",\"frame\":%u}}",
+              is_first ? "" : ",", EscapeJson(stamp.stage).c_str(),
+              stamp.pid, frame.channel_index,
+              (double) stamp.enter_ns / kMicroSecToNanoSec,
+              (double) (stamp.exit_ns - stamp.enter_ns) / kMicroSecToNanoSec,
+              channel.c_str(), frame.frame_id);
+      is_first = false;
+    }
+  }
+  fprintf(fp, "\n]}\n");
+
+  fclose(fp);
+  return kUtilsOk;
+}
+}
+}
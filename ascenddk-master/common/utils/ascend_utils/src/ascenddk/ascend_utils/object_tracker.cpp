@@ -0,0 +1,300 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/object_tracker.h"
+
+#include <algorithm>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace {
+// initial variance of a box coordinate and of its velocity, the velocity of
+// a new track is unknown
+const float kInitPosVariance = 10.0f;
+const float kInitVelVariance = 1000.0f;
+
+// process noise of a box coordinate and of its velocity per frame
+const float kPosNoise = 1.0f;
+const float kVelNoise = 1.0f;
+
+// measurement noise of a detected box coordinate
+const float kMeasureNoise = 10.0f;
+
+// minimal width and height of a predicted box
+const float kMinBoxSide = 1.0f;
+
+// avoids a division by zero for boxes without area
+const float kMinUnionArea = 1e-6f;
+
+// a candidate match of a track and a detection
+struct MatchPair {
+  float iou;
+  uint32_t track_index;
+  uint32_t detection_index;
+};
+
+bool IsBetterMatch(const MatchPair &left, const MatchPair &right) {
+  return left.iou > right.iou;
+}
+}
+
+namespace ascend {
+namespace utils {
+
+ObjectTracker::ObjectTracker(const ObjectTrackerPara &para) {
+  para_ = para;
+  next_id_ = 1;
+}
+
+ObjectTracker::~ObjectTracker() {
+}
+
+size_t ObjectTracker::GetTrackNum() const {
+  return tracks_.size();
+}
+
+ObjectTracker::Track ObjectTracker::CreateTrack(
+    const TrackDetection &detection) {
+  const TrackBox &box = detection.box;
+  float measure[kAxisNum] = { (box.lt_x + box.rb_x) / 2,
+      (box.lt_y + box.rb_y) / 2, box.rb_x - box.lt_x, box.rb_y - box.lt_y };
+
+  Track track;
+  track.id = next_id_++;
+  track.label = detection.label;
+  track.hits = 1;
+  track.missed = 0;
+  for (int i = 0; i < kAxisNum; ++i) {
+    track.axis[i].pos = measure[i];
+    track.axis[i].vel = 0;
+    track.axis[i].p00 = kInitPosVariance;
+    track.axis[i].p01 = 0;
+    track.axis[i].p11 = kInitVelVariance;
+  }
+
+  return track;
+}
+
+void ObjectTracker::Predict(Track &track) {
+  // x = F x, P = F P F' + Q with F = [1 1; 0 1]
+  for (int i = 0; i < kAxisNum; ++i) {
+    KalmanAxis &axis = track.axis[i];
+    axis.pos += axis.vel;
+    axis.p00 += 2 * axis.p01 + axis.p11 + kPosNoise;
+    axis.p01 += axis.p11;
+    axis.p11 += kVelNoise;
+  }
+
+  track.axis[kWidth].pos = max(track.axis[kWidth].pos, kMinBoxSide);
+  track.axis[kHeight].pos = max(track.axis[kHeight].pos, kMinBoxSide);
+}
+
+void ObjectTracker::Correct(Track &track, const TrackBox &box) {
+  float measure[kAxisNum] = { (box.lt_x + box.rb_x) / 2,
+      (box.lt_y + box.rb_y) / 2, box.rb_x - box.lt_x, box.rb_y - box.lt_y };
+
+  // K = P H' / (H P H' + R), x += K (z - H x), P = (I - K H) P, H = [1 0]
+  for (int i = 0; i < kAxisNum; ++i) {
+    KalmanAxis &axis = track.axis[i];
+    float innovation = measure[i] - axis.pos;
+    float gain_pos = axis.p00 / (axis.p00 + kMeasureNoise);
+    float gain_vel = axis.p01 / (axis.p00 + kMeasureNoise);
+    axis.pos += gain_pos * innovation;
+    axis.vel += gain_vel * innovation;
+    axis.p11 -= gain_vel * axis.p01;
+    axis.p01 -= gain_pos * axis.p01;
+    axis.p00 -= gain_pos * axis.p00;
+  }
+}
+
+void ObjectTracker::ComputeIouMatrix(
+    const vector<TrackDetection> &detections) {
+  size_t det_num = detections.size();
+  det_lt_x_.resize(det_num);
+  det_lt_y_.resize(det_num);
+  det_rb_x_.resize(det_num);
+  det_rb_y_.resize(det_num);
+  det_area_.resize(det_num);
+  det_label_.resize(det_num);
+  for (size_t j = 0; j < det_num; ++j) {
+    const TrackBox &box = detections[j].box;
+    det_lt_x_[j] = box.lt_x;
+    det_lt_y_[j] = box.lt_y;
+    det_rb_x_[j] = box.rb_x;
+    det_rb_y_[j] = box.rb_y;
+    det_area_[j] = (box.rb_x - box.lt_x) * (box.rb_y - box.lt_y);
+    det_label_[j] = detections[j].label;
+  }
+
+  iou_matrix_.resize(tracks_.size() * det_num);
+  const float *lt_x = det_lt_x_.data();
+  const float *lt_y = det_lt_y_.data();
+  const float *rb_x = det_rb_x_.data();
+  const float *rb_y = det_rb_y_.data();
+  const float *area = det_area_.data();
+  const int32_t *label = det_label_.data();
+  for (size_t i = 0; i < tracks_.size(); ++i) {
+    const Track &track = tracks_[i];
+    float half_width = track.axis[kWidth].pos / 2;
+    float half_height = track.axis[kHeight].pos / 2;
+    float track_lt_x = track.axis[kCenterX].pos - half_width;
+    float track_lt_y = track.axis[kCenterY].pos - half_height;
+    float track_rb_x = track.axis[kCenterX].pos + half_width;
+    float track_rb_y = track.axis[kCenterY].pos + half_height;
+    float track_area = track.axis[kWidth].pos * track.axis[kHeight].pos;
+    int32_t track_label = track.label;
+
+    float *row = iou_matrix_.data() + i * det_num;
+    size_t j = 0;
+#if defined(__aarch64__)
+    // 4 detections per iteration
+    const float32x4_t zero = vdupq_n_f32(0);
+    const float32x4_t min_union = vdupq_n_f32(kMinUnionArea);
+    const float32x4_t box_lt_x = vdupq_n_f32(track_lt_x);
+    const float32x4_t box_lt_y = vdupq_n_f32(track_lt_y);
+    const float32x4_t box_rb_x = vdupq_n_f32(track_rb_x);
+    const float32x4_t box_rb_y = vdupq_n_f32(track_rb_y);
+    const float32x4_t box_area = vdupq_n_f32(track_area);
+    const int32x4_t box_label = vdupq_n_s32(track_label);
+    for (; j + 4 <= det_num; j += 4) {
+      float32x4_t inter_width = vmaxq_f32(
+          vsubq_f32(vminq_f32(vld1q_f32(rb_x + j), box_rb_x),
+                    vmaxq_f32(vld1q_f32(lt_x + j), box_lt_x)),
+          zero);
+      float32x4_t inter_height = vmaxq_f32(
+          vsubq_f32(vminq_f32(vld1q_f32(rb_y + j), box_rb_y),
+                    vmaxq_f32(vld1q_f32(lt_y + j), box_lt_y)),
+          zero);
+      float32x4_t inter_area = vmulq_f32(inter_width, inter_height);
+      float32x4_t union_area = vmaxq_f32(
+          vsubq_f32(vaddq_f32(box_area, vld1q_f32(area + j)), inter_area),
+          min_union);
+      float32x4_t iou = vdivq_f32(inter_area, union_area);
+
+      // IoU of another label is cleared to 0
+      uint32x4_t same_label = vceqq_s32(vld1q_s32(label + j), box_label);
+      vst1q_f32(row + j, vreinterpretq_f32_u32(
+          vandq_u32(vreinterpretq_u32_f32(iou), same_label)));
+    }
+#endif
+
+    // tail detections, or all detections without neon
+    for (; j < det_num; ++j) {
+      float inter_lt_x = lt_x[j] > track_lt_x ? lt_x[j] : track_lt_x;
+      float inter_lt_y = lt_y[j] > track_lt_y ? lt_y[j] : track_lt_y;
+      float inter_rb_x = rb_x[j] < track_rb_x ? rb_x[j] : track_rb_x;
+      float inter_rb_y = rb_y[j] < track_rb_y ? rb_y[j] : track_rb_y;
+      float inter_width = inter_rb_x - inter_lt_x;
+      float inter_height = inter_rb_y - inter_lt_y;
+      inter_width = inter_width > 0 ? inter_width : 0;
+      inter_height = inter_height > 0 ? inter_height : 0;
+      float inter_area = inter_width * inter_height;
+      float union_area = track_area + area[j] - inter_area;
+      union_area = union_area > kMinUnionArea ? union_area : kMinUnionArea;
+      row[j] = (label[j] == track_label) ? inter_area / union_area : 0;
+    }
+  }
+}
+
+void ObjectTracker::Update(const vector<TrackDetection> &detections,
+                           vector<TrackResult> &results) {
+  size_t det_num = detections.size();
+  results.assign(det_num, TrackResult());
+
+  for (size_t i = 0; i < tracks_.size(); ++i) {
+    Predict(tracks_[i]);
+  }
+  ComputeIouMatrix(detections);
+
+  // match from the best pair down, a track or detection is used once
+  vector<MatchPair> pairs;
+  for (size_t i = 0; i < tracks_.size(); ++i) {
+    for (size_t j = 0; j < det_num; ++j) {
+      float iou = iou_matrix_[i * det_num + j];
+      if (iou >= para_.iou_threshold) {
+        MatchPair pair = { iou, static_cast<uint32_t>(i),
+            static_cast<uint32_t>(j) };
+        pairs.push_back(pair);
+      }
+    }
+  }
+  sort(pairs.begin(), pairs.end(), IsBetterMatch);
+
+  vector<bool> is_track_matched(tracks_.size(), false);
+  vector<bool> is_detection_matched(det_num, false);
+  for (size_t k = 0; k < pairs.size(); ++k) {
+    uint32_t i = pairs[k].track_index;
+    uint32_t j = pairs[k].detection_index;
+    if (is_track_matched[i] || is_detection_matched[j]) {
+      continue;
+    }
+
+    is_track_matched[i] = true;
+    is_detection_matched[j] = true;
+    Track &track = tracks_[i];
+    Correct(track, detections[j].box);
+    ++track.hits;
+    track.missed = 0;
+    results[j].track_id = track.id;
+    results[j].hits = track.hits;
+  }
+
+  // drop tracks missing for too long, keep the others for a later match
+  vector<Track> live_tracks;
+  live_tracks.reserve(tracks_.size() + det_num);
+  for (size_t i = 0; i < tracks_.size(); ++i) {
+    if (!is_track_matched[i] && (++tracks_[i].missed > para_.max_missed)) {
+      continue;
+    }
+    live_tracks.push_back(tracks_[i]);
+  }
+
+  for (size_t j = 0; j < det_num; ++j) {
+    if (is_detection_matched[j]) {
+      continue;
+    }
+
+    Track track = CreateTrack(detections[j]);
+    results[j].track_id = track.id;
+    results[j].hits = track.hits;
+    live_tracks.push_back(track);
+  }
+
+  tracks_.swap(live_tracks);
+}
+}
+}
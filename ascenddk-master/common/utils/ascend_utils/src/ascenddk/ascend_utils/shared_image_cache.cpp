@@ -0,0 +1,144 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#include "ascenddk/ascend_utils/shared_image_cache.h"
+
+using namespace std;
+
+namespace {
+// a consumer waits this long for another one to produce the image, then
+// produces it by itself
+const int kProduceWaitMs = 1000;
+
+// an image is dropped this long after it is produced, even if some of its
+// consumers never came
+const int kImageExpireMs = 3000;
+
+// caches of this process by name
+mutex g_image_caches_mutex;
+map<string, shared_ptr<ascend::utils::SharedImageCache>> g_image_caches;
+}
+
+namespace ascend {
+namespace utils {
+
+shared_ptr<SharedImageCache> SharedImageCache::GetSharedImageCache(
+    const string &name) {
+  lock_guard<mutex> lock(g_image_caches_mutex);
+  shared_ptr<SharedImageCache> &cache = g_image_caches[name];
+  if (cache == nullptr) {
+    cache = make_shared<SharedImageCache>();
+  }
+
+  return cache;
+}
+
+SharedImageCache::SharedImageCache() {
+}
+
+SharedImageCache::~SharedImageCache() {
+}
+
+bool SharedImageCache::Get(const string &key, int consumer_num,
+                           const ProduceFunc &produce, SharedImage &image) {
+  if (consumer_num <= 1) {
+    return produce(image);
+  }
+
+  unique_lock<mutex> lock(mutex_);
+  EraseExpired();
+  map<string, shared_ptr<Entry>>::iterator iter = entries_.find(key);
+  if (iter != entries_.end()) {
+    shared_ptr<Entry> entry = iter->second;
+    ready_.wait_for(lock, chrono::milliseconds(kProduceWaitMs),
+                    [&entry] { return entry->is_ready; });
+
+    // the image is taken by one more consumer whether or not it is usable
+    if (--entry->remaining <= 0) {
+      map<string, shared_ptr<Entry>>::iterator current = entries_.find(key);
+      if ((current != entries_.end()) && (current->second == entry)) {
+        entries_.erase(current);
+      }
+    }
+
+    if (entry->is_ready && entry->is_ok) {
+      image = entry->image;
+      return true;
+    }
+
+    // the producer failed or is too slow, do not wait for it again
+    lock.unlock();
+    return produce(image);
+  }
+
+  shared_ptr<Entry> entry = make_shared<Entry>();
+  entry->is_ready = false;
+  entry->is_ok = false;
+  entry->remaining = consumer_num - 1;
+  entry->image.size = 0;
+  entry->create_time = chrono::steady_clock::now();
+  entries_[key] = entry;
+  lock.unlock();
+
+  bool is_ok = produce(image);
+
+  lock.lock();
+  entry->is_ready = true;
+  entry->is_ok = is_ok;
+  if (is_ok) {
+    entry->image = image;
+  }
+  ready_.notify_all();
+
+  return is_ok;
+}
+
+size_t SharedImageCache::GetImageNum() {
+  lock_guard<mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void SharedImageCache::EraseExpired() {
+  chrono::steady_clock::time_point expire_time = chrono::steady_clock::now()
+      - chrono::milliseconds(kImageExpireMs);
+  for (map<string, shared_ptr<Entry>>::iterator iter = entries_.begin();
+      iter != entries_.end();) {
+    if (iter->second->is_ready && (iter->second->create_time < expire_time)) {
+      iter = entries_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+}
+}
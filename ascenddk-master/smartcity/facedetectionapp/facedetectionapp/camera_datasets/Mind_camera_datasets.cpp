@@ -54,6 +54,13 @@ namespace {
 const uint32_t kInitFrameId = 0;
 
 const int kMaxBatchSize = 1;
+
+// frame buffers prepared at init, the pool grows if the downstream engines
+// hold more frames at the same time
+const int kFrameBufferCount = 8;
+
+// data_source of a replay file: File:<path>
+const std::string kReplaySourcePrefix = "File:";
 }
 
 using hiai::Engine;
@@ -98,7 +105,19 @@ HIAI_StatusT Mind_CameraDatasets::Init(
     } else if (name == "image_format") {
       config_->image_format = CommonParseParam(value);
     } else if (name == "data_source") {
-      config_->channel_id = CommonParseParam(value);
+      // File:<path> replays a yuv420sp file instead of the camera
+      if (value.compare(0, kReplaySourcePrefix.size(), kReplaySourcePrefix)
+          == 0) {
+        config_->replay_file = value.substr(kReplaySourcePrefix.size());
+      } else {
+        config_->channel_id = CommonParseParam(value);
+      }
+    } else if (name == "replay_fast") {
+      config_->replay_fast = (value == "true");
+    } else if (name == "replay_loop") {
+      config_->replay_loop = (value != "false");
+    } else if (name == "replay_channel") {
+      config_->replay_channel = atoi(value.data());
     } else if (name == "image_size") {
       ParseImageSize(value, config_->resolution_width,
                      config_->resolution_height);
@@ -107,6 +126,10 @@ HIAI_StatusT Mind_CameraDatasets::Init(
     }
   }
 
+  if (!config_->replay_file.empty()) {
+    config_->channel_id = config_->replay_channel;
+  }
+
   HIAI_StatusT ret = HIAI_OK;
   bool failed_flag = (config_->image_format == PARSEPARAM_FAIL
       || config_->channel_id == PARSEPARAM_FAIL
@@ -119,6 +142,34 @@ HIAI_StatusT Mind_CameraDatasets::Init(
     ret = HIAI_ERROR;
   }
 
+  if (ret == HIAI_OK) {
+    // frame buffers are allocated and prefaulted once, then recycled
+    ascend::utils::FrameBufferPoolPara pool_para;
+    pool_para.buffer_size = config_->resolution_width
+        * config_->resolution_height * 3 / 2;
+    pool_para.buffer_count = kFrameBufferCount;
+    frame_pool_ = make_shared<ascend::utils::FrameBufferPool>(pool_para);
+    if (frame_pool_->Init() != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] init frame buffer pool failed");
+      ret = HIAI_ERROR;
+    }
+  }
+
+  if ((ret == HIAI_OK) && !config_->replay_file.empty()) {
+    ascend::utils::VirtualCameraPara virtual_para;
+    virtual_para.path = config_->replay_file;
+    virtual_para.resolution.width = config_->resolution_width;
+    virtual_para.resolution.height = config_->resolution_height;
+    virtual_para.fps = config_->replay_fast ? 0 : config_->fps;
+    virtual_para.loop = config_->replay_loop;
+    virtual_camera_ = make_shared<ascend::utils::VirtualCamera>(virtual_para);
+    if (virtual_camera_->Init() != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] open replay file %s failed",
+                      config_->replay_file.c_str());
+      ret = HIAI_ERROR;
+    }
+  }
+
   HIAI_ENGINE_LOG("[CameraDatasets] end init!");
   return ret;
 }
@@ -272,9 +323,12 @@ Mind_CameraDatasets::CreateBatchImageParaObj() {
   img_data.img.size = config_->resolution_width * config_->resolution_height * 3
       / 2;
 
-  shared_ptr <uint8_t> data(new uint8_t[img_data.img.size],
-                            default_delete<uint8_t[]>());
-  img_data.img.data = data;
+  // the buffer goes back to the pool when the last engine releases it
+  img_data.img.data = frame_pool_->Acquire<uint8_t>();
+  if (img_data.img.data == nullptr) {
+    HIAI_ENGINE_LOG("[CameraDatasets] get frame buffer failed");
+    return nullptr;
+  }
 
   pobj->v_img.push_back(img_data);
 
@@ -282,38 +336,38 @@ Mind_CameraDatasets::CreateBatchImageParaObj() {
 }
 
 bool Mind_CameraDatasets::DoCapProcess() {
-  CameraOperationCode ret_code = PreCapProcess();
-  if (ret_code == kCameraSetPropeptyFailed) {
-    CloseCamera(config_->channel_id);
-
-    HIAI_ENGINE_LOG("[CameraDatasets] DoCapProcess.PreCapProcess failed");
-    return false;
+  // a replay file needs no camera setup
+  if (virtual_camera_ == nullptr) {
+    CameraOperationCode ret_code = PreCapProcess();
+    if (ret_code == kCameraSetPropeptyFailed) {
+      CloseCamera(config_->channel_id);
+
+      HIAI_ENGINE_LOG("[CameraDatasets] DoCapProcess.PreCapProcess failed");
+      return false;
+    }
   }
 
   // set procedure is running.
   SetExitFlag (CAMERADATASETS_RUN);
 
   HIAI_StatusT hiai_ret = HIAI_OK;
-  int read_ret = 0;
-  int read_size = 0;
-  bool read_flag = false;
   while (GetExitFlag() == CAMERADATASETS_RUN) {
     shared_ptr < BatchImageParaWithScaleT > pobj = CreateBatchImageParaObj();
+    if (pobj == nullptr) {
+      break;
+    }
     NewImageParaT* pimg_data = &pobj->v_img[0];
     uint8_t* pdata = pimg_data->img.data.get();
-    read_size = (int) pimg_data->img.size;
-
-    // do read frame from camera
-    read_ret = ReadFrameFromCamera(config_->channel_id, (void*) pdata,
-                                   &read_size);
-    // indicates failure when readRet is 1
-    read_flag = ((read_ret == 1) && (read_size == (int) pimg_data->img.size));
-
-    if (!read_flag) {
-      HIAI_ENGINE_LOG("[CameraDatasets] readFrameFromCamera failed "
-                      "{camera:%d, ret:%d, size:%d, expectsize:%d} ",
-                      config_->channel_id, read_ret, read_size,
-                      (int) pimg_data->img.size);
+
+    // do read frame from camera or replay file
+    CameraOperationCode read_code = ReadFrame(pdata,
+                                              (int) pimg_data->img.size);
+    if (read_code == kCameraEndOfStream) {
+      HIAI_ENGINE_LOG("[CameraDatasets] replay file is over");
+      break;
+    }
+
+    if (read_code != kCameraOk) {
       break;
     }
 
@@ -329,7 +383,9 @@ bool Mind_CameraDatasets::DoCapProcess() {
   }
 
   // close camera
-  CloseCamera(config_->channel_id);
+  if (virtual_camera_ == nullptr) {
+    CloseCamera(config_->channel_id);
+  }
 
   if (hiai_ret != HIAI_OK) {
     return false;
@@ -338,6 +394,38 @@ bool Mind_CameraDatasets::DoCapProcess() {
   return true;
 }
 
+Mind_CameraDatasets::CameraOperationCode Mind_CameraDatasets::ReadFrame(
+    uint8_t* data, int size) {
+  if (virtual_camera_ != nullptr) {
+    int ret = virtual_camera_->ReadFrame((char*) data, size);
+    if (ret == ascend::utils::kDvppErrorEndOfStream) {
+      return kCameraEndOfStream;
+    }
+
+    if (ret != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] read replay file failed {ret:%d}",
+                      ret);
+      return kCameraReadFailed;
+    }
+
+    return kCameraOk;
+  }
+
+  // do read frame from camera, readSize maybe changed when called
+  int read_size = size;
+  int read_ret = ReadFrameFromCamera(config_->channel_id, (void*) data,
+                                     &read_size);
+  // indicates failure when readRet is 1
+  if ((read_ret != 1) || (read_size != size)) {
+    HIAI_ENGINE_LOG("[CameraDatasets] readFrameFromCamera failed "
+                    "{camera:%d, ret:%d, size:%d, expectsize:%d} ",
+                    config_->channel_id, read_ret, read_size, size);
+    return kCameraReadFailed;
+  }
+
+  return kCameraOk;
+}
+
 void Mind_CameraDatasets::SetExitFlag(int flag) {
   TLock lock(mutex_);
   exit_flag_ = flag;
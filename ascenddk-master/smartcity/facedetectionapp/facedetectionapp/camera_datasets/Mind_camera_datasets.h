@@ -44,6 +44,8 @@
 #include "hiaiengine/data_type.h"
 #include "hiaiengine/data_type_reg.h"
 #include "face_detection_params.h"
+#include "ascenddk/ascend_ezdvpp/frame_buffer_pool.h"
+#include "ascenddk/ascend_ezdvpp/virtual_camera.h"
 
 #define CAMERAL_1 (0)
 #define CAMERAL_2 (1)
@@ -70,6 +72,14 @@ public:
     int image_format;
     int resolution_width;
     int resolution_height;
+    // yuv420sp file replayed instead of the camera, data_source "File:<path>"
+    std::string replay_file;
+    // replay as fast as possible instead of at fps
+    bool replay_fast = false;
+    // start over at the end of the replay file
+    bool replay_loop = true;
+    // channel id of the replayed frames
+    int replay_channel = 0;
     std::string ToString() const;
   };
 
@@ -78,6 +88,8 @@ public:
     kCameraNotClosed = -1,
     kCameraOpenFailed = -2,
     kCameraSetPropeptyFailed = -3,
+    kCameraReadFailed = -4,
+    kCameraEndOfStream = -5,
   };
 
   /**
@@ -127,7 +139,7 @@ private:
 
   /**
    * @brief  create Image object
-   * @return : shared_ptr of data frame
+   * @return : shared_ptr of data frame, nullptr if no frame buffer
    */
   std::shared_ptr<BatchImageParaWithScaleT> CreateBatchImageParaObj();
 
@@ -148,6 +160,15 @@ private:
    */
   bool DoCapProcess();
 
+  /**
+   * @brief  read a frame from camera or replay file
+   * @param [in]  data    frame buffer
+   * @param [in]  size    size of frame buffer
+   * @return  kCameraOk ; kCameraReadFailed ; kCameraEndOfStream when the
+   *          replay file is over
+   */
+  Mind_CameraDatasets::CameraOperationCode ReadFrame(uint8_t* data, int size);
+
   /**
    * @brief  parse param
    * @return value of config
@@ -185,6 +206,10 @@ private:
   // ret of cameradataset
   int exit_flag_;
   uint32_t frame_id_;
+  // recycled buffers of captured frames
+  std::shared_ptr<ascend::utils::FrameBufferPool> frame_pool_;
+  // replay source, nullptr when the camera is used
+  std::shared_ptr<ascend::utils::VirtualCamera> virtual_camera_;
 
 };
 
@@ -96,31 +96,14 @@ const int32_t kDvppToJpegLevel = 100;
 // need to deal results when index is 2
 const int32_t kDealResultIndex = 2;
 
-// each results size
-const int32_t kEachResultSize = 7;
-
-// attribute index
-const int32_t kAttributeIndex = 1;
-
-// score index
-const int32_t kScoreIndex = 2;
-
-// anchor_lt.x index
-const int32_t kAnchorLeftTopAxisIndexX = 3;
-
-// anchor_lt.y index
-const int32_t kAnchorLeftTopAxisIndexY = 4;
-
-// anchor_rb.x index
-const int32_t kAnchorRightBottomAxisIndexX = 5;
-
-// anchor_rb.y index
-const int32_t kAnchorRightBottomAxisIndexY = 6;
-
 // face attribute
 const float kAttributeFaceLabelValue = 1.0;
 const float kAttributeFaceDeviation = 0.00001;
 
+// labels kept by the detection filter
+const std::vector<int32_t> kFaceLabels = {
+    static_cast<int32_t>(kAttributeFaceLabelValue) };
+
 // percent
 const int32_t kScorePercent = 100;
 
@@ -194,6 +177,11 @@ HIAI_StatusT FaceDetectionPostProcess::Init(
     // else : nothing need to do
   }
 
+  // overlapping faces are suppressed, one box for every face
+  ascend::utils::DetectionFilterPara filter_para;
+  filter_para.score_threshold = fd_post_process_config_->confidence;
+  detection_filter_ = ascend::utils::DetectionFilter(filter_para);
+
   // call presenter agent, create connection to presenter server
   uint16_t u_port = static_cast<uint16_t>(fd_post_process_config_
       ->presenter_port);
@@ -376,26 +364,29 @@ HIAI_StatusT FaceDetectionPostProcess::HandleResults(
     uint32_t height = img_vec[ind].img.height;
     uint32_t img_size = img_vec[ind].img.size;
 
-    // every inference result needs 8 float
-    // loop the result for every inference result
+    // the filter thresholds the scores and keeps the best of overlapped
+    // faces
+    std::vector<ascend::utils::DetectionBox> boxes;
+    detection_filter_.Filter(result,
+                             size / ascend::utils::kDetectionResultSize,
+                             kFaceLabels, boxes);
+
     std::vector<DetectionResult> detection_results;
-    float *ptr = result;
-    for (int32_t k = 0; k < size - kEachResultSize; k += kEachResultSize) {
-      ptr = result + k;
+    for (size_t k = 0; k < boxes.size(); ++k) {
       // attribute
-      float attr = ptr[kAttributeIndex];
+      float attr = boxes[k].label;
       // confidence
-      float score = ptr[kScoreIndex];
+      float score = boxes[k].score;
 
       //Detection result
       DetectionResult one_result;
       // left top
       Point point_lt, point_rb;
-      point_lt.x = ptr[kAnchorLeftTopAxisIndexX] * width;
-      point_lt.y = ptr[kAnchorLeftTopAxisIndexY] * height;
+      point_lt.x = boxes[k].lt_x * width;
+      point_lt.y = boxes[k].lt_y * height;
       // right bottom
-      point_rb.x = ptr[kAnchorRightBottomAxisIndexX] * width;
-      point_rb.y = ptr[kAnchorRightBottomAxisIndexY] * height;
+      point_rb.x = boxes[k].rb_x * width;
+      point_rb.y = boxes[k].rb_y * height;
 
       one_result.lt = point_lt;
       one_result.rb = point_rb;
@@ -40,6 +40,7 @@
 #include "hiaiengine/engine.h"
 #include "ascenddk/presenter/agent/presenter_channel.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "ascenddk/ascend_utils/detection_filter.h"
 
 #define INPUT_SIZE 1
 #define OUTPUT_SIZE 0
@@ -94,6 +95,9 @@ private:
   // presenter channel
   std::shared_ptr<ascend::presenter::Channel> presenter_channel_;
 
+  // score threshold and nms of the inference results
+  ascend::utils::DetectionFilter detection_filter_;
+
   /**
    * @brief: handle original image
    * @param [in]: EngineTransT format data which inference engine send
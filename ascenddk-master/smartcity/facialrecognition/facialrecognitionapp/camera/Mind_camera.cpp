@@ -56,10 +56,22 @@ using namespace std;
 namespace {
 // initial value of frameId
 const uint32_t kInitFrameId = 0;
+
+// frame buffers prepared at init, the pool grows if the downstream engines
+// hold more frames at the same time
+const int kFrameBufferCount = 8;
+
+// data_source of a replay file: File:<path>
+const string kReplaySourcePrefix = "File:";
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "Mind_camera";
 }
 
 // register custom data type
-HIAI_REGISTER_DATA_TYPE("FaceRecognitionInfo", FaceRecognitionInfo);
+HIAI_REGISTER_SERIALIZE_FUNC("FaceRecognitionInfo", FaceRecognitionInfo,
+                             SerializeFaceRecognitionInfo,
+                             DeserializeFaceRecognitionInfo);
 
 Mind_camera::Mind_camera() {
   config_ = nullptr;
@@ -99,7 +111,19 @@ HIAI_StatusT Mind_camera::Init(
     } else if (name == "image_format") {
       config_->image_format = CommonParseParam(value);
     } else if (name == "data_source") {
-      config_->channel_id = CommonParseParam(value);
+      // File:<path> replays a yuv420sp file instead of the camera
+      if (value.compare(0, kReplaySourcePrefix.size(), kReplaySourcePrefix)
+          == 0) {
+        config_->replay_file = value.substr(kReplaySourcePrefix.size());
+      } else {
+        config_->channel_id = CommonParseParam(value);
+      }
+    } else if (name == "replay_fast") {
+      config_->replay_fast = (value == "true");
+    } else if (name == "replay_loop") {
+      config_->replay_loop = (value != "false");
+    } else if (name == "replay_channel") {
+      config_->replay_channel = atoi(value.data());
     } else if (name == "image_size") {
       ParseImageSize(value, config_->resolution_width,
                      config_->resolution_height);
@@ -108,6 +132,10 @@ HIAI_StatusT Mind_camera::Init(
     }
   }
 
+  if (!config_->replay_file.empty()) {
+    config_->channel_id = config_->replay_channel;
+  }
+
   HIAI_StatusT ret = HIAI_OK;
   bool failed_flag = (config_->image_format == PARSEPARAM_FAIL
       || config_->channel_id == PARSEPARAM_FAIL
@@ -120,6 +148,47 @@ HIAI_StatusT Mind_camera::Init(
     ret = HIAI_ERROR;
   }
 
+  if (ret == HIAI_OK) {
+    // frame buffers are allocated and prefaulted once, then recycled
+    ascend::utils::FrameBufferPoolPara pool_para;
+    pool_para.buffer_size = config_->resolution_width
+        * config_->resolution_height * 3 / 2;
+    pool_para.buffer_count = kFrameBufferCount;
+
+    // frames are sent to the device by DMA without serializing them, which
+    // needs HIAI_DMalloc memory. the pool frees it, not the framework
+    pool_para.allocate = [](int size) -> char* {
+      void* buffer = nullptr;
+      HIAI_StatusT dmalloc_ret = hiai::HIAIMemory::HIAI_DMalloc(
+          size, buffer, MALLOC_DEFAULT_TIME_OUT,
+          hiai::MEMORY_ATTR_MANUAL_FREE);
+      return (dmalloc_ret == HIAI_OK) ? static_cast<char*>(buffer) : nullptr;
+    };
+    pool_para.release = [](char* buffer) {
+      (void) hiai::HIAIMemory::HIAI_DFree(buffer);
+    };
+    frame_pool_ = make_shared<ascend::utils::FrameBufferPool>(pool_para);
+    if (frame_pool_->Init() != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] init frame buffer pool failed");
+      ret = HIAI_ERROR;
+    }
+  }
+
+  if ((ret == HIAI_OK) && !config_->replay_file.empty()) {
+    ascend::utils::VirtualCameraPara virtual_para;
+    virtual_para.path = config_->replay_file;
+    virtual_para.resolution.width = config_->resolution_width;
+    virtual_para.resolution.height = config_->resolution_height;
+    virtual_para.fps = config_->replay_fast ? 0 : config_->fps;
+    virtual_para.loop = config_->replay_loop;
+    virtual_camera_ = make_shared<ascend::utils::VirtualCamera>(virtual_para);
+    if (virtual_camera_->Init() != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] open replay file %s failed",
+                      config_->replay_file.c_str());
+      ret = HIAI_ERROR;
+    }
+  }
+
   HIAI_ENGINE_LOG("[CameraDatasets] end init!");
   return ret;
 }
@@ -269,47 +338,55 @@ shared_ptr<FaceRecognitionInfo> Mind_camera::CreateBatchImageParaObj() {
   pObj->org_img.size = config_->resolution_width * config_->resolution_height
       * 3 / 2;
 
-  shared_ptr<uint8_t> data(new uint8_t[pObj->org_img.size],
-                           default_delete<uint8_t[]>());
-  pObj->org_img.data = data;
+  // the buffer goes back to the pool when the last engine releases it
+  pObj->org_img.data = frame_pool_->Acquire<uint8_t>();
+  if (pObj->org_img.data == nullptr) {
+    HIAI_ENGINE_LOG("[CameraDatasets] get frame buffer failed");
+    return nullptr;
+  }
   return pObj;
 }
 
 bool Mind_camera::DoCapProcess() {
-  CameraOperationCode ret_code = PreCapProcess();
-  if (ret_code == kCameraSetPropertyFailed) {
-    CloseCamera(config_->channel_id);
-
-    HIAI_ENGINE_LOG("[CameraDatasets] DoCapProcess.PreCapProcess failed");
-    return false;
+  // a replay file needs no camera setup
+  if (virtual_camera_ == nullptr) {
+    CameraOperationCode ret_code = PreCapProcess();
+    if (ret_code == kCameraSetPropertyFailed) {
+      CloseCamera(config_->channel_id);
+
+      HIAI_ENGINE_LOG("[CameraDatasets] DoCapProcess.PreCapProcess failed");
+      return false;
+    }
   }
 
   // set procedure is running.
   SetExitFlag(CAMERADATASETS_RUN);
 
   HIAI_StatusT hiai_ret = HIAI_OK;
-  int read_ret = 0;
-  int read_size = 0;
-  bool read_flag = false;
   while (GetExitFlag() == CAMERADATASETS_RUN) {
     shared_ptr<FaceRecognitionInfo> p_obj = CreateBatchImageParaObj();
+    if (p_obj == nullptr) {
+      break;
+    }
     uint8_t* p_data = p_obj->org_img.data.get();
-    read_size = (int) p_obj->org_img.size;
-
-    // do read frame from camera, readSize maybe changed when called
-    read_ret = ReadFrameFromCamera(config_->channel_id, (void*) p_data,
-                                   &read_size);
-    // indicates failure when readRet is 1
-    read_flag = ((read_ret == 1) && (read_size == (int) p_obj->org_img.size));
-
-    if (!read_flag) {
-      HIAI_ENGINE_LOG("[CameraDatasets] readFrameFromCamera failed "
-                      "{camera:%d, ret:%d, size:%d, expectsize:%d} ",
-                      config_->channel_id, read_ret, read_size,
-                      (int )p_obj->org_img.size);
+
+    // do read frame from camera or replay file
+    CameraOperationCode read_code = ReadFrame(p_data,
+                                              (int) p_obj->org_img.size);
+    if (read_code == kCameraEndOfStream) {
+      HIAI_ENGINE_LOG("[CameraDatasets] replay file is over");
       break;
     }
 
+    if (read_code != kCameraOk) {
+      break;
+    }
+
+    // the frame is captured now, the trace starts here
+    ascend::utils::EnterTraceStage(p_obj->frame.trace, kTraceStage);
+    p_obj->frame.capture_time_ns = p_obj->frame.trace.back().enter_ns;
+    ascend::utils::ExitTraceStage(p_obj->frame.trace);
+
     hiai_ret = SendData(0, "FaceRecognitionInfo",
                         static_pointer_cast<void>(p_obj));
 
@@ -322,7 +399,9 @@ bool Mind_camera::DoCapProcess() {
   }
 
   // close camera
-  CloseCamera(config_->channel_id);
+  if (virtual_camera_ == nullptr) {
+    CloseCamera(config_->channel_id);
+  }
 
   if (hiai_ret != HIAI_OK) {
     return false;
@@ -331,6 +410,38 @@ bool Mind_camera::DoCapProcess() {
   return true;
 }
 
+Mind_camera::CameraOperationCode Mind_camera::ReadFrame(
+    uint8_t* data, int size) {
+  if (virtual_camera_ != nullptr) {
+    int ret = virtual_camera_->ReadFrame((char*) data, size);
+    if (ret == ascend::utils::kDvppErrorEndOfStream) {
+      return kCameraEndOfStream;
+    }
+
+    if (ret != ascend::utils::kDvppOperationOk) {
+      HIAI_ENGINE_LOG("[CameraDatasets] read replay file failed {ret:%d}",
+                      ret);
+      return kCameraReadFailed;
+    }
+
+    return kCameraOk;
+  }
+
+  // do read frame from camera, readSize maybe changed when called
+  int read_size = size;
+  int read_ret = ReadFrameFromCamera(config_->channel_id, (void*) data,
+                                     &read_size);
+  // indicates failure when readRet is 1
+  if ((read_ret != 1) || (read_size != size)) {
+    HIAI_ENGINE_LOG("[CameraDatasets] readFrameFromCamera failed "
+                    "{camera:%d, ret:%d, size:%d, expectsize:%d} ",
+                    config_->channel_id, read_ret, read_size, size);
+    return kCameraReadFailed;
+  }
+
+  return kCameraOk;
+}
+
 void Mind_camera::SetExitFlag(int flag) {
   TLock lock(mutex_);
   exit_flag_ = flag;
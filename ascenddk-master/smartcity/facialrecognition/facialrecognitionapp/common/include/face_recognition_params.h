@@ -34,8 +34,14 @@
 #ifndef FACE_RECOGNITION_PARAMS_H_
 #define FACE_RECOGNITION_PARAMS_H_
 
+#include <memory>
+#include <sstream>
+#include "cereal/archives/portable_binary.hpp"
+#include "hiaiengine/ai_memory.h"
+#include "hiaiengine/api.h"
 #include "hiaiengine/data_type.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_data_type.h"
+#include "ascenddk/ascend_utils/latency_trace.h"
 
 #define CHECK_MEM_OPERATOR_RESULTS(ret) \
 if (ret != EOK) { \
@@ -79,6 +85,7 @@ struct FrameInfo {
   uint32_t frame_id = 0;  // frame id
   uint32_t channel_id = 0;  // channel id for current frame
   uint32_t timestamp = 0;  // timestamp for current frame
+  int64_t capture_time_ns = 0;  // monotonic capture time in nanosecond
   uint32_t image_source = 0;  // 0:Camera 1:Register
   std::string face_id = "";  // registered face id
   // original image format and rank using for org_img addition
@@ -87,6 +94,8 @@ struct FrameInfo {
       ascend::utils::kVpcYuv420SemiPlannar;
   ascend::utils::DvppVpcImageRankType org_img_rank = ascend::utils::kVpcNv21;
   bool img_aligned = false; // original image already aligned or not
+  // engines the frame has passed, stamped by every engine before sending
+  std::vector<ascend::utils::TraceStamp> trace;
 };
 
 /**
@@ -95,8 +104,9 @@ struct FrameInfo {
  */
 template<class Archive>
 void serialize(Archive& ar, FrameInfo& data) {
-  ar(data.frame_id, data.channel_id, data.timestamp, data.image_source,
-     data.face_id, data.org_img_format, data.org_img_rank);
+  ar(data.frame_id, data.channel_id, data.timestamp, data.capture_time_ns,
+     data.image_source, data.face_id, data.org_img_format, data.org_img_rank,
+     data.trace);
 }
 
 /**
@@ -193,4 +203,72 @@ void serialize(Archive& ar, FaceRecognitionInfo& data) {
   ar(data.frame, data.err_info, data.org_img, data.face_imgs);
 }
 
+/**
+ * @brief: serialize the attributes of an image without its pixel data
+ */
+template<class Archive>
+void SerializeImageHeader(Archive& ar, hiai::ImageData<u_int8_t>& data) {
+  ar(data.format, data.width, data.height, data.channel, data.depth,
+     data.height_step, data.width_step, data.size);
+}
+
+/**
+ * @brief: serialize FaceRecognitionInfo between host and device without
+ *         copying the original image. the control string only holds the
+ *         frame information and image attributes, the original image is
+ *         the data buffer the framework transfers by DMA, so it should be
+ *         allocated by HIAI_DMalloc (see Mind_camera). cropped images are
+ *         still serialized into the control string.
+ * @param [in] input_ptr: FaceRecognitionInfo to send
+ * @param [out] ctrl_str: control string
+ * @param [out] data_ptr: original image data
+ * @param [out] data_len: original image size
+ */
+inline void SerializeFaceRecognitionInfo(void* input_ptr,
+                                         std::string& ctrl_str,
+                                         uint8_t*& data_ptr,
+                                         uint32_t& data_len) {
+  FaceRecognitionInfo* info = static_cast<FaceRecognitionInfo*>(input_ptr);
+  std::ostringstream oss;
+  {
+    cereal::PortableBinaryOutputArchive ar(oss);
+    ar(info->frame, info->err_info, info->face_imgs);
+    SerializeImageHeader(ar, info->org_img);
+  }
+  ctrl_str = oss.str();
+  data_ptr = info->org_img.data.get();
+  data_len = (data_ptr == nullptr) ? 0 : info->org_img.size;
+}
+
+/**
+ * @brief: deserialize FaceRecognitionInfo of SerializeFaceRecognitionInfo,
+ *         the original image uses the received buffer, which is given back
+ *         to the framework when the last engine releases it
+ * @param [in] ctrl_ptr: control string
+ * @param [in] ctrl_len: control string length
+ * @param [in] data_ptr: original image data
+ * @param [in] data_len: original image size
+ * @return FaceRecognitionInfo
+ */
+inline std::shared_ptr<void> DeserializeFaceRecognitionInfo(
+    const char* ctrl_ptr, const uint32_t& ctrl_len, const uint8_t* data_ptr,
+    const uint32_t& data_len) {
+  std::shared_ptr<FaceRecognitionInfo> info =
+      std::make_shared<FaceRecognitionInfo>();
+  std::istringstream iss(std::string(ctrl_ptr, ctrl_len));
+  {
+    cereal::PortableBinaryInputArchive ar(iss);
+    ar(info->frame, info->err_info, info->face_imgs);
+    SerializeImageHeader(ar, info->org_img);
+  }
+  if (data_ptr != nullptr) {
+    info->org_img.data.reset(const_cast<uint8_t*>(data_ptr),
+                             hiai::Graph::ReleaseDataBuffer);
+  }
+  if (data_len < info->org_img.size) {
+    info->org_img.size = data_len;
+  }
+  return std::static_pointer_cast<void>(info);
+}
+
 #endif /* FACE_RECOGNITION_PARAMS_H_ */
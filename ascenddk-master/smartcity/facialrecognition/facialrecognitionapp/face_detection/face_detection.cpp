@@ -38,6 +38,7 @@
 
 #include "hiaiengine/log.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "ascenddk/ascend_utils/detection_filter.h"
 
 using hiai::Engine;
 using hiai::ImageData;
@@ -63,38 +64,32 @@ const float kConfidenceMax = 1.0;
 // results
 // inference output result index
 const int32_t kResultIndex = 0;
-// each result size (7 float)
-const int32_t kEachResultSize = 7;
-// attribute index
-const int32_t kAttributeIndex = 1;
-// score index
-const int32_t kScoreIndex = 2;
-// left top X-axis coordinate point
-const int32_t kLeftTopXaxisIndex = 3;
-// left top Y-axis coordinate point
-const int32_t kLeftTopYaxisIndex = 4;
-// right bottom X-axis coordinate point
-const int32_t kRightBottomXaxisIndex = 5;
-// right bottom Y-axis coordinate point
-const int32_t kRightBottomYaxisIndex = 6;
 
 // face attribute
 const float kAttributeFaceLabelValue = 1.0;
 const float kAttributeFaceDeviation = 0.00001;
 
-// ratio
-const float kMinRatio = 0.0;
-const float kMaxRatio = 1.0;
+// labels kept by the detection filter
+const vector<int32_t> kFaceLabels = {
+    static_cast<int32_t>(kAttributeFaceLabelValue) };
 
 // image source from register
 const uint32_t kRegisterSrc = 1;
 
 // sleep interval when queue full (unit:microseconds)
 const __useconds_t kSleepInterval = 200000;
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "face_detection";
+
+// engine the results are sent to, for the engine profile
+const string kNextEngine = "face_feature_mask";
 }
 
 // register custom data type
-HIAI_REGISTER_DATA_TYPE("FaceRecognitionInfo", FaceRecognitionInfo);
+HIAI_REGISTER_SERIALIZE_FUNC("FaceRecognitionInfo", FaceRecognitionInfo,
+                             SerializeFaceRecognitionInfo,
+                             DeserializeFaceRecognitionInfo);
 HIAI_REGISTER_DATA_TYPE("FaceRectangle", FaceRectangle);
 HIAI_REGISTER_DATA_TYPE("FaceImage", FaceImage);
 
@@ -136,6 +131,11 @@ HIAI_StatusT FaceDetection::Init(
     return HIAI_ERROR;
   }
 
+  // overlapping faces are suppressed, one crop for every face
+  DetectionFilterPara filter_para;
+  filter_para.score_threshold = confidence_;
+  detection_filter_ = DetectionFilter(filter_para);
+
   // initialize model manager
   vector<hiai::AIModelDescription> model_desc_vec;
   model_desc_vec.push_back(fd_model_desc);
@@ -174,11 +174,6 @@ bool FaceDetection::IsValidResults(float attr, float score,
   return true;
 }
 
-float FaceDetection::CorrectionRatio(float ratio) {
-  float tmp = (ratio < kMinRatio) ? kMinRatio : ratio;
-  return (tmp > kMaxRatio) ? kMaxRatio : tmp;
-}
-
 bool FaceDetection::PreProcess(
   const shared_ptr<FaceRecognitionInfo> &image_handle,
   ImageData<u_int8_t> &resized_image) {
@@ -307,22 +302,21 @@ bool FaceDetection::PostProcess(
   uint32_t width = image_handle->org_img.width;
   uint32_t height = image_handle->org_img.height;
 
-  // every inference result needs 8 float
-  // loop the result for every result
-  float *ptr = result;
-  for (int32_t i = 0; i < size - kEachResultSize; i += kEachResultSize) {
-    ptr = result + i;
-    // attribute
-    float attr = ptr[kAttributeIndex];
-    // confidence
-    float score = ptr[kScoreIndex];
+  // the filter thresholds the scores and keeps the best of overlapped faces
+  vector<DetectionBox> boxes;
+  detection_filter_.Filter(result, size / kDetectionResultSize, kFaceLabels,
+                           boxes);
+
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    float attr = boxes[i].label;
+    float score = boxes[i].score;
 
     // position
     FaceRectangle rectangle;
-    rectangle.lt.x = CorrectionRatio(ptr[kLeftTopXaxisIndex]) * width;
-    rectangle.lt.y = CorrectionRatio(ptr[kLeftTopYaxisIndex]) * height;
-    rectangle.rb.x = CorrectionRatio(ptr[kRightBottomXaxisIndex]) * width;
-    rectangle.rb.y = CorrectionRatio(ptr[kRightBottomYaxisIndex]) * height;
+    rectangle.lt.x = boxes[i].lt_x * width;
+    rectangle.lt.y = boxes[i].lt_y * height;
+    rectangle.rb.x = boxes[i].rb_x * width;
+    rectangle.rb.y = boxes[i].rb_y * height;
 
     // check results is invalid, skip it
     if (!IsValidResults(attr, score, rectangle)) {
@@ -358,18 +352,27 @@ void FaceDetection::HandleErrors(
 void FaceDetection::SendResult(
   const shared_ptr<FaceRecognitionInfo> &image_handle) {
 
+  // the frame leaves this engine
+  ExitTraceStage(image_handle->frame.trace);
+
   // when register face, can not discard when queue full
   HIAI_StatusT hiai_ret;
+  int64_t start_ns = GetMonotonicTimeNs();
+  bool is_queue_full = false;
   do {
     hiai_ret = SendData(kSendDataPort, "FaceRecognitionInfo",
                         static_pointer_cast<void>(image_handle));
     // when queue full, sleep
     if (hiai_ret == HIAI_QUEUE_FULL) {
       HIAI_ENGINE_LOG("queue full, sleep 200ms");
+      is_queue_full = true;
       usleep(kSleepInterval);
     }
   } while (hiai_ret == HIAI_QUEUE_FULL
            && image_handle->frame.image_source == kRegisterSrc);
+  RecordEngineSend(kNextEngine,
+                   is_queue_full ? GetMonotonicTimeNs() - start_ns : 0,
+                   is_queue_full, hiai_ret != HIAI_OK);
 
   // send failed
   if (hiai_ret != HIAI_OK) {
@@ -380,6 +383,8 @@ void FaceDetection::SendResult(
 
 HIAI_StatusT FaceDetection::Detection(
   shared_ptr<FaceRecognitionInfo> &image_handle) {
+  EnterTraceStage(image_handle->frame.trace, kTraceStage);
+
   string err_msg = "";
   if (image_handle->err_info.err_code != AppErrorCode::kNone) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
@@ -420,6 +425,7 @@ HIAI_StatusT FaceDetection::Detection(
 
 HIAI_IMPL_ENGINE_PROCESS("face_detection",
                          FaceDetection, INPUT_SIZE) {
+  ENGINE_PROFILE_PROCESS(kTraceStage, -1);
   HIAI_StatusT ret = HIAI_OK;
 
   // deal arg0 (camera input)
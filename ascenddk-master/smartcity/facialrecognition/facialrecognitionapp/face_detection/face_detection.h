@@ -41,6 +41,7 @@
 #include "hiaiengine/engine.h"
 #include "hiaiengine/data_type_reg.h"
 #include "hiaiengine/ai_tensor.h"
+#include "ascenddk/ascend_utils/detection_filter.h"
 
 #include "face_recognition_params.h"
 
@@ -88,6 +89,9 @@ private:
   // confidence : used to check inference result
   float confidence_;
 
+  // score threshold and nms of the inference results
+  ascend::utils::DetectionFilter detection_filter_;
+
   /**
    * @brief: check confidence is valid or not
    * param [in]: confidence
@@ -104,15 +108,6 @@ private:
    */
   bool IsValidResults(float attr, float score, const FaceRectangle &rectangle);
 
-  /**
-   * @brief: correction ratio
-   * param [in]: coordinate ratio
-   * @return: ratio in [0, 1]
-   *          when ratio less than zero, then return zero
-   *          when ratio more than one, then return one
-   */
-  float CorrectionRatio(float ratio);
-
   /**
    * @brief: pre-process
    * param [in]: image_handle: original image
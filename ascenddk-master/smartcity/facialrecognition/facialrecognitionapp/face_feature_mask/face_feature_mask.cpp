@@ -46,7 +46,6 @@ using namespace ascend::utils;
 using hiai::Engine;
 using namespace std;
 using namespace hiai;
-using namespace cv;
 
 namespace {
 // The image's width need to be resized
@@ -65,6 +64,9 @@ const int32_t kEachResultTensorNum = 10;
 const float kNormalizedCenterData = 0.5;
 
 const int32_t kSendDataIntervalMiss = 20;
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "face_feature_mask";
 }
 
 /**
@@ -124,21 +126,30 @@ bool FaceFeatureMaskProcess::InitAiModel(const AIConfig &config) {
 }
 
 bool FaceFeatureMaskProcess::InitNormlizedData() {
-  // Load the mean data
-  Mat train_mean_value(kResizedImgWidth, kResizedImgHeight, CV_32FC3, (void *)kTrainMean);
-  train_mean_ = train_mean_value;
-  if (train_mean_.empty()) {
+  // Load the mean and std data, both of them are BGR HWC 40*40 tables
+  TensorPreprocessPara tensor_para;
+  tensor_para.yuv_store_type = kYuv420sp;
+  tensor_para.dest_resolution.width = kResizedImgWidth;
+  tensor_para.dest_resolution.height = kResizedImgHeight;
+  tensor_para.channel_order = kTensorBgr;
+  tensor_para.data_type = kTensorFloat32;
+  tensor_para.mean = kTrainMean;
+  tensor_para.std = kTrainStd;
+  tensor_preprocess_ = make_shared<TensorPreprocess>(tensor_para);
+  if (tensor_preprocess_->Init() != kDvppOperationOk) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "Load mean failed!");
+                    "Load mean and std failed!");
     return false;
   }
 
-  // Load the STD data
-  Mat train_std_value(kResizedImgWidth, kResizedImgHeight, CV_32FC3, (void *)kTrainStd);
-  train_std_ = train_std_value;
-  if (train_std_.empty()) {
+  // The batch buffer is allocated once and reused by every inference
+  int tensor_size = batch_size_ * kResizedImgWidth * kResizedImgHeight
+                    * kRgbChannel;
+  tensor_buffer_.reset(new(nothrow) float[tensor_size],
+                       default_delete<float[]>());
+  if (tensor_buffer_ == nullptr) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "Load std failed!");
+                    "New the tensor buffer error.");
     return false;
   }
   HIAI_ENGINE_LOG("Load mean and std success!");
@@ -198,123 +209,19 @@ bool FaceFeatureMaskProcess::Crop(const shared_ptr<FaceRecognitionInfo> &face_re
   return true;
 }
 
-bool FaceFeatureMaskProcess::Resize(const vector<FaceImage> &face_imgs,
-                                    vector<ImageData<u_int8_t>> &resized_imgs) {
-  // Begin to resize all the resize image
-  for (vector<FaceImage>::const_iterator face_img_iter = face_imgs.begin();
-       face_img_iter != face_imgs.end(); ++face_img_iter) {
-
-    int32_t img_size = face_img_iter->image.size;
-    if (img_size <= 0) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "image size less than or equal zero, size=%d", img_size);
-      return false;
-    }
-
-    int32_t origin_width = face_img_iter->image.width;
-    int32_t origin_height = face_img_iter->image.height;
-    ImageData<u_int8_t> resized_image;
-    DvppCropOrResizePara resize_para;
-
-    resize_para.image_type = kVpcYuv420SemiPlannar;
-    resize_para.rank = kVpcNv21;
-    resize_para.horz_min = 0;
-    resize_para.horz_max = origin_width - 1;
-    resize_para.vert_min = 0;
-    resize_para.vert_max = origin_height - 1;
-    resize_para.src_resolution.width = origin_width;
-    resize_para.src_resolution.height = origin_height;
-
-    resize_para.dest_resolution.width = kResizedImgWidth;
-    resize_para.dest_resolution.height = kResizedImgHeight;
-    resize_para.is_input_align = true;
-    resize_para.is_output_align = false;
-    DvppProcess dvpp_resize_img(resize_para);
-
-    // Invoke EZ_DVPP interface to resize image
-    DvppOutput dvpp_output;
-    int ret = dvpp_resize_img.DvppOperationProc(
-                reinterpret_cast<char *>(face_img_iter->image.data.get()), img_size, &dvpp_output);
-    if (ret != kDvppOperationOk) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "Call ez_dvpp failed, failed to resize image.");
-      return false;
-    }
-
-    // call success, set data and size
-    resized_image.data.reset(dvpp_output.buffer, default_delete<u_int8_t[]>());
-    resized_image.size = dvpp_output.size;
-    resized_image.width = kResizedImgWidth;
-    resized_image.height = kResizedImgHeight;
-    resized_imgs.push_back(resized_image);
-  }
-  return true;
-}
-
-bool FaceFeatureMaskProcess::ImageYUV2BGR (
-  const vector<ImageData<u_int8_t>> &resized_image,
-  vector<Mat> &bgr_image) {
-  for (vector<ImageData<u_int8_t>>::const_iterator resized_img_iter = resized_image.begin();
-       resized_img_iter != resized_image.end(); ++resized_img_iter) {
-
-    int img_height = resized_img_iter->height;
-    int img_width = resized_img_iter->width;
-    Mat src(img_height * kNv12SizeMolecule / kNv12SizeDenominator,
-            img_width, CV_8UC1);
-
-    int copy_size = img_width * img_height * kNv12SizeMolecule
-                    / kNv12SizeDenominator;
-    int destination_size = src.cols * src.rows * src.elemSize();
-    int ret = memcpy_s(src.data, destination_size, resized_img_iter->data.get(),
-                       copy_size);
-    CHECK_MEM_OPERATOR_RESULTS(ret);
-
-    Mat dst_temp;
-    cvtColor(src, dst_temp, CV_YUV2BGR_NV12);
-    Mat dst;
-    dst_temp.convertTo(dst, CV_32FC3);
-    bgr_image.push_back(dst);
-  }
-  return true;
-}
-
-bool FaceFeatureMaskProcess::NormalizeData (
-  vector<Mat> &normalized_image) {
-  // The flag to record
-  bool failuar_flag = true;
-  for (vector<Mat>::iterator iter = normalized_image.begin();
-       iter != normalized_image.end(); ++iter) {
-
-    // Sub the mean and divide the std
-    *iter = *iter  - train_mean_;
-    *iter = *iter  / train_std_;
-
-    // Record that whether all the data is empty
-    if (failuar_flag && !(*iter).empty()) {
-      failuar_flag = false;
-    }
-  }
-
-  // If all the data is empty, return false
-  if (failuar_flag) {
-    HIAI_ENGINE_LOG("All the data normalize failed");
-    return false;
-  }
-  return true;
-}
-
-bool FaceFeatureMaskProcess::Inference(vector<Mat> &normalized_image,
-                                       vector<FaceImage> &face_imgs) {
+bool FaceFeatureMaskProcess::Inference(vector<FaceImage> &face_imgs) {
   // Define the ai model's data
   AIContext ai_context;
 
-  int normalized_image_size = normalized_image.size();
-  int normalized_image_mod = normalized_image_size % batch_size_;
+  int face_size = face_imgs.size();
+  int face_mod = face_size % batch_size_;
 
   // calcuate the iter number
   // calcuate the value by batch
-  int iter_num = normalized_image_mod == 0 ?
-                 (normalized_image_size / batch_size_) : (normalized_image_size / batch_size_ + 1);
+  int iter_num = face_mod == 0 ?
+                 (face_size / batch_size_) : (face_size / batch_size_ + 1);
+
+  float *tensor_buffer = tensor_buffer_.get();
 
   // Invoke interface to do the inference
   for (int i = 0; i < iter_num; i++) {
@@ -322,21 +229,12 @@ bool FaceFeatureMaskProcess::Inference(vector<Mat> &normalized_image,
     int start_index = batch_size_ * i;
     int end_index = start_index + batch_size_;
 
-    // Last group data, need to fulfill the extra data
-    // fulfill with last Mat in the vector
-    if (i == iter_num - 1 && normalized_image_mod != 0) {
-      int fulfill_number = batch_size_ - normalized_image_mod;
-      EnrichDataByLastMat(normalized_image, fulfill_number);
-      end_index = i * batch_size_ + normalized_image_mod;
+    // Last group data, only part of the batch is real face
+    if (i == iter_num - 1 && face_mod != 0) {
+      end_index = i * batch_size_ + face_mod;
     }
 
-    float *tensor_buffer = new(std::nothrow) float[batch_size_ * kResizedImgWidth * kResizedImgHeight * kRgbChannel];
-    if (tensor_buffer == nullptr) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "New the tensor buffer error.");
-      return false;
-    }
-    int last_size = CopyDataToBuffer(normalized_image, start_index, tensor_buffer);
+    int last_size = CopyDataToBuffer(face_imgs, start_index, tensor_buffer);
 
     if (last_size == -1) {
       return false;
@@ -355,7 +253,6 @@ bool FaceFeatureMaskProcess::Inference(vector<Mat> &normalized_image,
     if (ret != SUCCESS) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                       "Fail to create output tensor");
-      delete [] tensor_buffer;
       return false;
     }
 
@@ -364,7 +261,6 @@ bool FaceFeatureMaskProcess::Inference(vector<Mat> &normalized_image,
     if (ret != SUCCESS) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                       "Fail to process the data in FWK");
-      delete [] tensor_buffer;
       return false;
     }
 
@@ -374,12 +270,10 @@ bool FaceFeatureMaskProcess::Inference(vector<Mat> &normalized_image,
     shared_ptr<AISimpleTensor> result_tensor = static_pointer_cast <
         AISimpleTensor > (output_data_vec[0]);
     if (!ArrangeFaceMarkInfo(result_tensor, start_index, end_index, face_imgs)) {
-      delete [] tensor_buffer;
       return false;
     }
     input_data_vec.clear();
     output_data_vec.clear();
-    delete [] tensor_buffer;
   }
   return true;
 }
@@ -448,43 +342,49 @@ void FaceFeatureMaskProcess::EnrichFacePosition(int *face_position,
   face_feature->right_mouth.y = face_position[FaceFeaturePos::kRightMouthY];
 }
 
-void FaceFeatureMaskProcess::EnrichDataByLastMat(vector<Mat> &normalized_image,
-    int number) {
-  Mat last_mat = normalized_image[normalized_image.size() - 1];
-  for (int i = 0; i < number; i++) {
-    normalized_image.push_back(last_mat);
-  }
-}
-
-int FaceFeatureMaskProcess::CopyDataToBuffer(vector<Mat> &normalized_image,
+int FaceFeatureMaskProcess::CopyDataToBuffer(const vector<FaceImage> &face_imgs,
     int start_index, float *tensor_buffer) {
 
+  int each_length = kResizedImgWidth * kResizedImgHeight * kRgbChannel;
+  int each_size = each_length * sizeof(float);
   int last_size = 0;
+  int face_size = face_imgs.size();
   for (int i = start_index; i < start_index + batch_size_; i++) {
+    float *slot = tensor_buffer + last_size;
 
-    // Split the normalized data by opencv
-    vector<Mat> temp_splited_image;
-    split(normalized_image[i], temp_splited_image);
-
-    // Copy data to buffer
-    for (vector<Mat>::iterator
-         splited_data_iter = temp_splited_image.begin();
-         splited_data_iter != temp_splited_image.end(); ++splited_data_iter) {
-
-      // Change data type to float
-      (*splited_data_iter).convertTo(*splited_data_iter, CV_32FC3);
-      int splited_data_length = (*splited_data_iter).rows * (*splited_data_iter).cols;
-      int each_size = splited_data_length * sizeof(float);
-      int ret = memcpy_s(tensor_buffer + last_size, each_size, (*splited_data_iter).ptr<float>(0), each_size);
+    // Fulfill the extra data with last face in the vector
+    if (i >= face_size) {
+      int ret = memcpy_s(slot, each_size, slot - each_length, each_size);
       if (ret != EOK) {
         HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                         "memory operation failed in the feature mask's CopyDataToBuffer, error=%d", ret);
-        return 0;
+        return -1;
       }
+      last_size += each_length;
+      continue;
+    }
 
-      // Calcuate the memory's end position
-      last_size += splited_data_length;
+    // The cropped image is the aligned output of ez_dvpp
+    const ImageData<u_int8_t> &face_img = face_imgs[i].image;
+    TensorPreprocessRoi roi;
+    roi.src_resolution.width = face_img.width;
+    roi.src_resolution.height = face_img.height;
+    roi.horz_min = 0;
+    roi.horz_max = face_img.width - 1;
+    roi.vert_min = 0;
+    roi.vert_max = face_img.height - 1;
+    roi.is_input_align = true;
+    int ret = tensor_preprocess_->TensorPreprocessProc(
+                reinterpret_cast<char *>(face_img.data.get()), face_img.size,
+                roi, slot, each_size);
+    if (ret != kDvppOperationOk) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                      "Preprocess the face failed, error=%d", ret);
+      return -1;
     }
+
+    // Calcuate the memory's end position
+    last_size += each_length;
   }
   return last_size;
 }
@@ -504,6 +404,7 @@ HIAI_StatusT FaceFeatureMaskProcess::SendFailed(const string error_log,
   ErrorInfo err_info = face_recognition_info->err_info;
   err_info.err_code = AppErrorCode::kFeatureMask;
   err_info.err_msg = error_log;
+  ExitTraceStage(face_recognition_info->frame.trace);
   HIAI_StatusT ret = HIAI_OK;
   do {
     ret = SendData(DEFAULT_DATA_PORT, "FaceRecognitionInfo",
@@ -522,6 +423,7 @@ HIAI_StatusT FaceFeatureMaskProcess::SendSuccess(
 
   HIAI_ENGINE_LOG("VCNN network run success, the total face is %d .",
                   face_recognition_info->face_imgs.size());
+  ExitTraceStage(face_recognition_info->frame.trace);
   HIAI_StatusT ret = HIAI_OK;
   do {
     ret = SendData(DEFAULT_DATA_PORT, "FaceRecognitionInfo",
@@ -536,6 +438,8 @@ HIAI_StatusT FaceFeatureMaskProcess::SendSuccess(
 }
 
 HIAI_IMPL_ENGINE_PROCESS("face_feature_mask", FaceFeatureMaskProcess, INPUT_SIZE) {
+  ENGINE_PROFILE_PROCESS(kTraceStage, -1);
+
   // args is null, arg0 is image info, arg1 is model info
   if (nullptr == arg0) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
@@ -547,9 +451,11 @@ HIAI_IMPL_ENGINE_PROCESS("face_feature_mask", FaceFeatureMaskProcess, INPUT_SIZE
   // If not correct, Send the message to next node directly
   shared_ptr<FaceRecognitionInfo> face_recognition_info = static_pointer_cast <
       FaceRecognitionInfo > (arg0);
+  EnterTraceStage(face_recognition_info->frame.trace, kTraceStage);
   if (!IsDataHandleWrong(face_recognition_info)) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "The message status is not normal");
+    ExitTraceStage(face_recognition_info->frame.trace);
     SendData(DEFAULT_DATA_PORT, "FaceRecognitionInfo",
              static_pointer_cast<void>(face_recognition_info));
     return HIAI_ERROR;
@@ -565,25 +471,8 @@ HIAI_IMPL_ENGINE_PROCESS("face_feature_mask", FaceFeatureMaskProcess, INPUT_SIZE
                       face_recognition_info);
   }
 
-  vector<ImageData<u_int8_t>> resized_imgs;
-  if (!Resize(face_recognition_info->face_imgs, resized_imgs)) {
-    return SendFailed("Resize all the data failed, all the data failed",
-                      face_recognition_info);
-  }
-
-  vector<Mat> bgr_imgs;
-  if (!ImageYUV2BGR(resized_imgs, bgr_imgs)) {
-    return SendFailed("Convert all the data failed, all the data failed",
-                      face_recognition_info);
-  }
-
-  if (!NormalizeData(bgr_imgs)) {
-    return SendFailed("Normalize all the data failed, all the data failed",
-                      face_recognition_info);
-  }
-
   // Inference the data
-  bool inference_flag = Inference(bgr_imgs, face_recognition_info->face_imgs);
+  bool inference_flag = Inference(face_recognition_info->face_imgs);
   if (!inference_flag) {
     return SendFailed("Inference the data failed",
                       face_recognition_info);
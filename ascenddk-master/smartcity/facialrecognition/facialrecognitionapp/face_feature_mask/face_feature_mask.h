@@ -48,9 +48,7 @@
 #include <unistd.h>
 #include <vector>
 #include <stdint.h>
-#include "opencv2/opencv.hpp"
-#include "opencv2/imgproc.hpp"
-#include "opencv2/core/types_c.h"
+#include "ascenddk/ascend_ezdvpp/tensor_preprocess.h"
 
 #define INPUT_SIZE 2
 #define OUTPUT_SIZE 1
@@ -80,11 +78,11 @@ class FaceFeatureMaskProcess : public hiai::Engine {
   // AI module manager
   std::shared_ptr<hiai::AIModelManager> ai_model_manager_;
 
-  // Mean value after trained
-  cv::Mat train_mean_;
+  // Fused resize, yuv to bgr and normalization with the trained mean and std
+  std::shared_ptr<ascend::utils::TensorPreprocess> tensor_preprocess_;
 
-  // Std value after trained
-  cv::Mat train_std_;
+  // Input tensor of one batch, reused by every inference
+  std::shared_ptr<float> tensor_buffer_;
 
   /*
    * Define the face feature position
@@ -112,7 +110,7 @@ class FaceFeatureMaskProcess : public hiai::Engine {
 
   /*
    * @brief: Init the normlized mean and std value, the data source is from
-   *   trainMean.png and trainSTD.png
+   *   trainMean.png and trainSTD.png, and the batch tensor buffer
    * @return: Whether init success
    */
   bool InitNormlizedData();
@@ -129,52 +127,13 @@ class FaceFeatureMaskProcess : public hiai::Engine {
   bool Crop(const std::shared_ptr<FaceRecognitionInfo> &face_recognition_info, const hiai::ImageData<u_int8_t> &org_img,
             std::vector<FaceImage> &face_imgs);
 
-  /*
-   * @brief: Resize the face from cropped image base on the face size 40*40
-   *   Invoke the ez_dvpp interface to do the resize action
-   * @param [in]: face_imgs->image Image data after cropped
-   * @param [in]: resized_image Face info after resize
-   * @return: Whether init success
-   */
-  bool Resize(const std::vector<FaceImage> &face_imgs,
-              std::vector<hiai::ImageData<u_int8_t>> &resized_image);
-
-  /*
-   * @brief: Transform the image from resized YUV image to BGR image
-   *   Invoke the opencv's interface to transf
-   * @param [in]: resized_image The resized YUV image
-   * @param [in]: bgr_image BGE images after transf
-   * @return: Whether init success
-   */
-  bool ImageYUV2BGR(const std::vector<hiai::ImageData<u_int8_t>> &resized_image,
-                    std::vector<cv::Mat> &bgr_image);
-
-  /*
-   * @brief: Transform the image from (0,255) to little number
-   *   Invoke the opencv's interface to do the normalization,
-   *   sub mean and divide std.
-   * @param [in]: normalized_image The BGR image data,between(0,255)
-   * @param [in]: normalized_image The data after normalization
-   * @return: Whether init success
-   */
-  bool NormalizeData (std::vector<cv::Mat> &normalized_image);
-
   /*
    * @brief: Inference the data by the FWK's Process interface
-   * @param [in]: normalized_image The data after normalization
+   * @param [in]: face_imgs->image The cropped face images
    * @param [in]: face_imgs->feature_mask The inference result
    * @return: Whether init success
    */
-  bool Inference(std::vector<cv::Mat> &normalized_image,
-                 std::vector<FaceImage> &face_imgs);
-
-  /*
-   * @brief: Copy the data from Mat to Memory Buffer
-   * @param [in]: normalized_image The original data after normalized
-   * @param [in]: number How many Mat need to be fulfilled
-   */
-  void EnrichDataByLastMat(std::vector<cv::Mat> &normalized_image,
-                           int number);
+  bool Inference(std::vector<FaceImage> &face_imgs);
 
   /*
    * @brief: Enrich the face's position by inference result
@@ -185,13 +144,15 @@ class FaceFeatureMaskProcess : public hiai::Engine {
                           FaceFeature* face_feature);
 
   /*
-   * @brief: Copy the data from Mat to Memory Buffer
-   * @param [in]: normalized_image The data after normalized
-   * @param [in]: start_index start index in the splited_image data.
+   * @brief: Fill the batch buffer, resize every cropped face to 40*40,
+   *   convert to BGR, normalize and split channels in one pass.
+   *   The slots after the last face are fulfilled with the last face
+   * @param [in]: face_imgs->image The cropped face images, NV12 aligned
+   * @param [in]: start_index start index in the face_imgs.
    * @param [in]: tensor_buffer The buffer for the inference
-   * @return: Handle result
+   * @return: Handle result, the used float number, -1 when failed
    */
-  int CopyDataToBuffer(std::vector<cv::Mat> &normalized_image,
+  int CopyDataToBuffer(const std::vector<FaceImage> &face_imgs,
                        int start_index, float* tensor_buffer);
 
   /*
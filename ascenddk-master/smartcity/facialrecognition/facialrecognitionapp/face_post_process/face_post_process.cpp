@@ -50,7 +50,9 @@ using namespace ascend::utils;
 using namespace google::protobuf;
 
 // register custom data type
-HIAI_REGISTER_DATA_TYPE("FaceRecognitionInfo", FaceRecognitionInfo);
+HIAI_REGISTER_SERIALIZE_FUNC("FaceRecognitionInfo", FaceRecognitionInfo,
+                             SerializeFaceRecognitionInfo,
+                             DeserializeFaceRecognitionInfo);
 HIAI_REGISTER_DATA_TYPE("FaceRectangle", FaceRectangle);
 HIAI_REGISTER_DATA_TYPE("FaceImage", FaceImage);
 
@@ -58,12 +60,51 @@ HIAI_REGISTER_DATA_TYPE("FaceImage", FaceImage);
 namespace {
 // level for call DVPP
 const int32_t kDvppToJpegLevel = 100;
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "face_post_process";
 }
 
 HIAI_StatusT FacePostProcess::Init(
     const hiai::AIConfig &config,
     const std::vector<hiai::AIModelDescription> &model_desc) {
-  // need do nothing
+  // latency trace is exported only when a file is configured
+  LatencyTracerPara tracer_para;
+
+  // so is the engine profile of the device process
+  EngineProfilePara profile_para;
+  for (int index = 0; index < config.items_size(); index++) {
+    const ::hiai::AIConfigItem& item = config.items(index);
+    if (item.name() == kLatencyHistogramFileKey) {
+      tracer_para.histogram_file = item.value();
+    } else if (item.name() == kLatencyTraceFileKey) {
+      tracer_para.chrome_trace_file = item.value();
+    } else if (item.name() == kLatencyExportIntervalKey) {
+      stringstream ss(item.value());
+      ss >> tracer_para.export_interval;
+    } else if (item.name() == kEngineProfileFileKey) {
+      profile_para.text_file = item.value();
+    } else if (item.name() == kEngineProfileJsonFileKey) {
+      profile_para.json_file = item.value();
+    } else if (item.name() == kEngineProfileIntervalKey) {
+      stringstream ss(item.value());
+      ss >> profile_para.export_interval_ms;
+    }
+    // else: noting need to do
+  }
+
+  if (!tracer_para.histogram_file.empty()
+      || !tracer_para.chrome_trace_file.empty()) {
+    latency_tracer_.reset(new LatencyTracer(tracer_para));
+  }
+
+  if ((!profile_para.text_file.empty() || !profile_para.json_file.empty())
+      && (StartEngineProfile(profile_para) != kUtilsOk)) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                    "engine_profile_interval_ms = %d is invalid.",
+                    profile_para.export_interval_ms);
+    return HIAI_ERROR;
+  }
   return HIAI_OK;
 }
 
@@ -204,6 +245,7 @@ HIAI_StatusT FacePostProcess::ReplyFeature(
 }
 
 HIAI_IMPL_ENGINE_PROCESS("face_post_process", FacePostProcess, INPUT_SIZE) {
+  ENGINE_PROFILE_PROCESS(kTraceStage, -1);
 
   // deal arg0 (engine only have one input)
   if (arg0 != nullptr) {
@@ -213,7 +255,16 @@ HIAI_IMPL_ENGINE_PROCESS("face_post_process", FacePostProcess, INPUT_SIZE) {
     // deal data from camera
     if (image_handle->frame.image_source == 0) {
       HIAI_ENGINE_LOG("post process dealing data from camera.");
-      return SendFeature(image_handle);
+      EnterTraceStage(image_handle->frame.trace, kTraceStage);
+      HIAI_StatusT ret = SendFeature(image_handle);
+      ExitTraceStage(image_handle->frame.trace);
+      if (latency_tracer_ != nullptr) {
+        latency_tracer_->RecordFrame(
+            image_handle->frame.trace,
+            to_string(image_handle->frame.channel_id),
+            image_handle->frame.frame_id);
+      }
+      return ret;
     }
 
     // deal data from register
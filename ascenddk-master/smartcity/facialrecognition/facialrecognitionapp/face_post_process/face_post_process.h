@@ -36,6 +36,7 @@
 
 #include "face_recognition_params.h"
 
+#include <memory>
 #include <vector>
 #include <stdint.h>
 
@@ -89,6 +90,8 @@ private:
    */
   HIAI_StatusT ReplyFeature(const std::shared_ptr<FaceRecognitionInfo> &info);
 
+  // latency of the frames from camera, nullptr: not configured
+  std::unique_ptr<ascend::utils::LatencyTracer> latency_tracer_;
 };
 
 #endif
@@ -93,10 +93,18 @@ const int32_t kEveryFaceResVecCount = 1024;
 
 // sleep interval when queue full (unit:microseconds)
 const __useconds_t kSleepInterval = 200000;
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "face_recognition";
+
+// engine the results are sent to, for the engine profile
+const string kNextEngine = "face_post_process";
 }
 
 // register custom data type
-HIAI_REGISTER_DATA_TYPE("FaceRecognitionInfo", FaceRecognitionInfo);
+HIAI_REGISTER_SERIALIZE_FUNC("FaceRecognitionInfo", FaceRecognitionInfo,
+                             SerializeFaceRecognitionInfo,
+                             DeserializeFaceRecognitionInfo);
 HIAI_REGISTER_DATA_TYPE("FaceRectangle", FaceRectangle);
 HIAI_REGISTER_DATA_TYPE("FaceImage", FaceImage);
 
@@ -535,7 +543,12 @@ void FaceRecognition::InferenceFeatureVector(
 
 void FaceRecognition::SendResult(
     const shared_ptr<FaceRecognitionInfo> &image_handle) {
+  // the frame leaves this engine
+  ExitTraceStage(image_handle->frame.trace);
+
   HIAI_StatusT hiai_ret;
+  int64_t start_ns = GetMonotonicTimeNs();
+  bool is_queue_full = false;
   // when register face, can not discard when queue full
   do {
     hiai_ret = SendData(0, "FaceRecognitionInfo",
@@ -543,10 +556,14 @@ void FaceRecognition::SendResult(
     // when queue full, sleep
     if (hiai_ret == HIAI_QUEUE_FULL) {
       HIAI_ENGINE_LOG("queue full, sleep 200ms");
+      is_queue_full = true;
       usleep(kSleepInterval);
     }
   } while (hiai_ret == HIAI_QUEUE_FULL
       && image_handle->frame.image_source == kRegisterSrc);
+  RecordEngineSend(kNextEngine,
+                   is_queue_full ? GetMonotonicTimeNs() - start_ns : 0,
+                   is_queue_full, hiai_ret != HIAI_OK);
 
   // send failed
   if (hiai_ret != HIAI_OK) {
@@ -557,6 +574,8 @@ void FaceRecognition::SendResult(
 
 HIAI_StatusT FaceRecognition::Recognition(
     shared_ptr<FaceRecognitionInfo> &image_handle) {
+  EnterTraceStage(image_handle->frame.trace, kTraceStage);
+
   string err_msg = "";
   if (image_handle->err_info.err_code != AppErrorCode::kNone) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
@@ -588,6 +607,7 @@ HIAI_StatusT FaceRecognition::Recognition(
 
 HIAI_IMPL_ENGINE_PROCESS("face_recognition",
     FaceRecognition, INPUT_SIZE) {
+  ENGINE_PROFILE_PROCESS(kTraceStage, -1);
   HIAI_StatusT ret = HIAI_OK;
 
   // deal arg0 (engine only have one input)
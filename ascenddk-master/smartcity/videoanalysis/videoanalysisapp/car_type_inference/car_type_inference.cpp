@@ -43,6 +43,7 @@
 #include <hiaiengine/log.h>
 #include <hiaiengine/ai_types.h>
 #include "hiaiengine/ai_model_parser.h"
+#include "engine_flow_control.h"
 
 namespace {
 // car type kind
@@ -107,8 +108,6 @@ const string kCarTypeClass[431] = { "Audi", "Audi", "Audi", "Audi", "Audi",
     "Chevy", "Chevy", "Chevy", "Chevy", "Zhonghua", "Zhonghua", "Zhonghua",
     "Zhonghua", "Zhonghua", "Zhonghua", "Zhonghua", "Zhonghua", "Zhonghua",
     "Zhonghua", "Brabus", "Zxauto", "Zxauto", "Zxauto" };
-// time for waitting when send queue is full.
-const int kWaitTime = 20000;
 // the image width for model.
 const int kDestImageWidth = 224;
 // the image height for model.
@@ -119,6 +118,11 @@ const string kModelPathItemName = "model_path";
 const string kPasscodeItemName = "passcode";
 // the name of batch_size in the config file
 const string kBatchSizeItemName = "batch_size";
+// the name of batch_timeout_ms in the config file
+const string kBatchTimeoutItemName = "batch_timeout_ms";
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "car_type_inference";
 }
 
 HIAI_REGISTER_DATA_TYPE("BatchCarInfoT", BatchCarInfoT);
@@ -130,7 +134,11 @@ HIAI_StatusT CarTypeInferenceEngine::Init(
     const hiai::AIConfig& config,
     const std::vector<hiai::AIModelDescription>& model_desc) {
   HIAI_ENGINE_LOG("[CarTypeInferenceEngine] start init!");
+  InitInputCredits(kCarTypeInferenceEngine);
+  resize_cache_ = ascend::utils::SharedImageCache::GetSharedImageCache(
+      kCarResizeCache);
   hiai::AIStatus ret = hiai::SUCCESS;
+  int batch_timeout_ms = kDefaultBatchTimeoutMs;
 
   if (ai_model_manager_ == nullptr) {
     ai_model_manager_ = std::make_shared<hiai::AIModelManager>();
@@ -153,15 +161,35 @@ HIAI_StatusT CarTypeInferenceEngine::Init(
     } else if (item.name() == kBatchSizeItemName) {
       std::stringstream ss(item.value());
       ss >> batch_size_;
+    } else if (item.name() == kBatchTimeoutItemName) {
+      std::stringstream ss(item.value());
+      ss >> batch_timeout_ms;
     }
   }
 
+  if ((batch_timeout_ms < 0) || (batch_timeout_ms > kMaxBatchTimeoutMs)) {
+    HIAI_ENGINE_LOG(
+        "[CarTypeInferenceEngine] batch_timeout_ms should be 0~%d!",
+        kMaxBatchTimeoutMs);
+    return HIAI_ERROR;
+  }
+
   model_desc_vec.push_back(model_description);
   ret = ai_model_manager_->Init(config, model_desc_vec);
   if (ret != hiai::SUCCESS) {
     return HIAI_ERROR;
   }
 
+  batcher_.Init(batch_size_, batch_timeout_ms,
+                [this](const CarBatchSlots& slots) {
+                  return BatchInferenceProcess(slots);
+                },
+                [this](const std::shared_ptr<BatchCarInfoT>& tran_data) {
+                  ascend::utils::ExitTraceStage(
+                      tran_data->video_image_info.trace);
+                  SendResultData(tran_data);
+                });
+
   HIAI_ENGINE_LOG("[CarTypeInferenceEngine] end init!");
   return HIAI_OK;
 }
@@ -170,15 +198,11 @@ HIAI_StatusT CarTypeInferenceEngine::SendResultData(
     const std::shared_ptr<BatchCarInfoT>& tran_data) {
   HIAI_StatusT hiai_ret = HIAI_OK;
 
-  do {
-    // this engine only have one outport, this port parameter be set to zero.
-    hiai_ret = SendData(0, "BatchCarInfoT",
-                        std::static_pointer_cast<void>(tran_data));
-    if (hiai_ret == HIAI_QUEUE_FULL) {
-      HIAI_ENGINE_LOG("[CarTypeInferenceEngine] queue full");
-      usleep(kWaitTime);
-    }
-  } while (hiai_ret == HIAI_QUEUE_FULL);
+  // this engine only have one outport, this port parameter be set to zero.
+  hiai_ret = SendDataWithCredit(kVideoAnalysisPostEngine, [&]() {
+    return SendData(0, "BatchCarInfoT",
+                    std::static_pointer_cast<void>(tran_data));
+  });
 
   if (hiai_ret != HIAI_OK) {
     HIAI_ENGINE_LOG("[CarTypeInferenceEngine] send finished data failed!");
@@ -220,15 +244,32 @@ void CarTypeInferenceEngine::BatchImageResize(
     dvpp_resize_param.dest_resolution.width = kDestImageWidth;
     dvpp_resize_param.dest_resolution.height = kDestImageHeight;
 
-    ascend::utils::DvppProcess dvpp_process(dvpp_resize_param);
-
-    char* image_buffer = (char*) (iter->img.data.get());
-    ascend::utils::DvppOutput dvpp_out;
-    int ret = dvpp_process.DvppOperationProc(image_buffer, iter->img.size,
-                                             &dvpp_out);
-    if (ret != ascend::utils::kDvppOperationOk) {
-      HIAI_ENGINE_LOG(
-          "[CarTypeInferenceEngine] resize image failed with code %d !", ret);
+    // the first of the car engines resizes, the other takes its result
+    std::string key = GetResizeKey(batch_image_input->video_image_info,
+                                   iter->object_info, kDestImageWidth,
+                                   kDestImageHeight);
+    ascend::utils::SharedImage resized_image;
+    bool is_resized = resize_cache_->Get(
+        key, iter->object_info.resize_share_num,
+        [&](ascend::utils::SharedImage& image) {
+          ascend::utils::DvppProcess dvpp_process(dvpp_resize_param);
+
+          char* image_buffer = (char*) (iter->img.data.get());
+          ascend::utils::DvppOutput dvpp_out;
+          int ret = dvpp_process.DvppOperationProc(image_buffer,
+                                                   iter->img.size, &dvpp_out);
+          if (ret != ascend::utils::kDvppOperationOk) {
+            HIAI_ENGINE_LOG("[CarTypeInferenceEngine] resize image failed "
+                            "with code %d !", ret);
+            return false;
+          }
+
+          image.data.reset(dvpp_out.buffer, std::default_delete<uint8_t[]>());
+          image.size = dvpp_out.size;
+          return true;
+        },
+        resized_image);
+    if (!is_resized) {
       continue;
     }
 
@@ -241,27 +282,24 @@ void CarTypeInferenceEngine::BatchImageResize(
     obj_image->img.height = kDestImageHeight;
     obj_image->img.channel = iter->img.channel;
     obj_image->img.depth = iter->img.depth;
-    obj_image->img.size = dvpp_out.size;
-    obj_image->img.data.reset(dvpp_out.buffer,
-                              std::default_delete<uint8_t[]>());
+    obj_image->img.size = resized_image.size;
+    obj_image->img.data = resized_image.data;
     batch_image_output->obj_imgs.push_back(*obj_image);
   }
 }
 
-bool CarTypeInferenceEngine::ConstructBatchBuffer(
-    int batch_index,
-    const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-    uint8_t* temp) {
+bool CarTypeInferenceEngine::ConstructBatchBuffer(const CarBatchSlots& slots,
+                                                  uint8_t* temp) {
   bool is_successed = true;
-  int image_number = image_handle->obj_imgs.size();
-  int image_size = image_handle->obj_imgs[0].img.size * sizeof(uint8_t);
+  int image_number = slots.size();
+  int image_size = slots[0].GetImage().img.size * sizeof(uint8_t);
 
-  //the loop for each image
+  //the loop for each image, the crops may come from different frames
   for (int j = 0; j < batch_size_; j++) {
-    if (batch_index + j < image_number) {
-      errno_t err = memcpy_s(
-          temp + j * image_size, image_size,
-          image_handle->obj_imgs[batch_index + j].img.data.get(), image_size);
+    if (j < image_number) {
+      const ObjectImageParaT& image = slots[j].GetImage();
+      errno_t err = memcpy_s(temp + j * image_size, image_size,
+                             image.img.data.get(), image.img.size);
       if (err != EOK) {
         HIAI_ENGINE_LOG(
             "[CarTypeInferenceEngine] ERROR, copy image buffer failed");
@@ -285,15 +323,13 @@ bool CarTypeInferenceEngine::ConstructBatchBuffer(
 
 bool CarTypeInferenceEngine::ConstructInferenceResult(
     const std::vector<std::shared_ptr<hiai::IAITensor> >& output_data_vec,
-    int batch_index,
-    const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-    const std::shared_ptr<BatchCarInfoT>& tran_data) {
+    const CarBatchSlots& slots) {
   if (output_data_vec.size() == 0) {
     HIAI_ENGINE_LOG("[CarTypeInferenceEngine] output_data_vec is null!");
     return false;
   }
 
-  int image_number = image_handle->obj_imgs.size();
+  int image_number = slots.size();
 
   for (int n = 0; n < output_data_vec.size(); ++n) {
     std::shared_ptr<hiai::AINeuralNetworkBuffer> result_tensor =
@@ -314,116 +350,89 @@ bool CarTypeInferenceEngine::ConstructInferenceResult(
           max_confidence_index = batch_result_index + index;
         }
       }
-      // creat out struct for each batch
-      CarInfoT out;
-      if (batch_index + batch_result_index / (size / batch_size_)
-          < image_number) {
-        out.object_id = image_handle->obj_imgs[batch_index
-            + batch_result_index / (size / batch_size_)].object_info.object_id;
+      // creat out struct for each batch, and give it back to its frame
+      int image_index = batch_result_index / (size / batch_size_);
+      if (image_index < image_number) {
+        const BatchSlotT<BatchCarInfoT>& slot = slots[image_index];
+        CarInfoT out;
+        out.object_id = slot.GetImage().object_info.object_id;
         out.label = max_confidence_index - batch_result_index;
         out.attribute_name = kCarType;
         out.inference_result = kCarTypeClass[max_confidence_index
             - batch_result_index];
         out.confidence = *(result + max_confidence_index);
-        tran_data->car_infos.push_back(out);
-
+        slot.frame->tran_data->car_infos.push_back(out);
       }
     }
   }
   return true;
 }
 
-HIAI_StatusT CarTypeInferenceEngine::BatchInferenceProcess(
-    const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-    std::shared_ptr<BatchCarInfoT> tran_data) {
+bool CarTypeInferenceEngine::BatchInferenceProcess(
+    const CarBatchSlots& slots) {
   HIAI_ENGINE_LOG("[CarTypeInferenceEngine] start process!");
 
   hiai::AIStatus ret = hiai::SUCCESS;
-  HIAI_StatusT hiai_ret = HIAI_OK;
-  int image_number = image_handle->obj_imgs.size();
-  int image_size = image_handle->obj_imgs[0].img.size * sizeof(uint8_t);
+  int image_size = slots[0].GetImage().img.size * sizeof(uint8_t);
   int batch_buffer_size = image_size * batch_size_;
 
-  // the loop for each batch ,maybe image_number greater than batch_size_
-  for (int i = 0; i < image_number; i += batch_size_) {
-
-    std::vector<std::shared_ptr<hiai::IAITensor> > input_data_vec;
-    std::vector<std::shared_ptr<hiai::IAITensor> > output_data_vec;
-    //1.prepare input buffer for each batch
-    if (tran_data == nullptr) {
-      tran_data = std::make_shared<BatchCarInfoT>();
-    }
-    //  apply buffer for each batch
-    uint8_t* temp = new uint8_t[batch_buffer_size];
-    // Origin image information is transmitted to next Engine directly
-    tran_data->video_image_info = image_handle->video_image_info;
-    bool is_successed = true;
-
-    is_successed = ConstructBatchBuffer(i, image_handle, temp);
-    if (!is_successed) {
-      HIAI_ENGINE_LOG(
-          "[CarTypeInferenceEngine] batch input buffer construct failed!");
-      delete[] temp;
-      return HIAI_ERROR;
-    }
-
-    std::shared_ptr<hiai::AINeuralNetworkBuffer> neural_buffer =
-        std::shared_ptr<hiai::AINeuralNetworkBuffer>(
-            new hiai::AINeuralNetworkBuffer());
-    neural_buffer->SetBuffer((void*) (temp), batch_buffer_size);
-    std::shared_ptr<hiai::IAITensor> input_data = std::static_pointer_cast<
-        hiai::IAITensor>(neural_buffer);
-    input_data_vec.push_back(input_data);
-
-    // 2.Call Process, Predict
-    ret = ai_model_manager_->CreateOutputTensor(input_data_vec,
-                                                output_data_vec);
-    if (ret != hiai::SUCCESS) {
-      HIAI_ENGINE_LOG("[CarTypeInferenceEngine] CreateOutputTensor failed");
-      delete[] temp;
-      return HIAI_ERROR;
-    }
-    hiai::AIContext ai_context;
+  std::vector<std::shared_ptr<hiai::IAITensor> > input_data_vec;
+  std::vector<std::shared_ptr<hiai::IAITensor> > output_data_vec;
+  //1.prepare input buffer for the batch
+  uint8_t* temp = new uint8_t[batch_buffer_size];
+  bool is_successed = ConstructBatchBuffer(slots, temp);
+  if (!is_successed) {
     HIAI_ENGINE_LOG(
-        "[CarTypeInferenceEngine] ai_model_manager_->Process start!");
-    ret = ai_model_manager_->Process(ai_context, input_data_vec,
-                                     output_data_vec, 0);
-    if (ret != hiai::SUCCESS) {
-      HIAI_ENGINE_LOG(
-          "[CarTypeInferenceEngine] ai_model_manager Process failed");
-      delete[] temp;
-      return HIAI_ERROR;
-    }
+        "[CarTypeInferenceEngine] batch input buffer construct failed!");
     delete[] temp;
-    input_data_vec.clear();
-
-    //3.set the tran_data with the result of this batch
-
-    is_successed = ConstructInferenceResult(output_data_vec, i, image_handle,
-                                            tran_data);
+    return false;
+  }
 
-    if (!is_successed) {
-      HIAI_ENGINE_LOG(
-          "[CarTypeInferenceEngine] batch copy output buffer failed!");
-      return HIAI_ERROR;
-    }
-    //4. send the result
-    hiai_ret = SendResultData(tran_data);
-    if (hiai_ret != HIAI_OK) {
-      HIAI_ENGINE_LOG(
-          "[CarTypeInferenceEngine] SendData failed! error code: %d", hiai_ret);
-    }
+  std::shared_ptr<hiai::AINeuralNetworkBuffer> neural_buffer =
+      std::shared_ptr<hiai::AINeuralNetworkBuffer>(
+          new hiai::AINeuralNetworkBuffer());
+  neural_buffer->SetBuffer((void*) (temp), batch_buffer_size);
+  std::shared_ptr<hiai::IAITensor> input_data = std::static_pointer_cast<
+      hiai::IAITensor>(neural_buffer);
+  input_data_vec.push_back(input_data);
+
+  // 2.Call Process, Predict
+  ret = ai_model_manager_->CreateOutputTensor(input_data_vec,
+                                              output_data_vec);
+  if (ret != hiai::SUCCESS) {
+    HIAI_ENGINE_LOG("[CarTypeInferenceEngine] CreateOutputTensor failed");
+    delete[] temp;
+    return false;
+  }
+  hiai::AIContext ai_context;
+  HIAI_ENGINE_LOG(
+      "[CarTypeInferenceEngine] ai_model_manager_->Process start!");
+  ret = ai_model_manager_->Process(ai_context, input_data_vec,
+                                   output_data_vec, 0);
+  if (ret != hiai::SUCCESS) {
+    HIAI_ENGINE_LOG(
+        "[CarTypeInferenceEngine] ai_model_manager Process failed");
+    delete[] temp;
+    return false;
+  }
+  delete[] temp;
+  input_data_vec.clear();
 
-    //5. release sources
-    tran_data = nullptr;
+  //3.give the result of each crop back to its frame
+  is_successed = ConstructInferenceResult(output_data_vec, slots);
+  if (!is_successed) {
+    HIAI_ENGINE_LOG(
+        "[CarTypeInferenceEngine] batch copy output buffer failed!");
+    return false;
   }
-  HIAI_ENGINE_LOG("[CarTypeInferenceEngine] end process!");
 
-  return HIAI_OK;
+  HIAI_ENGINE_LOG("[CarTypeInferenceEngine] end process!");
+  return true;
 }
 
 HIAI_IMPL_ENGINE_PROCESS("car_type_inference", CarTypeInferenceEngine,
                          INPUT_SIZE) {
+  PROFILE_ENGINE_PROCESS_WITH_CREDIT(kCarTypeInferenceEngine);
   HIAI_StatusT hiai_ret = HIAI_OK;
   std::shared_ptr<BatchCarInfoT> tran_data = std::make_shared<BatchCarInfoT>();
   std::shared_ptr<BatchCroppedImageParaT> image_input = std::make_shared<
@@ -436,6 +445,7 @@ HIAI_IMPL_ENGINE_PROCESS("car_type_inference", CarTypeInferenceEngine,
     HIAI_ENGINE_LOG("[CarTypeInferenceEngine] input data is null!");
     return HIAI_ERROR;
   }
+  ReleaseInputCredits(kCarTypeInferenceEngine);
   // this engine only need one queue, so the port should be set to zero.
   input_que_.PushData(0, arg0);
   if (!input_que_.PopAllData(image_input)) {
@@ -449,16 +459,23 @@ HIAI_IMPL_ENGINE_PROCESS("car_type_inference", CarTypeInferenceEngine,
 
   // add is_finished for showing this data in dataset are all sended.
   if (image_input->video_image_info.is_finished == true) {
+    // frames still waiting for a batch go out before the finished flag
+    batcher_.Flush();
     tran_data->video_image_info = image_input->video_image_info;
     return SendResultData(tran_data);
   }
 
+  ascend::utils::EnterTraceStage(image_input->video_image_info.trace,
+                                 kTraceStage);
+
   // resize input image;
   BatchImageResize(image_input, image_handle);
   if (image_handle->obj_imgs.empty() == true) {
     HIAI_ENGINE_LOG("[CarColorInferenceEngine] image_input resize failed");
     return HIAI_ERROR;
   }
-  // inference and send inference result;
-  return BatchInferenceProcess(image_handle, tran_data);
+  // the crops join the next batch, results are sent once all are inferred
+  tran_data->video_image_info = image_handle->video_image_info;
+  batcher_.AddFrame(image_handle, tran_data);
+  return HIAI_OK;
 }
@@ -44,6 +44,8 @@
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
 
 #include "video_analysis_params.h"
+#include "cross_frame_batcher.h"
+#include "shared_crop_resize.h"
 
 #define INPUT_SIZE 2
 #define OUTPUT_SIZE 1
@@ -73,14 +75,19 @@ class CarTypeInferenceEngine : public hiai::Engine {
   HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE);
 
  private:
+  typedef CrossFrameBatcher<BatchCarInfoT>::BatchSlots CarBatchSlots;
+
   // How many image numbers of a batch.
   int batch_size_;
   // used to cache the input queue.
   hiai::MultiTypeQueue input_que_;
   // Define a AIModelManager type smart pointer.
   std::shared_ptr<hiai::AIModelManager> ai_model_manager_;
+  // resized cars shared with the other car attribute engine.
+  std::shared_ptr<ascend::utils::SharedImageCache> resize_cache_;
   /**
-   * @brief call ez_dvpp interface for resizing image.
+   * @brief call ez_dvpp interface for resizing image, a crop shared with
+   *        the other car attribute engine is resized only once.
    * @param [in] batch_image_input:  batch image from previous engine.
    * @param [out] batch_image_output: batch image for processing.
    */
@@ -94,38 +101,30 @@ class CarTypeInferenceEngine : public hiai::Engine {
    */
   HIAI_StatusT SendResultData(const std::shared_ptr<BatchCarInfoT>& tran_data);
   /**
-   * @brief  batch inference
-   * @param [in] image_handle: batch image for processing.
-   * @param [in] tran_data:  the data will be sent to next engine.
-   * @return  success --> HIAI_OK ; fail --> HIAI_ERROR
+   * @brief  batch inference, the crops may come from several frames
+   * @param [in] slots: crops of the batch and their frames.
+   * @return  success --> true ; fail --> false
    */
-  HIAI_StatusT BatchInferenceProcess(
-      const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-      std::shared_ptr<BatchCarInfoT> tran_data);
+  bool BatchInferenceProcess(const CarBatchSlots& slots);
   /**
    * @brief  construct batch buffer as a input for process
-   * @param [in] batch_index:  batch index of input image;
-   * @param [in] image_handle:  batch image for processing.
+   * @param [in] slots: crops of the batch and their frames.
    * @param [in] temp:  apply memory for image origin data.
    * @return  success --> true ; fail --> fail
    */
-  bool ConstructBatchBuffer(
-      int batch_index,
-      const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-      uint8_t* temp);
+  bool ConstructBatchBuffer(const CarBatchSlots& slots, uint8_t* temp);
   /**
-   * @brief  analyze inference result
+   * @brief  analyze inference result, add it to the frame of each crop
    * @param [in] output_data_vec:  inference output from model
-   * @param [in] batch_index:  batch index of input image;
-   * @param [in] image_handle:  batch image for processing.
-   * @param [in] tran_data: the data will be sent to next engine.
+   * @param [in] slots: crops of the batch and their frames.
    * @return  success --> true ; fail --> fail
    */
   bool ConstructInferenceResult(
       const std::vector<std::shared_ptr<hiai::IAITensor> >& output_data_vec,
-      int batch_index,
-      const std::shared_ptr<BatchCroppedImageParaT>& image_handle,
-      const std::shared_ptr<BatchCarInfoT>& tran_data);
+      const CarBatchSlots& slots);
+
+  // collects crops of several frames into one batch, destroyed first
+  CrossFrameBatcher<BatchCarInfoT> batcher_;
 };
 
 #endif
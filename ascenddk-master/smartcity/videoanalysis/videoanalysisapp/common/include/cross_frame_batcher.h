@@ -0,0 +1,346 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef COMMON_INCLUDE_CROSS_FRAME_BATCHER_H
+#define COMMON_INCLUDE_CROSS_FRAME_BATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "hiaiengine/log.h"
+#include "video_analysis_params.h"
+
+// default wait for a batch to fill up, in milliseconds
+const int kDefaultBatchTimeoutMs = 20;
+
+// maximum wait for a batch to fill up, in milliseconds
+const int kMaxBatchTimeoutMs = 1000;
+
+// a frame waiting for the inference results of its crops
+template<class ResultT>
+struct PendingFrameT {
+  std::shared_ptr<BatchCroppedImageParaT> image_handle;  // resized crops
+  std::shared_ptr<ResultT> tran_data;  // results sent to next engine
+  std::chrono::steady_clock::time_point arrive_time;
+  uint32_t next_crop;  // first crop not put into a batch yet
+  uint32_t done_crops;  // crops whose batch has been inferred
+};
+
+// one input of a batch: a crop and the frame it belongs to
+template<class ResultT>
+struct BatchSlotT {
+  std::shared_ptr<PendingFrameT<ResultT> > frame;
+  uint32_t crop_index;
+
+  const ObjectImageParaT& GetImage() const {
+    return frame->image_handle->obj_imgs[crop_index];
+  }
+};
+
+/**
+ * Collects the crops of frames from all channels into model batches. A batch
+ * runs once it is full or once its oldest crop has waited timeout_ms, the
+ * results go back to the frames and every frame is sent in arrival order
+ * when all its crops are inferred.
+ */
+template<class ResultT>
+class CrossFrameBatcher {
+ public:
+  typedef std::vector<BatchSlotT<ResultT> > BatchSlots;
+
+  // runs the model on a batch and adds the results to the frames of slots
+  typedef std::function<bool(const BatchSlots&)> InferFunc;
+
+  // sends a frame whose crops are all inferred to the next engine
+  typedef std::function<void(const std::shared_ptr<ResultT>&)> SendFunc;
+
+  CrossFrameBatcher()
+      : batch_size_(1),
+        timeout_ms_(0),
+        pending_crops_(0),
+        is_sending_(false),
+        is_running_(false) {
+  }
+
+  ~CrossFrameBatcher() {
+    Stop();
+  }
+
+  /**
+   * @brief set the batch parameters and start the deadline thread
+   * @param [in] batch_size: batch size of the model
+   * @param [in] timeout_ms: maximum wait for a batch to fill up, 0 means
+   *        the crops of a frame never wait for other frames
+   * @param [in] infer: runs the model on a batch
+   * @param [in] send: sends the results of a frame
+   */
+  void Init(int batch_size, int timeout_ms, const InferFunc &infer,
+            const SendFunc &send) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_size_ = batch_size > 0 ? batch_size : 1;
+    timeout_ms_ = timeout_ms;
+    infer_ = infer;
+    send_ = send;
+    if ((timeout_ms_ > 0) && !is_running_) {
+      is_running_ = true;
+      flush_thread_ = std::thread(&CrossFrameBatcher::FlushThread, this);
+    }
+  }
+
+  /**
+   * @brief queue the crops of a frame and run every full batch
+   * @param [in] image_handle: resized crops of the frame, not empty
+   * @param [in] tran_data: results of the frame, sent when complete
+   */
+  void AddFrame(const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
+                const std::shared_ptr<ResultT> &tran_data) {
+    std::shared_ptr<PendingFrameT<ResultT> > frame = std::make_shared<
+        PendingFrameT<ResultT> >();
+    frame->image_handle = image_handle;
+    frame->tran_data = tran_data;
+    frame->arrive_time = std::chrono::steady_clock::now();
+    frame->next_crop = 0;
+    frame->done_crops = 0;
+
+    bool is_drain = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      frames_.push_back(frame);
+      pending_crops_ += image_handle->obj_imgs.size();
+      is_drain = (timeout_ms_ <= 0);
+    }
+    RunBatches(is_drain);
+  }
+
+  /**
+   * @brief run the queued crops in partial batches and send all frames, used
+   *        before a finished flag is passed on
+   */
+  void Flush() {
+    RunBatches(true);
+
+    // batches taken by the deadline thread are inferred and sent by it
+    std::unique_lock<std::mutex> lock(mutex_);
+    sent_cond_.wait(lock, [this]() {
+      return frames_.empty() && ready_.empty() && !is_sending_;
+    });
+  }
+
+  /**
+   * @brief stop the deadline thread, queued crops are dropped and counted
+   */
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_running_ = false;
+    }
+    deadline_cond_.notify_all();
+    if (flush_thread_.joinable()) {
+      flush_thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!frames_.empty()) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                      "[CrossFrameBatcher] stopped, %zu frames with %zu "
+                      "crops not inferred are dropped", frames_.size(),
+                      pending_crops_);
+      frames_.clear();
+      ready_.clear();
+      pending_crops_ = 0;
+    }
+  }
+
+ private:
+  /**
+   * @brief run the full batches, and the partial ones too when is_drain,
+   *        then send the complete frames
+   * @param [in] is_drain: run every queued crop
+   */
+  void RunBatches(bool is_drain) {
+    while (true) {
+      BatchSlots slots;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if ((pending_crops_ == 0)
+            || (!is_drain && (pending_crops_ < batch_size_))) {
+          break;
+        }
+        TakeBatch(slots);
+      }
+      RunBatch(slots);
+    }
+
+    SendReady();
+  }
+
+  /**
+   * @brief take the oldest queued crops as one batch, the caller holds
+   *        mutex_
+   * @param [out] slots: crops of the batch
+   */
+  void TakeBatch(BatchSlots &slots) {
+    for (typename std::deque<std::shared_ptr<PendingFrameT<ResultT> > >::
+        iterator iter = frames_.begin();
+        (iter != frames_.end()) && (slots.size() < batch_size_); ++iter) {
+      PendingFrameT<ResultT> &frame = **iter;
+      while ((frame.next_crop < frame.image_handle->obj_imgs.size())
+          && (slots.size() < batch_size_)) {
+        BatchSlotT<ResultT> slot;
+        slot.frame = *iter;
+        slot.crop_index = frame.next_crop++;
+        slots.push_back(slot);
+      }
+    }
+
+    pending_crops_ -= slots.size();
+  }
+
+  /**
+   * @brief infer a batch without mutex_, so new frames are queued meanwhile,
+   *        and queue the frames that are complete for SendReady
+   * @param [in] slots: crops of the batch
+   */
+  void RunBatch(const BatchSlots &slots) {
+    {
+      // the model and its buffers serve one batch at a time
+      std::lock_guard<std::mutex> infer_lock(infer_mutex_);
+
+      // a failed batch leaves its crops without results, the frames still go
+      if (!infer_(slots)) {
+        HIAI_ENGINE_LOG("[CrossFrameBatcher] inference of %zu crops failed",
+                        slots.size());
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < slots.size(); ++i) {
+      ++slots[i].frame->done_crops;
+    }
+
+    // frames leave in arrival order, a frame waits for the older ones
+    while (!frames_.empty()
+        && (frames_.front()->done_crops
+            == frames_.front()->image_handle->obj_imgs.size())) {
+      ready_.push_back(frames_.front()->tran_data);
+      frames_.pop_front();
+    }
+  }
+
+  /**
+   * @brief send the complete frames without mutex_, since sending may wait
+   *        for the next engine. One thread sends at a time to keep the
+   *        order, the others leave their frames to it
+   */
+  void SendReady() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (is_sending_) {
+      return;
+    }
+
+    is_sending_ = true;
+    while (!ready_.empty()) {
+      std::shared_ptr<ResultT> tran_data = ready_.front();
+      ready_.pop_front();
+      lock.unlock();
+      send_(tran_data);
+      lock.lock();
+    }
+    is_sending_ = false;
+    sent_cond_.notify_all();
+  }
+
+  /**
+   * @brief run a partial batch once its oldest crop reaches the deadline
+   */
+  void FlushThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (is_running_) {
+      std::chrono::milliseconds timeout(timeout_ms_);
+      std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      std::chrono::steady_clock::time_point deadline = now + timeout;
+      for (size_t i = 0; i < frames_.size(); ++i) {
+        const PendingFrameT<ResultT> &frame = *frames_[i];
+        if (frame.next_crop < frame.image_handle->obj_imgs.size()) {
+          deadline = frame.arrive_time + timeout;
+          break;
+        }
+      }
+
+      if ((pending_crops_ > 0) && (now >= deadline)) {
+        BatchSlots slots;
+        TakeBatch(slots);
+        lock.unlock();
+        RunBatch(slots);
+        SendReady();
+        lock.lock();
+        continue;
+      }
+
+      deadline_cond_.wait_until(lock, deadline);
+    }
+  }
+
+  size_t batch_size_;
+  int timeout_ms_;
+  InferFunc infer_;
+  SendFunc send_;
+
+  // frames in arrival order, until all their crops are inferred
+  std::deque<std::shared_ptr<PendingFrameT<ResultT> > > frames_;
+
+  // crops of frames_ not put into a batch yet
+  size_t pending_crops_;
+
+  // complete frames in arrival order, until SendReady sends them
+  std::deque<std::shared_ptr<ResultT> > ready_;
+
+  // a thread is in SendReady
+  bool is_sending_;
+
+  bool is_running_;
+  std::mutex mutex_;
+  std::mutex infer_mutex_;
+  std::condition_variable deadline_cond_;
+  std::condition_variable sent_cond_;
+  std::thread flush_thread_;
+};
+
+#endif /* COMMON_INCLUDE_CROSS_FRAME_BATCHER_H */
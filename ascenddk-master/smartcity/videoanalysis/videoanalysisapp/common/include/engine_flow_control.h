@@ -0,0 +1,149 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef COMMON_INCLUDE_ENGINE_FLOW_CONTROL_H
+#define COMMON_INCLUDE_ENGINE_FLOW_CONTROL_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "hiaiengine/engine.h"
+#include "ascenddk/ascend_utils/flow_credit.h"
+#include "ascenddk/ascend_utils/latency_trace.h"
+
+// engine names in the graph, also the names of their input credits
+const std::string kObjectDetectionEngine = "object_detection";
+const std::string kObjectDetectionPostEngine = "object_detection_post";
+const std::string kCarTypeInferenceEngine = "car_type_inference";
+const std::string kCarColorInferenceEngine = "car_color_inference";
+const std::string kPedestrianAttrInferenceEngine =
+    "pedestrian_attr_inference";
+const std::string kVideoAnalysisPostEngine = "video_analysis_post";
+
+// data an engine may have queued, below the hiai queue size of an engine
+const int kEngineInputCredits = 16;
+
+// maximum wait for a credit, then the data is sent without one
+const int kCreditTimeoutMs = 5000;
+
+// maximum wait for the receiver after HIAI_QUEUE_FULL, the receiver may run
+// in another process and never signal
+const int kQueueFullWaitMs = 10;
+
+/**
+ * @brief set the input credits of an engine, called in its Init
+ * @param [in] engine_name: engine name
+ */
+inline void InitInputCredits(const std::string &engine_name) {
+  ascend::utils::FlowCredit::GetFlowCredit(engine_name)->SetCapacity(
+      kEngineInputCredits);
+}
+
+/**
+ * @brief return the credits of the data an engine takes in Process, called
+ *        first in Process
+ * @param [in] engine_name: engine name
+ * @param [in] data_num: number of input data of this Process call
+ */
+inline void ReleaseInputCredits(const std::string &engine_name,
+                                int data_num = 1) {
+  std::shared_ptr<ascend::utils::FlowCredit> credit =
+      ascend::utils::FlowCredit::GetFlowCredit(engine_name);
+  for (int i = 0; i < data_num; ++i) {
+    credit->Release();
+  }
+}
+
+/**
+ * @brief get the data queued to an engine for its profile
+ * @param [in] engine_name: engine name
+ * @return credits taken, -1: the engine profile is not started
+ */
+inline int GetProfileQueueDepth(const std::string &engine_name) {
+  if (!ascend::utils::IsEngineProfileStarted()) {
+    return -1;
+  }
+
+  return ascend::utils::FlowCredit::GetFlowCredit(engine_name)->GetInFlight();
+}
+
+// profiles the rest of Process as a call of the engine, with the credits
+// taken for it as its queue depth. Used first in Process, before the input
+// credits are released
+#define PROFILE_ENGINE_PROCESS_WITH_CREDIT(engine_name) \
+  ENGINE_PROFILE_PROCESS(engine_name, GetProfileQueueDepth(engine_name))
+
+/**
+ * @brief send data to the next engine once it has a free credit, and wait
+ *        for the next engine to take data while its queue is full
+ * @param [in] receiver: name of the next engine
+ * @param [in] send_data: calls SendData of the engine
+ * @param [out] is_blocked: set to true if the next engine was full, may be
+ *        nullptr
+ * @return result of SendData, never HIAI_QUEUE_FULL
+ */
+inline HIAI_StatusT SendDataWithCredit(
+    const std::string &receiver, const std::function<HIAI_StatusT()> &send_data,
+    bool *is_blocked = nullptr) {
+  std::shared_ptr<ascend::utils::FlowCredit> credit =
+      ascend::utils::FlowCredit::GetFlowCredit(receiver);
+  int64_t start_ns = ascend::utils::GetMonotonicTimeNs();
+  bool has_credit = credit->Acquire(kCreditTimeoutMs, is_blocked);
+  int64_t blocked_ns = ascend::utils::GetMonotonicTimeNs() - start_ns;
+
+  bool is_queue_full = false;
+  HIAI_StatusT hiai_ret = send_data();
+  while (hiai_ret == HIAI_QUEUE_FULL) {
+    is_queue_full = true;
+    if (is_blocked != nullptr) {
+      *is_blocked = true;
+    }
+
+    int64_t wait_ns = ascend::utils::GetMonotonicTimeNs();
+    credit->WaitRelease(kQueueFullWaitMs);
+    blocked_ns += ascend::utils::GetMonotonicTimeNs() - wait_ns;
+    hiai_ret = send_data();
+  }
+
+  // the receiver never gets the data, so it never returns the credit
+  if ((hiai_ret != HIAI_OK) && has_credit) {
+    credit->Release();
+  }
+
+  ascend::utils::RecordEngineSend(receiver, blocked_ns, is_queue_full,
+                                  hiai_ret != HIAI_OK);
+  return hiai_ret;
+}
+
+#endif /* COMMON_INCLUDE_ENGINE_FLOW_CONTROL_H */
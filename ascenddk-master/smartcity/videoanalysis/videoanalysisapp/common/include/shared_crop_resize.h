@@ -0,0 +1,65 @@
+/**
+ * ============================================================================
+ *
+ * Copyright (C) 2018, Hisilicon Technologies Co., Ltd. All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1 Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *   2 Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ *   3 Neither the names of the copyright holders nor the names of the
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ * ============================================================================
+ */
+
+#ifndef COMMON_INCLUDE_SHARED_CROP_RESIZE_H
+#define COMMON_INCLUDE_SHARED_CROP_RESIZE_H
+
+#include <sstream>
+#include <string>
+
+#include "ascenddk/ascend_utils/shared_image_cache.h"
+#include "video_analysis_params.h"
+
+// cache of the crops resized by the car type and car color engines, a car
+// is resized once for both models
+const std::string kCarResizeCache = "car_attribute_resize";
+
+/**
+ * @brief get the cache key of a crop resized to a size, the object id of a
+ *        crop is unique in its frame
+ * @param [in] video_image_info: frame of the crop
+ * @param [in] object_info: object of the crop
+ * @param [in] width: resized width
+ * @param [in] height: resized height
+ * @return cache key
+ */
+inline std::string GetResizeKey(const VideoImageInfoT &video_image_info,
+                                const ObjectInfoT &object_info, int width,
+                                int height) {
+  std::stringstream ss;
+  ss << video_image_info.channel_id << "/" << video_image_info.frame_id << "/"
+     << object_info.object_id << "/" << width << "x" << height;
+  return ss.str();
+}
+
+#endif /* COMMON_INCLUDE_SHARED_CROP_RESIZE_H */
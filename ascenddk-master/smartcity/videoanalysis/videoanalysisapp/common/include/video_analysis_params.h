@@ -36,6 +36,7 @@
 
 #include "hiaiengine/data_type.h"
 #include "hiaiengine/data_type_reg.h"
+#include "ascenddk/ascend_utils/latency_trace.h"
 
 using hiai::ImageData;
 using hiai::IMAGEFORMAT;
@@ -45,19 +46,26 @@ struct VideoImageInfoT {
   uint32_t frame_id;
   std::string channel_name;
   bool is_finished;
+  // monotonic time the frame is decoded in nanosecond
+  int64_t capture_time_ns = 0;
+  // engines the frame has passed, stamped by every engine before sending
+  std::vector<ascend::utils::TraceStamp> trace;
 
   VideoImageInfoT& operator=(VideoImageInfoT& value) {
     channel_id = value.channel_id;
     frame_id = value.frame_id;
     channel_name = value.channel_name;
     is_finished = value.is_finished;
+    capture_time_ns = value.capture_time_ns;
+    trace = value.trace;
     return *this;
   }
 };
 
 template <class Archive>
 void serialize(Archive& ar, VideoImageInfoT& data) {
-  ar(data.channel_id, data.frame_id, data.channel_name, data.is_finished);
+  ar(data.channel_id, data.frame_id, data.channel_name, data.is_finished,
+     data.capture_time_ns, data.trace);
 }
 
 struct VideoImageParaT {
@@ -73,11 +81,18 @@ void serialize(Archive& ar, VideoImageParaT& data) {
 struct ObjectInfoT {
   std::string object_id;
   float score;
+  // false: attribute engines skip the object in this frame, the results of
+  // its track from an earlier frame are reused
+  bool is_attr_inferred = true;
+  // attribute engines resizing the crop to the same size, they share one
+  // resize of it
+  uint32_t resize_share_num = 1;
 };
 
 template <class Archive>
 void serialize(Archive& ar, ObjectInfoT& data) {
-  ar(data.object_id, data.score);
+  ar(data.object_id, data.score, data.is_attr_inferred,
+     data.resize_share_num);
 }
 
 struct ObjectImageParaT {
@@ -93,11 +108,14 @@ void serialize(Archive& ar, ObjectImageParaT& data) {
 struct VideoDetectionImageParaT {
   VideoImageParaT image;
   std::vector<ObjectImageParaT> obj_imgs;
+  // attribute engines the crops of the frame are sent to, each of them
+  // sends one batch of results for the frame
+  uint32_t attr_batch_num = 0;
 };
 
 template <class Archive>
 void serialize(Archive& ar, VideoDetectionImageParaT& data) {
-  ar(data.image, data.obj_imgs);
+  ar(data.image, data.obj_imgs, data.attr_batch_num);
 }
 
 struct BatchCroppedImageParaT {
@@ -38,6 +38,7 @@
 #include <sstream>
 #include "ascenddk/ascend_ezdvpp/dvpp_data_type.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "engine_flow_control.h"
 
 using ascend::utils::DvppCropOrResizePara;
 using ascend::utils::DvppOutput;
@@ -56,9 +57,11 @@ const uint32_t kInputWidth = 512;
 const uint32_t kInputHeight = 512;
 
 const int kDvppProcSuccess = 0;     // call dvpp success return.
-const int kSleepMicroSecs = 20000;  // waiting time after queue is full.
 
 const string kModelPath = "model_path";
+
+// stage name in the latency trace of a frame
+const string kTraceStage = "object_detection";
 }  // namespace
 
 HIAI_REGISTER_DATA_TYPE("VideoImageInfoT", VideoImageInfoT);
@@ -70,6 +73,7 @@ HIAI_StatusT ObjectDetectionInferenceEngine::Init(
     const hiai::AIConfig& config,
     const vector<hiai::AIModelDescription>& model_desc) {
   HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODInferenceEngine] start to initialize!");
+  InitInputCredits(kObjectDetectionEngine);
 
   if (ai_model_manager_ == nullptr) {
     ai_model_manager_ = make_shared<hiai::AIModelManager>();
@@ -219,16 +223,15 @@ HIAI_StatusT ObjectDetectionInferenceEngine::SendDetectionResult(
     detection_trans->status = false;
     detection_trans->msg = err_msg;
   }
-  HIAI_StatusT ret;
-  do {
-    // send data to next engine.
-    ret = SendData(kOutputPort, "DetectionEngineTransT",
-                   static_pointer_cast<void>(detection_trans));
-    if (ret == HIAI_QUEUE_FULL) {
-      HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODInferenceEngine] output queue full");
-      usleep(kSleepMicroSecs);
-    }
-  } while (ret == HIAI_QUEUE_FULL);
+  if (!detection_trans->video_image.video_image_info.is_finished) {
+    ascend::utils::ExitTraceStage(
+        detection_trans->video_image.video_image_info.trace);
+  }
+  // send data to next engine.
+  HIAI_StatusT ret = SendDataWithCredit(kObjectDetectionPostEngine, [&]() {
+    return SendData(kOutputPort, "DetectionEngineTransT",
+                    static_pointer_cast<void>(detection_trans));
+  });
   if (ret != HIAI_OK) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "[ODInferenceEngine] send inference data failed!");
@@ -239,6 +242,7 @@ HIAI_StatusT ObjectDetectionInferenceEngine::SendDetectionResult(
 
 HIAI_IMPL_ENGINE_PROCESS("object_detection", ObjectDetectionInferenceEngine,
                          INPUT_SIZE) {
+  PROFILE_ENGINE_PROCESS_WITH_CREDIT(kObjectDetectionEngine);
   HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODInferenceEngine] start process!");
 
   if (arg0 == nullptr) {
@@ -247,6 +251,7 @@ HIAI_IMPL_ENGINE_PROCESS("object_detection", ObjectDetectionInferenceEngine,
                     "[ODInferenceEngine] input data is null!");
     return HIAI_ERROR;
   }
+  ReleaseInputCredits(kObjectDetectionEngine);
   shared_ptr<VideoImageParaT> video_image =
       static_pointer_cast<VideoImageParaT>(arg0);
 
@@ -261,6 +266,8 @@ HIAI_IMPL_ENGINE_PROCESS("object_detection", ObjectDetectionInferenceEngine,
                     "[ODInferenceEngine] input video finished!");
     return SendDetectionResult(detection_trans);
   }
+  ascend::utils::EnterTraceStage(
+      detection_trans->video_image.video_image_info.trace, kTraceStage);
 
   // resize input image.
   ImageData<u_int8_t> resized_img;
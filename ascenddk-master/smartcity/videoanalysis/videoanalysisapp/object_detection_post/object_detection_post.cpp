@@ -36,6 +36,7 @@
 #include <sstream>
 #include "ascenddk/ascend_ezdvpp/dvpp_data_type.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "engine_flow_control.h"
 using namespace std;
 
 namespace {
@@ -47,7 +48,8 @@ const uint32_t kLabelPerson = 1;
 const uint32_t kLabelBus = 6;
 const uint32_t kLabelCar = 3;
 
-const uint32_t kSizePerResultset = 7;
+// labels kept by the detection filter
+const vector<int32_t> kObjectLabels = { kLabelPerson, kLabelBus, kLabelCar };
 
 // valid confidence value
 const float kMinConfidence = 0.0f;
@@ -69,8 +71,12 @@ const uint32_t kPortCarType = 1;
 const uint32_t kPortCarColor = 2;
 const uint32_t kPortPedestrian = 3;
 
+// next engine of every output port
+const string kPortEngines[] = { kVideoAnalysisPostEngine,
+    kCarTypeInferenceEngine, kCarColorInferenceEngine,
+    kPedestrianAttrInferenceEngine };
+
 const int kDvppProcSuccess = 0;
-const int kSleepMicroSecs = 20000;
 const int kInferenceVectorSize = 2;
 const int kInferenceOutputNum = 1;
 const int kInferenceOutputBBox = 0;
@@ -79,23 +85,40 @@ const string kPrefixCar = "car_";
 const string kPrefixBus = "bus_";
 const string kPrefixPerson = "person_";
 
+// tracking config items
+const string kAttrRefreshItemName = "attr_refresh_interval";
+const string kTrackIouItemName = "track_iou_threshold";
+const string kTrackMaxMissedItemName = "track_max_missed";
+
+// maximum attr_refresh_interval and track_max_missed
+const int kMaxAttrRefreshInterval = 1000;
+const int kMaxTrackMissed = 100;
+
+// detection filter config items
+const string kNmsThresholdItemName = "nms_threshold";
+const string kTopKItemName = "top_k";
+
+// maximum top_k, the SSD output has at most 200 detections
+const int kMaxTopK = 200;
+
+// number of jpeg encode threads, jpeg encode pool allows 1 to 16
+const string kJpegWorkerNumItemName = "jpeg_encode_worker_num";
+const int kMaxJpegWorkerNum = 16;
+
 // function of dvpp returns success
 const int kDvppOperationOk = 0;
 
-// infernece output data index
-enum BBoxDataIndex {
-  kAttribute = 1,
-  kScore,
-  kTopLeftX,
-  kTopLeftY,
-  kLowerRightX,
-  kLowerRightY,
-};
+// stage name in the latency trace of a frame
+const string kTraceStage = "object_detection_post";
 }  // namespace
 
+using ascend::utils::DetectionBox;
+using ascend::utils::DetectionFilter;
 using ascend::utils::DvppCropOrResizePara;
 using ascend::utils::DvppOutput;
 using ascend::utils::DvppProcess;
+using ascend::utils::JpegEncodePool;
+using ascend::utils::JpegEncodeTask;
 using hiai::ImageData;
 using namespace std;
 
@@ -113,6 +136,7 @@ HIAI_StatusT ObjectDetectionPostProcess::Init(
     const hiai::AIConfig& config,
     const vector<hiai::AIModelDescription>& model_desc) {
   HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODPostProcess] start to initialize!");
+  InitInputCredits(kObjectDetectionPostEngine);
 
   for (int index = 0; index < config.items_size(); ++index) {
     const ::hiai::AIConfigItem& item = config.items(index);
@@ -125,8 +149,41 @@ HIAI_StatusT ObjectDetectionPostProcess::Init(
                         value.c_str());
         return HIAI_ERROR;
       }
+    } else if (name == kJpegWorkerNumItemName) {
+      istringstream iss(value);
+      int worker_num = 0;
+      iss >> worker_num;
+      if (iss.fail() || worker_num < 1 || worker_num > kMaxJpegWorkerNum) {
+        HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                        "[ODPostProcess] %s value %s is invalid!",
+                        name.c_str(), value.c_str());
+        return HIAI_ERROR;
+      }
+      jpeg_encode_para_.worker_num = worker_num;
+    } else if (!InitTrackConfig(name, value) ||
+               !InitFilterConfig(name, value)) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                      "[ODPostProcess] %s value %s is invalid!", name.c_str(),
+                      value.c_str());
+      return HIAI_ERROR;
     }
   }
+
+  filter_para_.score_threshold = confidence_;
+  detection_filter_ = DetectionFilter(filter_para_);
+
+  // use dvpp convert yuv to jpg image, level should set fixed value 100,
+  // the images are aligned
+  jpeg_encode_para_.format = JPGENC_FORMAT_NV12;
+  jpeg_encode_para_.level = 100;
+  jpeg_encode_para_.is_align_image = true;
+  jpeg_encode_pool_.reset(new (nothrow) JpegEncodePool(jpeg_encode_para_));
+  if (jpeg_encode_pool_ == nullptr ||
+      jpeg_encode_pool_->Init() != kDvppOperationOk) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "[ODPostProcess] failed to start jpeg encode pool!");
+    return HIAI_ERROR;
+  }
   return HIAI_OK;
 }
 
@@ -181,79 +238,111 @@ HIAI_StatusT ObjectDetectionPostProcess::CropObjectFromImage(
 }
 
 void ObjectDetectionPostProcess::FilterBoundingBox(
-    float* bbox_buffer, int32_t bbox_buffer_size,
+    float* bbox_buffer, int32_t bbox_num,
     shared_ptr<VideoDetectionImageParaT>& detection_image,
     vector<ObjectImageParaT>& car_type_imgs,
     vector<ObjectImageParaT>& car_color_imgs,
     vector<ObjectImageParaT>& person_imgs) {
-  float* ptr = bbox_buffer;
-  int32_t num_car = 0;
-  int32_t num_bus = 0;
-  int32_t num_person = 0;
+  // overlapping boxes of one object are suppressed before they are cropped
+  vector<DetectionBox> boxes;
+  detection_filter_.Filter(bbox_buffer, bbox_num > 0 ? bbox_num : 0,
+                           kObjectLabels, boxes);
+
+  vector<ascend::utils::TrackDetection> detections;
+  vector<float> scores;
 
   uint32_t base_width = detection_image->image.img.width;
   uint32_t base_height = detection_image->image.img.height;
 
-  for (int32_t k = 0; k < bbox_buffer_size; k += kSizePerResultset) {
-    ptr = bbox_buffer + k;
-    int32_t attr = static_cast<int32_t>(ptr[BBoxDataIndex::kAttribute]);
-    float score = ptr[BBoxDataIndex::kScore];
+  for (size_t k = 0; k < boxes.size(); ++k) {
+    uint32_t lt_x = boxes[k].lt_x * base_width,
+             lt_y = boxes[k].lt_y * base_height,
+             rb_x = boxes[k].rb_x * base_width,
+             rb_y = boxes[k].rb_y * base_height;
 
-    if (score < confidence_ ||
-        (attr != kLabelCar && attr != kLabelBus && attr != kLabelPerson)) {
+    if (rb_x < lt_x + kMinCropPixel || rb_y < lt_y + kMinCropPixel) {
       continue;
     }
 
-    // bbox coordinate should between 0.0f and 1.0f
-    uint32_t lt_x =
-                 CorrectCoordinate(ptr[BBoxDataIndex::kTopLeftX]) * base_width,
-             lt_y =
-                 CorrectCoordinate(ptr[BBoxDataIndex::kTopLeftY]) * base_height,
-             rb_x = CorrectCoordinate(ptr[BBoxDataIndex::kLowerRightX]) *
-                    base_width,
-             rb_y = CorrectCoordinate(ptr[BBoxDataIndex::kLowerRightY]) *
-                    base_height;
-
-    if (rb_x - lt_x < kMinCropPixel || rb_y - lt_x < kMinCropPixel) {
-      continue;
-    }
+    ascend::utils::TrackDetection detection;
+    detection.box.lt_x = lt_x;
+    detection.box.lt_y = lt_y;
+    detection.box.rb_x = rb_x;
+    detection.box.rb_y = rb_y;
+    detection.label = boxes[k].label;
+    detections.push_back(detection);
+    scores.push_back(boxes[k].score);
+  }
+
+  // the same object keeps its track id in the following frames
+  const string& channel_id = detection_image->image.video_image_info.channel_id;
+  unordered_map<string, ascend::utils::ObjectTracker>::iterator tracker =
+      trackers_.find(channel_id);
+  if (tracker == trackers_.end()) {
+    tracker = trackers_.emplace(
+        channel_id, ascend::utils::ObjectTracker(tracker_para_)).first;
+  }
+  vector<ascend::utils::TrackResult> tracks;
+  tracker->second.Update(detections, tracks);
+
+  for (size_t k = 0; k < detections.size(); ++k) {
     // crop image
     ObjectImageParaT object_image;
-    BoundingBox bbox = {lt_x, lt_y, rb_x, rb_y};
+    const ascend::utils::TrackBox& box = detections[k].box;
+    BoundingBox bbox = {static_cast<uint32_t>(box.lt_x),
+                        static_cast<uint32_t>(box.lt_y),
+                        static_cast<uint32_t>(box.rb_x),
+                        static_cast<uint32_t>(box.rb_y)};
     HIAI_StatusT crop_ret =
         CropObjectFromImage(detection_image->image.img, object_image.img, bbox);
     if (crop_ret != HIAI_OK) {
       continue;
     }
 
-    object_image.object_info.score = score;
+    // attributes hardly change along a track, infer them for new tracks
+    // and then once every attr_refresh_interval_ frames
+    bool is_attr_inferred =
+        (tracks[k].hits - 1) % attr_refresh_interval_ == 0;
+    object_image.object_info.score = scores[k];
+    object_image.object_info.is_attr_inferred = is_attr_inferred;
+    int32_t attr = detections[k].label;
+    stringstream ss;
     if (attr == kLabelCar) {
-      ++num_car;
-      stringstream ss;
-      ss << kPrefixCar << num_car;
+      ss << kPrefixCar << tracks[k].track_id;
       object_image.object_info.object_id = ss.str();
-      car_type_imgs.push_back(object_image);
-      car_color_imgs.push_back(object_image);
+      if (is_attr_inferred) {
+        // both engines resize the car to one size, only one of them does
+        object_image.object_info.resize_share_num = 2;
+        car_type_imgs.push_back(object_image);
+        car_color_imgs.push_back(object_image);
+      }
 
     } else if (attr == kLabelBus) {
-      ++num_bus;
-      stringstream ss;
-      ss << kPrefixBus << num_bus;
+      ss << kPrefixBus << tracks[k].track_id;
       object_image.object_info.object_id = ss.str();
-      car_color_imgs.push_back(object_image);
+      if (is_attr_inferred) {
+        car_color_imgs.push_back(object_image);
+      }
 
     } else if (attr == kLabelPerson) {
-      ++num_person;
-      stringstream ss;
-      ss << kPrefixPerson << num_person;
+      ss << kPrefixPerson << tracks[k].track_id;
       object_image.object_info.object_id = ss.str();
-      person_imgs.push_back(object_image);
+      if (is_attr_inferred) {
+        person_imgs.push_back(object_image);
+      }
     }
     detection_image->obj_imgs.push_back(object_image);
   }
 }
+
 HIAI_StatusT ObjectDetectionPostProcess::HandleResults(
     const shared_ptr<DetectionEngineTransT>& inference_result) {
+  // the stage is copied into every output of the frame
+  if (!inference_result->video_image.video_image_info.is_finished) {
+    ascend::utils::EnterTraceStage(
+        inference_result->video_image.video_image_info.trace, kTraceStage);
+  }
+
   shared_ptr<VideoDetectionImageParaT> detection_image =
       make_shared<VideoDetectionImageParaT>();
 
@@ -262,6 +351,7 @@ HIAI_StatusT ObjectDetectionPostProcess::HandleResults(
   // send finished datas to all output port.
   if (inference_result->video_image.video_image_info.is_finished) {
     HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODPostProcess] input video finished");
+    trackers_.erase(inference_result->video_image.video_image_info.channel_id);
     SendResults(kPortPost, "VideoDetectionImageParaT",
                 static_pointer_cast<void>(detection_image));
 
@@ -301,13 +391,16 @@ HIAI_StatusT ObjectDetectionPostProcess::HandleResults(
 
   float* bbox_buffer = reinterpret_cast<float*>(out_bbox.data.get());
   float bbox_number = *reinterpret_cast<float*>(out_num.data.get());
-  int32_t bbox_buffer_size = bbox_number * kSizePerResultset;
   HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODPostProcess] number of bbox: %d",
                   bbox_number);
 
-  FilterBoundingBox(bbox_buffer, bbox_buffer_size, detection_image,
+  FilterBoundingBox(bbox_buffer, bbox_number, detection_image,
                     car_type_imgs, car_color_imgs, person_imgs);
 
+  // the analysis post sends the frame when these engines have sent results
+  detection_image->attr_batch_num = !car_type_imgs.empty()
+      + !car_color_imgs.empty() + !person_imgs.empty();
+
   // send_data
   HIAI_StatusT send_ret = SendDetectImage(detection_image);
   if (send_ret != HIAI_OK) {
@@ -336,6 +429,7 @@ void ObjectDetectionPostProcess::SendCroppedImages(
       make_shared<BatchCroppedImageParaT>();
   object_image->video_image_info = video_image_info;
   object_image->obj_imgs = cropped_images;
+  ascend::utils::ExitTraceStage(object_image->video_image_info.trace);
   HIAI_StatusT ret = SendResults(port_id, "BatchCroppedImageParaT",
                                  static_pointer_cast<void>(object_image));
   if (ret != HIAI_OK) {
@@ -359,17 +453,62 @@ bool ObjectDetectionPostProcess::InitConfidence(const string& input) {
   return true;
 }
 
+bool ObjectDetectionPostProcess::InitTrackConfig(const string& name,
+                                                 const string& value) {
+  istringstream iss(value);
+  if (name == kAttrRefreshItemName) {
+    int interval = 0;
+    iss >> interval;
+    if (iss.fail() || interval < 1 || interval > kMaxAttrRefreshInterval) {
+      return false;
+    }
+    attr_refresh_interval_ = interval;
+  } else if (name == kTrackIouItemName) {
+    float iou_threshold = 0;
+    iss >> iou_threshold;
+    if (iss.fail() || iou_threshold <= kLowerCoord ||
+        iou_threshold > kUpperCoord) {
+      return false;
+    }
+    tracker_para_.iou_threshold = iou_threshold;
+  } else if (name == kTrackMaxMissedItemName) {
+    int max_missed = 0;
+    iss >> max_missed;
+    if (iss.fail() || max_missed < 0 || max_missed > kMaxTrackMissed) {
+      return false;
+    }
+    tracker_para_.max_missed = max_missed;
+  }
+  return true;
+}
+
+bool ObjectDetectionPostProcess::InitFilterConfig(const string& name,
+                                                  const string& value) {
+  istringstream iss(value);
+  if (name == kNmsThresholdItemName) {
+    float nms_threshold = 0;
+    iss >> nms_threshold;
+    if (iss.fail() || nms_threshold <= kLowerCoord ||
+        nms_threshold > kUpperCoord) {
+      return false;
+    }
+    filter_para_.nms_threshold = nms_threshold;
+  } else if (name == kTopKItemName) {
+    int top_k = 0;
+    iss >> top_k;
+    if (iss.fail() || top_k < 0 || top_k > kMaxTopK) {
+      return false;
+    }
+    filter_para_.top_k = top_k;
+  }
+  return true;
+}
+
 HIAI_StatusT ObjectDetectionPostProcess::SendResults(
     uint32_t port_id, string data_type, const shared_ptr<void>& data_ptr) {
-  HIAI_StatusT ret;
-  do {
-    ret = SendData(port_id, data_type, data_ptr);
-    if (ret == HIAI_QUEUE_FULL) {
-      HIAI_ENGINE_LOG(HIAI_DEBUG_INFO, "[ODPostProcess] port %d queue full.",
-                      port_id);
-      usleep(kSleepMicroSecs);
-    }
-  } while (ret == HIAI_QUEUE_FULL);
+  HIAI_StatusT ret = SendDataWithCredit(kPortEngines[port_id], [&]() {
+    return SendData(port_id, data_type, data_ptr);
+  });
   if (ret != HIAI_OK) {
     return HIAI_ERROR;
   }
@@ -378,79 +517,51 @@ HIAI_StatusT ObjectDetectionPostProcess::SendResults(
 
 HIAI_StatusT ObjectDetectionPostProcess::SendDetectImage(
     const shared_ptr<VideoDetectionImageParaT> &image_para) {
-  ascend::utils::DvppToJpgPara dvpp_to_jpg_para;
-  dvpp_to_jpg_para.format = JPGENC_FORMAT_NV12;
-
-  // use dvpp convert yuv to jpg image, level should set fixed value 100
-  dvpp_to_jpg_para.level = 100;
-  dvpp_to_jpg_para.resolution.height = image_para->image.img.height;
-  dvpp_to_jpg_para.resolution.width = image_para->image.img.width;
-
-  // true indicate the image is aligned
-  dvpp_to_jpg_para.is_align_image = true;
-  ascend::utils::DvppProcess dvpp_jpg_process(dvpp_to_jpg_para);
-  ascend::utils::DvppOutput dvpp_output = { 0 };
-
-  // use dvpp convert yuv image to jpg image
-  int ret_dvpp;
-  ret_dvpp = dvpp_jpg_process.DvppOperationProc(
-      (char*) (image_para->image.img.data.get()), image_para->image.img.size,
-      &dvpp_output);
-  if (ret_dvpp == kDvppOperationOk) {
-    image_para->image.img.data.reset(dvpp_output.buffer,
-                                     default_delete<uint8_t[]>());
-    image_para->image.img.size = dvpp_output.size;
-  } else {
+  // the frame is the first task, then every object image
+  vector<ImageData<u_int8_t>*> images;
+  images.push_back(&image_para->image.img);
+  for (vector<ObjectImageParaT>::iterator iter = image_para->obj_imgs.begin();
+      iter != image_para->obj_imgs.end(); ++iter) {
+    images.push_back(&iter->img);
+  }
+
+  vector<JpegEncodeTask> tasks(images.size());
+  for (size_t i = 0; i < images.size(); ++i) {
+    tasks[i].input_buf = (char*) (images[i]->data.get());
+    tasks[i].input_size = images[i]->size;
+    tasks[i].resolution.width = images[i]->width;
+    tasks[i].resolution.height = images[i]->height;
+  }
+
+  // use dvpp convert yuv images to jpg images
+  int ret_dvpp = jpeg_encode_pool_->Encode(tasks);
+  if (ret_dvpp != kDvppOperationOk) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "fail to convert yuv to jpg,ret_dvpp = %d", ret_dvpp);
     return HIAI_ERROR;
   }
 
-  // get small images after reasoning
-  for (vector<ObjectImageParaT>::iterator iter = image_para->obj_imgs.begin();
-      iter != image_para->obj_imgs.end(); ++iter) {
-    // use dvpp convert yuv image to jpg image
-    ascend::utils::DvppToJpgPara dvpp_to_jpg_obj_para;
-    dvpp_to_jpg_obj_para.format = JPGENC_FORMAT_NV12;
-
-    // level should set fixed value 100
-    dvpp_to_jpg_obj_para.level = 100;
-
-    // true indicate the image is aligned
-    dvpp_to_jpg_obj_para.is_align_image = true;
-    dvpp_to_jpg_obj_para.resolution.height = iter->img.height;
-    dvpp_to_jpg_obj_para.resolution.width = iter->img.width;
-    ascend::utils::DvppProcess dvpp_jpg_objprocess(dvpp_to_jpg_obj_para);
-    ascend::utils::DvppOutput obj_dvpp_output = { 0 };
-    ret_dvpp = dvpp_jpg_objprocess.DvppOperationProc(
-        (char*) (iter->img.data.get()), iter->img.size, &obj_dvpp_output);
-    if (ret_dvpp == kDvppOperationOk) {
-      iter->img.data.reset(obj_dvpp_output.buffer, default_delete<uint8_t[]>());
-      iter->img.size = obj_dvpp_output.size;
-    } else {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "fail to convert obj yuv to jpg,ret_dvpp = %d", ret_dvpp);
-      return HIAI_ERROR;
-    }
+  // the jpeg buffers go back to the pool when the post engine releases them
+  for (size_t i = 0; i < images.size(); ++i) {
+    images[i]->data = tasks[i].output;
+    images[i]->size = tasks[i].output_size;
   }
 
+  ascend::utils::ExitTraceStage(image_para->image.video_image_info.trace);
   return SendResults(kPortPost, "VideoDetectionImageParaT",
                      static_pointer_cast<void>(image_para));
 }
 
-float ObjectDetectionPostProcess::CorrectCoordinate(float value) {
-  float tmp = value < kLowerCoord ? kLowerCoord : value;
-  return tmp > kUpperCoord ? kUpperCoord : tmp;
-}
-
 HIAI_IMPL_ENGINE_PROCESS("object_detection_post", ObjectDetectionPostProcess,
                          INPUT_SIZE) {
+  PROFILE_ENGINE_PROCESS_WITH_CREDIT(kObjectDetectionPostEngine);
 
   if (arg0 == nullptr) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "[ODPostProcess] failed to PopAllData!");
     return HIAI_ERROR;
   }
+  ReleaseInputCredits(kObjectDetectionPostEngine);
   shared_ptr<DetectionEngineTransT> detection_trans =
       static_pointer_cast<DetectionEngineTransT>(arg0);
 
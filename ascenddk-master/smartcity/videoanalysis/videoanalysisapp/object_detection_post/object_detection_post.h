@@ -34,7 +34,11 @@
 #ifndef OBJECT_DETECTION_POST_OBJECT_DETECTION_POST_H_
 #define OBJECT_DETECTION_POST_OBJECT_DETECTION_POST_H_
 
+#include <memory>
 #include <unordered_map>
+#include "ascenddk/ascend_ezdvpp/jpeg_encode_pool.h"
+#include "ascenddk/ascend_utils/detection_filter.h"
+#include "ascenddk/ascend_utils/object_tracker.h"
 #include "hiaiengine/api.h"
 #include "hiaiengine/data_type.h"
 #include "hiaiengine/data_type_reg.h"
@@ -57,7 +61,9 @@ class ObjectDetectionPostProcess : public hiai::Engine {
   /**
    * @brief : constructor,init confidence_ with default value 0.9f.
    */
-  ObjectDetectionPostProcess() : confidence_(0.9f) {}
+  ObjectDetectionPostProcess()
+      : confidence_(0.9f),
+        attr_refresh_interval_(10) {}
   /**
    * @brief HIAI_DEFINE_PROCESS : default destructor.
    */
@@ -96,16 +102,19 @@ class ObjectDetectionPostProcess : public hiai::Engine {
                                    hiai::ImageData<u_int8_t>& target_img,
                                    const BoundingBox& bbox);
   /**
-   * @brief : filter bounding box from inferece results.
+   * @brief : filter bounding box from inferece results with nms, track the
+   *          boxes of the channel and crop them. objects are named by their
+   *          track, only new tracks and tracks due for a refresh go to the
+   *          attribute engines.
    * @param [in] bbox_buffer: bbox results buffer.
-   * @param [in] bbox_buffer_size: bbox buffer size.
+   * @param [in] bbox_num: number of bbox in the buffer.
    * @param [out] detection_image: detection results shared_ptr.
    * @param [out] car_type_imgs: car type imags vector.
    * @param [out] car_color_imgs: car color images vector.
    * @param [out] person_imgs: person images vector.
    */
   void FilterBoundingBox(
-      float* bbox_buffer, int32_t bbox_buffer_size,
+      float* bbox_buffer, int32_t bbox_num,
       std::shared_ptr<VideoDetectionImageParaT>& detection_image,
       vector<ObjectImageParaT>& car_type_imgs,
       vector<ObjectImageParaT>& car_color_imgs,
@@ -121,7 +130,8 @@ class ObjectDetectionPostProcess : public hiai::Engine {
                            const std::shared_ptr<void>& data_ptr);
 
    /**
-   * @brief : send image results to post port.
+   * @brief : encode the frame and its object images to jpeg concurrently
+   *          and send them to post port.
    * @param [in] image_para: output data shared ptr.
    * @return HIAI_StatusT
    */
@@ -146,13 +156,41 @@ class ObjectDetectionPostProcess : public hiai::Engine {
   bool InitConfidence(const string& input);
 
   /**
-   * @brief : correct the coordinate value between 0.0f and 1.0f.
-   * @param [in] input: coordinate value .
-   * @return value bewteen 0.0 and 1.0.
+   * @brief : read the tracking config items.
+   * @param [in] name: config item name.
+   * @param [in] value: config item value.
+   * @return true: valid or not a tracking item; false: invalid value.
    */
-  float CorrectCoordinate(float value);
+  bool InitTrackConfig(const string& name, const string& value);
+
+  /**
+   * @brief : read the detection filter config items.
+   * @param [in] name: config item name.
+   * @param [in] value: config item value.
+   * @return true: valid or not a filter item; false: invalid value.
+   */
+  bool InitFilterConfig(const string& name, const string& value);
 
   float confidence_;
+
+  // attributes of a track are inferred again every attr_refresh_interval_
+  // analyzed frames, 1: every frame
+  uint32_t attr_refresh_interval_;
+
+  ascend::utils::DetectionFilterPara filter_para_;
+
+  // score threshold, nms and top k of the detections
+  ascend::utils::DetectionFilter detection_filter_;
+
+  ascend::utils::ObjectTrackerPara tracker_para_;
+
+  // object tracker of every channel, by channel id
+  std::unordered_map<std::string, ascend::utils::ObjectTracker> trackers_;
+
+  ascend::utils::JpegEncodePoolPara jpeg_encode_para_;
+
+  // jpeg encoder of the detection images
+  std::unique_ptr<ascend::utils::JpegEncodePool> jpeg_encode_pool_;
 };
 
 #endif /* OBJECT_DETECTION_POST_OBJECT_DETECTION_POST_H_ */
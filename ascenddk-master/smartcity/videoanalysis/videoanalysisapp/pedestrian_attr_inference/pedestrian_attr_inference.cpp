@@ -45,6 +45,7 @@
 #include <hiaiengine/log.h>
 #include <hiaiengine/ai_types.h>
 #include "hiaiengine/ai_model_parser.h"
+#include "engine_flow_control.h"
 
 namespace {
 const int kDestImageWidth = 226; // the image width for model
@@ -69,6 +70,9 @@ const string kPasscodeItemName = "passcode"; // passcode string
 // the name of batch_size in the config file
 const string kBatchSizeItemName = "batch_size";
 
+// the name of batch_timeout_ms in the config file
+const string kBatchTimeoutItemName = "batch_timeout_ms";
+
 const string kAttrShortHair = "Short hair"; // the attribute: short hair
 
 const string kAttrLongHair = "Long hair"; // the attribute: long hair
@@ -86,7 +90,8 @@ const string kPedestrianAttr[kPedestrianAttrNumber] = { "Age16-30", "Age31-45",
     "Shorts", "Short Sleeve", "Skirt", "Sneaker", "Stripes", "Sunglasses",
     "Trousers", "Tshirt", "UpperOther", "V-Neck" };
 
-const int kWaitTime = 10000; // wait 10 ms when send data to Cnext engine
+// stage name in the latency trace of a frame
+const string kTraceStage = "pedestrian_attr_inference";
 }
 
 HIAI_REGISTER_DATA_TYPE("PedestrianInfoT", PedestrianInfoT);
@@ -98,6 +103,8 @@ HIAI_StatusT PedestrianAttrInference::Init(
     const hiai::AIConfig &config,
     const std::vector<hiai::AIModelDescription> &model_desc) {
   HIAI_ENGINE_LOG("Start init!");
+  InitInputCredits(kPedestrianAttrInferenceEngine);
+  int batch_timeout_ms = kDefaultBatchTimeoutMs;
 
   if (ai_model_manager_ == nullptr) { // check ai model manager is nullptr
     ai_model_manager_ = std::make_shared<hiai::AIModelManager>();
@@ -119,9 +126,19 @@ HIAI_StatusT PedestrianAttrInference::Init(
     } else if (item.name() == kBatchSizeItemName) { // get batch size
       std::stringstream ss(item.value());
       ss >> batch_size_;
+    } else if (item.name() == kBatchTimeoutItemName) { // get batch timeout
+      std::stringstream ss(item.value());
+      ss >> batch_timeout_ms;
     }
   }
 
+  // check batch timeout is valid
+  if ((batch_timeout_ms < 0) || (batch_timeout_ms > kMaxBatchTimeoutMs)) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "batch_timeout_ms should be 0~%d!", kMaxBatchTimeoutMs);
+    return HIAI_ERROR;
+  }
+
   model_desc_vec.push_back(model_description);
 
   // check ai model manager initialize result
@@ -129,6 +146,17 @@ HIAI_StatusT PedestrianAttrInference::Init(
     return HIAI_ERROR;
   }
 
+  // inference runs once a batch is full or its oldest crop timed out
+  batcher_.Init(batch_size_, batch_timeout_ms,
+                [this](const PedestrianBatchSlots &slots) {
+                  return BatchInferenceProcess(slots);
+                },
+                [this](const std::shared_ptr<BatchPedestrianInfoT> &tran_data) {
+                  ascend::utils::ExitTraceStage(
+                      tran_data->video_image_info.trace);
+                  SendResultData(tran_data);
+                });
+
   HIAI_ENGINE_LOG("End init!");
   return HIAI_OK;
 }
@@ -138,18 +166,13 @@ HIAI_StatusT PedestrianAttrInference::SendResultData(
 
   HIAI_StatusT hiai_ret = HIAI_OK;
 
-  // send result data to next engine
-  do {
-    HIAI_ENGINE_LOG("All data has send, process success!");
-
+  // send result data to next engine, wait while its queue is full
+  HIAI_ENGINE_LOG("All data has send, process success!");
+  hiai_ret = SendDataWithCredit(kVideoAnalysisPostEngine, [&]() {
     // send data to output port 0
-    hiai_ret = SendData(0, "BatchPedestrianInfoT",
-                        std::static_pointer_cast<void>(tran_data));
-    if (hiai_ret == HIAI_QUEUE_FULL) { // check queue is full
-      HIAI_ENGINE_LOG("The queue full, sleep 10ms");
-      usleep(kWaitTime);
-    }
-  } while (hiai_ret == HIAI_QUEUE_FULL); // loop while queue is full
+    return SendData(0, "BatchPedestrianInfoT",
+                    std::static_pointer_cast<void>(tran_data));
+  });
 
   if (hiai_ret != HIAI_OK) { // check send data is failed
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT, "Fail to send data!");
@@ -278,11 +301,9 @@ void PedestrianAttrInference::ExtractResults(int batch_result_index,
 
 bool PedestrianAttrInference::ConstructInferenceResult(
     const std::vector<std::shared_ptr<hiai::IAITensor>> &output_data_vec,
-    int batch_index,
-    const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-    const std::shared_ptr<BatchPedestrianInfoT> &tran_data) {
+    const PedestrianBatchSlots &slots) {
   bool is_successed = true;
-  int image_number = image_handle->obj_imgs.size();
+  int image_number = slots.size();
 
   // loop for each data in output_data_vec
   for (int n = 0; n < output_data_vec.size(); ++n) {
@@ -296,17 +317,18 @@ bool PedestrianAttrInference::ConstructInferenceResult(
     // analyze each batch result
     for (int batch_result_index = 0; batch_result_index < size;
         batch_result_index += kPedestrianAttrNumber) {
-      if (batch_index + batch_result_index / kPedestrianAttrNumber
-          < image_number) { // check current data is valid image data
+      int image_index = batch_result_index / kPedestrianAttrNumber;
+      if (image_index < image_number) { // check current data is valid image
+        const BatchSlotT<BatchPedestrianInfoT> &slot = slots[image_index];
         PedestrianInfoT out_data;
-        out_data.object_id = image_handle->obj_imgs[batch_index
-            + batch_result_index / kPedestrianAttrNumber].object_info.object_id;
+        out_data.object_id = slot.GetImage().object_info.object_id;
         out_data.attribute_name = "pedestrian";
 
         // extract appropriate results
         ExtractResults(batch_result_index, out_data, result);
 
-        tran_data->pedestrian_info.push_back(out_data);
+        // give the result back to the frame of the crop
+        slot.frame->tran_data->pedestrian_info.push_back(out_data);
       }
     }
   }
@@ -315,19 +337,17 @@ bool PedestrianAttrInference::ConstructInferenceResult(
 }
 
 bool PedestrianAttrInference::ConstructBatchBuffer(
-    int batch_index,
-    const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-    uint8_t* batch_buffer) {
+    const PedestrianBatchSlots &slots, uint8_t* batch_buffer) {
   bool is_successed = true;
-  int image_number = image_handle->obj_imgs.size();
-  int image_size = image_handle->obj_imgs[0].img.size * sizeof(uint8_t);
+  int image_number = slots.size();
+  int image_size = slots[0].GetImage().img.size * sizeof(uint8_t);
 
-  //the loop for each image
+  //the loop for each image, the crops may come from different frames
   for (int j = 0; j < batch_size_; j++) {
-    if (batch_index + j < image_number) { // check current iamge is valid
-      errno_t ret_memcpy = memcpy_s(
-          batch_buffer + j * image_size, image_size,
-          image_handle->obj_imgs[batch_index + j].img.data.get(), image_size);
+    if (j < image_number) { // check current iamge is valid
+      const ObjectImageParaT &image = slots[j].GetImage();
+      errno_t ret_memcpy = memcpy_s(batch_buffer + j * image_size, image_size,
+                                    image.img.data.get(), image.img.size);
       if (ret_memcpy != EOK) { // check memcpy_s result
         HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                         "Fail to copy image buffer!");
@@ -351,92 +371,67 @@ bool PedestrianAttrInference::ConstructBatchBuffer(
   return is_successed;
 }
 
-HIAI_StatusT PedestrianAttrInference::BatchInferenceProcess(
-    const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-    std::shared_ptr<BatchPedestrianInfoT> tran_data) {
+bool PedestrianAttrInference::BatchInferenceProcess(
+    const PedestrianBatchSlots &slots) {
   HIAI_ENGINE_LOG("Start process!");
 
-  int image_number = image_handle->obj_imgs.size();
-  int image_size = image_handle->obj_imgs[0].img.size * sizeof(uint8_t);
+  int image_size = slots[0].GetImage().img.size * sizeof(uint8_t);
   int batch_buffer_size = image_size * batch_size_;
+  std::vector<std::shared_ptr<hiai::IAITensor>> input_data_vec;
+  std::vector<std::shared_ptr<hiai::IAITensor>> output_data_vec;
 
-  // the loop for each batch ,maybe image_number greater than batch_size_
-  for (int i = 0; i < image_number; i += batch_size_) {
-    std::vector<std::shared_ptr<hiai::IAITensor>> input_data_vec;
-    std::vector<std::shared_ptr<hiai::IAITensor>> output_data_vec;
-
-    // prepare input buffer for each batch
-    if (tran_data == nullptr) {
-      tran_data = std::make_shared<BatchPedestrianInfoT>();
-    }
-
-    // apply buffer for each batch
-    uint8_t* batch_buffer = new uint8_t[batch_buffer_size];
-    // origin image information is transmitted to next Engine directly
-    tran_data->video_image_info = image_handle->video_image_info;
-
-    if (!ConstructBatchBuffer(i, image_handle, batch_buffer)) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "Fail to construct input buffer!");
+  // apply buffer for the batch
+  uint8_t* batch_buffer = new uint8_t[batch_buffer_size];
+  if (!ConstructBatchBuffer(slots, batch_buffer)) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to construct input buffer!");
 
-      delete[] batch_buffer;
-      return HIAI_ERROR;
-    }
+    delete[] batch_buffer;
+    return false;
+  }
 
-    std::shared_ptr<hiai::AINeuralNetworkBuffer> neural_buffer =
-        std::shared_ptr<hiai::AINeuralNetworkBuffer>(
-            new hiai::AINeuralNetworkBuffer());
-    neural_buffer->SetBuffer((void*) (batch_buffer), batch_buffer_size);
-    std::shared_ptr<hiai::IAITensor> input_data = std::static_pointer_cast<
-        hiai::IAITensor>(neural_buffer);
-    input_data_vec.push_back(input_data);
-
-    // Call Process, Predict
-    if (ai_model_manager_->CreateOutputTensor(input_data_vec, output_data_vec)
-        != hiai::SUCCESS) {
-      HIAI_ENGINE_RUN_ARGS_NOT_RIGHT, HIAI_ENGINE_LOG(
-          "CreateOutputTensor failed");
-
-      delete[] batch_buffer;
-      return HIAI_ERROR;
-    }
+  std::shared_ptr<hiai::AINeuralNetworkBuffer> neural_buffer =
+      std::shared_ptr<hiai::AINeuralNetworkBuffer>(
+          new hiai::AINeuralNetworkBuffer());
+  neural_buffer->SetBuffer((void*) (batch_buffer), batch_buffer_size);
+  std::shared_ptr<hiai::IAITensor> input_data = std::static_pointer_cast<
+      hiai::IAITensor>(neural_buffer);
+  input_data_vec.push_back(input_data);
+
+  // Call Process, Predict
+  if (ai_model_manager_->CreateOutputTensor(input_data_vec, output_data_vec)
+      != hiai::SUCCESS) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "CreateOutputTensor failed");
 
-    hiai::AIContext ai_context;
-    HIAI_ENGINE_LOG("Start ai_model_manager_->Process!");
-    hiai::AIStatus ret_process = ai_model_manager_->Process(ai_context,
-                                                            input_data_vec,
-                                                            output_data_vec, 0);
-    if (ret_process != hiai::SUCCESS) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "ai_model_manager Process failed");
+    delete[] batch_buffer;
+    return false;
+  }
 
-      delete[] batch_buffer;
-      return HIAI_ERROR;
-    }
+  hiai::AIContext ai_context;
+  HIAI_ENGINE_LOG("Start ai_model_manager_->Process!");
+  hiai::AIStatus ret_process = ai_model_manager_->Process(ai_context,
+                                                          input_data_vec,
+                                                          output_data_vec, 0);
+  if (ret_process != hiai::SUCCESS) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "ai_model_manager Process failed");
 
     delete[] batch_buffer;
+    return false;
+  }
 
-    // set the tran_data with the result of this batch
-    if (!ConstructInferenceResult(output_data_vec, i, image_handle,
-                                  tran_data)) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "Fail to copy batch output buffer!");
-      return HIAI_ERROR;
-    }
-
-    // send the result data
-    HIAI_StatusT ret_send_data = SendResultData(tran_data);
-    if (ret_send_data != HIAI_OK) { // check send data result
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "SendData failed! error code: %d", ret_send_data);
-    }
+  delete[] batch_buffer;
 
-    // release sources
-    tran_data = nullptr;
+  // give the result of each crop back to its frame
+  if (!ConstructInferenceResult(output_data_vec, slots)) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to copy batch output buffer!");
+    return false;
   }
 
   HIAI_ENGINE_LOG("End process!");
-  return HIAI_OK;
+  return true;
 }
 
 /**
@@ -447,6 +442,7 @@ HIAI_StatusT PedestrianAttrInference::BatchInferenceProcess(
  */
 HIAI_IMPL_ENGINE_PROCESS("pedestrian_attr_inference",
     PedestrianAttrInference, INPUT_SIZE) {
+  PROFILE_ENGINE_PROCESS_WITH_CREDIT(kPedestrianAttrInferenceEngine);
   HIAI_ENGINE_LOG("Start process!");
 
   std::shared_ptr<BatchPedestrianInfoT> tran_data = std::make_shared<
@@ -458,6 +454,7 @@ HIAI_IMPL_ENGINE_PROCESS("pedestrian_attr_inference",
   std::shared_ptr<BatchCroppedImageParaT> image_handle = std::make_shared<
       BatchCroppedImageParaT>();
 
+  ReleaseInputCredits(kPedestrianAttrInferenceEngine);
   input_que_.PushData(0, arg0); // push arg0 data to the input queue
   if (!input_que_.PopAllData(image_input)) { // get all input data
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT, "Fail to PopAllData!");
@@ -472,10 +469,15 @@ HIAI_IMPL_ENGINE_PROCESS("pedestrian_attr_inference",
 
   // check current data is contains is_finished
   if (image_input->video_image_info.is_finished == true) {
+    // frames still waiting for a batch go out before the finished flag
+    batcher_.Flush();
     tran_data->video_image_info = image_input->video_image_info;
     return SendResultData(tran_data);
   }
 
+  ascend::utils::EnterTraceStage(image_input->video_image_info.trace,
+                                 kTraceStage);
+
   // resize input image
   BatchImageResize(image_input, image_handle);
   if (image_handle->obj_imgs.empty() == true) { // check resize result
@@ -484,6 +486,8 @@ HIAI_IMPL_ENGINE_PROCESS("pedestrian_attr_inference",
     return HIAI_ERROR;
   }
 
-  // inference and send inference result
-  return BatchInferenceProcess(image_handle, tran_data);
+  // the crops join the next batch, results are sent once all are inferred
+  tran_data->video_image_info = image_handle->video_image_info;
+  batcher_.AddFrame(image_handle, tran_data);
+  return HIAI_OK;
 }
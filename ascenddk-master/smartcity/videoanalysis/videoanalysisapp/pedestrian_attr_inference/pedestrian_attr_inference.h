@@ -35,6 +35,7 @@
 #define PEDESTRIAN_ATTR_INFERENCE_H_
 
 #include "video_analysis_params.h"
+#include "cross_frame_batcher.h"
 #include "hiaiengine/api.h"
 #include "hiaiengine/ai_model_manager.h"
 #include "hiaiengine/ai_types.h"
@@ -75,6 +76,9 @@ class PedestrianAttrInference : public hiai::Engine {
 HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
 
  private:
+  typedef CrossFrameBatcher<BatchPedestrianInfoT>::BatchSlots
+      PedestrianBatchSlots;
+
   const int kDefaultBatchSize = 1; // default batch size
 
   int batch_size_; // model inference batch size
@@ -103,38 +107,30 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
       const std::shared_ptr<BatchPedestrianInfoT> &tran_data);
 
   /**
-   * @brief send result data to next engine
-   * @param [in] image_handle: the image data after resized
-   * @param [in] tran_data: the data used for transmit
-   * @return HIAI_OK: batch inference success; HIAI_ERROR:batch inference failed
+   * @brief batch inference, the crops may come from several frames
+   * @param [in] slots: the crops of the batch and their frames
+   * @return true: batch inference success; false: batch inference failed
    */
-  HIAI_StatusT BatchInferenceProcess(
-      const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-      std::shared_ptr<BatchPedestrianInfoT> tran_data);
+  bool BatchInferenceProcess(const PedestrianBatchSlots &slots);
 
   /**
-   * @brief send result data to next engine
-   * @param [in] image_handle: the image data after resized
+   * @brief construct the input buffer of a batch
+   * @param [in] slots: the crops of the batch and their frames
    * @param [in] batch_buffer: used for record image data
-   * @return HIAI_OK: batch construct success; HIAI_ERROR:batch construct failed
+   * @return true: batch construct success; false: batch construct failed
    */
-  bool ConstructBatchBuffer(
-      int i, const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-      uint8_t* batch_buffer);
+  bool ConstructBatchBuffer(const PedestrianBatchSlots &slots,
+                            uint8_t* batch_buffer);
 
   /**
-   * @brief construct inference result
+   * @brief construct inference result, add it to the frame of each crop
    * @param [in] output_data_vec: the vector used for record output data
-   * @param [in] batch_index: batch index
-   * @param [in] image_handle: the image data after resized
-   * @param [out] tran_data: the data used for transmit
-   * @return true: construct result success; HIAI_ERROR: construct result failed
+   * @param [in] slots: the crops of the batch and their frames
+   * @return true: construct result success; false: construct result failed
    */
   bool ConstructInferenceResult(
       const std::vector<std::shared_ptr<hiai::IAITensor>> &output_data_vec,
-      int batch_index,
-      const std::shared_ptr<BatchCroppedImageParaT> &image_handle,
-      const std::shared_ptr<BatchPedestrianInfoT> &tran_data);
+      const PedestrianBatchSlots &slots);
 
   /**
    * @brief extract valid pedestrian attribute confidence
@@ -144,6 +140,9 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
    */
   void ExtractResults(int batch_result_index, PedestrianInfoT &out_data,
                       float* &result);
+
+  // collects crops of several frames into one batch, destroyed first
+  CrossFrameBatcher<BatchPedestrianInfoT> batcher_;
 };
 
 #endif /* PEDESTRIAN_ATTR_INFERENCE_H_ */
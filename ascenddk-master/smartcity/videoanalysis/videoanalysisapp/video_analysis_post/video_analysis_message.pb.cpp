@@ -62,6 +62,11 @@ class HumanInferenceResultDefaultTypeInternal {
   ::google::protobuf::internal::ExplicitlyConstructed<HumanInferenceResult>
       _instance;
 } _HumanInferenceResult_default_instance_;
+class FrameAnalysisResultDefaultTypeInternal {
+ public:
+  ::google::protobuf::internal::ExplicitlyConstructed<FrameAnalysisResult>
+      _instance;
+} _FrameAnalysisResult_default_instance_;
 }  // namespace video_analysis
 }  // namespace presenter
 }  // namespace ascend
@@ -239,7 +244,31 @@ void InitDefaultsHumanInferenceResult() {
   ::google::protobuf::GoogleOnceInit(&once, &InitDefaultsHumanInferenceResultImpl);
 }
 
-::google::protobuf::Metadata file_level_metadata[8];
+void InitDefaultsFrameAnalysisResultImpl() {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+#ifdef GOOGLE_PROTOBUF_ENFORCE_UNIQUENESS
+  ::google::protobuf::internal::InitProtobufDefaultsForceUnique();
+#else
+  ::google::protobuf::internal::InitProtobufDefaults();
+#endif  // GOOGLE_PROTOBUF_ENFORCE_UNIQUENESS
+  protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsImageSet();
+  protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsCarInferenceResult();
+  protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsHumanInferenceResult();
+  {
+    void* ptr = &::ascend::presenter::video_analysis::_FrameAnalysisResult_default_instance_;
+    new (ptr) ::ascend::presenter::video_analysis::FrameAnalysisResult();
+    ::google::protobuf::internal::OnShutdownDestroyMessage(ptr);
+  }
+  ::ascend::presenter::video_analysis::FrameAnalysisResult::InitAsDefaultInstance();
+}
+
+void InitDefaultsFrameAnalysisResult() {
+  static GOOGLE_PROTOBUF_DECLARE_ONCE(once);
+  ::google::protobuf::GoogleOnceInit(&once, &InitDefaultsFrameAnalysisResultImpl);
+}
+
+::google::protobuf::Metadata file_level_metadata[9];
 const ::google::protobuf::EnumDescriptor* file_level_enum_descriptors[2];
 
 const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
@@ -307,6 +336,14 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_PROTOBUF_ATTRIBUT
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::HumanInferenceResult, frame_index_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::HumanInferenceResult, object_id_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::HumanInferenceResult, human_property_),
+  ~0u,  // no _has_bits_
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::FrameAnalysisResult, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::FrameAnalysisResult, image_set_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::FrameAnalysisResult, car_result_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(::ascend::presenter::video_analysis::FrameAnalysisResult, human_result_),
 };
 static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_PROTOBUF_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, sizeof(::ascend::presenter::video_analysis::RegisterApp)},
@@ -317,6 +354,7 @@ static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_PROT
   { 39, -1, sizeof(::ascend::presenter::video_analysis::CarInferenceResult)},
   { 49, -1, sizeof(::ascend::presenter::video_analysis::MapType)},
   { 56, -1, sizeof(::ascend::presenter::video_analysis::HumanInferenceResult)},
+  { 64, -1, sizeof(::ascend::presenter::video_analysis::FrameAnalysisResult)},
 };
 
 static ::google::protobuf::Message const * const file_default_instances[] = {
@@ -328,6 +366,7 @@ static ::google::protobuf::Message const * const file_default_instances[] = {
   reinterpret_cast<const ::google::protobuf::Message*>(&::ascend::presenter::video_analysis::_CarInferenceResult_default_instance_),
   reinterpret_cast<const ::google::protobuf::Message*>(&::ascend::presenter::video_analysis::_MapType_default_instance_),
   reinterpret_cast<const ::google::protobuf::Message*>(&::ascend::presenter::video_analysis::_HumanInferenceResult_default_instance_),
+  reinterpret_cast<const ::google::protobuf::Message*>(&::ascend::presenter::video_analysis::_FrameAnalysisResult_default_instance_),
 };
 
 void protobuf_AssignDescriptors() {
@@ -346,7 +385,7 @@ void protobuf_AssignDescriptorsOnce() {
 void protobuf_RegisterTypes(const ::std::string&) GOOGLE_PROTOBUF_ATTRIBUTE_COLD;
 void protobuf_RegisterTypes(const ::std::string&) {
   protobuf_AssignDescriptorsOnce();
-  ::google::protobuf::internal::RegisterAllTypes(file_level_metadata, 8);
+  ::google::protobuf::internal::RegisterAllTypes(file_level_metadata, 9);
 }
 
 void AddDescriptorsImpl() {
@@ -375,17 +414,23 @@ void AddDescriptorsImpl() {
       "nd.presenter.video_analysis.FrameIndex\022\021"
       "\n\tobject_id\030\002 \001(\t\022@\n\016human_property\030\003 \003("
       "\0132(.ascend.presenter.video_analysis.MapT"
-      "ype*\337\001\n\tErrorCode\022\016\n\nkErrorNone\020\000\022\032\n\026kEr"
-      "rorAppRegisterExist\020\001\022\036\n\032kErrorAppRegist"
-      "erNoStorage\020\002\022\031\n\025kErrorAppRegisterType\020\003"
-      "\022\032\n\026kErrorAppRegisterLimit\020\004\022\023\n\017kErrorAp"
-      "pDelete\020\005\022\021\n\rkErrorAppLost\020\006\022\026\n\022kErrorSt"
-      "orageLimit\020\007\022\017\n\013kErrorOther\020\010*0\n\020CarInfe"
-      "renceType\022\r\n\tkCarColor\020\000\022\r\n\tkCarBrand\020\001b"
-      "\006proto3"
+      "ype\"\351\001\n\023FrameAnalysisResult\022<\n\timage_set"
+      "\030\001 \001(\0132).ascend.presenter.video_analysis"
+      ".ImageSet\022G\n\ncar_result\030\002 \003(\01323.ascend.p"
+      "resenter.video_analysis.CarInferenceResu"
+      "lt\022K\n\014human_result\030\003 \003(\01325.ascend.presen"
+      "ter.video_analysis.HumanInferenceResult*"
+      "\337\001\n\tErrorCode\022\016\n\nkErrorNone\020\000\022\032\n\026kErrorA"
+      "ppRegisterExist\020\001\022\036\n\032kErrorAppRegisterNo"
+      "Storage\020\002\022\031\n\025kErrorAppRegisterType\020\003\022\032\n\026"
+      "kErrorAppRegisterLimit\020\004\022\023\n\017kErrorAppDel"
+      "ete\020\005\022\021\n\rkErrorAppLost\020\006\022\026\n\022kErrorStorag"
+      "eLimit\020\007\022\017\n\013kErrorOther\020\010*0\n\020CarInferenc"
+      "eType\022\r\n\tkCarColor\020\000\022\r\n\tkCarBrand\020\001b\006pro"
+      "to3"
   };
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 1207);
+      descriptor, 1443);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "video_analysis_message.proto", &protobuf_RegisterTypes);
 }
@@ -3235,6 +3280,339 @@ void HumanInferenceResult::InternalSwap(HumanInferenceResult* other) {
 }
 
 
+// ===================================================================
+
+void FrameAnalysisResult::InitAsDefaultInstance() {
+  ::ascend::presenter::video_analysis::_FrameAnalysisResult_default_instance_._instance.get_mutable()->image_set_ = const_cast< ::ascend::presenter::video_analysis::ImageSet*>(
+      ::ascend::presenter::video_analysis::ImageSet::internal_default_instance());
+}
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int FrameAnalysisResult::kImageSetFieldNumber;
+const int FrameAnalysisResult::kCarResultFieldNumber;
+const int FrameAnalysisResult::kHumanResultFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+FrameAnalysisResult::FrameAnalysisResult()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  if (GOOGLE_PREDICT_TRUE(this != internal_default_instance())) {
+    ::protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsFrameAnalysisResult();
+  }
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:ascend.presenter.video_analysis.FrameAnalysisResult)
+}
+FrameAnalysisResult::FrameAnalysisResult(const FrameAnalysisResult& from)
+  : ::google::protobuf::Message(),
+      _internal_metadata_(NULL),
+      car_result_(from.car_result_),
+      human_result_(from.human_result_),
+      _cached_size_(0) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  if (from.has_image_set()) {
+    image_set_ = new ::ascend::presenter::video_analysis::ImageSet(*from.image_set_);
+  } else {
+    image_set_ = NULL;
+  }
+  // @@protoc_insertion_point(copy_constructor:ascend.presenter.video_analysis.FrameAnalysisResult)
+}
+
+void FrameAnalysisResult::SharedCtor() {
+  image_set_ = NULL;
+  _cached_size_ = 0;
+}
+
+FrameAnalysisResult::~FrameAnalysisResult() {
+  // @@protoc_insertion_point(destructor:ascend.presenter.video_analysis.FrameAnalysisResult)
+  SharedDtor();
+}
+
+void FrameAnalysisResult::SharedDtor() {
+  if (this != internal_default_instance()) delete image_set_;
+}
+
+void FrameAnalysisResult::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* FrameAnalysisResult::descriptor() {
+  ::protobuf_video_5fanalysis_5fmessage_2eproto::protobuf_AssignDescriptorsOnce();
+  return ::protobuf_video_5fanalysis_5fmessage_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
+}
+
+const FrameAnalysisResult& FrameAnalysisResult::default_instance() {
+  ::protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsFrameAnalysisResult();
+  return *internal_default_instance();
+}
+
+FrameAnalysisResult* FrameAnalysisResult::New(::google::protobuf::Arena* arena) const {
+  FrameAnalysisResult* n = new FrameAnalysisResult;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void FrameAnalysisResult::Clear() {
+// @@protoc_insertion_point(message_clear_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  car_result_.Clear();
+  human_result_.Clear();
+  if (GetArenaNoVirtual() == NULL && image_set_ != NULL) {
+    delete image_set_;
+  }
+  image_set_ = NULL;
+  _internal_metadata_.Clear();
+}
+
+bool FrameAnalysisResult::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // .ascend.presenter.video_analysis.ImageSet image_set = 1;
+      case 1: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(10u /* 10 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessage(
+               input, mutable_image_set()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+      case 2: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessage(input, add_car_result()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+      case 3: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(26u /* 26 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessage(input, add_human_result()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, _internal_metadata_.mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:ascend.presenter.video_analysis.FrameAnalysisResult)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:ascend.presenter.video_analysis.FrameAnalysisResult)
+  return false;
+#undef DO_
+}
+
+void FrameAnalysisResult::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .ascend.presenter.video_analysis.ImageSet image_set = 1;
+  if (this->has_image_set()) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      1, *this->image_set_, output);
+  }
+
+  // repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->car_result_size()); i < n; i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      2, this->car_result(static_cast<int>(i)), output);
+  }
+
+  // repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->human_result_size()); i < n; i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      3, this->human_result(static_cast<int>(i)), output);
+  }
+
+  if ((_internal_metadata_.have_unknown_fields() &&  ::google::protobuf::internal::GetProto3PreserveUnknownsDefault())) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()), output);
+  }
+  // @@protoc_insertion_point(serialize_end:ascend.presenter.video_analysis.FrameAnalysisResult)
+}
+
+::google::protobuf::uint8* FrameAnalysisResult::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  (void)deterministic; // Unused
+  // @@protoc_insertion_point(serialize_to_array_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // .ascend.presenter.video_analysis.ImageSet image_set = 1;
+  if (this->has_image_set()) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageToArray(
+        1, *this->image_set_, deterministic, target);
+  }
+
+  // repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->car_result_size()); i < n; i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageToArray(
+        2, this->car_result(static_cast<int>(i)), deterministic, target);
+  }
+
+  // repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->human_result_size()); i < n; i++) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageToArray(
+        3, this->human_result(static_cast<int>(i)), deterministic, target);
+  }
+
+  if ((_internal_metadata_.have_unknown_fields() &&  ::google::protobuf::internal::GetProto3PreserveUnknownsDefault())) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:ascend.presenter.video_analysis.FrameAnalysisResult)
+  return target;
+}
+
+size_t FrameAnalysisResult::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  size_t total_size = 0;
+
+  if ((_internal_metadata_.have_unknown_fields() &&  ::google::protobuf::internal::GetProto3PreserveUnknownsDefault())) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        (::google::protobuf::internal::GetProto3PreserveUnknownsDefault()   ? _internal_metadata_.unknown_fields()   : _internal_metadata_.default_instance()));
+  }
+  // repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+  {
+    unsigned int count = static_cast<unsigned int>(this->car_result_size());
+    total_size += 1UL * count;
+    for (unsigned int i = 0; i < count; i++) {
+      total_size +=
+        ::google::protobuf::internal::WireFormatLite::MessageSize(
+          this->car_result(static_cast<int>(i)));
+    }
+  }
+
+  // repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+  {
+    unsigned int count = static_cast<unsigned int>(this->human_result_size());
+    total_size += 1UL * count;
+    for (unsigned int i = 0; i < count; i++) {
+      total_size +=
+        ::google::protobuf::internal::WireFormatLite::MessageSize(
+          this->human_result(static_cast<int>(i)));
+    }
+  }
+
+  // .ascend.presenter.video_analysis.ImageSet image_set = 1;
+  if (this->has_image_set()) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::MessageSize(
+        *this->image_set_);
+  }
+
+  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = cached_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void FrameAnalysisResult::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  GOOGLE_DCHECK_NE(&from, this);
+  const FrameAnalysisResult* source =
+      ::google::protobuf::internal::DynamicCastToGenerated<const FrameAnalysisResult>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:ascend.presenter.video_analysis.FrameAnalysisResult)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:ascend.presenter.video_analysis.FrameAnalysisResult)
+    MergeFrom(*source);
+  }
+}
+
+void FrameAnalysisResult::MergeFrom(const FrameAnalysisResult& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  car_result_.MergeFrom(from.car_result_);
+  human_result_.MergeFrom(from.human_result_);
+  if (from.has_image_set()) {
+    mutable_image_set()->::ascend::presenter::video_analysis::ImageSet::MergeFrom(from.image_set());
+  }
+}
+
+void FrameAnalysisResult::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void FrameAnalysisResult::CopyFrom(const FrameAnalysisResult& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:ascend.presenter.video_analysis.FrameAnalysisResult)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool FrameAnalysisResult::IsInitialized() const {
+  return true;
+}
+
+void FrameAnalysisResult::Swap(FrameAnalysisResult* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void FrameAnalysisResult::InternalSwap(FrameAnalysisResult* other) {
+  using std::swap;
+  car_result_.InternalSwap(&other->car_result_);
+  human_result_.InternalSwap(&other->human_result_);
+  swap(image_set_, other->image_set_);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata FrameAnalysisResult::GetMetadata() const {
+  protobuf_video_5fanalysis_5fmessage_2eproto::protobuf_AssignDescriptorsOnce();
+  return ::protobuf_video_5fanalysis_5fmessage_2eproto::file_level_metadata[kIndexInFileMessages];
+}
+
+
 // @@protoc_insertion_point(namespace_scope)
 }  // namespace video_analysis
 }  // namespace presenter
@@ -37,7 +37,7 @@ namespace protobuf_video_5fanalysis_5fmessage_2eproto {
 struct TableStruct {
   static const ::google::protobuf::internal::ParseTableField entries[];
   static const ::google::protobuf::internal::AuxillaryParseTableField aux[];
-  static const ::google::protobuf::internal::ParseTable schema[8];
+  static const ::google::protobuf::internal::ParseTable schema[9];
   static const ::google::protobuf::internal::FieldMetadata field_metadata[];
   static const ::google::protobuf::internal::SerializationTable serialization_table[];
   static const ::google::protobuf::uint32 offsets[];
@@ -59,6 +59,8 @@ void InitDefaultsMapTypeImpl();
 void InitDefaultsMapType();
 void InitDefaultsHumanInferenceResultImpl();
 void InitDefaultsHumanInferenceResult();
+void InitDefaultsFrameAnalysisResultImpl();
+void InitDefaultsFrameAnalysisResult();
 inline void InitDefaults() {
   InitDefaultsRegisterApp();
   InitDefaultsCommonResponse();
@@ -68,6 +70,7 @@ inline void InitDefaults() {
   InitDefaultsCarInferenceResult();
   InitDefaultsMapType();
   InitDefaultsHumanInferenceResult();
+  InitDefaultsFrameAnalysisResult();
 }
 }  // namespace protobuf_video_5fanalysis_5fmessage_2eproto
 namespace ascend {
@@ -79,6 +82,9 @@ extern CarInferenceResultDefaultTypeInternal _CarInferenceResult_default_instanc
 class CommonResponse;
 class CommonResponseDefaultTypeInternal;
 extern CommonResponseDefaultTypeInternal _CommonResponse_default_instance_;
+class FrameAnalysisResult;
+class FrameAnalysisResultDefaultTypeInternal;
+extern FrameAnalysisResultDefaultTypeInternal _FrameAnalysisResult_default_instance_;
 class FrameIndex;
 class FrameIndexDefaultTypeInternal;
 extern FrameIndexDefaultTypeInternal _FrameIndex_default_instance_;
@@ -1190,6 +1196,134 @@ class HumanInferenceResult : public ::google::protobuf::Message /* @@protoc_inse
   friend struct ::protobuf_video_5fanalysis_5fmessage_2eproto::TableStruct;
   friend void ::protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsHumanInferenceResultImpl();
 };
+// -------------------------------------------------------------------
+
+class FrameAnalysisResult : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ascend.presenter.video_analysis.FrameAnalysisResult) */ {
+ public:
+  FrameAnalysisResult();
+  virtual ~FrameAnalysisResult();
+
+  FrameAnalysisResult(const FrameAnalysisResult& from);
+
+  inline FrameAnalysisResult& operator=(const FrameAnalysisResult& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  #if LANG_CXX11
+  FrameAnalysisResult(FrameAnalysisResult&& from) noexcept
+    : FrameAnalysisResult() {
+    *this = ::std::move(from);
+  }
+
+  inline FrameAnalysisResult& operator=(FrameAnalysisResult&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+  #endif
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const FrameAnalysisResult& default_instance();
+
+  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
+  static inline const FrameAnalysisResult* internal_default_instance() {
+    return reinterpret_cast<const FrameAnalysisResult*>(
+               &_FrameAnalysisResult_default_instance_);
+  }
+  static PROTOBUF_CONSTEXPR int const kIndexInFileMessages =
+    8;
+
+  void Swap(FrameAnalysisResult* other);
+  friend void swap(FrameAnalysisResult& a, FrameAnalysisResult& b) {
+    a.Swap(&b);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline FrameAnalysisResult* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  FrameAnalysisResult* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CopyFrom(const FrameAnalysisResult& from);
+  void MergeFrom(const FrameAnalysisResult& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void InternalSwap(FrameAnalysisResult* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return NULL;
+  }
+  inline void* MaybeArenaPtr() const {
+    return NULL;
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+  int car_result_size() const;
+  void clear_car_result();
+  static const int kCarResultFieldNumber = 2;
+  const ::ascend::presenter::video_analysis::CarInferenceResult& car_result(int index) const;
+  ::ascend::presenter::video_analysis::CarInferenceResult* mutable_car_result(int index);
+  ::ascend::presenter::video_analysis::CarInferenceResult* add_car_result();
+  ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::CarInferenceResult >*
+      mutable_car_result();
+  const ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::CarInferenceResult >&
+      car_result() const;
+
+  // repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+  int human_result_size() const;
+  void clear_human_result();
+  static const int kHumanResultFieldNumber = 3;
+  const ::ascend::presenter::video_analysis::HumanInferenceResult& human_result(int index) const;
+  ::ascend::presenter::video_analysis::HumanInferenceResult* mutable_human_result(int index);
+  ::ascend::presenter::video_analysis::HumanInferenceResult* add_human_result();
+  ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::HumanInferenceResult >*
+      mutable_human_result();
+  const ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::HumanInferenceResult >&
+      human_result() const;
+
+  // .ascend.presenter.video_analysis.ImageSet image_set = 1;
+  bool has_image_set() const;
+  void clear_image_set();
+  static const int kImageSetFieldNumber = 1;
+  const ::ascend::presenter::video_analysis::ImageSet& image_set() const;
+  ::ascend::presenter::video_analysis::ImageSet* release_image_set();
+  ::ascend::presenter::video_analysis::ImageSet* mutable_image_set();
+  void set_allocated_image_set(::ascend::presenter::video_analysis::ImageSet* image_set);
+
+  // @@protoc_insertion_point(class_scope:ascend.presenter.video_analysis.FrameAnalysisResult)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::CarInferenceResult > car_result_;
+  ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::HumanInferenceResult > human_result_;
+  ::ascend::presenter::video_analysis::ImageSet* image_set_;
+  mutable int _cached_size_;
+  friend struct ::protobuf_video_5fanalysis_5fmessage_2eproto::TableStruct;
+  friend void ::protobuf_video_5fanalysis_5fmessage_2eproto::InitDefaultsFrameAnalysisResultImpl();
+};
 // ===================================================================
 
 
@@ -2251,6 +2385,120 @@ HumanInferenceResult::human_property() const {
   return human_property_;
 }
 
+// -------------------------------------------------------------------
+
+// FrameAnalysisResult
+
+// .ascend.presenter.video_analysis.ImageSet image_set = 1;
+inline bool FrameAnalysisResult::has_image_set() const {
+  return this != internal_default_instance() && image_set_ != NULL;
+}
+inline void FrameAnalysisResult::clear_image_set() {
+  if (GetArenaNoVirtual() == NULL && image_set_ != NULL) {
+    delete image_set_;
+  }
+  image_set_ = NULL;
+}
+inline const ::ascend::presenter::video_analysis::ImageSet& FrameAnalysisResult::image_set() const {
+  const ::ascend::presenter::video_analysis::ImageSet* p = image_set_;
+  // @@protoc_insertion_point(field_get:ascend.presenter.video_analysis.FrameAnalysisResult.image_set)
+  return p != NULL ? *p : *reinterpret_cast<const ::ascend::presenter::video_analysis::ImageSet*>(
+      &::ascend::presenter::video_analysis::_ImageSet_default_instance_);
+}
+inline ::ascend::presenter::video_analysis::ImageSet* FrameAnalysisResult::release_image_set() {
+  // @@protoc_insertion_point(field_release:ascend.presenter.video_analysis.FrameAnalysisResult.image_set)
+  
+  ::ascend::presenter::video_analysis::ImageSet* temp = image_set_;
+  image_set_ = NULL;
+  return temp;
+}
+inline ::ascend::presenter::video_analysis::ImageSet* FrameAnalysisResult::mutable_image_set() {
+  
+  if (image_set_ == NULL) {
+    image_set_ = new ::ascend::presenter::video_analysis::ImageSet;
+  }
+  // @@protoc_insertion_point(field_mutable:ascend.presenter.video_analysis.FrameAnalysisResult.image_set)
+  return image_set_;
+}
+inline void FrameAnalysisResult::set_allocated_image_set(::ascend::presenter::video_analysis::ImageSet* image_set) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete image_set_;
+  }
+  if (image_set) {
+    ::google::protobuf::Arena* submessage_arena = NULL;
+    if (message_arena != submessage_arena) {
+      image_set = ::google::protobuf::internal::GetOwnedMessage(
+          message_arena, image_set, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  image_set_ = image_set;
+  // @@protoc_insertion_point(field_set_allocated:ascend.presenter.video_analysis.FrameAnalysisResult.image_set)
+}
+
+// repeated .ascend.presenter.video_analysis.CarInferenceResult car_result = 2;
+inline int FrameAnalysisResult::car_result_size() const {
+  return car_result_.size();
+}
+inline void FrameAnalysisResult::clear_car_result() {
+  car_result_.Clear();
+}
+inline const ::ascend::presenter::video_analysis::CarInferenceResult& FrameAnalysisResult::car_result(int index) const {
+  // @@protoc_insertion_point(field_get:ascend.presenter.video_analysis.FrameAnalysisResult.car_result)
+  return car_result_.Get(index);
+}
+inline ::ascend::presenter::video_analysis::CarInferenceResult* FrameAnalysisResult::mutable_car_result(int index) {
+  // @@protoc_insertion_point(field_mutable:ascend.presenter.video_analysis.FrameAnalysisResult.car_result)
+  return car_result_.Mutable(index);
+}
+inline ::ascend::presenter::video_analysis::CarInferenceResult* FrameAnalysisResult::add_car_result() {
+  // @@protoc_insertion_point(field_add:ascend.presenter.video_analysis.FrameAnalysisResult.car_result)
+  return car_result_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::CarInferenceResult >*
+FrameAnalysisResult::mutable_car_result() {
+  // @@protoc_insertion_point(field_mutable_list:ascend.presenter.video_analysis.FrameAnalysisResult.car_result)
+  return &car_result_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::CarInferenceResult >&
+FrameAnalysisResult::car_result() const {
+  // @@protoc_insertion_point(field_list:ascend.presenter.video_analysis.FrameAnalysisResult.car_result)
+  return car_result_;
+}
+
+// repeated .ascend.presenter.video_analysis.HumanInferenceResult human_result = 3;
+inline int FrameAnalysisResult::human_result_size() const {
+  return human_result_.size();
+}
+inline void FrameAnalysisResult::clear_human_result() {
+  human_result_.Clear();
+}
+inline const ::ascend::presenter::video_analysis::HumanInferenceResult& FrameAnalysisResult::human_result(int index) const {
+  // @@protoc_insertion_point(field_get:ascend.presenter.video_analysis.FrameAnalysisResult.human_result)
+  return human_result_.Get(index);
+}
+inline ::ascend::presenter::video_analysis::HumanInferenceResult* FrameAnalysisResult::mutable_human_result(int index) {
+  // @@protoc_insertion_point(field_mutable:ascend.presenter.video_analysis.FrameAnalysisResult.human_result)
+  return human_result_.Mutable(index);
+}
+inline ::ascend::presenter::video_analysis::HumanInferenceResult* FrameAnalysisResult::add_human_result() {
+  // @@protoc_insertion_point(field_add:ascend.presenter.video_analysis.FrameAnalysisResult.human_result)
+  return human_result_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::HumanInferenceResult >*
+FrameAnalysisResult::mutable_human_result() {
+  // @@protoc_insertion_point(field_mutable_list:ascend.presenter.video_analysis.FrameAnalysisResult.human_result)
+  return &human_result_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ascend::presenter::video_analysis::HumanInferenceResult >&
+FrameAnalysisResult::human_result() const {
+  // @@protoc_insertion_point(field_list:ascend.presenter.video_analysis.FrameAnalysisResult.human_result)
+  return human_result_;
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -2268,6 +2516,8 @@ HumanInferenceResult::human_property() const {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
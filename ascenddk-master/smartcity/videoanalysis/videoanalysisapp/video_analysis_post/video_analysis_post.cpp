@@ -43,6 +43,7 @@
 #include <regex>
 #include "hiaiengine/log.h"
 #include "ascenddk/ascend_ezdvpp/dvpp_process.h"
+#include "engine_flow_control.h"
 
 using hiai::Engine;
 using namespace hiai;
@@ -64,6 +65,19 @@ HIAI_REGISTER_DATA_TYPE("DetectionEngineTransT", DetectionEngineTransT);
 HIAI_REGISTER_DATA_TYPE("PedestrianInfoT", PedestrianInfoT);
 HIAI_REGISTER_DATA_TYPE("BatchPedestrianInfoT", BatchPedestrianInfoT);
 
+namespace {
+// key of an object in the track attribute cache
+string GetTrackKey(const string &channel_id, const string &object_id) {
+  return channel_id + "/" + object_id;
+}
+
+// key of a frame in the pending frames
+string GetFrameKey(const VideoImageInfoT &video_image_info) {
+  return video_image_info.channel_id + "/"
+      + to_string(video_image_info.frame_id);
+}
+}
+
 VideoAnalysisPost::~VideoAnalysisPost() {
   if (agent_channel_ != nullptr) {
     delete agent_channel_;
@@ -100,10 +114,19 @@ bool VideoAnalysisPost::IsInvalidAppName(const std::string &app_name) {
 HIAI_StatusT VideoAnalysisPost::Init(
     const hiai::AIConfig &config,
     const std::vector<hiai::AIModelDescription> &model_desc) {
+  // the four input ports share the credits of this engine
+  InitInputCredits(kVideoAnalysisPostEngine);
+
   if (app_config_ == nullptr) {
     app_config_ = make_shared<RegisterAppParam>();
   }
 
+  // latency trace is exported only when a file is configured
+  ascend::utils::LatencyTracerPara tracer_para;
+
+  // so is the engine profile of the device process
+  ascend::utils::EngineProfilePara profile_para;
+
   // get engine config and save to app_config_
   for (int index = 0; index < config.items_size(); index++) {
     const ::hiai::AIConfigItem& item = config.items(index);
@@ -137,11 +160,35 @@ HIAI_StatusT VideoAnalysisPost::Init(
         return HIAI_ERROR;
       }
       app_config_->app_name = value;
+    } else if (name == ascend::utils::kLatencyHistogramFileKey) {
+      tracer_para.histogram_file = value;
+    } else if (name == ascend::utils::kLatencyTraceFileKey) {
+      tracer_para.chrome_trace_file = value;
+    } else if (name == ascend::utils::kLatencyExportIntervalKey) {
+      tracer_para.export_interval = atoi(value.data());
+    } else if (name == ascend::utils::kEngineProfileFileKey) {
+      profile_para.text_file = value;
+    } else if (name == ascend::utils::kEngineProfileJsonFileKey) {
+      profile_para.json_file = value;
+    } else if (name == ascend::utils::kEngineProfileIntervalKey) {
+      profile_para.export_interval_ms = atoi(value.data());
     } else {
       HIAI_ENGINE_LOG("unused config name: %s", name.c_str());
     }
   }
   app_config_->app_type = kAppType;
+  if (!tracer_para.histogram_file.empty()
+      || !tracer_para.chrome_trace_file.empty()) {
+    latency_tracer_.reset(new ascend::utils::LatencyTracer(tracer_para));
+  }
+  if ((!profile_para.text_file.empty() || !profile_para.json_file.empty())
+      && (ascend::utils::StartEngineProfile(profile_para)
+          != ascend::utils::kUtilsOk)) {
+    HIAI_ENGINE_LOG(HIAI_GRAPH_INVALID_VALUE,
+                    "engine_profile_interval_ms = %d is invalid.",
+                    profile_para.export_interval_ms);
+    return HIAI_ERROR;
+  }
   HIAI_ENGINE_LOG("host_ip = %s,port = %d,app_name = %s",
                   app_config_->host_ip.c_str(), app_config_->port,
                   app_config_->app_name.c_str());
@@ -197,7 +244,7 @@ HIAI_StatusT VideoAnalysisPost::Init(
   return HIAI_OK;
 }
 
-OperationCode VideoAnalysisPost::SendDetectionImage(
+OperationCode VideoAnalysisPost::AddDetectionImage(
     const shared_ptr<VideoDetectionImageParaT> &image_para) {
   if (image_para == nullptr) {
     return kInvalidParam;
@@ -208,29 +255,133 @@ OperationCode VideoAnalysisPost::SendDetectionImage(
     return kExitApp;
   }
 
-  // Construct Message ImageSet,which has FrameIndex,image and Object
-  ImageSet image_set;
-  FrameIndex* frame_image = new FrameIndex();
+  string frame_key = GetFrameKey(image_para->image.video_image_info);
+  GetPendingFrame(frame_key).image_para = image_para;
+  return SendReadyFrame(frame_key);
+}
+
+OperationCode VideoAnalysisPost::AddCarInfo(
+    const shared_ptr<BatchCarInfoT> &car_info_para) {
+  if (car_info_para == nullptr) {
+    return kInvalidParam;
+  }
+
+  // exit app when data has been transferred
+  if (car_info_para->video_image_info.is_finished) {
+    return kExitApp;
+  }
+
+  string frame_key = GetFrameKey(car_info_para->video_image_info);
+  PendingFrameT &frame = GetPendingFrame(frame_key);
+  frame.car_infos.insert(frame.car_infos.end(),
+                         car_info_para->car_infos.begin(),
+                         car_info_para->car_infos.end());
+  ++frame.batch_num;
+  return SendReadyFrame(frame_key);
+}
+
+OperationCode VideoAnalysisPost::AddPedestrianInfo(
+    const shared_ptr<BatchPedestrianInfoT> &pedestrian_info_para) {
+  if (pedestrian_info_para == nullptr) {
+    return kInvalidParam;
+  }
+
+  // exit app when data has been transferred
+  if (pedestrian_info_para->video_image_info.is_finished) {
+    return kExitApp;
+  }
+
+  string frame_key = GetFrameKey(pedestrian_info_para->video_image_info);
+  PendingFrameT &frame = GetPendingFrame(frame_key);
+  frame.pedestrian_infos.insert(
+      frame.pedestrian_infos.end(),
+      pedestrian_info_para->pedestrian_info.begin(),
+      pedestrian_info_para->pedestrian_info.end());
+  ++frame.batch_num;
+  return SendReadyFrame(frame_key);
+}
+
+PendingFrameT& VideoAnalysisPost::GetPendingFrame(const string &frame_key) {
+  pair<unordered_map<string, PendingFrameT>::iterator, bool> inserted =
+      pending_frames_.emplace(frame_key, PendingFrameT());
+  if (inserted.second) {
+    inserted.first->second.arrive_ns = ascend::utils::GetMonotonicTimeNs();
+  }
+  return inserted.first->second;
+}
+
+OperationCode VideoAnalysisPost::SendReadyFrame(const string &frame_key) {
+  unordered_map<string, PendingFrameT>::iterator frame = pending_frames_.find(
+      frame_key);
+  if ((frame == pending_frames_.end()) || (frame->second.image_para == nullptr)
+      || (frame->second.batch_num < frame->second.image_para->attr_batch_num)) {
+    return kOperationOk;
+  }
+
+  OperationCode ret = SendFrameResult(frame->second);
+  pending_frames_.erase(frame);
+  return ret;
+}
+
+OperationCode VideoAnalysisPost::SendExpiredFrames(bool flush_all) {
+  int64_t now_ns = ascend::utils::GetMonotonicTimeNs();
+  OperationCode ret = kOperationOk;
+  for (unordered_map<string, PendingFrameT>::iterator iter = pending_frames_
+      .begin(); iter != pending_frames_.end();) {
+    if (!flush_all
+        && (now_ns - iter->second.arrive_ns <= kPendingFrameTimeoutNs)) {
+      ++iter;
+      continue;
+    }
+
+    // the results of a frame whose image is lost can not be shown
+    if (iter->second.image_para == nullptr) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                      "[VideoAnalysePost]image of frame %s is lost",
+                      iter->first.c_str());
+    } else {
+      HIAI_ENGINE_LOG("[VideoAnalysePost]frame %s is sent with %u of %u "
+                      "attribute results", iter->first.c_str(),
+                      iter->second.batch_num,
+                      iter->second.image_para->attr_batch_num);
+      OperationCode send_ret = SendFrameResult(iter->second);
+      if (send_ret != kOperationOk) {
+        ret = send_ret;
+      }
+    }
+    iter = pending_frames_.erase(iter);
+  }
+
+  return ret;
+}
+
+OperationCode VideoAnalysisPost::SendFrameResult(PendingFrameT &frame) {
+  const VideoImageInfoT &video_image_info =
+      frame.image_para->image.video_image_info;
+  AddCachedAttributes(frame);
+
+  // Construct Message FrameAnalysisResult, which has the ImageSet of the
+  // frame and the inference results of its objects
+  FrameAnalysisResult frame_result;
+  ImageSet* image_set = frame_result.mutable_image_set();
+  FrameIndex* frame_image = image_set->mutable_frame_index();
 
   // fill content of FrameIndex
   frame_image->set_app_id(app_config_->app_name);
-  frame_image->set_channel_id(image_para->image.video_image_info.channel_id);
-  frame_image->set_channel_name(
-      image_para->image.video_image_info.channel_name);
-  frame_image->set_frame_id(
-      to_string(image_para->image.video_image_info.frame_id));
-  image_set.set_allocated_frame_index(frame_image);
+  frame_image->set_channel_id(video_image_info.channel_id);
+  frame_image->set_channel_name(video_image_info.channel_name);
+  frame_image->set_frame_id(to_string(video_image_info.frame_id));
 
   // set up origin image buff in ImageSet Message
-  image_set.set_frame_image(
-      string(reinterpret_cast<char*>(image_para->image.img.data.get()),
-             image_para->image.img.size));
+  image_set->set_frame_image(
+      string(reinterpret_cast<char*>(frame.image_para->image.img.data.get()),
+             frame.image_para->image.img.size));
 
   // get small images after reasoning
-  for (vector<ObjectImageParaT>::iterator iter = image_para->obj_imgs.begin();
-      iter != image_para->obj_imgs.end(); ++iter) {
+  for (vector<ObjectImageParaT>::iterator iter = frame.image_para->obj_imgs
+      .begin(); iter != frame.image_para->obj_imgs.end(); ++iter) {
     // set up id and confidence of small images
-    Object* object_img = image_set.add_object();
+    Object* object_img = image_set->add_object();
     object_img->set_id(iter->object_info.object_id);
     object_img->set_confidence(iter->object_info.score);
 
@@ -239,182 +390,151 @@ OperationCode VideoAnalysisPost::SendDetectionImage(
         string(reinterpret_cast<char*>(iter->img.data.get()), iter->img.size));
   }
 
-  // construct callback Messages
-  unique_ptr < google::protobuf::Message > response_detection;
-
-  // send infomation images to server
-  PresenterErrorCode detection_image_err = agent_channel_->SendMessage(
-      image_set, response_detection);
-  if (detection_image_err != PresenterErrorCode::kNone) {
-    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "send detection image failed, error code=%d",
-                    detection_image_err);
-    return kSendDataFailed;
+  // the frame of the results is given by the ImageSet
+  for (vector<CarInfoT>::iterator iter = frame.car_infos.begin();
+      iter != frame.car_infos.end(); ++iter) {
+    CarInferenceResult* car_result = frame_result.add_car_result();
+    car_result->set_object_id(iter->object_id);
+    if (iter->attribute_name == kCarType) {
+      car_result->set_type(ascend::presenter::video_analysis::kCarBrand);
+    } else {
+      car_result->set_type(ascend::presenter::video_analysis::kCarColor);
+    }
+    car_result->set_confidence(iter->confidence);
+    car_result->set_value(iter->inference_result);
   }
 
-  // get responded Message and judge result
-  CommonResponse* detection_image_response =
-      dynamic_cast<CommonResponse*>(response_detection.get());
-  if (detection_image_response == nullptr) {
-    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "[SendDetectionImage]detection_image_response is nullptr");
-    return kSendDataFailed;
+  for (vector<PedestrianInfoT>::iterator iter = frame.pedestrian_infos.begin();
+      iter != frame.pedestrian_infos.end(); ++iter) {
+    HumanInferenceResult* person_result = frame_result.add_human_result();
+    person_result->set_object_id(iter->object_id);
+    map<string, float>::iterator iter_map;
+    for (iter_map = iter->pedestrian_attribute_map.begin();
+        iter_map != iter->pedestrian_attribute_map.end(); ++iter_map) {
+      // set up human_property
+      MapType* property_map = person_result->add_human_property();
+      property_map->set_key(iter_map->first);
+      property_map->set_value(iter_map->second);
+    }
   }
 
-  ErrorCode response_code = detection_image_response->ret();
-  if (response_code != kErrorNone) {
+  // the server sends no response, so the frames are sent back to back;
+  // a server side error closes the channel and fails the later frames
+  PresenterErrorCode frame_err = agent_channel_->SendMessage(frame_result);
+  if (frame_err != PresenterErrorCode::kNone) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "[SendDetectionImage]server response failed, error code=%d",
-                    response_code);
+                    "send frame result failed, error code=%d,frame_id = %u",
+                    frame_err, video_image_info.frame_id);
     return kSendDataFailed;
   }
 
   return kOperationOk;
 }
 
-OperationCode VideoAnalysisPost::SendCarInfo(
+void VideoAnalysisPost::CacheCarInfo(
     const shared_ptr<BatchCarInfoT> &car_info_para) {
-  if (car_info_para == nullptr) {
-    return kInvalidParam;
-  }
-
-  // exit app when data has been transferred
-  if (car_info_para->video_image_info.is_finished) {
-    return kExitApp;
+  if ((car_info_para == nullptr)
+      || car_info_para->video_image_info.is_finished) {
+    return;
   }
 
+  int64_t now_ns = ascend::utils::GetMonotonicTimeNs();
   for (vector<CarInfoT>::iterator iter = car_info_para->car_infos.begin();
       iter != car_info_para->car_infos.end(); ++iter) {
-    // Construct Message CarInferenceResult,which has FrameIndex,object_id,
-    // CarInferenceType,confidence and value
-    CarInferenceResult car_result;
-    FrameIndex* frame_car = new FrameIndex();
-
-    // set up relevant infomations of origin image
-    frame_car->set_app_id(app_config_->app_name);
-    frame_car->set_channel_id(car_info_para->video_image_info.channel_id);
-    frame_car->set_channel_name(car_info_para->video_image_info.channel_name);
-    frame_car->set_frame_id(
-        to_string(car_info_para->video_image_info.frame_id));
-    car_result.set_allocated_frame_index(frame_car);
-
-    // set up relevant infomations of small image
-    car_result.set_object_id(iter->object_id);
-    if (iter->attribute_name == kCarType) {
-      car_result.set_type(ascend::presenter::video_analysis::kCarBrand);
-    } else {
-      car_result.set_type(ascend::presenter::video_analysis::kCarColor);
-    }
-    car_result.set_confidence(iter->confidence);
-    car_result.set_value(iter->inference_result);
-
-    // construct callback Messages,send to presenter server
-    unique_ptr < google::protobuf::Message > response_objcar;
-    PresenterErrorCode car_err = agent_channel_->SendMessage(car_result,
-                                                             response_objcar);
-    if (car_err != PresenterErrorCode::kNone) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "send car result failed, error code=%d,object_id = %s",
-                      car_err, iter->object_id.c_str());
-      return kSendDataFailed;
+    TrackAttributeT &track_attr = track_attrs_[GetTrackKey(
+        car_info_para->video_image_info.channel_id, iter->object_id)];
+    track_attr.access_ns = now_ns;
+
+    // keep the latest result of every attribute
+    vector<CarInfoT>::iterator cached = track_attr.car_infos.begin();
+    while ((cached != track_attr.car_infos.end())
+        && (cached->attribute_name != iter->attribute_name)) {
+      ++cached;
     }
-
-    // get responded Message and judge result
-    CommonResponse* car_response = dynamic_cast<CommonResponse*>(response_objcar
-        .get());
-    if (car_response == nullptr) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "car_response is nullptr");
-      return kSendDataFailed;
-    }
-
-    ErrorCode response_code = car_response->ret();
-    if (response_code != kErrorNone) {
-      HIAI_ENGINE_LOG(
-          HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-          "[SendCarInfo]server response failed, error code=%d,object_id = %s",
-          response_code, iter->object_id.c_str());
-      return kSendDataFailed;
+    if (cached == track_attr.car_infos.end()) {
+      track_attr.car_infos.push_back(*iter);
+    } else {
+      *cached = *iter;
     }
   }
-
-  return kOperationOk;
 }
 
-OperationCode VideoAnalysisPost::SendPedestrianInfo(
+void VideoAnalysisPost::CachePedestrianInfo(
     const shared_ptr<BatchPedestrianInfoT> &pedestrian_info_para) {
-  if (pedestrian_info_para == nullptr) {
-    return kInvalidParam;
-  }
-
-  // exit app when data has been transferred
-  if (pedestrian_info_para->video_image_info.is_finished) {
-    return kExitApp;
+  if ((pedestrian_info_para == nullptr)
+      || pedestrian_info_para->video_image_info.is_finished) {
+    return;
   }
 
+  int64_t now_ns = ascend::utils::GetMonotonicTimeNs();
   for (vector<PedestrianInfoT>::iterator iter = pedestrian_info_para
       ->pedestrian_info.begin();
       iter != pedestrian_info_para->pedestrian_info.end(); ++iter) {
-    // Construct Message HumanInferenceResult,which has FrameIndex,object_id,
-    // and human_property
-    HumanInferenceResult person_result;
-    FrameIndex* frame_person = new FrameIndex();
-
-    // set up relevant infomations of origin image
-    frame_person->set_app_id(app_config_->app_name);
-    frame_person->set_channel_id(
-        pedestrian_info_para->video_image_info.channel_id);
-    frame_person->set_channel_name(
-        pedestrian_info_para->video_image_info.channel_name);
-    frame_person->set_frame_id(
-        to_string(pedestrian_info_para->video_image_info.frame_id));
-    person_result.set_allocated_frame_index(frame_person);
-
-    // set up relevant infomations of small image
-    person_result.set_object_id(iter->object_id);
-    map<string, float>::iterator iter_map;
-    for (iter_map = iter->pedestrian_attribute_map.begin();
-        iter_map != iter->pedestrian_attribute_map.end(); ++iter_map) {
-      // set up human_property
-      MapType* property_map = person_result.add_human_property();
-      property_map->set_key(iter_map->first);
-      property_map->set_value(iter_map->second);
-    }
+    TrackAttributeT &track_attr = track_attrs_[GetTrackKey(
+        pedestrian_info_para->video_image_info.channel_id, iter->object_id)];
+    track_attr.access_ns = now_ns;
+    track_attr.pedestrian_infos.assign(1, *iter);
+  }
+}
 
-    // construct callback Messages,send to presenter server
-    unique_ptr < google::protobuf::Message > response_objper;
-    PresenterErrorCode person_err = agent_channel_->SendMessage(
-        person_result, response_objper);
-    if (person_err != PresenterErrorCode::kNone) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "send person result failed, error code=%d,object_id = %s",
-                      person_err, iter->object_id.c_str());
-      return kSendDataFailed;
+void VideoAnalysisPost::AddCachedAttributes(PendingFrameT &frame) {
+  const VideoImageInfoT &video_image_info =
+      frame.image_para->image.video_image_info;
+  int64_t now_ns = ascend::utils::GetMonotonicTimeNs();
+  for (vector<ObjectImageParaT>::iterator iter = frame.image_para->obj_imgs
+      .begin(); iter != frame.image_para->obj_imgs.end(); ++iter) {
+    if (iter->object_info.is_attr_inferred) {
+      continue;
     }
 
-    // get responded Message and judge result
-    CommonResponse* person_response =
-        dynamic_cast<CommonResponse*>(response_objper.get());
-    if (person_response == nullptr) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                      "[SendPersonInfo]person_response is nullptr");
-      return kSendDataFailed;
+    // nothing cached yet if the first results of the track are on the way
+    unordered_map<string, TrackAttributeT>::iterator track_attr =
+        track_attrs_.find(GetTrackKey(video_image_info.channel_id,
+                                      iter->object_info.object_id));
+    if (track_attr == track_attrs_.end()) {
+      continue;
     }
 
-    ErrorCode response_code = person_response->ret();
-    if (response_code != kErrorNone) {
-      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT, "[SendPersonInfo]server "
-                      "response failed, error code=%d,object_id = %s",
-                      response_code, iter->object_id.c_str());
-      return kSendDataFailed;
+    track_attr->second.access_ns = now_ns;
+    frame.car_infos.insert(frame.car_infos.end(),
+                           track_attr->second.car_infos.begin(),
+                           track_attr->second.car_infos.end());
+    frame.pedestrian_infos.insert(frame.pedestrian_infos.end(),
+                                  track_attr->second.pedestrian_infos.begin(),
+                                  track_attr->second.pedestrian_infos.end());
+  }
+
+  // drop the tracks that have ended
+  for (unordered_map<string, TrackAttributeT>::iterator iter = track_attrs_
+      .begin(); iter != track_attrs_.end();) {
+    if (now_ns - iter->second.access_ns > kTrackAttrExpireNs) {
+      iter = track_attrs_.erase(iter);
+    } else {
+      ++iter;
     }
   }
+}
+
+void VideoAnalysisPost::RecordLatency(VideoImageInfoT &video_image_info,
+                                      int64_t enter_ns) {
+  if ((latency_tracer_ == nullptr) || video_image_info.is_finished) {
+    return;
+  }
 
-  return kOperationOk;
+  ascend::utils::EnterTraceStage(video_image_info.trace, kTraceStage);
+  video_image_info.trace.back().enter_ns = enter_ns;
+  ascend::utils::ExitTraceStage(video_image_info.trace);
+  latency_tracer_->RecordFrame(video_image_info.trace,
+                               video_image_info.channel_id,
+                               video_image_info.frame_id);
 }
 
 HIAI_IMPL_ENGINE_PROCESS("video_analysis_post", VideoAnalysisPost, INPUT_SIZE) {
+  PROFILE_ENGINE_PROCESS_WITH_CREDIT(kVideoAnalysisPostEngine);
   //arg0:image detection; arg1:car type; arg2:car color; arg3:person info
+  ReleaseInputCredits(kVideoAnalysisPostEngine,
+                      (arg0 != nullptr) + (arg1 != nullptr)
+                          + (arg2 != nullptr) + (arg3 != nullptr));
   input_que_.PushData(0, arg0);
   input_que_.PushData(1, arg1);
   input_que_.PushData(2, arg2);
@@ -427,53 +547,86 @@ HIAI_IMPL_ENGINE_PROCESS("video_analysis_post", VideoAnalysisPost, INPUT_SIZE) {
   shared_ptr<void> input_arg2;
   shared_ptr<void> input_arg3;
 
-  // if the image detection channel has data,then send to presenter server
+  // the data of a frame is sent to presenter server in one message, when
+  // the image and all the attribute results of the frame have arrived
   if (input_que_.FrontData(0, input_arg0)) {
     input_que_.PopData(0, input_arg0);
-    image_ret_ = SendDetectionImage(
-        static_pointer_cast<VideoDetectionImageParaT>(input_arg0));
+    int64_t enter_ns = ascend::utils::GetMonotonicTimeNs();
+    shared_ptr<VideoDetectionImageParaT> image_para =
+        static_pointer_cast<VideoDetectionImageParaT>(input_arg0);
+    image_ret_ = AddDetectionImage(image_para);
+    if (image_para != nullptr) {
+      RecordLatency(image_para->image.video_image_info, enter_ns);
+    }
     if ((image_ret_ != kOperationOk) && (image_ret_ != kExitApp)) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
-          "SendDetectionImage failed,error code: %d", image_ret_);
+          "AddDetectionImage failed,error code: %d", image_ret_);
     }
   }
 
-  // if the car type channel has data,then send to presenter server
+  // if the car type channel has data,then add it to its frame
   if (input_que_.FrontData(1, input_arg1)) {
     input_que_.PopData(1, input_arg1);
-    car_type_ret_ = SendCarInfo(
-        static_pointer_cast<BatchCarInfoT>(input_arg1));
+    int64_t enter_ns = ascend::utils::GetMonotonicTimeNs();
+    shared_ptr<BatchCarInfoT> car_type_para =
+        static_pointer_cast<BatchCarInfoT>(input_arg1);
+    CacheCarInfo(car_type_para);
+    car_type_ret_ = AddCarInfo(car_type_para);
+    if (car_type_para != nullptr) {
+      RecordLatency(car_type_para->video_image_info, enter_ns);
+    }
     if ((car_type_ret_ != kOperationOk) && (car_type_ret_ != kExitApp)) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
-          "SendCarType failed,error code: %d",car_type_ret_);
+          "AddCarType failed,error code: %d",car_type_ret_);
     }
   }
 
-  // if the car color channel has data,then send to presenter server
+  // if the car color channel has data,then add it to its frame
   if (input_que_.FrontData(2, input_arg2)) {
     input_que_.PopData(2, input_arg2);
-    car_color_ret_ = SendCarInfo(
-        static_pointer_cast<BatchCarInfoT>(input_arg2));
+    int64_t enter_ns = ascend::utils::GetMonotonicTimeNs();
+    shared_ptr<BatchCarInfoT> car_color_para =
+        static_pointer_cast<BatchCarInfoT>(input_arg2);
+    CacheCarInfo(car_color_para);
+    car_color_ret_ = AddCarInfo(car_color_para);
+    if (car_color_para != nullptr) {
+      RecordLatency(car_color_para->video_image_info, enter_ns);
+    }
     if ((car_color_ret_ != kOperationOk) && (car_color_ret_ != kExitApp)) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
-          "SendCarColor failed,error code: %d",car_color_ret_);
+          "AddCarColor failed,error code: %d",car_color_ret_);
     }
   }
 
-  // if the person info channel has data,then send to presenter server
+  // if the person info channel has data,then add it to its frame
   if (input_que_.FrontData(3, input_arg3)) {
     input_que_.PopData(3, input_arg3);
-    pedestrian_ret_ = SendPedestrianInfo(
-        static_pointer_cast<BatchPedestrianInfoT>(input_arg3));
+    int64_t enter_ns = ascend::utils::GetMonotonicTimeNs();
+    shared_ptr<BatchPedestrianInfoT> pedestrian_para =
+        static_pointer_cast<BatchPedestrianInfoT>(input_arg3);
+    CachePedestrianInfo(pedestrian_para);
+    pedestrian_ret_ = AddPedestrianInfo(pedestrian_para);
+    if (pedestrian_para != nullptr) {
+      RecordLatency(pedestrian_para->video_image_info, enter_ns);
+    }
     if ((pedestrian_ret_ != kOperationOk) && (pedestrian_ret_ != kExitApp)) {
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
-          "SendPedestrianInfo failed,error code: %d",pedestrian_ret_);
+          "AddPedestrianInfo failed,error code: %d",pedestrian_ret_);
     }
   }
 
   // if all channel transmissions are completed,then exit app
-  if ((image_ret_ == kExitApp) && (car_type_ret_ == kExitApp) &&
-      (car_color_ret_ == kExitApp) && (pedestrian_ret_ == kExitApp)) {
+  bool is_finished = (image_ret_ == kExitApp) && (car_type_ret_ == kExitApp)
+      && (car_color_ret_ == kExitApp) && (pedestrian_ret_ == kExitApp);
+
+  // do not hold the frames whose attribute results are lost
+  OperationCode expire_ret = SendExpiredFrames(is_finished);
+  if (expire_ret != kOperationOk) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
+        "SendExpiredFrames failed,error code: %d", expire_ret);
+  }
+
+  if (is_finished) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,"[VideoAnalysePost]"
         "app will exit...");
     shared_ptr<string> result_data(new string);
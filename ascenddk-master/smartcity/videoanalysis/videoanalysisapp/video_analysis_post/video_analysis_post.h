@@ -38,6 +38,7 @@
 #include <dirent.h>
 #include <memory>
 #include <unistd.h>
+#include <unordered_map>
 #include <vector>
 #include <stdint.h>
 #include "hiaiengine/engine.h"
@@ -97,6 +98,40 @@ const std::string kAppName = "app_name";
 // app type
 const std::string kAppType = "video_analysis";
 
+// stage name in the latency trace of a frame
+const std::string kTraceStage = "video_analysis_post";
+
+// cached attributes of a track unused for this long are dropped
+const int64_t kTrackAttrExpireNs = 60000000000LL;
+
+// latest attributes of a tracked object, reused in the frames where the
+// object is not inferred
+struct TrackAttributeT {
+  // one result for each CarInferenceType
+  std::vector<CarInfoT> car_infos;
+  // empty or one result
+  std::vector<PedestrianInfoT> pedestrian_infos;
+  // monotonic time the attributes are last updated or reused in nanosecond
+  int64_t access_ns;
+};
+
+// a frame missing some attribute results is sent without them after this
+const int64_t kPendingFrameTimeoutNs = 3000000000LL;
+
+// a frame waiting for the attribute results of its objects
+struct PendingFrameT {
+  // nullptr: detection image of the frame not arrived yet
+  std::shared_ptr<VideoDetectionImageParaT> image_para;
+  // car attributes of the frame
+  std::vector<CarInfoT> car_infos;
+  // person attributes of the frame
+  std::vector<PedestrianInfoT> pedestrian_infos;
+  // attribute result batches arrived, compared with attr_batch_num
+  uint32_t batch_num = 0;
+  // monotonic time the first data of the frame arrived in nanosecond
+  int64_t arrive_ns = 0;
+};
+
 class VideoAnalysisPost : public hiai::Engine {
 public:
   /**
@@ -151,29 +186,92 @@ public:
   bool IsInvalidAppName(const std::string &app_name);
 
   /**
-   * @brief  send image infomation to presenter server by protobuf
-   * @param [in]  image infomation from detected engine
+   * @brief  add the detection image to its pending frame, and send the frame
+   *         if all its attribute results have arrived
+   * @param [in]  image_para: image infomation from detected engine
    * @return  OperationCode
    */
-  OperationCode SendDetectionImage(
+  OperationCode AddDetectionImage(
       const std::shared_ptr<VideoDetectionImageParaT> &image_para);
 
   /**
-   * @brief  send car inference to presenter server by protobuf
-   * @param [in]  car infomation from car inferential engine
+   * @brief  add the car attributes to their pending frame, and send the frame
+   *         if all its attribute results have arrived
+   * @param [in]  car_info_para: car infomation from car inferential engine
+   * @return  OperationCode
+   */
+  OperationCode AddCarInfo(const std::shared_ptr<BatchCarInfoT> &car_info_para);
+
+  /**
+   * @brief  add the person attributes to their pending frame, and send the
+   *         frame if all its attribute results have arrived
+   * @param [in]  pedestrian_info_para: person infomation from person
+   *              inferential engine
+   * @return  OperationCode
+   */
+  OperationCode AddPedestrianInfo(
+      const std::shared_ptr<BatchPedestrianInfoT> &pedestrian_info_para);
+
+  /**
+   * @brief  get the pending frame, created when the first data of the frame
+   *         arrives
+   * @param [in]  frame_key: channel id and frame id of the frame
+   * @return  pending frame
+   */
+  PendingFrameT& GetPendingFrame(const std::string &frame_key);
+
+  /**
+   * @brief  send the pending frame if its image and all its attribute
+   *         results have arrived
+   * @param [in]  frame_key: channel id and frame id of the frame
    * @return  OperationCode
    */
-  OperationCode SendCarInfo(
-      const std::shared_ptr<BatchCarInfoT> &car_info_para);
+  OperationCode SendReadyFrame(const std::string &frame_key);
 
   /**
-   * @brief  send person inference to presenter server by protobuf
-   * @param [in]  person infomation from person inferential engine
+   * @brief  send the frames waiting longer than kPendingFrameTimeoutNs with
+   *         the results received so far
+   * @param [in]  flush_all: true: send all the pending frames
    * @return  OperationCode
    */
-  OperationCode SendPedestrianInfo(
+  OperationCode SendExpiredFrames(bool flush_all);
+
+  /**
+   * @brief  send the image and all the attributes of a frame to presenter
+   *         server in one message, without waiting for the response
+   * @param [in]  frame: pending frame with its image received
+   * @return  OperationCode
+   */
+  OperationCode SendFrameResult(PendingFrameT &frame);
+
+  /**
+   * @brief  cache the car attributes by their track
+   * @param [in]  car_info_para: car infomation from car inferential engine
+   */
+  void CacheCarInfo(const std::shared_ptr<BatchCarInfoT> &car_info_para);
+
+  /**
+   * @brief  cache the person attributes by their track
+   * @param [in]  pedestrian_info_para: person infomation from person
+   *              inferential engine
+   */
+  void CachePedestrianInfo(
       const std::shared_ptr<BatchPedestrianInfoT> &pedestrian_info_para);
 
+  /**
+   * @brief  add the cached attributes of the objects not inferred in this
+   *         frame, as results of this frame
+   * @param [in]  frame: pending frame with its image received
+   */
+  void AddCachedAttributes(PendingFrameT &frame);
+
+  /**
+   * @brief  stamp this engine and record the trace of the frame
+   * @param [in]  video_image_info: frame information
+   * @param [in]  enter_ns: time the data entered this engine
+   */
+  void RecordLatency(VideoImageInfoT &video_image_info, int64_t enter_ns);
+
   /**
    * @brief  reload Engine Process
    * @param [in]  define the number of input and output
@@ -191,17 +289,27 @@ private:
   // agent channel by factory create,used to send Message
   ascend::presenter::Channel* agent_channel_;
 
-  // ret of SendDetectionImage function
+  // ret of AddDetectionImage function
   OperationCode image_ret_;
 
-  // ret of SendCarInfo function when infomation about car type
+  // ret of AddCarInfo function when infomation about car type
   OperationCode car_type_ret_;
 
-  // ret of SendCarInfo function when infomation about car color
+  // ret of AddCarInfo function when infomation about car color
   OperationCode car_color_ret_;
 
-  // ret of SendPedestrianInfo function
+  // ret of AddPedestrianInfo function
   OperationCode pedestrian_ret_;
+
+  // frames waiting for their image or attribute results, by channel id and
+  // frame id
+  std::unordered_map<std::string, PendingFrameT> pending_frames_;
+
+  // attributes of the tracked objects, by channel id and object id
+  std::unordered_map<std::string, TrackAttributeT> track_attrs_;
+
+  // latency of the frames, nullptr: not configured
+  std::unique_ptr<ascend::utils::LatencyTracer> latency_tracer_;
 };
 
 #endif
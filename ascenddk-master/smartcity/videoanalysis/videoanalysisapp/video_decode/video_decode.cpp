@@ -40,6 +40,8 @@
 #include <unistd.h>
 #include <sys/prctl.h>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <memory>
 #include <mutex>
@@ -49,19 +51,61 @@
 
 #include "hiaiengine/log.h"
 #include "hiaiengine/data_type_reg.h"
+#include "ascenddk/ascend_ezdvpp/dvpp_data_type.h"
+#include "engine_flow_control.h"
 
 using namespace std;
 
 namespace {
-const int kWait10Milliseconds = 10000; // wait 10ms
+// the maximum time to wait for a free slot in the image data queue
+const int kPushTimeoutMilliseconds = 10000; // wait 10s
 
-const int kWait100Milliseconds = 100000; // wait 100ms
+const int kKeyFrameInterval = 5; // initial key frame interval
 
-const int kKeyFrameInterval = 5; // key fram interval
+// config items of the key frame interval bounds
+const string kMinSampleIntervalItem = "min_sample_interval";
 
-const int kImageDataQueueSize = 10; // the queue default size
+const string kMaxSampleIntervalItem = "max_sample_interval";
+
+const int kDefaultMinSampleInterval = 1; // every frame when idle
+
+const int kDefaultMaxSampleInterval = 25; // 1 frame per second at 25fps
+
+const int kMaxSampleInterval = 250; // key frame interval maximum value
+
+// config item of the latency budget of a watched engine in millisecond
+const string kSampleLatencyBudgetItem = "sample_latency_budget_ms";
+
+const int kDefaultSampleLatencyBudget = 200; // budget default value: 200ms
+
+const int kMaxSampleLatencyBudget = 10000; // budget maximum value: 10s
+
+const int64_t kMilliSecToNanoSec = 1000000; // 1ms = 1000000ns
+
+const int64_t kMicroSecToNanoSec = 1000; // 1us = 1000ns
+
+const int64_t kMilliSecToMicroSec = 1000; // 1ms = 1000us
+
+const int64_t kSecToNanoSec = 1000000000; // 1s = 1000000000ns
 
-const int kMaxRetryNumber = 100; // the maximum number of retry
+const int kBitsPerByte = 8; // bits of one byte
+
+const int kBitsPerKilobit = 1000; // bitrate unit
+
+const int kPermille = 1000; // packet loss unit
+
+// key frames without congestion before the interval is shortened
+const int kSampleProbeFrames = 10;
+
+// engines whose queue wait plus processing time is held in the budget
+const char * const kSampleWatchStages[] = { "object_detection",
+    "car_type_inference", "car_color_inference",
+    "pedestrian_attr_inference" };
+
+// gauge name head of the key frame interval, e.g. sample_interval.channel1
+const string kSampleIntervalGaugeHead = "sample_interval.";
+
+const int kImageDataQueueSize = 10; // the queue default size
 
 const int kCompareEqual = 0; // string compare equal
 
@@ -69,9 +113,39 @@ const int kNoFlag = 0; // no flag
 
 const int kHandleSuccessful = 0; // the process handled successfully
 
-const string kStrChannelId1 = "channel1"; // channle id 1 string
+// config item of a video source: channel1, channel2 ...
+const string kRegexChannelItem = "^channel([1-9][0-9]{0,3})$";
+
+// config item of the maximum number of decode threads
+const string kDecodeThreadNumItem = "decode_thread_num";
+
+const int kDefaultDecodeThreadNum = 4; // decode threads default value
+
+const int kMaxDecodeThreadNum = 16; // decode threads maximum value
 
-const string kStrChannelId2 = "channel2";  // channle id 2 string
+// wait for a ready channel, then check whether all channels are finished
+const int kWaitReadyMilliseconds = 100;
+
+// config item of the decoder: hardware, software or auto
+const string kDecodeModeItem = "decode_mode";
+
+const string kDecodeModeHardware = "hardware"; // decode with vdec
+
+const string kDecodeModeSoftware = "software"; // decode with libavcodec
+
+const string kDecodeModeAuto = "auto"; // vdec first, then libavcodec
+
+// config item of the maximum number of vdec channels in auto mode
+const string kMaxVdecChannelNumItem = "max_vdec_channel_num";
+
+const int kMaxVdecChannelNum = 16; // vdec channels of the device
+
+// config item of the threads of one libavcodec decoder
+const string kSoftwareThreadNumItem = "software_decode_thread_num";
+
+const int kDefaultSoftwareThreadNum = 2; // libavcodec threads default value
+
+const int kMaxSoftwareThreadNum = 16; // libavcodec threads maximum value
 
 const string kVideoTypeH264 = "h264"; // video type h264
 
@@ -79,11 +153,9 @@ const string kVideoTypeH265 = "h265"; // video type h265
 
 const string kNeedRemoveStr = " \r\n\t"; // the string need remove
 
-const string kVideoImageParaType = "VideoImageParaT"; // video image para type
-
-const int kIntChannelId1 = 1; // channel id 1 integer
+const string kTraceStage = "video_decode"; // stage name in latency trace
 
-const int kIntChannelId2 = 2; // channel id 2 integer
+const string kVideoImageParaType = "VideoImageParaT"; // video image para type
 
 const int kVideoFormatLength = 5; // video format string length
 
@@ -95,14 +167,48 @@ const string kRtspTransport = "rtsp_transport"; // rtsp transport
 
 const string kUdp = "udp"; // video format udp
 
+const string kTcp = "tcp"; // rtsp over the rtsp tcp connection
+
+// config item of the rtsp lower transport: udp or tcp
+const string kRtspTransportItem = "rtsp_transport";
+
+// config item of the reorder delay of rtsp packets in millisecond
+const string kRtspJitterBufferItem = "rtsp_jitter_buffer_ms";
+
+const int kDefaultRtspJitterBuffer = 500; // jitter buffer default: 500ms
+
+const int kMaxRtspJitterBuffer = 10000; // jitter buffer maximum value: 10s
+
+// config items of the backoff before an rtsp channel connects again
+const string kReconnectIntervalItem = "rtsp_reconnect_interval_ms";
+
+const string kMaxReconnectIntervalItem = "rtsp_max_reconnect_interval_ms";
+
+const int kDefaultReconnectInterval = 1000; // first backoff default: 1s
+
+const int kDefaultMaxReconnectInterval = 30000; // maximum backoff: 30s
+
+const int kMaxReconnectInterval = 600000; // backoff maximum value: 10min
+
+// gauge name heads of the stream health, e.g. stream_fps.channel1
+const string kStreamBitrateGaugeHead = "stream_bitrate_kbps.";
+
+const string kStreamFpsGaugeHead = "stream_fps.";
+
+const string kStreamLossGaugeHead = "stream_packet_loss_permille.";
+
+const string kStreamSkipGaugeHead = "stream_skipped_packets.";
+
+const string kStreamDecodeGaugeHead = "stream_decode_us.";
+
+const string kStreamReconnectGaugeHead = "stream_reconnects.";
+
 const string kBufferSize = "buffer_size"; // buffer size string
 
 const string kMaxBufferSize = "104857600"; // maximum buffer size:100MB
 
 const string kMaxDelayStr = "max_delay"; // maximum delay string
 
-const string kMaxDelayValue = "100000000"; // maximum delay time:100s
-
 const string kTimeoutStr = "stimeout"; // timeout string
 
 const string kTimeoutValue = "5000000"; // timeout:5s
@@ -115,7 +221,7 @@ const string kReorderQueueSize = "reorder_queue_size"; // reorder queue size
 
 const string kReorderQueueSizeValue = "0"; // reorder queue size value
 
-const string kThreadNameHead = "handle_"; // thread name head string
+const string kThreadNameHead = "decode_"; // thread name head string
 
 const int kErrorBufferSize = 1024; // buffer size for error info
 
@@ -136,33 +242,37 @@ const string kRegexRtsp =
         "6[0-4]\\d{3}|65[0-4]\\d{2}|655[0-2]\\d|6553[0-5])/"
         "(.{1,100})$";
 
-uint32_t frame_id_1 = 0; // frame id used for channle1
-
-uint32_t frame_id_2 = 0; // frame id used for channle2
-
-// the queue record image data from channel1
-ThreadSafeQueue<shared_ptr<VideoImageParaT>> channel1_queue(
-    kImageDataQueueSize);
-
-// the queue record image data from channel2
-ThreadSafeQueue<shared_ptr<VideoImageParaT>> channel2_queue(
-    kImageDataQueueSize);
 }
 
 HIAI_REGISTER_DATA_TYPE("VideoImageParaT", VideoImageParaT);
 
-bool IsKeyFrame(uint32_t frame_id) {
-  // the 1, 6, 11, 16... frame is key frame
-  if (frame_id % kKeyFrameInterval == 1) {
-    return true;
+bool IsKeyFrame(YuvImageFrameInfo &frame_info, uint32_t frame_id) {
+  // the interval may change after every key frame, so the next key frame id
+  // is kept instead of frame_id % interval
+  FrameSampler &sampler = frame_info.sampler;
+  if (frame_id < sampler.next_frame_id) {
+    return false;
   }
 
-  return false;
+  sampler.next_frame_id = frame_id + sampler.interval;
+  return true;
 }
 
 VideoDecode::VideoDecode() {
-  channel1_ = ""; // initialize channel1 to empty string
-  channel2_ = ""; // initialize channel2 to empty string
+  decode_thread_num_ = kDefaultDecodeThreadNum;
+  finished_channel_num_ = 0;
+  decode_mode_ = kDecodeHardware;
+  max_vdec_channel_num_ = kMaxVdecChannelNum;
+  software_thread_num_ = kDefaultSoftwareThreadNum;
+  vdec_channel_num_ = 0;
+  min_sample_interval_ = kDefaultMinSampleInterval;
+  max_sample_interval_ = kDefaultMaxSampleInterval;
+  sample_latency_budget_ns_ =
+      kDefaultSampleLatencyBudget * kMilliSecToNanoSec;
+  rtsp_jitter_buffer_ms_ = kDefaultRtspJitterBuffer;
+  rtsp_transport_ = kUdp;
+  reconnect_interval_ms_ = kDefaultReconnectInterval;
+  max_reconnect_interval_ms_ = kDefaultMaxReconnectInterval;
 }
 
 VideoDecode::~VideoDecode() {
@@ -180,14 +290,10 @@ void VideoDecode::SendFinishedData() {
   HIAI_StatusT hiai_ret = HIAI_OK;
 
   // send finished data to next engine, use output port:0
-  do {
-    hiai_ret = SendData(0, kVideoImageParaType,
-                        static_pointer_cast<void>(video_image_para));
-    if (hiai_ret == HIAI_QUEUE_FULL) { // check hiai queue is full
-      HIAI_ENGINE_LOG("Queue full when send finished data, sleep 10ms");
-      usleep(kWait10Milliseconds);  // sleep 10 ms
-    }
-  } while (hiai_ret == HIAI_QUEUE_FULL); // loop when hiai queue is full
+  hiai_ret = SendDataWithCredit(kObjectDetectionEngine, [&]() {
+    return SendData(0, kVideoImageParaType,
+                    static_pointer_cast<void>(video_image_para));
+  });
 
   if (hiai_ret != HIAI_OK) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
@@ -195,35 +301,12 @@ void VideoDecode::SendFinishedData() {
   }
 }
 
-uint32_t GetFrameId(const string &channel_id) {
-  if (channel_id == kStrChannelId1) { // check input channel id is channel1
-    frame_id_1++;
-    return frame_id_1;
-  } else { // the input channel id is channel2
-    frame_id_2++;
-    return frame_id_2;
-  }
-}
-
 void AddImage2QueueByChannel(
     const shared_ptr<VideoImageParaT>& video_image_para,
     ThreadSafeQueue<shared_ptr<VideoImageParaT>> &current_queue) {
-  bool add_image_success = false;
-  int count = 0; // count retry number
-
-  // add image data to queue, max retry time: 100
-  while (count < kMaxRetryNumber) {
-    count++;
-
-    if (current_queue.Push(video_image_para)) { // push image data to queue
-      add_image_success = true;
-      break;
-    } else { // queue is full, sleep 100 ms
-      usleep(kWait100Milliseconds);
-    }
-  }
-
-  if (!add_image_success) { // fail to send image data
+  // add image data to queue, if the queue is full, the decode thread sleeps
+  // until SendImageDataByChannel pops an element or the timeout expires
+  if (!current_queue.Push(video_image_para, kPushTimeoutMilliseconds)) {
     HIAI_ENGINE_LOG(
         HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
         "Fail to add image data to queue, channel_id:%s, channel_name:%s, frame_id:%d",
@@ -235,12 +318,15 @@ void AddImage2QueueByChannel(
 
 void SendKeyFrameData(const vpc_in_msg &vpc_in_msg, void* hiai_data,
                       FRAME* frame) {
-  string channel_name = ((YuvImageFrameInfo*) (hiai_data))->channel_name;
-  string channel_id = ((YuvImageFrameInfo*) (hiai_data))->channel_id;
-  uint32_t frame_id = GetFrameId(channel_id);
+  // a channel is decoded by one worker at a time, so its frame info is not
+  // shared
+  YuvImageFrameInfo* frame_info = (YuvImageFrameInfo*) (hiai_data);
+  string channel_name = frame_info->channel_name;
+  string channel_id = frame_info->channel_id;
+  uint32_t frame_id = ++frame_info->frame_id;
 
   // only send key frame to next engine, key frame id: 1,6,11,16...
-  if (!IsKeyFrame(frame_id)) {
+  if (!IsKeyFrame(*frame_info, frame_id)) {
     return;
   }
 
@@ -249,34 +335,24 @@ void SendKeyFrameData(const vpc_in_msg &vpc_in_msg, void* hiai_data,
                   frame_id, channel_id.c_str(), channel_name.c_str(),
                   frame->realWidth, frame->realHeight);
 
-  //send yuv420sp data
-  VideoImageInfoT i_video_image_info;
-  i_video_image_info.channel_id = channel_id;
-  i_video_image_info.channel_name = channel_name;
-  i_video_image_info.frame_id = frame_id;
-  i_video_image_info.is_finished = false;
-
-  hiai::ImageData<unsigned char> image_data;
-  image_data.width = frame->realWidth;
-  image_data.height = frame->realHeight;
-  image_data.format = IMAGEFORMAT::YUV420SP;
-  image_data.size = vpc_in_msg.auto_out_buffer_1->getBufferSize();
-
-  if (image_data.size <= 0) { // check image data size
+  int image_size = vpc_in_msg.auto_out_buffer_1->getBufferSize();
+  if (image_size <= 0) { // check image data size
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "Fail to copy vpc output image, buffer size is invalid!");
     return;
   }
 
-  unsigned char* out_put_image_buffer = new (nothrow) unsigned char[image_data
-      .size];
+  unsigned char* out_put_image_buffer = new (nothrow) unsigned char[
+      image_size];
   if (out_put_image_buffer == nullptr) { // check new result
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                     "Fail to new data when handle vpc output!");
     return;
   }
 
-  int memcpy_result = memcpy_s(out_put_image_buffer, image_data.size,
+  shared_ptr<unsigned char> image_buffer(out_put_image_buffer,
+                                         default_delete<unsigned char[]>());
+  int memcpy_result = memcpy_s(out_put_image_buffer, image_size,
                                vpc_in_msg.auto_out_buffer_1->getBuffer(),
                                vpc_in_msg.auto_out_buffer_1->getBufferSize());
   if (memcpy_result != EOK) { // check memcpy_s result
@@ -286,17 +362,39 @@ void SendKeyFrameData(const vpc_in_msg &vpc_in_msg, void* hiai_data,
     return;
   }
 
-  image_data.data.reset(out_put_image_buffer,
-                        default_delete<unsigned char[]>());
+  AddYuvImage(hiai_data, frame_id, frame->realWidth, frame->realHeight,
+              image_buffer, image_size);
+}
+
+void AddYuvImage(void* hiai_data, uint32_t frame_id, uint32_t width,
+                 uint32_t height, const shared_ptr<unsigned char> &data,
+                 uint32_t size) {
+  YuvImageFrameInfo* frame_info = (YuvImageFrameInfo*) (hiai_data);
+
+  //send yuv420sp data
+  VideoImageInfoT i_video_image_info;
+  i_video_image_info.channel_id = frame_info->channel_id;
+  i_video_image_info.channel_name = frame_info->channel_name;
+  i_video_image_info.frame_id = frame_id;
+  i_video_image_info.is_finished = false;
+
+  // the frame is decoded now, the trace starts here
+  ascend::utils::EnterTraceStage(i_video_image_info.trace, kTraceStage);
+  i_video_image_info.capture_time_ns =
+      i_video_image_info.trace.back().enter_ns;
+
+  hiai::ImageData<unsigned char> image_data;
+  image_data.width = width;
+  image_data.height = height;
+  image_data.format = IMAGEFORMAT::YUV420SP;
+  image_data.size = size;
+  image_data.data = data;
+
   shared_ptr<VideoImageParaT> video_image_para = make_shared<VideoImageParaT>();
   video_image_para->img = image_data;
   video_image_para->video_image_info = i_video_image_info;
 
-  if (channel_id == kStrChannelId1) { // add image data to channel1 queue
-    AddImage2QueueByChannel(video_image_para, channel1_queue);
-  } else { // add image data to channel2 queue
-    AddImage2QueueByChannel(video_image_para, channel2_queue);
-  }
+  AddImage2QueueByChannel(video_image_para, *frame_info->image_queue);
 }
 
 void CallVpcGetYuvImage(FRAME* frame, void* hiai_data) {
@@ -432,34 +530,26 @@ void VideoDecode::InitVideoStreamFilter(
   }
 }
 
-int VideoDecode::GetIntChannelId(const string channel_id) {
-  if (channel_id == kStrChannelId1) { // check channel is channel1
-    return kIntChannelId1;
-  } else { // the channel is channel2
-    return kIntChannelId2;
-  }
-}
-
-const string &VideoDecode::GetChannelValue(const string &channel_id) {
-  if (channel_id == kStrChannelId1) { // check channel is channel1
-    return channel1_;
-  } else { // the channel is channel2
-    return channel2_;
-  }
-}
-
 void VideoDecode::SetDictForRtsp(const string& channel_value,
                                  AVDictionary* &avdic) {
   if (IsValidRtsp(channel_value)) { // check channel value is valid rtsp address
     HIAI_ENGINE_LOG("Set parameters for %s", channel_value.c_str());
     avformat_network_init();
 
-    av_dict_set(&avdic, kRtspTransport.c_str(), kUdp.c_str(), kNoFlag);
+    av_dict_set(&avdic, kRtspTransport.c_str(), rtsp_transport_.c_str(),
+                kNoFlag);
     av_dict_set(&avdic, kBufferSize.c_str(), kMaxBufferSize.c_str(), kNoFlag);
-    av_dict_set(&avdic, kMaxDelayStr.c_str(), kMaxDelayValue.c_str(), kNoFlag);
+
+    // the jitter buffer: rtp packets are held up to max_delay to put late
+    // packets back in order, without it they pass as they come
+    string max_delay = to_string(rtsp_jitter_buffer_ms_ * kMilliSecToMicroSec);
+    av_dict_set(&avdic, kMaxDelayStr.c_str(), max_delay.c_str(), kNoFlag);
+    if (rtsp_jitter_buffer_ms_ == 0) {
+      av_dict_set(&avdic, kReorderQueueSize.c_str(),
+                  kReorderQueueSizeValue.c_str(), kNoFlag);
+    }
+
     av_dict_set(&avdic, kTimeoutStr.c_str(), kTimeoutValue.c_str(), kNoFlag);
-    av_dict_set(&avdic, kReorderQueueSize.c_str(), 
-                kReorderQueueSizeValue.c_str(), kNoFlag);
     av_dict_set(&avdic, kPktSize.c_str(), kPktSizeValue.c_str(), kNoFlag);
   }
 }
@@ -498,10 +588,9 @@ bool VideoDecode::OpenVideoFromInputChannel(
 bool VideoDecode::InitVideoParams(int videoindex, VideoType &video_type,
                                   AVFormatContext* av_format_context,
                                   AVBSFContext* &bsf_ctx) {
-  // check video type, only support h264 and h265
+  // check video type, only support h264 and h265, the caller closes the
+  // video on failure
   if (!CheckVideoType(videoindex, av_format_context, video_type)) {
-	avformat_close_input(&av_format_context);
-	
     return false;
   }
 
@@ -541,123 +630,486 @@ bool VideoDecode::InitVideoParams(int videoindex, VideoType &video_type,
   return true;
 }
 
-void VideoDecode::UnpackVideo2Image(const string &channel_id) {
-  char thread_name_log[kThreadNameLength];
-  string thread_name = kThreadNameHead + channel_id;
-  prctl(PR_SET_NAME, (unsigned long)thread_name.c_str());
-  prctl(PR_GET_NAME, (unsigned long)thread_name_log);
-  HIAI_ENGINE_LOG("Unpack video to image from:%s, thread name:%s", 
-                   channel_id.c_str(), thread_name_log);
-  			   
-  string channel_value = GetChannelValue(channel_id);
-  AVFormatContext* av_format_context = avformat_alloc_context();
+bool VideoDecode::OpenVideoChannel(VideoChannel &channel) {
+  channel.is_opened = true;
+  channel.av_format_context = avformat_alloc_context();
 
-  // check open video result
-  if (!OpenVideoFromInputChannel(channel_value, av_format_context)) {
-    return;
+  // check open video result, the context is freed on failure
+  if (!OpenVideoFromInputChannel(channel.channel_value,
+                                 channel.av_format_context)) {
+    channel.av_format_context = nullptr;
+    return false;
   }
 
-  int videoindex = GetVideoIndex(av_format_context);
-  if (videoindex == kInvalidVideoIndex) { // check video index is valid
+  channel.video_index = GetVideoIndex(channel.av_format_context);
+  if (channel.video_index == kInvalidVideoIndex) { // check video index
     HIAI_ENGINE_LOG(
         HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
         "Video index is -1, current media has no video info, channel id:%s",
-        channel_id.c_str());
-    return;
+        channel.channel_id.c_str());
+    return false;
   }
 
-  AVBSFContext* bsf_ctx;
   VideoType video_type = kInvalidTpye;
 
   // check initialize video parameters result
-  if (!InitVideoParams(videoindex, video_type, av_format_context, bsf_ctx)) {
-    return;
+  if (!InitVideoParams(channel.video_index, video_type,
+                       channel.av_format_context, channel.bsf_ctx)) {
+    return false;
   }
 
-  IDVPPAPI* dvpp_api = nullptr;
-  CreateVdecApi(dvpp_api, 0);
-  if (dvpp_api == nullptr) { // check create dvpp api result
-    DestroyVdecApi(dvpp_api, 0);
-    return;
+  // in auto mode a channel without vdec spills to libavcodec
+  bool is_hardware = (decode_mode_ != kDecodeSoftware);
+  if (is_hardware && !OpenHardwareDecoder(channel, video_type)) {
+    if (decode_mode_ == kDecodeHardware) {
+      return false;
+    }
+
+    is_hardware = false;
+  }
+
+  if (!is_hardware && !OpenSoftwareDecoder(channel)) {
+    return false;
   }
 
-  vdec_in_msg vdec_msg;
-  vdec_msg.call_back = CallVpcGetYuvImage;
+  HIAI_ENGINE_LOG("Open video of channel id:%s, channel value:%s, decoder:%s",
+                  channel.channel_id.c_str(), channel.channel_value.c_str(),
+                  is_hardware ? kDecodeModeHardware.c_str() :
+                      kDecodeModeSoftware.c_str());
+  return true;
+}
+
+bool VideoDecode::OpenHardwareDecoder(VideoChannel &channel,
+                                      VideoType video_type) {
+  // reserve a vdec channel, the limit only applies to auto mode
+  if (++vdec_channel_num_ > max_vdec_channel_num_
+      && decode_mode_ == kDecodeAuto) {
+    vdec_channel_num_--;
+    HIAI_ENGINE_LOG("All %d vdec channels are used, channel id:%s",
+                    max_vdec_channel_num_, channel.channel_id.c_str());
+    return false;
+  }
 
-  YuvImageFrameInfo yuv_image_frame_info;
-  yuv_image_frame_info.channel_name = channel_value;
-  yuv_image_frame_info.channel_id = channel_id;
+  CreateVdecApi(channel.dvpp_api, 0);
+  if (channel.dvpp_api == nullptr) { // check create dvpp api result
+    vdec_channel_num_--;
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to call CreateVdecApi, channel id:%s",
+                    channel.channel_id.c_str());
+    return false;
+  }
 
-  vdec_msg.channelId = GetIntChannelId(channel_id);
-  vdec_msg.hiai_data = &yuv_image_frame_info;
+  channel.vdec_msg.call_back = CallVpcGetYuvImage;
+  channel.vdec_msg.channelId = channel.int_channel_id;
+  channel.vdec_msg.hiai_data = &channel.frame_info;
 
   int strcpy_result = 0;
   if (video_type == kH264) { // check video type is h264
-    strcpy_result = strcpy_s(vdec_msg.video_format, kVideoFormatLength,
-                             kVideoTypeH264.c_str());
-  } else { // the video type is h264
-    strcpy_result = strcpy_s(vdec_msg.video_format, kVideoFormatLength,
-                             kVideoTypeH265.c_str());
+    strcpy_result = strcpy_s(channel.vdec_msg.video_format,
+                             kVideoFormatLength, kVideoTypeH264.c_str());
+  } else { // the video type is h265
+    strcpy_result = strcpy_s(channel.vdec_msg.video_format,
+                             kVideoFormatLength, kVideoTypeH265.c_str());
   }
 
   if (strcpy_result != EOK) { // check strcpy result
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "Fail to call strcpy_s, result:%d, channel id:%s", 
-                    strcpy_result, channel_id.c_str());
+                    "Fail to call strcpy_s, result:%d, channel id:%s",
+                    strcpy_result, channel.channel_id.c_str());
+    return false;
+  }
+
+  channel.dvpp_api_ctl_msg.in = (void*) (&channel.vdec_msg);
+  channel.dvpp_api_ctl_msg.in_size = sizeof(vdec_in_msg);
+  return true;
+}
+
+bool VideoDecode::OpenSoftwareDecoder(VideoChannel &channel) {
+  // libavcodec takes the mp4 (avcc/hvcc) stream as it is, the bitstream
+  // filter is only needed by vdec
+  AVCodecParameters* codec_par =
+      channel.av_format_context->streams[channel.video_index]->codecpar;
+  const AVCodec* codec = avcodec_find_decoder(codec_par->codec_id);
+  if (codec == nullptr) { // check the decoder is built in ffmpeg
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "No software decoder for AVCodecID:%d, channel id:%s",
+                    codec_par->codec_id, channel.channel_id.c_str());
+    return false;
+  }
+
+  // freed by CloseVideoChannel on failure
+  channel.codec_ctx = avcodec_alloc_context3(codec);
+  channel.av_frame = av_frame_alloc();
+  if (channel.codec_ctx == nullptr || channel.av_frame == nullptr) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to alloc software decoder, channel id:%s",
+                    channel.channel_id.c_str());
+    return false;
+  }
+
+  if (avcodec_parameters_to_context(channel.codec_ctx, codec_par)
+      < kHandleSuccessful) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to call avcodec_parameters_to_context, channel id:%s",
+                    channel.channel_id.c_str());
+    return false;
+  }
+
+  // frame threading decodes several frames in parallel, so one channel uses
+  // software_thread_num_ cores at the cost of as many frames of delay
+  channel.codec_ctx->thread_count = software_thread_num_;
+  channel.codec_ctx->thread_type = FF_THREAD_FRAME;
+
+  int ret = avcodec_open2(channel.codec_ctx, codec, nullptr);
+  if (ret < kHandleSuccessful) { // check open decoder result
+    char buf_error[kErrorBufferSize];
+    av_strerror(ret, buf_error, kErrorBufferSize);
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to call avcodec_open2, error info:%s, channel id:%s",
+                    buf_error, channel.channel_id.c_str());
+    return false;
+  }
+
+  channel.is_software = true;
+  return true;
+}
+
+void VideoDecode::DecodeSoftwarePacket(VideoChannel &channel,
+                                       AVPacket* av_packet) {
+  int ret = avcodec_send_packet(channel.codec_ctx, av_packet);
+  if (ret < kHandleSuccessful) { // a broken packet is skipped
+    char buf_error[kErrorBufferSize];
+    av_strerror(ret, buf_error, kErrorBufferSize);
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to call avcodec_send_packet, error info:%s, "
+                    "channel id:%s", buf_error, channel.channel_id.c_str());
+  }
+
+  // every frame is decoded, only key frames are converted and sent
+  while (avcodec_receive_frame(channel.codec_ctx, channel.av_frame)
+      == kHandleSuccessful) {
+    uint32_t frame_id = ++channel.frame_info.frame_id;
+    if (IsKeyFrame(channel.frame_info, frame_id)) {
+      AddSoftwareFrame(channel, frame_id);
+    }
+
+    av_frame_unref(channel.av_frame);
+
+    // draining returns a frame per decoder thread, more than the image
+    // queue holds, so each one is sent before the next is received
+    if (av_packet == nullptr) {
+      SendImageDataByChannel(channel);
+    }
+  }
+}
+
+void VideoDecode::AddSoftwareFrame(VideoChannel &channel, uint32_t frame_id) {
+  AVFrame* frame = channel.av_frame;
+  HIAI_ENGINE_LOG("Get key frame, frame id:%d, channel_id:%s, channel_name:%s, "
+                  "width:%d, height:%d", frame_id, channel.channel_id.c_str(),
+                  channel.channel_value.c_str(), frame->width, frame->height);
+
+  // the same layout as the vpc output, so the next engines see no difference
+  int align_width = ALIGN_UP(frame->width, ascend::utils::kVpcWidthAlign);
+  int align_height = ALIGN_UP(frame->height, ascend::utils::kVpcHeightAlign);
+  int image_size = align_width * align_height * DVPP_YUV420SP_SIZE_MOLECULE
+      / DVPP_YUV420SP_SIZE_DENOMINATOR;
+
+  unsigned char* out_put_image_buffer = new (nothrow) unsigned char[
+      image_size];
+  if (out_put_image_buffer == nullptr) { // check new result
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to new data when handle software decode output!");
     return;
   }
 
-  dvppapi_ctl_msg dvppApiCtlMsg;
-  dvppApiCtlMsg.in = (void*) (&vdec_msg);
-  dvppApiCtlMsg.in_size = sizeof(vdec_in_msg);
+  shared_ptr<unsigned char> image_buffer(out_put_image_buffer,
+                                         default_delete<unsigned char[]>());
 
+  // yuv420p to nv12 is an unscaled copy in swscale, the context is cached
+  // until the resolution or the pixel format of the stream changes
+  channel.sws_ctx = sws_getCachedContext(
+      channel.sws_ctx, frame->width, frame->height,
+      (AVPixelFormat) frame->format, frame->width, frame->height,
+      AV_PIX_FMT_NV12, SWS_POINT, nullptr, nullptr, nullptr);
+  if (channel.sws_ctx == nullptr) { // check the pixel format is supported
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Fail to convert pixel format:%d to nv12, channel id:%s",
+                    frame->format, channel.channel_id.c_str());
+    return;
+  }
+
+  uint8_t* dest_data[] = { out_put_image_buffer, out_put_image_buffer
+      + align_width * align_height, nullptr, nullptr };
+  int dest_stride[] = { align_width, align_width, 0, 0 };
+  sws_scale(channel.sws_ctx, frame->data, frame->linesize, 0, frame->height,
+            dest_data, dest_stride);
+
+  AddYuvImage(&channel.frame_info, frame_id, frame->width, frame->height,
+              image_buffer, image_size);
+}
+
+bool VideoDecode::DecodeNextPacket(VideoChannel &channel) {
   AVPacket av_packet;
-  // loop to get every frame from video stream
-  while (av_read_frame(av_format_context, &av_packet) == kHandleSuccessful) {
-    if (av_packet.stream_index == videoindex) { // check current stream is video
-      // send video packet to ffmpeg
-      if (av_bsf_send_packet(bsf_ctx, &av_packet) != kHandleSuccessful) {
-        HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                        "Fail to call av_bsf_send_packet, channel id:%s",
-                          channel_id.c_str());
+
+  // read until a packet of the video stream
+  while (av_read_frame(channel.av_format_context, &av_packet)
+      == kHandleSuccessful) {
+    if (av_packet.stream_index != channel.video_index) {
+      av_packet_unref(&av_packet);
+      continue;
+    }
+
+    // the stream delivers, the next reconnection starts with the first
+    // backoff again
+    channel.reconnect_interval_ms = 0;
+
+    // the frames after a lost or corrupt packet miss their reference, they
+    // are dropped until the next key frame
+    if ((av_packet.flags & AV_PKT_FLAG_CORRUPT) != 0) {
+      channel.wait_key_packet = true;
+      channel.is_packet_lost = true;
+    }
+
+    if (channel.wait_key_packet && (((av_packet.flags & AV_PKT_FLAG_KEY) == 0)
+        || ((av_packet.flags & AV_PKT_FLAG_CORRUPT) != 0))) {
+      if (channel.is_packet_lost) {
+        channel.stats.window_lost_packets++;
+      } else {
+        channel.stats.window_skipped_packets++;
       }
+      av_packet_unref(&av_packet);
+      UpdateStreamStats(channel);
+      return true;
+    }
 
-      // receive single frame from ffmpeg
-      while (av_bsf_receive_packet(bsf_ctx, &av_packet) == kHandleSuccessful) {
-        vdec_msg.in_buffer = (char*) av_packet.data;
-        vdec_msg.in_buffer_size = av_packet.size;
-
-        // call vdec and check result
-        if (VdecCtl(dvpp_api, DVPP_CTL_VDEC_PROC, &dvppApiCtlMsg, 0)
-            != kHandleSuccessful) {
-          HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                          "Fail to call dvppctl process, channel id:%s",
-                          channel_id.c_str());
-
-          av_packet_unref(&av_packet);
-          av_bsf_free(&bsf_ctx);
-          avformat_close_input(&av_format_context);
-          DestroyVdecApi(dvpp_api, 0);
-          return;
-        }
+    channel.wait_key_packet = false;
+    channel.is_packet_lost = false;
+    channel.stats.window_packets++;
+    channel.stats.window_bytes += av_packet.size;
+
+    if (channel.is_software) { // decode with libavcodec
+      chrono::steady_clock::time_point decode_start =
+          chrono::steady_clock::now();
+      DecodeSoftwarePacket(channel, &av_packet);
+      av_packet_unref(&av_packet);
+      channel.stats.window_decode_ns += chrono::duration_cast<
+          chrono::nanoseconds>(chrono::steady_clock::now() - decode_start)
+          .count();
+      UpdateStreamStats(channel);
+      SendImageDataByChannel(channel);
+      return true;
+    }
 
-        av_packet_unref(&av_packet);
+    // send video packet to ffmpeg
+    if (av_bsf_send_packet(channel.bsf_ctx, &av_packet) != kHandleSuccessful) {
+      HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                      "Fail to call av_bsf_send_packet, channel id:%s",
+                      channel.channel_id.c_str());
+      av_packet_unref(&av_packet);
+    }
 
-        // send image data to next engine
-        SendImageDate(channel_id);
+    // receive single frame from ffmpeg
+    while (av_bsf_receive_packet(channel.bsf_ctx, &av_packet)
+        == kHandleSuccessful) {
+      channel.vdec_msg.in_buffer = (char*) av_packet.data;
+      channel.vdec_msg.in_buffer_size = av_packet.size;
+
+      // call vdec and check result, vpc runs in its callback
+      chrono::steady_clock::time_point decode_start =
+          chrono::steady_clock::now();
+      int vdec_ret = VdecCtl(channel.dvpp_api, DVPP_CTL_VDEC_PROC,
+                             &channel.dvpp_api_ctl_msg, 0);
+      channel.stats.window_decode_ns += chrono::duration_cast<
+          chrono::nanoseconds>(chrono::steady_clock::now() - decode_start)
+          .count();
+      if (vdec_ret != kHandleSuccessful) {
+        HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                        "Fail to call dvppctl process, channel id:%s",
+                        channel.channel_id.c_str());
+        av_packet_unref(&av_packet);
+        return false;
       }
+
+      av_packet_unref(&av_packet);
+
+      // send image data to next engine
+      SendImageDataByChannel(channel);
     }
+
+    UpdateStreamStats(channel);
+    return true;
   }
 
-  av_bsf_free(&bsf_ctx);  // free AVBSFContext pointer
-  avformat_close_input(&av_format_context);  // close input video
-  DestroyVdecApi(dvpp_api, 0);
+  HIAI_ENGINE_LOG("Ffmpeg read frame finished, channel id:%s",
+                  channel.channel_id.c_str());
+  return false;
+}
+
+void VideoDecode::CloseVideoChannel(VideoChannel &channel) {
+  if (channel.bsf_ctx != nullptr) { // free AVBSFContext pointer
+    av_bsf_free(&channel.bsf_ctx);
+  }
+
+  if (channel.av_format_context != nullptr) { // close input video
+    avformat_close_input(&channel.av_format_context);
+  }
+
+  if (channel.dvpp_api != nullptr) {
+    DestroyVdecApi(channel.dvpp_api, 0);
+    channel.dvpp_api = nullptr;
+    vdec_channel_num_--;
+  }
+
+  if (channel.is_software) { // drain the frames held by the decoder threads
+    DecodeSoftwarePacket(channel, nullptr);
+  }
+
+  if (channel.sws_ctx != nullptr) {
+    sws_freeContext(channel.sws_ctx);
+    channel.sws_ctx = nullptr;
+  }
+
+  if (channel.av_frame != nullptr) {
+    av_frame_free(&channel.av_frame);
+  }
+
+  if (channel.codec_ctx != nullptr) {
+    avcodec_free_context(&channel.codec_ctx);
+  }
 
   // send last yuv image data after call vdec
-  SendImageDate(channel_id);
+  SendImageDataByChannel(channel);
+
+  // the next connection chooses its decoder again
+  channel.is_opened = false;
+  channel.is_software = false;
+  channel.video_index = kInvalidVideoIndex;
+  channel.wait_key_packet = true;
+  channel.is_packet_lost = false;
+}
 
-  HIAI_ENGINE_LOG("Ffmpeg read frame finished, channel id:%s",
-                  channel_id.c_str());
+bool VideoDecode::ScheduleReconnect(VideoChannel &channel) {
+  if (!channel.is_rtsp || reconnect_interval_ms_ == 0) {
+    return false;
+  }
+
+  // exponential backoff while the camera stays down
+  channel.reconnect_interval_ms = (channel.reconnect_interval_ms == 0) ?
+      reconnect_interval_ms_ :
+      min(channel.reconnect_interval_ms * 2, max_reconnect_interval_ms_);
+  channel.reconnect_time = chrono::steady_clock::now()
+      + chrono::milliseconds(channel.reconnect_interval_ms);
+
+  // the stream is down until it connects again
+  StreamStats &stats = channel.stats;
+  stats.reconnect_num++;
+  stats.window_start = chrono::steady_clock::time_point();
+  stats.window_packets = 0;
+  stats.window_bytes = 0;
+  stats.window_decode_ns = 0;
+  stats.window_lost_packets = 0;
+  stats.window_skipped_packets = 0;
+  ascend::utils::SetGauge(kStreamBitrateGaugeHead + channel.channel_id, 0);
+  ascend::utils::SetGauge(kStreamFpsGaugeHead + channel.channel_id, 0);
+  ascend::utils::SetGauge(kStreamReconnectGaugeHead + channel.channel_id,
+                          stats.reconnect_num);
+
+  HIAI_ENGINE_LOG("Reconnect in %dms, channel id:%s, reconnections:%d",
+                  channel.reconnect_interval_ms, channel.channel_id.c_str(),
+                  stats.reconnect_num);
+  return true;
+}
+
+void VideoDecode::UpdateStreamStats(VideoChannel &channel) {
+  StreamStats &stats = channel.stats;
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+  if (stats.window_start == chrono::steady_clock::time_point()) {
+    stats.window_start = now;
+    return;
+  }
+
+  int64_t window_ns = chrono::duration_cast<chrono::nanoseconds>(
+      now - stats.window_start).count();
+  if (window_ns < kSecToNanoSec) {
+    return;
+  }
+
+  const string &channel_id = channel.channel_id;
+  int total_packets = stats.window_packets + stats.window_lost_packets;
+  ascend::utils::SetGauge(kStreamBitrateGaugeHead + channel_id,
+                          stats.window_bytes * kBitsPerByte * kSecToNanoSec
+                              / window_ns / kBitsPerKilobit);
+  ascend::utils::SetGauge(kStreamFpsGaugeHead + channel_id,
+                          stats.window_packets * kSecToNanoSec / window_ns);
+  ascend::utils::SetGauge(kStreamLossGaugeHead + channel_id,
+                          (total_packets == 0) ? 0 :
+                              stats.window_lost_packets * kPermille
+                                  / total_packets);
+  ascend::utils::SetGauge(kStreamSkipGaugeHead + channel_id,
+                          stats.window_skipped_packets);
+  ascend::utils::SetGauge(kStreamDecodeGaugeHead + channel_id,
+                          (stats.window_packets == 0) ? 0 :
+                              stats.window_decode_ns / stats.window_packets
+                                  / kMicroSecToNanoSec);
+
+  stats.window_start = now;
+  stats.window_packets = 0;
+  stats.window_bytes = 0;
+  stats.window_decode_ns = 0;
+  stats.window_lost_packets = 0;
+  stats.window_skipped_packets = 0;
+}
+
+void VideoDecode::DecodeWorker(int worker_index) {
+  char thread_name_log[kThreadNameLength];
+  string thread_name = kThreadNameHead + to_string(worker_index);
+  prctl(PR_SET_NAME, (unsigned long)thread_name.c_str());
+  prctl(PR_GET_NAME, (unsigned long)thread_name_log);
+  HIAI_ENGINE_LOG("Start decode worker, thread name:%s", thread_name_log);
+
+  int channel_num = channels_.size();
+  while (finished_channel_num_ < channel_num) {
+    VideoChannel* channel = nullptr;
+    if (!ready_channels_->WaitAndPop(channel, kWaitReadyMilliseconds)) {
+      continue;
+    }
+
+    // a channel waiting to reconnect goes behind the others, the worker only
+    // sleeps when no other channel is ready
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (!channel->is_opened && now < channel->reconnect_time) {
+      if (ready_channels_->Empty()) {
+        this_thread::sleep_for(min(
+            chrono::duration_cast<chrono::milliseconds>(
+                channel->reconnect_time - now),
+            chrono::milliseconds(kWaitReadyMilliseconds)));
+      }
+
+      ready_channels_->Push(channel);
+      continue;
+    }
+
+    // one packet per turn, then the channel goes behind the others
+    bool has_more = channel->is_opened ? DecodeNextPacket(*channel) :
+        OpenVideoChannel(*channel);
+    if (has_more) {
+      ready_channels_->Push(channel);
+      continue;
+    }
+
+    // a broken rtsp stream connects again, other channels are finished
+    CloseVideoChannel(*channel);
+    if (ScheduleReconnect(*channel)) {
+      ready_channels_->Push(channel);
+      continue;
+    }
+
+    finished_channel_num_++;
+    HIAI_ENGINE_LOG("Channel finished, channel id:%s, finished channels:%d/%d",
+                    channel->channel_id.c_str(), finished_channel_num_.load(),
+                    channel_num);
+  }
 }
 
 bool VideoDecode::VerifyVideoWithUnpack(const string &channel_value) {
@@ -709,32 +1161,43 @@ bool VideoDecode::VerifyVideoWithUnpack(const string &channel_value) {
 }
 
 bool VideoDecode::VerifyVideoType() {
-  // check channel1 and channel2 is not empty
-  if (!IsEmpty(channel1_, kStrChannelId1)
-      && !IsEmpty(channel2_, kStrChannelId2)) {
-    return (VerifyVideoWithUnpack(channel1_) && VerifyVideoWithUnpack(channel2_));
-  } else if (!IsEmpty(channel1_, kStrChannelId1)) { // channel1 is not empty
-    return VerifyVideoWithUnpack(channel1_);
-  } else {  // channel2 is not empty
-    return VerifyVideoWithUnpack(channel2_);
+  // every channel must be h264 or h265, a camera that is down now is
+  // verified by OpenVideoChannel when it is connected
+  for (const shared_ptr<VideoChannel> &channel : channels_) {
+    if (channel->is_rtsp && reconnect_interval_ms_ != 0) {
+      continue;
+    }
+
+    if (!VerifyVideoWithUnpack(channel->channel_value)) {
+      return false;
+    }
   }
+
+  return true;
 }
 
 void VideoDecode::MultithreadHandleVideo() {
-  // create two thread unpacke channel1 and channel2 video in same time
-  if (!IsEmpty(channel1_, kStrChannelId1)
-      && !IsEmpty(channel2_, kStrChannelId2)) {
-    thread thread_channel_1(&VideoDecode::UnpackVideo2Image, this,
-	                        kStrChannelId1);
-    thread thread_channel_2(&VideoDecode::UnpackVideo2Image, this,
-	                        kStrChannelId2);
+  // every channel starts in the ready queue, its queue slot is never taken by
+  // another channel, so queuing it again does not block
+  ready_channels_.reset(
+      new ThreadSafeQueue<VideoChannel*>((int) channels_.size()));
+  for (const shared_ptr<VideoChannel> &channel : channels_) {
+    ready_channels_->Push(channel.get());
+  }
 
-    thread_channel_1.join();
-    thread_channel_2.join();
-  } else if (!IsEmpty(channel1_, kStrChannelId1)) { // unpacke channel1 video
-    UnpackVideo2Image(kStrChannelId1);
-  } else {  // unpacke channel2 video
-    UnpackVideo2Image(kStrChannelId2);
+  // no more workers than channels
+  int worker_num = ((int) channels_.size() < decode_thread_num_) ?
+      (int) channels_.size() : decode_thread_num_;
+  HIAI_ENGINE_LOG("Decode %d channels with %d threads", (int) channels_.size(),
+                  worker_num);
+
+  vector<thread> workers;
+  for (int i = 0; i < worker_num; ++i) {
+    workers.push_back(thread(&VideoDecode::DecodeWorker, this, i));
+  }
+
+  for (thread &worker : workers) {
+    worker.join();
   }
 }
 
@@ -743,25 +1206,69 @@ HIAI_StatusT VideoDecode::Init(
     const vector<hiai::AIModelDescription> &model_desc) {
   HIAI_ENGINE_LOG("Start process!");
 
-  // get channel values from configs item
+  // get channel values from configs item: channel1, channel2 ...
+  string decode_mode = kDecodeModeHardware;
+  int sample_latency_budget_ms = kDefaultSampleLatencyBudget;
+  regex regex_channel_item(kRegexChannelItem.c_str());
   for (int index = 0; index < config.items_size(); ++index) {
     const ::hiai::AIConfigItem &item = config.items(index);
+    smatch channel_match;
+
+    // get channel value, an empty channel is not used
+    if (regex_match(item.name(), channel_match, regex_channel_item)) {
+      if (IsEmpty(item.value(), item.name())) {
+        continue;
+      }
 
-    // get channel1 value
-    if (item.name() == kStrChannelId1) {
-      channel1_ = item.value();
+      shared_ptr<VideoChannel> channel = make_shared<VideoChannel>();
+      channel->channel_id = item.name();
+      channel->channel_value = item.value();
+      channel->int_channel_id = atoi(channel_match[1].str().c_str());
+      channels_.push_back(channel);
       continue;
     }
 
-    // get channel2 value
-    if (item.name() == kStrChannelId2) {
-      channel2_ = item.value();
+    // get maximum number of decode threads
+    if (item.name() == kDecodeThreadNumItem) {
+      decode_thread_num_ = atoi(item.value().c_str());
       continue;
     }
+
+    // get decoder items
+    if (item.name() == kDecodeModeItem) {
+      decode_mode = item.value();
+    } else if (item.name() == kMaxVdecChannelNumItem) {
+      max_vdec_channel_num_ = atoi(item.value().c_str());
+    } else if (item.name() == kSoftwareThreadNumItem) {
+      software_thread_num_ = atoi(item.value().c_str());
+    } else if (item.name() == kMinSampleIntervalItem) {
+      min_sample_interval_ = atoi(item.value().c_str());
+    } else if (item.name() == kMaxSampleIntervalItem) {
+      max_sample_interval_ = atoi(item.value().c_str());
+    } else if (item.name() == kSampleLatencyBudgetItem) {
+      sample_latency_budget_ms = atoi(item.value().c_str());
+    } else if (item.name() == kRtspJitterBufferItem) {
+      rtsp_jitter_buffer_ms_ = atoi(item.value().c_str());
+    } else if (item.name() == kRtspTransportItem) {
+      rtsp_transport_ = item.value();
+    } else if (item.name() == kReconnectIntervalItem) {
+      reconnect_interval_ms_ = atoi(item.value().c_str());
+    } else if (item.name() == kMaxReconnectIntervalItem) {
+      max_reconnect_interval_ms_ = atoi(item.value().c_str());
+    }
   }
 
-  // verify channel values are valid
-  if (!VerifyChannelValues()) {
+  // decode in the order of channel number
+  sort(channels_.begin(), channels_.end(),
+       [](const shared_ptr<VideoChannel> &first,
+          const shared_ptr<VideoChannel> &second) {
+         return first->int_channel_id < second->int_channel_id;
+       });
+
+  // verify decoder and channel values are valid
+  if (!VerifyDecoderConfig(decode_mode)
+      || !VerifySampleConfig(sample_latency_budget_ms)
+      || !VerifyRtspConfig() || !VerifyChannelValues()) {
     return HIAI_ERROR;
   }
 
@@ -769,6 +1276,110 @@ HIAI_StatusT VideoDecode::Init(
   return HIAI_OK;
 }
 
+bool VideoDecode::VerifySampleConfig(int sample_latency_budget_ms) {
+  if (min_sample_interval_ < 1 || max_sample_interval_ > kMaxSampleInterval
+      || min_sample_interval_ > max_sample_interval_) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d or %s:%d, value range:1~%d, and the "
+                    "minimum should not be greater than the maximum",
+                    kMinSampleIntervalItem.c_str(), min_sample_interval_,
+                    kMaxSampleIntervalItem.c_str(), max_sample_interval_,
+                    kMaxSampleInterval);
+    return false;
+  }
+
+  if (sample_latency_budget_ms < 1
+      || sample_latency_budget_ms > kMaxSampleLatencyBudget) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d, value range:1~%d",
+                    kSampleLatencyBudgetItem.c_str(), sample_latency_budget_ms,
+                    kMaxSampleLatencyBudget);
+    return false;
+  }
+
+  sample_latency_budget_ns_ = sample_latency_budget_ms * kMilliSecToNanoSec;
+  return true;
+}
+
+bool VideoDecode::VerifyRtspConfig() {
+  if (rtsp_jitter_buffer_ms_ < 0
+      || rtsp_jitter_buffer_ms_ > kMaxRtspJitterBuffer) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d, value range:0~%d",
+                    kRtspJitterBufferItem.c_str(), rtsp_jitter_buffer_ms_,
+                    kMaxRtspJitterBuffer);
+    return false;
+  }
+
+  if (rtsp_transport_ != kUdp && rtsp_transport_ != kTcp) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%s, should be %s or %s",
+                    kRtspTransportItem.c_str(), rtsp_transport_.c_str(),
+                    kUdp.c_str(), kTcp.c_str());
+    return false;
+  }
+
+  if (reconnect_interval_ms_ < 0 || max_reconnect_interval_ms_ < 1
+      || max_reconnect_interval_ms_ > kMaxReconnectInterval
+      || reconnect_interval_ms_ > max_reconnect_interval_ms_) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d or %s:%d, value range:0~%d and 1~%d, and "
+                    "the first should not be greater than the maximum",
+                    kReconnectIntervalItem.c_str(), reconnect_interval_ms_,
+                    kMaxReconnectIntervalItem.c_str(),
+                    max_reconnect_interval_ms_, kMaxReconnectInterval,
+                    kMaxReconnectInterval);
+    return false;
+  }
+
+  return true;
+}
+
+bool VideoDecode::VerifyDecoderConfig(const string &decode_mode) {
+  if (decode_thread_num_ < 1 || decode_thread_num_ > kMaxDecodeThreadNum) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d, value range:1~%d",
+                    kDecodeThreadNumItem.c_str(), decode_thread_num_,
+                    kMaxDecodeThreadNum);
+    return false;
+  }
+
+  if (decode_mode == kDecodeModeHardware) {
+    decode_mode_ = kDecodeHardware;
+  } else if (decode_mode == kDecodeModeSoftware) {
+    decode_mode_ = kDecodeSoftware;
+  } else if (decode_mode == kDecodeModeAuto) {
+    decode_mode_ = kDecodeAuto;
+  } else { // the decode mode is invalid
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%s, should be %s, %s or %s",
+                    kDecodeModeItem.c_str(), decode_mode.c_str(),
+                    kDecodeModeHardware.c_str(), kDecodeModeSoftware.c_str(),
+                    kDecodeModeAuto.c_str());
+    return false;
+  }
+
+  if (max_vdec_channel_num_ < 0
+      || max_vdec_channel_num_ > kMaxVdecChannelNum) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d, value range:0~%d",
+                    kMaxVdecChannelNumItem.c_str(), max_vdec_channel_num_,
+                    kMaxVdecChannelNum);
+    return false;
+  }
+
+  if (software_thread_num_ < 1
+      || software_thread_num_ > kMaxSoftwareThreadNum) {
+    HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
+                    "Invalid %s:%d, value range:1~%d",
+                    kSoftwareThreadNumItem.c_str(), software_thread_num_,
+                    kMaxSoftwareThreadNum);
+    return false;
+  }
+
+  return true;
+}
+
 bool VideoDecode::IsEmpty(const string &input_str, const string &channel_id) {
   regex regex_space(kRegexSpace.c_str());
 
@@ -816,81 +1427,109 @@ bool VideoDecode::IsValidMp4File(const string &input_str) {
 }
 
 bool VideoDecode::VerifyChannelValues() {
-  // check channel1 and channel2 are empty
-  if (IsEmpty(channel1_, kStrChannelId1)
-      && IsEmpty(channel2_, kStrChannelId2)) {
+  // check all channels are empty
+  if (channels_.empty()) {
     HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
-                    "Both channel1 and channel2 are empty!");
+                    "All channels are empty!");
     return false;
   }
 
-  // verify channel1 value when channel1 is not empty
-  if (!IsEmpty(channel1_, kStrChannelId1)) {
+  for (const shared_ptr<VideoChannel> &channel : channels_) {
+    string &channel_value = channel->channel_value;
+
     // deletes the space at the head of the string
-    channel1_.erase(0, channel1_.find_first_not_of(kNeedRemoveStr.c_str()));
+    channel_value.erase(
+        0, channel_value.find_first_not_of(kNeedRemoveStr.c_str()));
 
     // deletes spaces at the end of the string
-    channel1_.erase(channel1_.find_last_not_of(kNeedRemoveStr.c_str()) + 1);
+    channel_value.erase(
+        channel_value.find_last_not_of(kNeedRemoveStr.c_str()) + 1);
 
-    HIAI_ENGINE_LOG("Display channel1:%s", channel1_.c_str());
+    HIAI_ENGINE_LOG("Display %s:%s", channel->channel_id.c_str(),
+                    channel_value.c_str());
 
-    if (!VerifyVideoSourceName(channel1_)) { // verify channel1
+    if (!VerifyVideoSourceName(channel_value)) { // verify channel value
       return false;
     }
-  }
-
-  // verify channel2 value when channel1 is not empty
-  if (!IsEmpty(channel2_, kStrChannelId2)) {
-    // deletes the space at the head of the string
-    channel2_.erase(0, channel2_.find_first_not_of(kNeedRemoveStr.c_str()));
 
-    // deletes spaces at the end of the string
-    channel2_.erase(channel2_.find_last_not_of(kNeedRemoveStr.c_str()) + 1);
+    channel->is_rtsp = IsValidRtsp(channel_value);
 
-    HIAI_ENGINE_LOG("Display channel2:%s", channel2_.c_str());
+    // the vdec callback gets the frame info of its channel
+    channel->image_queue.reset(
+        new ThreadSafeQueue<shared_ptr<VideoImageParaT>>(kImageDataQueueSize));
+    channel->frame_info.channel_name = channel_value;
+    channel->frame_info.channel_id = channel->channel_id;
+    channel->frame_info.image_queue = channel->image_queue.get();
 
-    if (!VerifyVideoSourceName(channel2_)) { // verify channel2
-      return false;
-    }
+    // start from the fixed interval used before, within the bounds
+    channel->frame_info.sampler.interval = min(
+        max(kKeyFrameInterval, min_sample_interval_), max_sample_interval_);
+    ascend::utils::SetGauge(kSampleIntervalGaugeHead + channel->channel_id,
+                            channel->frame_info.sampler.interval);
   }
 
   return true;
 }
 
-void VideoDecode::SendImageDataByChannel(
-    ThreadSafeQueue<shared_ptr<VideoImageParaT>> &current_queue) {
+void VideoDecode::SendImageDataByChannel(VideoChannel &channel) {
   HIAI_StatusT hiai_ret = HIAI_OK;
 
   // send image data unitl queue is empty
-  while (!current_queue.empty()) {
-    shared_ptr<VideoImageParaT> video_iamge_data = current_queue.Pop();
-    if (video_iamge_data == nullptr) { // the queue is empty and return
-      return;
-    }
+  shared_ptr<VideoImageParaT> video_iamge_data = nullptr;
+  while (channel.image_queue->TryPop(video_iamge_data)) {
+    ascend::utils::ExitTraceStage(video_iamge_data->video_image_info.trace);
 
-    // send image data
-    do {
-      hiai_ret = SendData(0, kVideoImageParaType,
-                          static_pointer_cast<void>(video_iamge_data));
-      if (hiai_ret == HIAI_QUEUE_FULL) { // check queue is full
-        HIAI_ENGINE_LOG("The queue is full when send image data, sleep 10ms");
-        usleep(kWait10Milliseconds); // sleep 10 ms
-      }
-    } while (hiai_ret == HIAI_QUEUE_FULL); // loop while queue is full
+    // send image data, block until object detection has room
+    bool is_queue_full = false;
+    hiai_ret = SendDataWithCredit(kObjectDetectionEngine, [&]() {
+      return SendData(0, kVideoImageParaType,
+                      static_pointer_cast<void>(video_iamge_data));
+    }, &is_queue_full);
 
     if (hiai_ret != HIAI_OK) { // check send data is failed
       HIAI_ENGINE_LOG(HIAI_ENGINE_RUN_ARGS_NOT_RIGHT,
                       "Send data failed! error code: %d", hiai_ret);
     }
+
+    AdjustSampleInterval(channel, is_queue_full);
   }
 }
 
-void VideoDecode::SendImageDate(const string &channel_id) {
-  if (channel_id == kStrChannelId1) { // check channel id is channle1
-    SendImageDataByChannel(channel1_queue);
-  } else { // check channel id is channle2
-    SendImageDataByChannel(channel2_queue);
+void VideoDecode::AdjustSampleInterval(VideoChannel &channel,
+                                       bool is_queue_full) {
+  // the slowest watched engine in this process, engines on the host are not
+  // seen here and only count through the queue of the next engine
+  int64_t max_load_ns = 0;
+  for (const char *stage : kSampleWatchStages) {
+    max_load_ns = max(max_load_ns, ascend::utils::GetStageLoadNs(stage));
+  }
+
+  // multiplicative back-off and additive probe, so channels sharing the
+  // engines converge to the same interval
+  FrameSampler &sampler = channel.frame_info.sampler;
+  int interval = sampler.interval;
+  if (is_queue_full || max_load_ns > sample_latency_budget_ns_) {
+    interval = min(interval * 2, max_sample_interval_);
+    sampler.calm_frames = 0;
+  } else if (++sampler.calm_frames >= kSampleProbeFrames) {
+    interval = max(interval - 1, min_sample_interval_);
+    sampler.calm_frames = 0;
   }
+
+  if (interval == sampler.interval) {
+    return;
+  }
+
+  HIAI_ENGINE_LOG("Key frame interval %d -> %d, channel id:%s, queue full:%d, "
+                  "engine load:%lldus", sampler.interval, interval,
+                  channel.channel_id.c_str(), is_queue_full,
+                  (long long) (max_load_ns / kMicroSecToNanoSec));
+
+  // a longer interval also delays the key frame already planned
+  sampler.next_frame_id += interval - sampler.interval;
+  sampler.interval = interval;
+  ascend::utils::SetGauge(kSampleIntervalGaugeHead + channel.channel_id,
+                          interval);
 }
 
 HIAI_IMPL_ENGINE_PROCESS("video_decode", VideoDecode, INPUT_SIZE) {
@@ -902,7 +1541,7 @@ HIAI_IMPL_ENGINE_PROCESS("video_decode", VideoDecode, INPUT_SIZE) {
     return HIAI_ERROR;
   }
 
-  MultithreadHandleVideo();  // handle video from file or RTSP with multi-thread
+  MultithreadHandleVideo();  // handle video from file or RTSP on the workers
 
   SendFinishedData();  // send the flag data when finished
 
@@ -38,6 +38,8 @@
 #include <stdint.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -46,14 +48,17 @@
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
 }
 
-#include "thread_safe_queue.h"
+#include "ascenddk/ascend_utils/thread_safe_queue.h"
 #include "hiaiengine/engine.h"
 #include "hiaiengine/multitype_queue.h"
 #include "dvpp/idvppapi.h"
 #include "video_analysis_params.h"
 
+using ascend::utils::ThreadSafeQueue;
+
 // input size used for engine
 #define INPUT_SIZE 1
 
@@ -67,19 +72,62 @@ enum VideoType {
   kInvalidTpye
 };
 
+// decoder of a channel, from config item decode_mode
+enum DecodeMode {
+  kDecodeHardware,  // vdec on the device, the default
+  kDecodeSoftware,  // libavcodec on the cpu, e.g. on a host without vdec
+  kDecodeAuto  // vdec while a vdec channel is available, else libavcodec
+};
+
+// analyzed frame interval of a channel, adapted to the load of the next
+// engines by VideoDecode::AdjustSampleInterval
+struct FrameSampler {
+  // frames between two key frames
+  int interval = 0;
+
+  // id of the next key frame, the first frame is a key frame
+  uint32_t next_frame_id = 1;
+
+  // key frames sent since the last congestion
+  int calm_frames = 0;
+};
+
+// health of the stream of a channel, published as gauges once a second by
+// VideoDecode::UpdateStreamStats
+struct StreamStats {
+  // start of the current window, zero before the first packet
+  std::chrono::steady_clock::time_point window_start;
+
+  // video packets decoded in the window and their size
+  int window_packets = 0;
+  int64_t window_bytes = 0;
+
+  // time spent in the decoder for the packets of the window
+  int64_t window_decode_ns = 0;
+
+  // video packets of the window that were corrupt or dropped while waiting
+  // for a key frame after a corrupt one
+  int window_lost_packets = 0;
+
+  // video packets of the window dropped before the first key frame of a
+  // connection, they are not a loss
+  int window_skipped_packets = 0;
+
+  // reconnections of the channel since the start
+  int reconnect_num = 0;
+};
+
+// yuv420sp image frame info, passed to the vdec callback
+struct YuvImageFrameInfo;
+
 /**
- * @brief check current is key frame, key frame: 1,6,11,16...
+ * @brief check current is key frame, key frame: 1, 1+interval ...
+ *        e.g. 1,6,11,16... for interval 5
+ * @param [in] frame_info: frame info of the channel
  * @param [in] frame_id: frame id
  * @return true: is key frame; false: is not key frame
  */
-bool IsKeyFrame(uint32_t frame_id);
-
-/**
- * @brief get frame id by channel id
- * @param [in] channel_id: channel id
- * @return frame id
- */
-uint32_t GetFrameId(const std::string &channel_id);
+bool IsKeyFrame(YuvImageFrameInfo &frame_info, uint32_t frame_id);
 
 /**
  * @brief send key frame data to next engine
@@ -97,6 +145,20 @@ void SendKeyFrameData(const vpc_in_msg &vpcInMsg, void* hiai_data,
  */
 void CallVpcGetYuvImage(FRAME* frame, void* hiai_data);
 
+/**
+ * @brief queue a decoded yuv420sp image of a channel, the image is aligned
+ *        like the vpc output: width to 128 and height to 16
+ * @param [in] hiai_data: used for transmit channel and frame info
+ * @param [in] frame_id: frame id of the image
+ * @param [in] width: image width
+ * @param [in] height: image height
+ * @param [in] data: image data
+ * @param [in] size: size of image data
+ */
+void AddYuvImage(void* hiai_data, uint32_t frame_id, uint32_t width,
+                 uint32_t height, const shared_ptr<unsigned char> &data,
+                 uint32_t size);
+
 /**
  * @brief add image data to queue by channel id
  * @param [in] video_image_para: the image data from video
@@ -106,10 +168,70 @@ void AddImage2QueueByChannel(
     const shared_ptr<VideoImageParaT> &video_image_para,
     ThreadSafeQueue<shared_ptr<VideoImageParaT>> &current_queue);
 
-// yuv420sp image frame info
+// yuv420sp image frame info, passed to the vdec callback
 struct YuvImageFrameInfo {
   std::string channel_name;
   std::string channel_id;
+
+  // id of the last decoded frame
+  uint32_t frame_id = 0;
+
+  // chooses the key frames
+  FrameSampler sampler;
+
+  // decoded key frames waiting to be sent by the worker of the channel
+  ThreadSafeQueue<shared_ptr<VideoImageParaT>> *image_queue = nullptr;
+};
+
+// one video source from the config items channel1, channel2 ..., demuxed and
+// decoded by one worker at a time
+struct VideoChannel {
+  // config item name, e.g. channel1
+  std::string channel_id;
+
+  // mp4 file path or rtsp address
+  std::string channel_value;
+
+  // number in the item name, used as vdec channel id
+  int int_channel_id = 0;
+
+  // an rtsp channel is connected again when its stream breaks
+  bool is_rtsp = false;
+
+  // earliest time of the next connection and the backoff before it, the
+  // backoff is 0 once the stream delivers packets
+  std::chrono::steady_clock::time_point reconnect_time;
+  int reconnect_interval_ms = 0;
+
+  // drop video packets until a key frame, after connecting or a loss
+  bool wait_key_packet = true;
+
+  // the key frame is waited for after a corrupt packet, the dropped
+  // packets are lost; after connecting they are only skipped
+  bool is_packet_lost = false;
+
+  // bitrate, fps, packet loss and decode time of the stream
+  StreamStats stats;
+
+  // demux and decode state, created by the first worker picking the channel
+  bool is_opened = false;
+  AVFormatContext* av_format_context = nullptr;
+  AVBSFContext* bsf_ctx = nullptr;
+  int video_index = -1;
+  IDVPPAPI* dvpp_api = nullptr;
+  vdec_in_msg vdec_msg;
+
+  // software decode state, used instead of vdec if is_software is true
+  bool is_software = false;
+  AVCodecContext* codec_ctx = nullptr;
+  AVFrame* av_frame = nullptr;
+  SwsContext* sws_ctx = nullptr;
+
+  dvppapi_ctl_msg dvpp_api_ctl_msg;
+  YuvImageFrameInfo frame_info;
+
+  // decoded key frames of this channel
+  std::unique_ptr<ThreadSafeQueue<shared_ptr<VideoImageParaT>>> image_queue;
 };
 
 class VideoDecode : public hiai::Engine {
@@ -143,18 +265,156 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
 
  private:
 
-  std::string channel1_; // channel1 content, mp4 file path or rtsp address
+  // video sources in the order of their channel number
+  std::vector<std::shared_ptr<VideoChannel>> channels_;
 
-  std::string channel2_; // channel2 content, mp4 file path or rtsp address
+  // maximum number of decode worker threads
+  int decode_thread_num_;
+
+  // channels waiting for a worker, every channel is queued at most once
+  std::unique_ptr<ThreadSafeQueue<VideoChannel*>> ready_channels_;
+
+  // channels at the end of their stream
+  std::atomic<int> finished_channel_num_;
+
+  // decoder used by the channels
+  DecodeMode decode_mode_;
+
+  // maximum number of channels decoded by vdec in auto mode
+  int max_vdec_channel_num_;
+
+  // threads of one libavcodec decoder
+  int software_thread_num_;
+
+  // channels decoded by vdec now
+  std::atomic<int> vdec_channel_num_;
+
+  // bounds of the key frame interval
+  int min_sample_interval_;
+  int max_sample_interval_;
+
+  // the interval grows when a watched engine is slower than this
+  int64_t sample_latency_budget_ns_;
+
+  // reorder delay of rtsp packets in millisecond, 0: no reordering
+  int rtsp_jitter_buffer_ms_;
+
+  // rtsp lower transport, udp or tcp
+  std::string rtsp_transport_;
+
+  // first and maximum backoff before an rtsp channel connects again,
+  // the backoff doubles after every failed connection. 0: no reconnection
+  int reconnect_interval_ms_;
+  int max_reconnect_interval_ms_;
 
   /**
-   * @brief unpack video to image
-   * @param [in] channel_id: the input channel id
+   * @brief adapt the key frame interval of a channel after a key frame is
+   *        sent: double it when the next engine queue was full or a watched
+   *        engine is over the latency budget, else shorten it by 1 every
+   *        kSampleProbeFrames key frames
+   * @param [in] channel: the channel
+   * @param [in] is_queue_full: the next engine had no credit or its queue
+   *        was full
    */
-  void UnpackVideo2Image(const std::string &channel_id);
+  void AdjustSampleInterval(VideoChannel &channel, bool is_queue_full);
 
   /**
-   * @brief verify the  video type of channel1 and channle2
+   * @brief verify the rtsp config items
+   * @return true: verify passed; false: verify failed
+   */
+  bool VerifyRtspConfig();
+
+  /**
+   * @brief plan the next connection of a closed rtsp channel
+   * @param [in] channel: the channel
+   * @return true: the channel connects again; false: the channel is finished
+   */
+  bool ScheduleReconnect(VideoChannel &channel);
+
+  /**
+   * @brief publish the stream gauges of a channel once a second
+   * @param [in] channel: the channel
+   */
+  void UpdateStreamStats(VideoChannel &channel);
+
+  /**
+   * @brief verify the sample config items
+   * @param [in] sample_latency_budget_ms: value of sample_latency_budget_ms
+   * @return true: verify passed; false: verify failed
+   */
+  bool VerifySampleConfig(int sample_latency_budget_ms);
+
+  /**
+   * @brief decode worker: takes the next ready channel, sends one video
+   *        packet of it to vdec and queues it again, so every channel gets
+   *        its turn however many channels share the workers
+   * @param [in] worker_index: index of the worker, used in the thread name
+   */
+  void DecodeWorker(int worker_index);
+
+  /**
+   * @brief open the video of a channel, its bitstream filter and vdec
+   * @param [in] channel: the channel
+   * @return true: success; false: fail to open
+   */
+  bool OpenVideoChannel(VideoChannel &channel);
+
+  /**
+   * @brief create vdec for the channel
+   * @param [in] channel: the channel
+   * @param [in] video_type: video type
+   * @return true: success; false: no vdec
+   */
+  bool OpenHardwareDecoder(VideoChannel &channel, VideoType video_type);
+
+  /**
+   * @brief create a frame threaded libavcodec decoder for the channel
+   * @param [in] channel: the channel
+   * @return true: success; false: fail to open the decoder
+   */
+  bool OpenSoftwareDecoder(VideoChannel &channel);
+
+  /**
+   * @brief send a packet to the libavcodec decoder of the channel and queue
+   *        every key frame it returns, a broken packet is skipped like vdec
+   *        does
+   * @param [in] channel: the channel
+   * @param [in] av_packet: the packet, nullptr to drain the decoder
+   */
+  void DecodeSoftwarePacket(VideoChannel &channel, AVPacket* av_packet);
+
+  /**
+   * @brief convert a libavcodec frame to an aligned yuv420sp image and
+   *        queue it
+   * @param [in] channel: the channel
+   * @param [in] frame_id: frame id of the image
+   */
+  void AddSoftwareFrame(VideoChannel &channel, uint32_t frame_id);
+
+  /**
+   * @brief read packets until one video packet is sent to vdec
+   * @param [in] channel: the channel
+   * @return true: the channel has more packets; false: end of stream or error
+   */
+  bool DecodeNextPacket(VideoChannel &channel);
+
+  /**
+   * @brief release the channel and send its last images, the channel can be
+   *        opened again
+   * @param [in] channel: the channel
+   */
+  void CloseVideoChannel(VideoChannel &channel);
+
+  /**
+   * @brief verify the decoder config items
+   * @param [in] decode_mode: value of config item decode_mode
+   * @return true: verify passed; false: verify failed
+   */
+  bool VerifyDecoderConfig(const std::string &decode_mode);
+
+  /**
+   * @brief verify the video type of every channel, an rtsp channel that
+   *        reconnects is verified when it is connected
    */
   bool VerifyVideoType();
 
@@ -165,16 +425,11 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
   bool VerifyVideoWithUnpack(const std::string &channel_value);
 
   /**
-   * @brief handle video with multithread
+   * @brief decode all channels on a pool of decode_thread_num_ workers and
+   *        wait until every channel is finished
    */
   void MultithreadHandleVideo();
 
-  /**
-   * @brief send image data to next engine
-   * @param [in] channel_id: the input channel id
-   */
-  void SendImageDate(const std::string &channel_id);
-
   /**
    * @brief get video index form video format context
    * @param [in] av_format_context: video format context
@@ -240,20 +495,6 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
    */
   void SendFinishedData();
 
-  /**
-   * @brief get channel id(integer value)
-   * @param [in] channel_id: the input channel id
-   * @return channel id(integer value)
-   */
-  int GetIntChannelId(const std::string channel_id);
-
-  /**
-   * @brief get channel value
-   * @param [in] channel_id: the input channel id
-   * @return channel value
-   */
-  const std::string &GetChannelValue(const std::string &channel_id);
-
   /**
    * @brief set dictionary for rtsp
    * @param [in] channel_value: the input channel value
@@ -271,7 +512,7 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
                                  AVFormatContext* &av_format_context);
 
   /**
-   * @brief open video format from input channel
+   * @brief initialize the bitstream filter of the video
    * @param [in] videoindex: the video index
    * @param [out] video_type: the input channel value
    * @param [in] av_format_context: the video format context
@@ -283,11 +524,10 @@ HIAI_DEFINE_PROCESS(INPUT_SIZE, OUTPUT_SIZE)
                        AVBSFContext* &bsf_ctx);
 
   /**
-   * @brief send image data by channel
-   * @param [out] current_queue:current channel queue
+   * @brief send image data by channel and adapt its key frame interval
+   * @param [in] channel: current channel
    */
-  void SendImageDataByChannel(
-      ThreadSafeQueue<shared_ptr<VideoImageParaT>> &current_queue);
+  void SendImageDataByChannel(VideoChannel &channel);
 };
 
 #endif /* VIDEO_DECODE_H_ */